@@ -0,0 +1,77 @@
+# 网页控制台打包 (PlatformIO pre 脚本)
+#
+# 把 web/index.html 压缩为 gzip，生成 src/dashboard_html.h:
+# - dashboard_html_gz[]  PROGMEM 字节数组 (直接从闪存发送，主机不做解压)
+# - DASHBOARD_HTML_GZ_LEN 压缩后长度
+# - DASHBOARD_ETAG       内容哈希 (强 ETag，内容不变则不变)
+#
+# gzip 头中的时间戳固定为 0，同一份 HTML 总是生成相同的字节和 ETag。
+# 也可以单独运行: python scripts/embed_dashboard.py
+
+import gzip
+import hashlib
+import io
+import os
+
+try:
+    Import("env")
+    PROJECT_DIR = env.subst("$PROJECT_DIR")
+except NameError:
+    PROJECT_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+SOURCE = os.path.join(PROJECT_DIR, "web", "index.html")
+OUTPUT = os.path.join(PROJECT_DIR, "src", "dashboard_html.h")
+
+
+def compress(data):
+    buf = io.BytesIO()
+    with gzip.GzipFile(filename="", mode="wb", compresslevel=9, fileobj=buf, mtime=0) as f:
+        f.write(data)
+    return buf.getvalue()
+
+
+def render(raw, gz):
+    etag = hashlib.sha1(gz).hexdigest()[:16]
+    lines = [
+        "/*",
+        " * 网页控制台 (gzip 压缩，由 scripts/embed_dashboard.py 生成，请勿手工修改)",
+        " * 源文件: web/index.html (%d 字节，压缩后 %d 字节)" % (len(raw), len(gz)),
+        " */",
+        "",
+        "#ifndef DASHBOARD_HTML_H",
+        "#define DASHBOARD_HTML_H",
+        "",
+        "#include <Arduino.h>",
+        "",
+        "#define DASHBOARD_HTML_GZ_LEN  %d" % len(gz),
+        "#define DASHBOARD_ETAG         \"\\\"%s\\\"\"" % etag,
+        "",
+        "static const uint8_t dashboard_html_gz[DASHBOARD_HTML_GZ_LEN] PROGMEM = {",
+    ]
+    for i in range(0, len(gz), 16):
+        lines.append("    " + ", ".join("0x%02x" % b for b in gz[i:i + 16]) + ",")
+    lines += [
+        "};",
+        "",
+        "#endif  // DASHBOARD_HTML_H",
+        "",
+    ]
+    return "\n".join(lines)
+
+
+def main():
+    with open(SOURCE, "rb") as f:
+        raw = f.read()
+    text = render(raw, compress(raw))
+
+    # 内容不变时不重写，避免触发重新编译
+    if os.path.exists(OUTPUT):
+        with open(OUTPUT, "r", encoding="utf-8") as f:
+            if f.read() == text:
+                return
+    with open(OUTPUT, "w", encoding="utf-8", newline="\n") as f:
+        f.write(text)
+    print("Dashboard: %s (%d -> %d bytes)" % (os.path.relpath(OUTPUT, PROJECT_DIR), len(raw), len(compress(raw))))
+
+
+main()
@@ -0,0 +1,99 @@
+# ESP8266 内存占用报告 (PlatformIO post 脚本)
+#
+# 链接完成后统计每个模块 (.o) 的 DRAM / IRAM / Flash 占用，
+# 并检查固件静态 DRAM 是否超出 platformio.ini 中的 custom_dram_budget，
+# 防止字符串常量等回流到 DRAM，挤占连接和历史记录所需的堆空间。
+#
+# 分类规则 (与 ESP8266 Arduino 链接脚本一致):
+# - DRAM : .data* .rodata* .bss*   (普通字符串常量位于 .rodata，占用 DRAM)
+# - IRAM : .iram*                  (IRAM_ATTR 函数)
+# - Flash: .text* .literal* .irom* (普通代码与 PROGMEM 数据)
+#
+# 结果同时写入 $BUILD_DIR/memory_report.csv
+
+Import("env")
+
+import os
+import subprocess
+
+
+def classify(section):
+    if section.startswith((".data", ".rodata", ".bss")):
+        return "dram"
+    if section.startswith(".iram"):
+        return "iram"
+    if section.startswith((".text", ".literal", ".irom")):
+        return "flash"
+    return None
+
+
+def section_sizes(size_tool, path):
+    out = subprocess.check_output([size_tool, "-A", path]).decode("utf-8", "replace")
+    for line in out.splitlines():
+        parts = line.split()
+        if len(parts) >= 2 and parts[0].startswith(".") and parts[1].isdigit():
+            yield parts[0], int(parts[1])
+
+
+def module_name(build_dir, path):
+    rel = os.path.relpath(path, build_dir)
+    head = rel.split(os.sep)[0]
+    if head == "src":
+        return os.path.basename(path).split(".")[0]
+    return head
+
+
+def report(source, target, env):
+    build_dir = env.subst("$BUILD_DIR")
+    size_tool = env.subst("$SIZETOOL") or "xtensa-lx106-elf-size"
+    elf = str(target[0])
+
+    modules = {}
+    for root, _, files in os.walk(build_dir):
+        for name in files:
+            if not name.endswith(".o"):
+                continue
+            path = os.path.join(root, name)
+            usage = modules.setdefault(module_name(build_dir, path),
+                                       {"dram": 0, "iram": 0, "flash": 0})
+            for section, size in section_sizes(size_tool, path):
+                kind = classify(section)
+                if kind:
+                    usage[kind] += size
+
+    # 最终固件：.text 为 IRAM，.irom0.text 为 Flash
+    total = {"dram": 0, "iram": 0, "flash": 0}
+    for section, size in section_sizes(size_tool, elf):
+        if section in (".data", ".rodata", ".bss"):
+            total["dram"] += size
+        elif section in (".text", ".iram0.text"):
+            total["iram"] += size
+        elif section == ".irom0.text":
+            total["flash"] += size
+
+    rows = sorted(modules.items(), key=lambda kv: kv[1]["dram"], reverse=True)
+
+    print("")
+    print("========== 内存占用 (按模块，字节) ==========")
+    print("%-28s %8s %8s %8s" % ("模块", "DRAM", "IRAM", "Flash"))
+    for name, usage in rows:
+        if usage["dram"] or usage["iram"]:
+            print("%-28s %8d %8d %8d" % (name, usage["dram"], usage["iram"], usage["flash"]))
+    print("%-28s %8d %8d %8d" % ("固件合计", total["dram"], total["iram"], total["flash"]))
+
+    with open(os.path.join(build_dir, "memory_report.csv"), "w") as f:
+        f.write("module,dram,iram,flash\n")
+        for name, usage in rows:
+            f.write("%s,%d,%d,%d\n" % (name, usage["dram"], usage["iram"], usage["flash"]))
+        f.write("TOTAL,%d,%d,%d\n" % (total["dram"], total["iram"], total["flash"]))
+
+    budget = env.GetProjectOption("custom_dram_budget", "")
+    if budget:
+        budget = int(budget)
+        print("静态 DRAM: %d / %d 字节 (预算)" % (total["dram"], budget))
+        if total["dram"] > budget:
+            print("❌ 静态 DRAM 超出预算 %d 字节" % (total["dram"] - budget))
+            env.Exit(1)
+
+
+env.AddPostAction("$BUILD_DIR/${PROGNAME}.elf", report)
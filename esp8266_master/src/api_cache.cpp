@@ -0,0 +1,109 @@
+/*
+ * REST 响应缓存实现
+ */
+
+#include "api_cache.h"
+#include "trace.h"
+#include <ESP8266WebServer.h>
+
+// Web 服务器 (在 main.cpp 中定义)
+extern ESP8266WebServer server;
+
+// 缓存项
+typedef struct {
+    String body;
+    uint32_t version;       // 生成时的状态版本 (0=无效)
+} ApiCacheEntry_t;
+
+static ApiCacheEntry_t entries[API_CACHE_COUNT];
+
+static uint32_t state_version = 1;
+static uint32_t boot_tag = 0;
+
+// 统计
+static uint32_t stat_hits = 0;
+static uint32_t stat_builds = 0;
+static uint32_t stat_not_modified = 0;
+
+static const char* const collected_headers[] = { "If-None-Match", "Accept" };
+
+// ==================== 内部函数 ====================
+
+/**
+ * 生成 ETag (带引号)
+ * 同一 URL 的不同表示 (JSON/CBOR) 使用不同的标签
+ */
+static void format_etag(char* buf, size_t size, ApiCacheSlot_t slot) {
+    snprintf_P(buf, size, PSTR("\"%08lx-%lu.%u\""),
+               (unsigned long)boot_tag, (unsigned long)state_version, (unsigned)slot);
+}
+
+// ==================== 函数实现 ====================
+
+void api_cache_begin(void) {
+    boot_tag = ESP.random();
+    server.collectHeaders((const char**)collected_headers,
+                          sizeof(collected_headers) / sizeof(collected_headers[0]));
+}
+
+/**
+ * If-None-Match 是否包含指定 ETag
+ * 按带引号的完整标签查找，W/ 前缀和逗号分隔的列表都能匹配
+ */
+bool api_cache_if_none_match(const char* etag) {
+    if (!server.hasHeader("If-None-Match")) return false;
+    String inm = server.header("If-None-Match");
+    if (inm == "*") return true;
+    return strstr(inm.c_str(), etag) != NULL;
+}
+
+bool api_cache_accepts(const char* mime) {
+    if (!server.hasHeader("Accept")) return false;
+    return server.header("Accept").indexOf(mime) >= 0;
+}
+
+void api_cache_invalidate(void) {
+    state_version++;
+    if (state_version == 0) state_version = 1;
+}
+
+uint32_t api_cache_version(void) {
+    return state_version;
+}
+
+/**
+ * 发送缓存的响应
+ */
+void api_cache_send(ApiCacheSlot_t slot, const char* content_type, ApiCacheBuilder_t build) {
+    ApiCacheEntry_t* e = &entries[slot];
+    char tag[28];
+    format_etag(tag, sizeof(tag), slot);
+
+    server.sendHeader("ETag", tag);
+    server.sendHeader("Cache-Control", "no-cache");
+    server.sendHeader("Vary", "Accept");
+
+    if (api_cache_if_none_match(tag)) {
+        stat_not_modified++;
+        server.send(304);
+        return;
+    }
+
+    if (e->version != state_version) {
+        TRACE_SCOPE(TRACE_SPAN_API_BUILD);
+        e->body = "";
+        build(e->body);
+        e->version = state_version;
+        stat_builds++;
+    } else {
+        stat_hits++;
+    }
+
+    server.send(200, content_type, e->body);
+}
+
+void api_cache_print_stats(Print& out) {
+    out.printf_P(PSTR("API 缓存: 版本 %lu, 命中 %lu, 重建 %lu, 304 %lu\n"),
+                 (unsigned long)state_version, (unsigned long)stat_hits,
+                 (unsigned long)stat_builds, (unsigned long)stat_not_modified);
+}
@@ -0,0 +1,71 @@
+/*
+ * REST 响应缓存 (按状态版本)
+ *
+ * 控制状态每次变化时版本号加 1。/api/status、/api/towers 的响应体
+ * 按版本缓存，状态未变化时直接发送缓存内容，不重新拼接 JSON。
+ *
+ * 响应带 ETag: "<启动标识>-<版本号>.<缓存项>"，客户端携带 If-None-Match
+ * 轮询时，状态未变化返回 304 (无响应体)。启动标识每次上电随机生成，
+ * 重启后版本号从头计数也不会与旧 ETag 冲突。
+ */
+
+#ifndef API_CACHE_H
+#define API_CACHE_H
+
+#include <Arduino.h>
+
+// 缓存的响应
+typedef enum {
+    API_CACHE_STATUS = 0,       // /api/status
+    API_CACHE_TOWERS,           // /api/towers
+    API_CACHE_TOWERS_CBOR,      // /api/towers (Accept: application/cbor)
+    API_CACHE_COUNT
+} ApiCacheSlot_t;
+
+// 响应体生成函数 (追加到 body)
+typedef void (*ApiCacheBuilder_t)(String& body);
+
+// ==================== 函数声明 ====================
+
+/**
+ * 初始化 (在 server.begin() 之前调用，注册需要收集的请求头)
+ */
+void api_cache_begin(void);
+
+/**
+ * 请求的 Accept 头是否包含指定类型
+ * @param mime 例如 "application/cbor"
+ */
+bool api_cache_accepts(const char* mime);
+
+/**
+ * 请求的 If-None-Match 是否包含指定 ETag
+ * @param etag 带引号的 ETag
+ */
+bool api_cache_if_none_match(const char* etag);
+
+/**
+ * 状态已变化，使所有缓存失效
+ */
+void api_cache_invalidate(void);
+
+/**
+ * 当前状态版本号
+ */
+uint32_t api_cache_version(void);
+
+/**
+ * 发送缓存的响应 (在路由处理函数中调用)
+ * If-None-Match 命中返回 304，缓存过期时调用 build 重新生成
+ * @param slot 缓存项
+ * @param content_type 响应类型
+ * @param build 响应体生成函数
+ */
+void api_cache_send(ApiCacheSlot_t slot, const char* content_type, ApiCacheBuilder_t build);
+
+/**
+ * 输出缓存统计 (命中/重建/304 次数)
+ */
+void api_cache_print_stats(Print& out);
+
+#endif  // API_CACHE_H
@@ -0,0 +1,81 @@
+/*
+ * LoRa 帧捕获格式 - 与平台无关
+ *
+ * 固件 (frame_capture.cpp) 把收发的帧和影响控制决策的输入写入闪存环形区，
+ * 导出为 pcap 文件 (链路类型 LINKTYPE_USER0)；Linux 回放工具 (linux_host/replay)
+ * 读取同一格式，把输入重新送入控制核心 (master_core.cpp) 并核对继电器输出。
+ *
+ * 每个 pcap 包 = CapturePacketHeader_t + data[len]，多字节字段均为小端。
+ * 时间戳为主机 millis() (开机后的毫秒数)，每段捕获以 CAPTURE_SNAPSHOT 开头。
+ *
+ * 回放需要知道输入发生在哪一轮主循环：自动控制每轮执行一次，
+ * 同一轮内先处理网页命令，再处理 LoRa 帧，最后读井水传感器并执行自动控制。
+ */
+
+#ifndef CAPTURE_FORMAT_H
+#define CAPTURE_FORMAT_H
+
+#include <stdint.h>
+
+// ==================== pcap ====================
+#define CAPTURE_PCAP_MAGIC      0xA1B2C3D4UL
+#define CAPTURE_PCAP_VERSION_MAJOR  2
+#define CAPTURE_PCAP_VERSION_MINOR  4
+#define CAPTURE_PCAP_LINKTYPE   147     // LINKTYPE_USER0
+#define CAPTURE_PCAP_SNAPLEN    256
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version_major;
+    uint16_t version_minor;
+    int32_t thiszone;
+    uint32_t sigfigs;
+    uint32_t snaplen;
+    uint32_t network;
+} CapturePcapHeader_t;
+
+typedef struct {
+    uint32_t ts_sec;
+    uint32_t ts_usec;
+    uint32_t incl_len;
+    uint32_t orig_len;
+} CapturePcapPacket_t;
+
+// ==================== 记录 ====================
+#define CAPTURE_DATA_MAX        32      // 与 LoRa 接收缓冲区相同
+
+typedef enum {
+    CAPTURE_RX = 0,     // 收到的 LoRa 帧 (rssi/snr 有效)
+    CAPTURE_TX,         // 发出的 LoRa 帧
+    CAPTURE_SNAPSHOT,   // 捕获开始时的系统状态，后跟 tower_count 条 CAPTURE_TOWER
+                        //   [模式][井水正常][水塔数 LE16][继电器路数 LE16][MAX_TOWERS LE16][继电器位图...]
+    CAPTURE_TOWER,      // 快照中的水塔 (按索引顺序): [ID][水位][水泵][在线][最后更新 LE32]
+    CAPTURE_WELL,       // 井水传感器变化: [正常]
+    CAPTURE_MODE,       // 模式切换: [模式]
+    CAPTURE_PUMPS,      // 手动控制水泵: [开启位图][关闭位图] (各 len/2 字节)
+    CAPTURE_RELAY,      // 继电器输出变化 (控制决策): [位图]
+    CAPTURE_STOP,       // 捕获停止 (当前这一轮的后续处理未记录)
+    CAPTURE_TYPE_COUNT
+} CaptureType_t;
+
+#define CAPTURE_SNAPSHOT_FIXED  8       // 快照中继电器位图之前的字节数
+#define CAPTURE_TOWER_LEN       8
+
+// pcap 包的前缀
+typedef struct {
+    uint8_t type;               // CaptureType_t
+    uint8_t len;                // data 长度
+    int16_t rssi;               // dBm
+    int8_t snr;                 // 0.25 dB
+    uint8_t reserved[3];
+    uint32_t loop;              // 主循环序号 (开机后从 1 开始，快照在 setup() 中时为 0)
+} CapturePacketHeader_t;
+
+// 闪存中的记录 (定长，便于按扇区寻址)
+typedef struct {
+    uint32_t ts_ms;
+    CapturePacketHeader_t h;
+    uint8_t data[CAPTURE_DATA_MAX];
+} CaptureRecord_t;
+
+#endif  // CAPTURE_FORMAT_H
@@ -0,0 +1,106 @@
+/*
+ * CBOR 编码器实现
+ */
+
+#include "cbor.h"
+
+// 主类型 (高 3 位)
+#define CBOR_MAJOR_UINT     0x00
+#define CBOR_MAJOR_TEXT     0x60
+#define CBOR_MAJOR_ARRAY    0x80
+
+// 简单值
+#define CBOR_FALSE          0xF4
+#define CBOR_TRUE           0xF5
+#define CBOR_NULL           0xF6
+
+// ==================== 内部函数 ====================
+
+/**
+ * 预留 n 字节
+ * @return 写入位置，空间不足返回 NULL
+ */
+static uint8_t* reserve(CborWriter_t* w, size_t n) {
+    if (w->overflow || w->size - w->len < n) {
+        w->overflow = true;
+        return NULL;
+    }
+    uint8_t* p = w->buf + w->len;
+    w->len += n;
+    return p;
+}
+
+/**
+ * 写入类型头 (主类型 + 长度/数值，按最短形式)
+ */
+static void write_head(CborWriter_t* w, uint8_t major, uint32_t value) {
+    uint8_t* p;
+
+    if (value < 24) {
+        p = reserve(w, 1);
+        if (p) p[0] = major | (uint8_t)value;
+    } else if (value <= 0xFF) {
+        p = reserve(w, 2);
+        if (p) {
+            p[0] = major | 24;
+            p[1] = (uint8_t)value;
+        }
+    } else if (value <= 0xFFFF) {
+        p = reserve(w, 3);
+        if (p) {
+            p[0] = major | 25;
+            p[1] = (uint8_t)(value >> 8);
+            p[2] = (uint8_t)value;
+        }
+    } else {
+        p = reserve(w, 5);
+        if (p) {
+            p[0] = major | 26;
+            p[1] = (uint8_t)(value >> 24);
+            p[2] = (uint8_t)(value >> 16);
+            p[3] = (uint8_t)(value >> 8);
+            p[4] = (uint8_t)value;
+        }
+    }
+}
+
+// ==================== 函数实现 ====================
+
+void cbor_init(CborWriter_t* w, uint8_t* buf, size_t size) {
+    w->buf = buf;
+    w->size = size;
+    w->len = 0;
+    w->overflow = false;
+}
+
+void cbor_uint(CborWriter_t* w, uint32_t value) {
+    write_head(w, CBOR_MAJOR_UINT, value);
+}
+
+void cbor_bool(CborWriter_t* w, bool value) {
+    uint8_t* p = reserve(w, 1);
+    if (p) p[0] = value ? CBOR_TRUE : CBOR_FALSE;
+}
+
+void cbor_null(CborWriter_t* w) {
+    uint8_t* p = reserve(w, 1);
+    if (p) p[0] = CBOR_NULL;
+}
+
+void cbor_text(CborWriter_t* w, const char* str) {
+    size_t n = strlen(str);
+    write_head(w, CBOR_MAJOR_TEXT, n);
+    uint8_t* p = reserve(w, n);
+    if (p) memcpy(p, str, n);
+}
+
+void cbor_text_P(CborWriter_t* w, PGM_P str) {
+    size_t n = strlen_P(str);
+    write_head(w, CBOR_MAJOR_TEXT, n);
+    uint8_t* p = reserve(w, n);
+    if (p) memcpy_P(p, str, n);
+}
+
+void cbor_array(CborWriter_t* w, uint32_t count) {
+    write_head(w, CBOR_MAJOR_ARRAY, count);
+}
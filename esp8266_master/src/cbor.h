@@ -0,0 +1,74 @@
+/*
+ * CBOR 编码器 (RFC 8949，仅编码)
+ *
+ * 写入调用方提供的固定缓冲区，不分配内存。
+ * 缓冲区不足时置 overflow 标志，之后的写入全部忽略，
+ * 调用方编码结束后检查一次即可。
+ *
+ * 只实现本项目用到的类型：无符号整数、布尔、null、文本串、定长数组。
+ * 数据结构说明见 docs/CBOR_SCHEMA.md。
+ */
+
+#ifndef CBOR_H
+#define CBOR_H
+
+#include <Arduino.h>
+
+// 编码器状态
+typedef struct {
+    uint8_t* buf;           // 输出缓冲区
+    size_t size;            // 缓冲区大小
+    size_t len;             // 已写入字节数
+    bool overflow;          // 缓冲区不足
+} CborWriter_t;
+
+// ==================== 函数声明 ====================
+
+/**
+ * 初始化编码器
+ * @param w 编码器
+ * @param buf 输出缓冲区
+ * @param size 缓冲区大小
+ */
+void cbor_init(CborWriter_t* w, uint8_t* buf, size_t size);
+
+/**
+ * 无符号整数 (主类型 0)
+ */
+void cbor_uint(CborWriter_t* w, uint32_t value);
+
+/**
+ * 布尔值 (简单值 20/21)
+ */
+void cbor_bool(CborWriter_t* w, bool value);
+
+/**
+ * null (简单值 22)
+ */
+void cbor_null(CborWriter_t* w);
+
+/**
+ * 文本串 (主类型 3)
+ * @param str UTF-8 字符串
+ */
+void cbor_text(CborWriter_t* w, const char* str);
+
+/**
+ * 文本串，内容在闪存中
+ * @param str PROGMEM 字符串指针
+ */
+void cbor_text_P(CborWriter_t* w, PGM_P str);
+
+/**
+ * 定长数组头 (主类型 4)，之后写入 count 个元素
+ */
+void cbor_array(CborWriter_t* w, uint32_t count);
+
+/**
+ * 编码结果是否完整
+ */
+static inline bool cbor_ok(const CborWriter_t* w) {
+    return !w->overflow;
+}
+
+#endif  // CBOR_H
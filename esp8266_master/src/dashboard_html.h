@@ -0,0 +1,148 @@
+/*
+ * 网页控制台 (gzip 压缩，由 scripts/embed_dashboard.py 生成，请勿手工修改)
+ * 源文件: web/index.html (4275 字节，压缩后 2088 字节)
+ */
+
+#ifndef DASHBOARD_HTML_H
+#define DASHBOARD_HTML_H
+
+#include <Arduino.h>
+
+#define DASHBOARD_HTML_GZ_LEN  2088
+#define DASHBOARD_ETAG         "\"05e4dd01f449c418\""
+
+static const uint8_t dashboard_html_gz[DASHBOARD_HTML_GZ_LEN] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0xff, 0x8d, 0x58, 0x5f, 0x6f, 0x1b, 0xc7,
+    0x11, 0x7f, 0xe7, 0xa7, 0x38, 0xd3, 0x49, 0x97, 0x84, 0xc8, 0xe3, 0x1f, 0x8b, 0xb2, 0x7b, 0xc7,
+    0xa3, 0xe0, 0x38, 0x02, 0x92, 0xc2, 0x91, 0x0c, 0x58, 0x7e, 0x28, 0x04, 0xa1, 0x58, 0xde, 0xed,
+    0x91, 0x6b, 0x1f, 0xef, 0x0e, 0xb7, 0x4b, 0x52, 0x0a, 0x4b, 0xa0, 0x29, 0x0a, 0xb8, 0x49, 0x9c,
+    0xa8, 0x05, 0x6a, 0x24, 0x68, 0x83, 0xa0, 0x76, 0x9a, 0x36, 0x28, 0xea, 0x38, 0x40, 0xdd, 0x42,
+    0x50, 0xdc, 0xf8, 0xbb, 0x14, 0x22, 0x25, 0x3f, 0xf5, 0x2b, 0x74, 0x66, 0xf7, 0x48, 0x1d, 0x29,
+    0x39, 0xc9, 0x0b, 0xc9, 0x9d, 0xdd, 0x99, 0x9d, 0xf9, 0xcd, 0x6f, 0x66, 0x56, 0x6a, 0x5e, 0x7a,
+    0x73, 0xeb, 0xc6, 0xf6, 0xcf, 0x6f, 0x6d, 0x18, 0x5d, 0xd9, 0x0b, 0x5a, 0xb9, 0x26, 0x7e, 0x19,
+    0x01, 0x0d, 0x3b, 0x4e, 0xfe, 0xdd, 0x6e, 0xf9, 0xc6, 0x66, 0x1e, 0x65, 0x8c, 0x7a, 0xf0, 0xd5,
+    0x63, 0x92, 0x1a, 0x6e, 0x97, 0x26, 0x82, 0x49, 0x27, 0xdf, 0x97, 0x7e, 0xf9, 0x5a, 0x7e, 0x26,
+    0x0e, 0x69, 0x8f, 0x39, 0xf9, 0x01, 0x67, 0xc3, 0x38, 0x4a, 0x64, 0xde, 0x70, 0xa3, 0x50, 0xb2,
+    0x10, 0x8e, 0x0d, 0xb9, 0x27, 0xbb, 0x8e, 0xc7, 0x06, 0xdc, 0x65, 0x65, 0xb5, 0x28, 0xf1, 0x90,
+    0x4b, 0x4e, 0x83, 0xb2, 0x70, 0x69, 0xc0, 0x9c, 0x1a, 0xda, 0x90, 0x5c, 0x06, 0xac, 0x35, 0xfd,
+    0xe6, 0xd9, 0xe4, 0xd1, 0x1f, 0x4e, 0xfe, 0xf4, 0xfb, 0xe9, 0xc7, 0x7f, 0x6b, 0x56, 0xb4, 0x2c,
+    0xd7, 0x14, 0x72, 0x1f, 0xbf, 0xdb, 0x91, 0xb7, 0x3f, 0xea, 0xd1, 0xa4, 0xc3, 0x43, 0xab, 0x6a,
+    0xfb, 0x60, 0xdf, 0xaa, 0x35, 0xe2, 0xbd, 0x4a, 0xcd, 0x5c, 0x35, 0xc4, 0xbe, 0x90, 0xac, 0x57,
+    0xee, 0xf3, 0x92, 0xa0, 0xa1, 0x28, 0x0b, 0x96, 0x70, 0xdf, 0x6e, 0x53, 0xf7, 0x5e, 0x27, 0x89,
+    0xfa, 0xa1, 0x67, 0x5d, 0xf6, 0xeb, 0xfe, 0xaa, 0x7f, 0xd5, 0x76, 0xa3, 0x20, 0x4a, 0xac, 0xcb,
+    0xf5, 0x7a, 0x7d, 0x9c, 0xc3, 0xa0, 0x58, 0x32, 0xca, 0x9e, 0xaa, 0x35, 0xd6, 0x1a, 0x6e, 0x75,
+    0x76, 0xca, 0xf7, 0x7d, 0x3b, 0xa6, 0x9e, 0xc7, 0xc3, 0x8e, 0x55, 0xab, 0xc6, 0x7b, 0x46, 0x6d,
+    0x2d, 0xde, 0xb3, 0x3d, 0x2e, 0xe2, 0x80, 0xee, 0x5b, 0x7e, 0xc0, 0xf6, 0xec, 0xbb, 0x7d, 0x21,
+    0xb9, 0xbf, 0x5f, 0x4e, 0xa3, 0xb5, 0x44, 0x4c, 0x21, 0xca, 0x36, 0x93, 0x43, 0xc6, 0x42, 0x9b,
+    0x06, 0xbc, 0x13, 0x96, 0x39, 0x78, 0x26, 0x2c, 0x17, 0xb6, 0x59, 0x32, 0xbb, 0xd5, 0xe8, 0xd6,
+    0x46, 0x18, 0x41, 0x59, 0xf0, 0x77, 0x99, 0x55, 0xbb, 0x06, 0x76, 0x67, 0x91, 0x8d, 0x73, 0x3d,
+    0xca, 0x43, 0x08, 0x74, 0x4f, 0xa3, 0x65, 0x5d, 0xad, 0x57, 0x33, 0xdb, 0x06, 0xed, 0xcb, 0xe8,
+    0xcc, 0xad, 0x7a, 0xbc, 0x37, 0xce, 0x99, 0x6d, 0x9a, 0x8c, 0x16, 0xfc, 0xea, 0xd0, 0xd8, 0x42,
+    0xa3, 0xb8, 0x28, 0x0f, 0x13, 0x58, 0xe1, 0x47, 0x6a, 0xa4, 0xdc, 0x8e, 0xa4, 0x8c, 0x7a, 0x33,
+    0x65, 0x49, 0x3b, 0x0b, 0x20, 0x60, 0xd8, 0xed, 0x28, 0x01, 0x2f, 0xcb, 0x09, 0xf5, 0x78, 0x5f,
+    0x58, 0xab, 0x60, 0x69, 0x76, 0xe3, 0x2a, 0xe2, 0x50, 0x4d, 0x6f, 0xf5, 0x96, 0x14, 0x59, 0x9b,
+    0xb1, 0x19, 0x7a, 0xee, 0x5a, 0xfd, 0x5a, 0xfd, 0x1a, 0x1c, 0xeb, 0x24, 0xdc, 0x9b, 0x7b, 0x87,
+    0x0b, 0x1b, 0x3f, 0xca, 0x80, 0x0a, 0x48, 0x24, 0x03, 0xec, 0x82, 0x7e, 0x2f, 0x14, 0x56, 0xc2,
+    0x62, 0x46, 0x65, 0x01, 0xe3, 0x2b, 0xfb, 0x3c, 0x08, 0x4a, 0x3d, 0x1e, 0x02, 0x0a, 0x85, 0x5a,
+    0x03, 0xae, 0x2b, 0xd5, 0xfc, 0xa4, 0x58, 0x54, 0x71, 0xa5, 0xb7, 0xbb, 0x34, 0xf1, 0x7e, 0xc0,
+    0xef, 0xb5, 0x8c, 0xdf, 0xa8, 0x05, 0xdb, 0x7b, 0x65, 0xd1, 0xa5, 0x5e, 0x34, 0x04, 0x20, 0x6b,
+    0x10, 0x09, 0x20, 0x60, 0x5c, 0xae, 0x56, 0xab, 0xf5, 0xd4, 0xa0, 0x19, 0xf9, 0xfe, 0x28, 0x82,
+    0x24, 0x72, 0xb9, 0x6f, 0x99, 0x0d, 0x85, 0x4e, 0x78, 0x6f, 0xd4, 0x65, 0xbc, 0xd3, 0x95, 0xd6,
+    0x4f, 0x95, 0x8d, 0xcc, 0x95, 0xec, 0x0a, 0xf0, 0xca, 0xbb, 0x08, 0xad, 0x48, 0x00, 0xc5, 0xa3,
+    0x10, 0x82, 0x82, 0x18, 0xf9, 0x80, 0xd9, 0xd1, 0x80, 0x25, 0x7e, 0x00, 0x17, 0x77, 0xb9, 0xe7,
+    0x01, 0x37, 0xd2, 0x7c, 0x82, 0x8b, 0x46, 0x35, 0xbd, 0xc6, 0xe0, 0xa3, 0xb9, 0x1e, 0x6d, 0x0b,
+    0x80, 0x45, 0x32, 0x3b, 0xcd, 0x55, 0xd5, 0x0e, 0x98, 0x2f, 0xe1, 0x2b, 0x51, 0x9e, 0x54, 0x17,
+    0xdc, 0x58, 0xad, 0xd3, 0x86, 0xdf, 0xb0, 0x65, 0x02, 0xdc, 0xd7, 0xea, 0xda, 0x61, 0xc3, 0x6c,
+    0x88, 0x99, 0xed, 0xf6, 0x05, 0xb6, 0x35, 0xbf, 0x6a, 0xd5, 0xea, 0xeb, 0xb6, 0x64, 0x7b, 0xb2,
+    0xac, 0xf8, 0x9a, 0x32, 0xd5, 0x96, 0x51, 0x6c, 0x5d, 0x59, 0x45, 0xa8, 0xdb, 0x7d, 0x70, 0x21,
+    0x1c, 0xe9, 0x28, 0xf1, 0xea, 0x57, 0x92, 0x63, 0x2d, 0x25, 0x87, 0xfd, 0xfd, 0x45, 0xe5, 0xf6,
+    0x13, 0x01, 0xbf, 0xe3, 0x88, 0xeb, 0x9a, 0xd0, 0x17, 0x98, 0x78, 0x47, 0x46, 0xaf, 0xce, 0xae,
+    0x7a, 0x57, 0x20, 0x31, 0x92, 0xb6, 0x03, 0x36, 0xca, 0xf8, 0x9a, 0xde, 0x0f, 0x06, 0x03, 0x1a,
+    0x0b, 0x66, 0xcd, 0x7e, 0xd8, 0xcb, 0x6c, 0x48, 0xe9, 0x8e, 0x91, 0x20, 0xd7, 0xed, 0x4c, 0xc5,
+    0x5d, 0xc1, 0xc0, 0xa4, 0x57, 0x92, 0xdd, 0x51, 0x96, 0xd9, 0x6b, 0x8a, 0x24, 0xca, 0xfc, 0xac,
+    0x48, 0x40, 0x0a, 0x70, 0x71, 0xcf, 0xb8, 0xcc, 0x80, 0xdc, 0x19, 0x9c, 0x30, 0x21, 0xe3, 0x5c,
+    0xb3, 0x92, 0xb6, 0xa7, 0x66, 0x25, 0xed, 0x92, 0xd8, 0xa7, 0xd2, 0x9e, 0xc9, 0x92, 0x56, 0xb3,
+    0x5b, 0x5b, 0x6a, 0x6b, 0x20, 0x68, 0x42, 0x9f, 0x08, 0x0d, 0xee, 0x39, 0xf9, 0x80, 0x87, 0xf7,
+    0xf2, 0xad, 0xd3, 0x17, 0x9f, 0x4f, 0x3f, 0xfe, 0xf2, 0xf8, 0xf0, 0xc9, 0x7f, 0x7f, 0xf5, 0x57,
+    0x30, 0x08, 0x9b, 0x2d, 0x6d, 0x0e, 0x0c, 0x40, 0x7f, 0x85, 0x7e, 0x00, 0x5f, 0x1e, 0x1f, 0x18,
+    0x6e, 0x40, 0x85, 0x70, 0xf2, 0x50, 0xef, 0xd8, 0x34, 0x95, 0x95, 0x54, 0x04, 0x55, 0x9c, 0x57,
+    0x16, 0x7b, 0x91, 0xc7, 0xf2, 0xad, 0xd4, 0xca, 0x2b, 0xce, 0x0c, 0x59, 0x10, 0x64, 0xce, 0x68,
+    0xfc, 0xd5, 0x8e, 0x8c, 0x3a, 0x9d, 0x00, 0xf4, 0x27, 0xbf, 0xbd, 0x3f, 0xfd, 0xe8, 0xf1, 0xf4,
+    0xab, 0x47, 0x93, 0xe7, 0x07, 0xcd, 0x8a, 0x3e, 0x80, 0x31, 0x82, 0x13, 0x8b, 0xae, 0x60, 0x2d,
+    0xe7, 0x53, 0xd5, 0x21, 0x4b, 0x04, 0x9a, 0xd5, 0x87, 0x54, 0xde, 0x5a, 0x4d, 0xa9, 0x60, 0x69,
+    0xca, 0x04, 0x7f, 0xb6, 0xa6, 0x9f, 0xfc, 0xfb, 0xe5, 0x27, 0xcf, 0xa0, 0xb7, 0x77, 0xd5, 0xf2,
+    0xf8, 0xdb, 0x2f, 0x4e, 0xfe, 0xfc, 0xde, 0x7c, 0x39, 0x3d, 0x38, 0x38, 0x7d, 0xf1, 0xcd, 0xd9,
+    0x52, 0xe1, 0x76, 0xb6, 0xfc, 0xc7, 0xa3, 0xe9, 0xc3, 0x74, 0xb7, 0x82, 0xf6, 0x2a, 0x33, 0xdb,
+    0x08, 0xb9, 0xf2, 0x81, 0x25, 0x49, 0xa4, 0x7d, 0x50, 0x32, 0xfc, 0x56, 0x5e, 0x80, 0xe7, 0x29,
+    0x8a, 0xc2, 0x4d, 0x78, 0x2c, 0x5b, 0xb9, 0x01, 0x4d, 0x0c, 0xed, 0xb1, 0x33, 0x1a, 0x97, 0x54,
+    0xca, 0x9d, 0x9d, 0xdd, 0x12, 0x0c, 0x12, 0x5c, 0xbf, 0xe6, 0xf8, 0xfd, 0xd0, 0xc5, 0x6a, 0x29,
+    0x70, 0xaf, 0x38, 0x4a, 0x98, 0xec, 0x27, 0xa1, 0xe1, 0x45, 0x6e, 0xbf, 0x07, 0xd5, 0x61, 0x76,
+    0x98, 0xdc, 0x08, 0x18, 0xfe, 0x7c, 0x63, 0xff, 0x6d, 0x0f, 0x8f, 0x8c, 0xed, 0xdc, 0x4c, 0xc3,
+    0x80, 0x42, 0x93, 0x85, 0x7e, 0x12, 0x94, 0xd0, 0x85, 0xb9, 0xb2, 0xcf, 0xa4, 0xdb, 0x55, 0xe2,
+    0x11, 0x0c, 0xcc, 0x6e, 0xe4, 0x59, 0xe4, 0xd6, 0xd6, 0xed, 0x6d, 0x52, 0xd2, 0x79, 0x16, 0xd6,
+    0x88, 0xdc, 0xd0, 0x53, 0xa4, 0xbc, 0xbd, 0x1f, 0x33, 0x62, 0x11, 0x1a, 0xc7, 0x01, 0x77, 0x29,
+    0xda, 0xac, 0x40, 0x17, 0x1f, 0x0e, 0xcb, 0x7e, 0x94, 0xc0, 0x90, 0x4b, 0x02, 0x16, 0xba, 0x90,
+    0x65, 0x8f, 0x8c, 0xd5, 0x15, 0x16, 0x7e, 0x8c, 0x8b, 0xe3, 0x33, 0x0f, 0x12, 0x16, 0x82, 0xc9,
+    0xdb, 0x92, 0xca, 0xbe, 0x28, 0x14, 0x47, 0x39, 0xc3, 0x78, 0xad, 0x40, 0x90, 0x18, 0xa4, 0x68,
+    0x22, 0x83, 0xd3, 0x8b, 0x1c, 0x88, 0xd6, 0x44, 0xb1, 0xe3, 0x38, 0xe4, 0xfa, 0x9d, 0xed, 0x2d,
+    0xb2, 0x4e, 0x4e, 0xef, 0xff, 0x7d, 0xf2, 0xc1, 0x57, 0x3a, 0xf1, 0xe0, 0xc3, 0xf4, 0xfd, 0x0f,
+    0xcf, 0x96, 0x36, 0x18, 0x42, 0xdc, 0x86, 0x0e, 0x98, 0x43, 0x0e, 0x91, 0xa2, 0x3d, 0x3c, 0x67,
+    0x10, 0x37, 0x7e, 0x31, 0x84, 0xce, 0x9e, 0xac, 0x93, 0xe3, 0xa3, 0x87, 0x90, 0xc4, 0xe9, 0x93,
+    0x2f, 0x26, 0x87, 0x87, 0x60, 0x4d, 0x2f, 0x4f, 0x9e, 0x1f, 0xc1, 0x27, 0x01, 0x55, 0xc5, 0xa1,
+    0x4d, 0x7c, 0x39, 0x10, 0xe0, 0x26, 0x59, 0x29, 0x2c, 0xeb, 0x83, 0x8e, 0x01, 0x63, 0x06, 0xee,
+    0xc9, 0x9d, 0x0b, 0x6f, 0x5b, 0x65, 0x4f, 0x87, 0x57, 0xa9, 0x18, 0xd3, 0x07, 0xef, 0x1f, 0x1f,
+    0x7e, 0x3b, 0xfd, 0xec, 0xe8, 0xf8, 0xf0, 0x83, 0x93, 0x3f, 0xfe, 0xe6, 0xe5, 0xa3, 0xa3, 0xc9,
+    0xd1, 0xc1, 0xf4, 0xd3, 0xef, 0x4e, 0xfe, 0x72, 0xf4, 0xbf, 0xe7, 0x0f, 0x2a, 0x34, 0xe6, 0x95,
+    0xb8, 0xdf, 0x8b, 0x0d, 0xd8, 0x03, 0xaa, 0x18, 0x93, 0x83, 0x5f, 0x03, 0x99, 0xa6, 0x9f, 0x3e,
+    0x3d, 0x7d, 0xfa, 0xa5, 0x3e, 0x7b, 0x7c, 0xf8, 0x21, 0xec, 0x9d, 0x3c, 0x7b, 0x3c, 0x79, 0xfe,
+    0x30, 0x0d, 0x14, 0xdf, 0x42, 0x0e, 0x51, 0x71, 0x2b, 0x86, 0x98, 0x90, 0x80, 0x0d, 0x0a, 0x69,
+    0xcc, 0xb0, 0xa3, 0xc4, 0xbd, 0x3d, 0xe5, 0x83, 0x56, 0x91, 0x8e, 0x66, 0xd5, 0x0e, 0xf7, 0x76,
+    0x6d, 0x25, 0x45, 0x23, 0x2b, 0x0e, 0xc9, 0x16, 0x0d, 0x8e, 0x1a, 0x88, 0x56, 0x42, 0xcb, 0x83,
+    0x06, 0x80, 0xf0, 0xfb, 0x34, 0x10, 0x6c, 0x9d, 0x18, 0x30, 0x7f, 0x20, 0x66, 0x52, 0x5c, 0x21,
+    0x40, 0x62, 0xac, 0x23, 0x5d, 0x03, 0x06, 0x59, 0x91, 0x26, 0xf7, 0x56, 0x88, 0x2e, 0x2e, 0xb2,
+    0xa2, 0x2c, 0x1b, 0xc6, 0x82, 0x55, 0xec, 0xf3, 0xa0, 0xc5, 0x0d, 0xd5, 0x91, 0x9c, 0x7c, 0x3a,
+    0xb5, 0x50, 0x35, 0x60, 0x03, 0x16, 0xac, 0x90, 0xd7, 0xb1, 0x32, 0x78, 0xab, 0xd9, 0x6e, 0x65,
+    0x85, 0x50, 0xdf, 0xad, 0x73, 0x76, 0xd3, 0x9e, 0x90, 0x9a, 0x56, 0xce, 0x22, 0x7c, 0xeb, 0x24,
+    0x0a, 0x67, 0x0e, 0x1a, 0x1e, 0x95, 0xb4, 0xcc, 0x71, 0x17, 0x30, 0x98, 0x0b, 0xa2, 0x30, 0x7b,
+    0xbe, 0x6a, 0xd5, 0x54, 0x30, 0x19, 0x0b, 0xc8, 0x88, 0x7f, 0xfe, 0xeb, 0xf4, 0xc5, 0xef, 0x4e,
+    0x1f, 0x3d, 0x40, 0x8a, 0xa9, 0xe5, 0xe4, 0xbd, 0xcf, 0xa6, 0x4f, 0x1e, 0xa3, 0xdd, 0x79, 0xbb,
+    0x49, 0x7d, 0x42, 0x14, 0xc7, 0x45, 0x5b, 0x93, 0x58, 0x83, 0x0b, 0x34, 0xe6, 0x61, 0xc8, 0x92,
+    0xb7, 0xb6, 0xdf, 0xb9, 0xe9, 0x20, 0xbe, 0x0b, 0xf4, 0x08, 0x22, 0xea, 0x6d, 0xa8, 0x46, 0xa0,
+    0xc9, 0xa1, 0x2b, 0x8f, 0x28, 0x0a, 0xe8, 0x06, 0x81, 0x65, 0xd0, 0x65, 0xe1, 0x59, 0x1a, 0x93,
+    0x79, 0x99, 0x26, 0xe6, 0x5d, 0x01, 0x82, 0xe2, 0x78, 0xf9, 0x48, 0xc0, 0x85, 0x4c, 0xf3, 0x0c,
+    0x7e, 0xcc, 0xed, 0x9c, 0xf9, 0x81, 0x07, 0xcc, 0x1e, 0x8d, 0xcf, 0x54, 0x58, 0x7a, 0xde, 0x30,
+    0x52, 0xe3, 0x44, 0xb7, 0x41, 0x0f, 0xd1, 0x60, 0xa6, 0xe4, 0x3d, 0x56, 0x81, 0x89, 0x56, 0xfd,
+    0x65, 0x15, 0xc2, 0x16, 0xd0, 0xab, 0xbc, 0x74, 0x93, 0x99, 0x58, 0xdf, 0x08, 0x45, 0x46, 0xd4,
+    0x63, 0x42, 0xd0, 0xce, 0xa2, 0x14, 0xad, 0x20, 0x22, 0xc0, 0xa0, 0x7a, 0xa3, 0xb1, 0x4e, 0xca,
+    0xc4, 0x4a, 0x25, 0xc5, 0x25, 0x6d, 0x17, 0xc6, 0xa2, 0x9c, 0xc9, 0xb0, 0x7b, 0x12, 0xcd, 0x4e,
+    0x88, 0xf3, 0x2e, 0xcc, 0xe1, 0x02, 0x21, 0xc5, 0x19, 0xd0, 0xe3, 0x6c, 0x2b, 0x0b, 0x02, 0x0d,
+    0xe2, 0xad, 0x24, 0xea, 0x71, 0xc1, 0x4c, 0x0a, 0x82, 0x9d, 0x2c, 0xa2, 0x42, 0x75, 0x99, 0x1f,
+    0x85, 0x68, 0x29, 0xab, 0x37, 0xcf, 0xe4, 0x0f, 0xeb, 0xed, 0x2e, 0x1f, 0x1a, 0xa4, 0xc0, 0x62,
+    0xb7, 0x1e, 0xec, 0x54, 0x77, 0xed, 0x79, 0x27, 0xb7, 0x67, 0x9d, 0xdc, 0x1e, 0xec, 0xd4, 0x76,
+    0xcf, 0xd7, 0x2b, 0xa4, 0x30, 0xad, 0x4f, 0xac, 0xa7, 0x5d, 0x47, 0x6a, 0x05, 0x60, 0xa6, 0xe8,
+    0x16, 0x50, 0x04, 0xd7, 0xd9, 0x8b, 0xed, 0xd3, 0x5e, 0x6c, 0x37, 0x17, 0xa0, 0x04, 0xaf, 0xff,
+    0x90, 0xb9, 0x52, 0x03, 0xc5, 0xfd, 0xc2, 0xa5, 0x21, 0x0f, 0xe1, 0x8d, 0x69, 0x6e, 0x0c, 0xa0,
+    0x27, 0xde, 0x8e, 0xfa, 0x89, 0x0b, 0x4c, 0x00, 0xd2, 0xe0, 0xb0, 0x5f, 0xea, 0xc0, 0xe4, 0xf4,
+    0x3f, 0x5f, 0x9f, 0x3e, 0x7d, 0x4c, 0x6c, 0x8d, 0xb4, 0x0d, 0x7f, 0x59, 0xbd, 0x8d, 0x8f, 0xa2,
+    0x01, 0x0d, 0x0a, 0x28, 0x2a, 0x35, 0x80, 0x1f, 0xe8, 0x02, 0x42, 0x32, 0x4e, 0xdb, 0x12, 0x13,
+    0x4e, 0xc8, 0x86, 0x46, 0xc6, 0xfc, 0x8c, 0xdd, 0x28, 0x11, 0x3a, 0x93, 0x4c, 0x98, 0xf0, 0xb0,
+    0x51, 0x67, 0x6e, 0x02, 0x33, 0x19, 0xd0, 0xb4, 0x40, 0x12, 0x26, 0xf6, 0x43, 0x97, 0x94, 0xe6,
+    0x78, 0xcc, 0xe0, 0xc8, 0x42, 0x37, 0x7e, 0xb5, 0x7e, 0x9a, 0xec, 0x52, 0x96, 0xe2, 0x98, 0x84,
+    0x9f, 0xdd, 0xde, 0xda, 0x34, 0x63, 0xfc, 0xc3, 0x10, 0x18, 0x89, 0x5d, 0xe0, 0x1c, 0x88, 0xd9,
+    0xa2, 0xfc, 0x9e, 0x0b, 0x94, 0x37, 0x8b, 0xf6, 0x75, 0x57, 0xbd, 0xe0, 0x06, 0x44, 0x5a, 0xe5,
+    0xcc, 0xe0, 0x61, 0x3a, 0xcb, 0x8b, 0xc5, 0xe5, 0x74, 0xda, 0x4b, 0xe9, 0x5e, 0x4c, 0xe6, 0xdc,
+    0x93, 0x28, 0x8c, 0x62, 0x16, 0x3a, 0x19, 0x5c, 0x5e, 0x91, 0xaf, 0xc9, 0xd7, 0x9f, 0xc3, 0x1b,
+    0x86, 0x8c, 0xe7, 0x7a, 0xaa, 0x13, 0xfc, 0x08, 0xc5, 0x97, 0xf7, 0x3f, 0x82, 0x67, 0x9e, 0x7e,
+    0xe3, 0xa1, 0xfa, 0x38, 0x97, 0x6d, 0x67, 0x51, 0xe8, 0xc2, 0xac, 0xbf, 0xe7, 0x2c, 0xf5, 0x0e,
+    0x8c, 0xbd, 0xed, 0x40, 0x49, 0xc3, 0x4b, 0x96, 0x49, 0x8c, 0xb8, 0x8d, 0x7f, 0xaf, 0xe1, 0xc8,
+    0xbc, 0x04, 0x33, 0xfb, 0x8d, 0x3b, 0xdb, 0xdb, 0x5b, 0x9b, 0xa4, 0xa8, 0xe9, 0x81, 0x2e, 0xa9,
+    0xb7, 0x07, 0x99, 0x4f, 0x3b, 0x52, 0x22, 0xf0, 0x2c, 0x22, 0x2b, 0x6d, 0x05, 0x19, 0x90, 0xcb,
+    0xe4, 0x2b, 0xe4, 0x27, 0x54, 0x5d, 0x01, 0xe2, 0xc2, 0x99, 0x1c, 0xd6, 0x60, 0xb0, 0x46, 0xd2,
+    0x06, 0x8f, 0x73, 0xa8, 0x88, 0x2c, 0xb7, 0xb5, 0x9b, 0xf8, 0x2a, 0xbc, 0xc8, 0xcd, 0xe2, 0x28,
+    0x73, 0xa3, 0x7a, 0x61, 0x94, 0xd4, 0x43, 0xc3, 0x49, 0x87, 0xf9, 0xd2, 0xeb, 0xe2, 0x9d, 0xeb,
+    0x9b, 0x77, 0xae, 0xdf, 0x04, 0xfb, 0x6a, 0x5d, 0xc4, 0x67, 0xd3, 0xbc, 0x78, 0x16, 0x28, 0x62,
+    0xe3, 0xc3, 0x3a, 0x7d, 0xaa, 0xc1, 0x40, 0xd0, 0x4f, 0xea, 0x8a, 0xfe, 0x17, 0xc5, 0xff, 0x01,
+    0xe9, 0x6b, 0x47, 0x65, 0xb3, 0x10, 0x00, 0x00,
+};
+
+#endif  // DASHBOARD_HTML_H
@@ -3,6 +3,10 @@
  */
 
 #include "error_codes.h"
+#include "trace.h"
+#include "pgm_util.h"
+#include "logger.h"
+#include "cbor.h"
 #include <Wire.h>
 #include <Adafruit_SSD1306.h>
 #include <ESP8266WiFi.h>
@@ -15,60 +19,37 @@ Error_t g_error_log[MAX_ERROR_LOG];
 uint8_t g_error_count = 0;
 uint16_t g_current_error = ERR_SYS_OK;
 
-// 错误描述表
+// 空日志槽位的描述
+static const char msg_none[] PROGMEM = "None";
+
+// 每个错误码的统计 (最后一项用于表外未知错误码)
+#define ERROR_STAT_COUNT    (ERR_CATEGORY_COUNT * ERR_CATEGORY_SLOTS + 1)
+#define ERROR_STAT_UNKNOWN  (ERROR_STAT_COUNT - 1)
+#define ERROR_LOG_NONE      0xFF
+
 typedef struct {
-    uint16_t code;
-    const char* message;
-    ErrorLevel_t level;
-} ErrorDesc_t;
+    uint32_t occurrences;   // 累计发生次数
+    uint32_t last_report;   // 最后一次打印/报警时间
+    uint16_t suppressed;    // 上次报告后被合并的次数
+    uint8_t log_index;      // 对应日志槽位 (ERROR_LOG_NONE 表示无)
+} ErrorStat_t;
+
+static ErrorStat_t error_stats[ERROR_STAT_COUNT];
 
-static const ErrorDesc_t error_table[] = {
-    // 系统错误
-    {ERR_SYS_OK, "System OK", ERR_LEVEL_NONE},
-    {ERR_SYS_INIT_FAIL, "SYS Init Fail", ERR_LEVEL_CRITICAL},
-    {ERR_SYS_MEMORY_LOW, "Mem Low", ERR_LEVEL_WARNING},
-    {ERR_SYS_WDT_RESET, "WDT Reset", ERR_LEVEL_ERROR},
-    {ERR_SYS_POWER_LOW, "Power Low", ERR_LEVEL_CRITICAL},
-    {ERR_SYS_OVERHEAT, "Overheat", ERR_LEVEL_ERROR},
-    
-    // 传感器错误
-    {ERR_SENSOR_OK, "Sensor OK", ERR_LEVEL_NONE},
-    {ERR_SENSOR_WATER_LOW, "Well Water Low", ERR_LEVEL_CRITICAL},
-    {ERR_SENSOR_ADC_FAIL, "ADC Fail", ERR_LEVEL_ERROR},
-    {ERR_SENSOR_OUT_OF_RANGE, "Sensor Range", ERR_LEVEL_WARNING},
-    {ERR_SENSOR_DISCONNECT, "Sensor Disc", ERR_LEVEL_ERROR},
-    
-    // 通信错误
-    {ERR_COM_OK, "Comm OK", ERR_LEVEL_NONE},
-    {ERR_COM_LORA_TIMEOUT, "LoRa Timeout", ERR_LEVEL_ERROR},
-    {ERR_COM_LORA_CRC, "LoRa CRC Err", ERR_LEVEL_ERROR},
-    {ERR_COM_I2C_FAIL, "I2C Fail", ERR_LEVEL_ERROR},
-    {ERR_COM_SPI_FAIL, "SPI Fail", ERR_LEVEL_ERROR},
-    {ERR_COM_WIFI_FAIL, "WiFi Fail", ERR_LEVEL_WARNING},
-    {ERR_COM_WEB_FAIL, "Web Server Err", ERR_LEVEL_WARNING},
-    
-    // 继电器错误
-    {ERR_REL_OK, "Relay OK", ERR_LEVEL_NONE},
-    {ERR_REL_STUCK_ON, "Relay Stuck On", ERR_LEVEL_CRITICAL},
-    {ERR_REL_STUCK_OFF, "Relay Stuck Off", ERR_LEVEL_ERROR},
-    {ERR_REL_OVERLOAD, "Relay Overload", ERR_LEVEL_CRITICAL},
-    {ERR_REL_DRIVER_FAIL, "74HC595 Fail", ERR_LEVEL_ERROR},
-    
-    // 网络错误
-    {ERR_NET_OK, "Net OK", ERR_LEVEL_NONE},
-    {ERR_NET_NO_FROM, "No Slave Data", ERR_LEVEL_WARNING},
-    {ERR_NET_TIMEOUT, "Net Timeout", ERR_LEVEL_ERROR},
-    {ERR_NET_INVALID_DATA, "Invalid Data", ERR_LEVEL_WARNING},
-    
-    // 水塔错误
-    {ERR_TOWER_OK, "Tower OK", ERR_LEVEL_NONE},
-    {ERR_TOWER_OVERFLOW, "Tower Overflow", ERR_LEVEL_CRITICAL},
-    {ERR_TOWER_DRY, "Tower Dry", ERR_LEVEL_WARNING},
-    {ERR_TOWER_PUMP_FAIL, "Pump Fail", ERR_LEVEL_CRITICAL},
-    {ERR_TOWER_SENSOR_FAIL, "Tower Sen Fail", ERR_LEVEL_ERROR},
-};
+// 报警浮层状态
+static uint16_t alert_code = ERR_SYS_OK;
+static uint32_t alert_start = 0;
+static bool alert_inverted = false;
 
-#define ERROR_TABLE_SIZE (sizeof(error_table) / sizeof(ErrorDesc_t))
+// ==================== 内部函数 ====================
+
+/**
+ * 错误码 -> 统计槽位
+ */
+static inline ErrorStat_t* error_stat(uint16_t code) {
+    if (!error_is_defined(code)) return &error_stats[ERROR_STAT_UNKNOWN];
+    return &error_stats[(code / 100) * ERR_CATEGORY_SLOTS + code % 100];
+}
 
 // ==================== 函数实现 ====================
 
@@ -83,40 +64,77 @@ void error_init(void) {
     for (int i = 0; i < MAX_ERROR_LOG; i++) {
         g_error_log[i].code = ERR_SYS_OK;
         g_error_log[i].level = ERR_LEVEL_NONE;
-        g_error_log[i].message = "None";
+        g_error_log[i].message = msg_none;
         g_error_log[i].timestamp = 0;
         g_error_log[i].tower_id = 0xFF;
+        g_error_log[i].count = 0;
+    }
+    
+    // 清空统计
+    memset(error_stats, 0, sizeof(error_stats));
+    for (int i = 0; i < ERROR_STAT_COUNT; i++) {
+        error_stats[i].log_index = ERROR_LOG_NONE;
     }
     
-    Serial.println("✅ 错误系统初始化完成");
+    alert_code = ERR_SYS_OK;
+    
+    LOG_I("✅ 错误系统初始化完成");
 }
 
 /**
  * 记录错误
+ * 
+ * 同一错误码在 ERROR_REPORT_INTERVAL_MS 内重复发生时，
+ * 只合并到上一条日志的计数中，不重复打印串口、不重复报警，
+ * 避免错误风暴 (如 LoRa 链路抖动) 拖慢控制循环。
  */
 void error_log(uint16_t code, ErrorLevel_t level, uint8_t tower_id) {
     if (code == ERR_SYS_OK) return;  // 不记录正常状态
     
+    uint32_t now = millis();
+    ErrorStat_t* stat = error_stat(code);
+    stat->occurrences++;
+    
     // 更新当前错误
     if (level >= ERR_LEVEL_ERROR) {
         g_current_error = code;
     }
     
+    // 去重：间隔内且日志槽位仍属于该错误码，则合并计数
+    if (stat->log_index != ERROR_LOG_NONE &&
+        g_error_log[stat->log_index].code == code &&
+        now - stat->last_report < ERROR_REPORT_INTERVAL_MS) {
+        Error_t* entry = &g_error_log[stat->log_index];
+        entry->count++;
+        entry->timestamp = now;
+        entry->tower_id = tower_id;
+        if (stat->suppressed < 0xFFFF) stat->suppressed++;
+        return;
+    }
+    
     // 添加到日志 (循环缓冲)
     uint8_t index = g_error_count % MAX_ERROR_LOG;
     
     g_error_log[index].code = code;
     g_error_log[index].level = level;
-    g_error_log[index].timestamp = millis();
+    g_error_log[index].timestamp = now;
     g_error_log[index].tower_id = tower_id;
     g_error_log[index].message = error_get_message(code);
+    g_error_log[index].count = 1;
     
     g_error_count++;
     
-    // 打印到串口
+    // 打印到串口 (附带上次报告后被合并的次数)
     error_print_serial(code);
+    if (stat->suppressed > 0) {
+        LOG_W("   (期间重复 %u 次)", stat->suppressed);
+    }
+    
+    stat->log_index = index;
+    stat->last_report = now;
+    stat->suppressed = 0;
     
-    // 显示到 OLED
+    // 登记报警浮层
     if (level >= ERR_LEVEL_WARNING) {
         error_display_oled(code);
     }
@@ -132,15 +150,26 @@ void error_clear(uint16_t code) {
         g_error_count = 0;
         for (int i = 0; i < MAX_ERROR_LOG; i++) {
             g_error_log[i].code = ERR_SYS_OK;
+            g_error_log[i].count = 0;
         }
-        Serial.println("✅ 已清除所有错误");
+        for (int i = 0; i < ERROR_STAT_COUNT; i++) {
+            error_stats[i].log_index = ERROR_LOG_NONE;
+            error_stats[i].suppressed = 0;
+        }
+        error_alert_dismiss();
+        LOG_I("✅ 已清除所有错误");
     } else {
         // 清除指定错误
         if (g_current_error == code) {
             g_current_error = ERR_SYS_OK;
         }
-        Serial.print("✅ 已清除错误：");
-        Serial.println(code);
+        ErrorStat_t* stat = error_stat(code);
+        stat->log_index = ERROR_LOG_NONE;
+        stat->suppressed = 0;
+        if (alert_code == code) {
+            error_alert_dismiss();
+        }
+        LOG_I("✅ 已清除错误：%u", code);
     }
 }
 
@@ -152,37 +181,61 @@ uint16_t error_get_current(void) {
 }
 
 /**
- * 获取错误描述
+ * 获取错误码累计发生次数
  */
-const char* error_get_message(uint16_t code) {
-    for (int i = 0; i < ERROR_TABLE_SIZE; i++) {
-        if (error_table[i].code == code) {
-            return error_table[i].message;
-        }
+uint32_t error_get_occurrences(uint16_t code) {
+    return error_stat(code)->occurrences;
+}
+
+/**
+ * 在 OLED 上显示错误 (非阻塞，只登记浮层)
+ */
+void error_display_oled(uint16_t code) {
+    if (code == ERR_SYS_OK) return;
+    
+    // 已有更高级别的报警在显示时不覆盖
+    uint32_t now = millis();
+    if (error_alert_active(now) && alert_code != code &&
+        error_get_level(alert_code) > error_get_level(code)) {
+        return;
     }
-    return "Unknown Error";
+    
+    alert_code = code;
+    alert_start = now;
 }
 
 /**
- * 获取错误级别
+ * 报警浮层是否正在显示
  */
-ErrorLevel_t error_get_level(uint16_t code) {
-    for (int i = 0; i < ERROR_TABLE_SIZE; i++) {
-        if (error_table[i].code == code) {
-            return error_table[i].level;
-        }
+bool error_alert_active(uint32_t now) {
+    return alert_code != ERR_SYS_OK && now - alert_start < ERROR_ALERT_DURATION_MS;
+}
+
+/**
+ * 关闭报警浮层
+ */
+void error_alert_dismiss(void) {
+    alert_code = ERR_SYS_OK;
+    if (alert_inverted) {
+        display.invertDisplay(false);
+        alert_inverted = false;
     }
-    return ERR_LEVEL_ERROR;
 }
 
 /**
- * 在 OLED 上显示错误
+ * 绘制报警浮层
  */
-void error_display_oled(uint16_t code) {
-    if (code == ERR_SYS_OK) return;
+bool error_alert_render(uint32_t now) {
+    if (!error_alert_active(now)) {
+        if (alert_code != ERR_SYS_OK) error_alert_dismiss();
+        return false;
+    }
+    
+    TRACE_SCOPE(TRACE_SPAN_ERROR_DISPLAY);
     
+    uint16_t code = alert_code;
     ErrorLevel_t level = error_get_level(code);
-    const char* message = error_get_message(code);
+    PGM_P message = error_get_message(code);
     
     display.clearDisplay();
     display.setTextSize(1);
@@ -190,43 +243,39 @@ void error_display_oled(uint16_t code) {
     
     // 错误标题
     display.setTextColor(SSD1306_WHITE);
-    display.println("=== ERROR ===");
+    display.println(F("=== ERROR ==="));
     
     // 错误码
-    display.print("Code: E");
-    if (code < 100) display.print("00");
-    else if (code < 1000) display.print("0");
+    display.print(F("Code: E"));
+    if (code < 100) display.print(F("00"));
+    else if (code < 1000) display.print(F("0"));
     display.println(code);
     
     // 错误级别
-    display.print("Level: ");
+    display.print(F("Level: "));
     switch (level) {
         case ERR_LEVEL_INFO:
-            display.println("INFO");
+            display.println(F("INFO"));
             break;
         case ERR_LEVEL_WARNING:
-            display.println("WARN");
+            display.println(F("WARN"));
             break;
         case ERR_LEVEL_ERROR:
-            display.println("ERROR");
+            display.println(F("ERROR"));
             break;
         case ERR_LEVEL_CRITICAL:
-            display.println("CRIT!");
+            display.println(F("CRIT!"));
             break;
         default:
-            display.println("NONE");
+            display.println(F("NONE"));
     }
     
-    // 错误描述 (滚动显示长消息)
-    display.println("-------------");
-    display.setTextSize(1);
+    // 错误描述 (长消息分两行)
+    display.println(F("-------------"));
     
-    // 分割长消息
     char msg_copy[32];
-    strncpy(msg_copy, message, 31);
-    msg_copy[31] = '\0';
+    copy_P(msg_copy, message, sizeof(msg_copy));
     
-    // 分两行显示
     if (strlen(msg_copy) > 16) {
         char line1[17], line2[17];
         strncpy(line1, msg_copy, 16);
@@ -239,20 +288,24 @@ void error_display_oled(uint16_t code) {
         display.println(msg_copy);
     }
     
-    // 闪烁效果 (严重错误)
-    if (level == ERR_LEVEL_CRITICAL) {
-        display.invertDisplay(true);
-        delay(500);
-        display.invertDisplay(false);
+    // 重复次数
+    uint32_t occurrences = error_stat(code)->occurrences;
+    if (occurrences > 1) {
+        display.print(F("x"));
+        display.println(occurrences);
     }
     
     display.display();
     
-    // 打印到串口
-    Serial.print("🚨 OLED 显示错误：");
-    Serial.print(code);
-    Serial.print(" - ");
-    Serial.println(message);
+    // 闪烁效果 (严重错误)：按时间相位切换反显，只在相位变化时发命令
+    bool invert = (level == ERR_LEVEL_CRITICAL) &&
+                  (((now - alert_start) / ERROR_ALERT_BLINK_MS) & 0x01) == 0;
+    if (invert != alert_inverted) {
+        display.invertDisplay(invert);
+        alert_inverted = invert;
+    }
+    
+    return true;
 }
 
 /**
@@ -287,22 +340,17 @@ Error_t* error_get_log(uint8_t index) {
  */
 void error_print_serial(uint16_t code) {
     ErrorLevel_t level = error_get_level(code);
-    const char* message = error_get_message(code);
     
-    Serial.print("❌ 错误 ");
-    Serial.print(code);
-    Serial.print(" [");
+    char message[32];
+    copy_P(message, error_get_message(code), sizeof(message));
     
     switch (level) {
-        case ERR_LEVEL_INFO: Serial.print("INFO"); break;
-        case ERR_LEVEL_WARNING: Serial.print("WARN"); break;
-        case ERR_LEVEL_ERROR: Serial.print("ERROR"); break;
-        case ERR_LEVEL_CRITICAL: Serial.print("CRIT"); break;
-        default: Serial.print("NONE");
+        case ERR_LEVEL_INFO: LOG_I("❌ 错误 %u [INFO] %s", code, message); break;
+        case ERR_LEVEL_WARNING: LOG_W("❌ 错误 %u [WARN] %s", code, message); break;
+        case ERR_LEVEL_ERROR: LOG_E("❌ 错误 %u [ERROR] %s", code, message); break;
+        case ERR_LEVEL_CRITICAL: LOG_E("❌ 错误 %u [CRIT] %s", code, message); break;
+        default: LOG_I("❌ 错误 %u [NONE] %s", code, message);
     }
-    
-    Serial.print("] ");
-    Serial.println(message);
 }
 
 /**
@@ -318,7 +366,7 @@ uint16_t system_health_check(void) {
     // 检查 WiFi
     if (WiFi.status() != WL_CONNECTED) {
         // WiFi 断开不视为严重错误
-        Serial.println("⚠️ WiFi 断开");
+        LOG_W("⚠️ WiFi 断开");
     }
     
     // 检查 I2C (OLED)
@@ -355,20 +403,51 @@ void error_get_stats(uint8_t* total, uint8_t* critical, uint8_t* error, uint8_t*
  * 导出错误日志 (JSON 格式)
  */
 String error_export_json(void) {
-    String json = "[";
+    String json = F("[");
     
     for (int i = 0; i < MAX_ERROR_LOG && i < g_error_count; i++) {
-        if (i > 0) json += ",";
+        if (i > 0) json += ',';
         
-        json += "{";
-        json += "\"code\":" + String(g_error_log[i].code);
-        json += ",\"level\":" + String(g_error_log[i].level);
-        json += ",\"message\":\"" + String(g_error_log[i].message) + "\"";
-        json += ",\"time\":" + String(g_error_log[i].timestamp);
-        json += ",\"tower\":" + String(g_error_log[i].tower_id);
-        json += "}";
+        json += F("{\"code\":");
+        json += g_error_log[i].code;
+        json += F(",\"level\":");
+        json += (int)g_error_log[i].level;
+        json += F(",\"message\":\"");
+        json += FPSTR(g_error_log[i].message);
+        json += F("\",\"time\":");
+        json += g_error_log[i].timestamp;
+        json += F(",\"tower\":");
+        json += g_error_log[i].tower_id;
+        json += F(",\"count\":");
+        json += g_error_log[i].count;
+        json += '}';
     }
     
-    json += "]";
+    json += ']';
     return json;
 }
+
+/**
+ * 导出错误日志 (CBOR 格式)
+ * 每条为定长数组 [code, level, message, time, tower, count]
+ */
+size_t error_export_cbor(uint8_t* buf, size_t size) {
+    CborWriter_t w;
+    uint8_t count = g_error_count < MAX_ERROR_LOG ? g_error_count : MAX_ERROR_LOG;
+    
+    cbor_init(&w, buf, size);
+    cbor_array(&w, count);
+    
+    for (uint8_t i = 0; i < count; i++) {
+        const Error_t* e = &g_error_log[i];
+        cbor_array(&w, 6);
+        cbor_uint(&w, e->code);
+        cbor_uint(&w, e->level);
+        cbor_text_P(&w, e->message);
+        cbor_uint(&w, e->timestamp);
+        cbor_uint(&w, e->tower_id);
+        cbor_uint(&w, e->count);
+    }
+    
+    return cbor_ok(&w) ? w.len : 0;
+}
@@ -6,12 +6,25 @@
  * - YYY: 具体错误编号 (001-999)
  * 
  * 显示格式：Exx-yyy (OLED 显示 8 字符)
+ * 
+ * 查表方式：错误码 = 类别 * 100 + 编号，按 [类别][编号] 直接索引 (O(1))，
+ * 描述表见 error_table.cpp (Linux 端工具也直接编译)
  */
 
 #ifndef ERROR_CODES_H
 #define ERROR_CODES_H
 
+#ifdef ARDUINO
 #include <Arduino.h>
+#else
+// Linux 端工具：没有单独的闪存地址空间，PROGMEM 数据直接访问
+#include <stdint.h>
+#include <stddef.h>
+#define PROGMEM
+typedef const char* PGM_P;
+#define pgm_read_ptr(addr)      (*(addr))
+#define pgm_read_dword(addr)    (*(addr))
+#endif
 
 // ==================== 错误码定义 ====================
 
@@ -59,6 +72,10 @@
 #define ERR_TOWER_PUMP_FAIL     503     // 水泵故障
 #define ERR_TOWER_SENSOR_FAIL   504     // 水塔传感器故障
 
+// 错误表维度 (类别 0-5，每类编号 0-7)
+#define ERR_CATEGORY_COUNT      6
+#define ERR_CATEGORY_SLOTS      8
+
 // ==================== 错误级别 ====================
 
 typedef enum {
@@ -74,9 +91,10 @@ typedef enum {
 typedef struct {
     uint16_t code;          // 错误码
     ErrorLevel_t level;     // 错误级别
-    const char* message;    // 错误描述
+    PGM_P message;          // 错误描述 (PROGMEM)
     uint32_t timestamp;     // 发生时间 (毫秒)
     uint8_t tower_id;       // 相关水塔 ID (0xFF 表示系统级)
+    uint16_t count;         // 去重合并的发生次数
 } Error_t;
 
 // ==================== 全局错误日志 ====================
@@ -87,6 +105,20 @@ extern Error_t g_error_log[MAX_ERROR_LOG];
 extern uint8_t g_error_count;
 extern uint16_t g_current_error;  // 当前错误码
 
+// ==================== 去重与报警浮层 ====================
+
+// 同一错误码的上报间隔：间隔内重复发生只计数，不重复打印和报警
+#define ERROR_REPORT_INTERVAL_MS    5000
+
+// 报警浮层显示时长
+#define ERROR_ALERT_DURATION_MS     3000
+
+// 严重错误闪烁周期 (反显切换间隔)
+#define ERROR_ALERT_BLINK_MS        500
+
+// CBOR 导出缓冲区大小 (满日志约 300 字节)
+#define ERROR_CBOR_MAX              512
+
 // ==================== 函数声明 ====================
 
 /**
@@ -114,12 +146,17 @@ void error_clear(uint16_t code);
  */
 uint16_t error_get_current(void);
 
+/**
+ * 错误码是否在描述表中
+ */
+bool error_is_defined(uint16_t code);
+
 /**
  * 获取错误描述
  * @param code 错误码
- * @return 错误描述字符串
+ * @return 错误描述字符串 (PROGMEM，使用 print_P/copy_P 访问)
  */
-const char* error_get_message(uint16_t code);
+PGM_P error_get_message(uint16_t code);
 
 /**
  * 获取错误级别
@@ -129,11 +166,39 @@ const char* error_get_message(uint16_t code);
 ErrorLevel_t error_get_level(uint16_t code);
 
 /**
- * 在 OLED 上显示错误
+ * 在 OLED 上显示错误 (非阻塞)
+ * 只登记报警浮层，实际绘制由显示调度调用 error_alert_render() 完成
  * @param code 错误码
  */
 void error_display_oled(uint16_t code);
 
+/**
+ * 报警浮层是否正在显示
+ * @param now 当前时间 (毫秒)
+ * @return true=显示中
+ */
+bool error_alert_active(uint32_t now);
+
+/**
+ * 绘制报警浮层 (由显示调度周期调用)
+ * 严重错误按 ERROR_ALERT_BLINK_MS 反显闪烁，不阻塞
+ * @param now 当前时间 (毫秒)
+ * @return true=已绘制浮层，false=无报警 (应绘制常规界面)
+ */
+bool error_alert_render(uint32_t now);
+
+/**
+ * 立即关闭报警浮层
+ */
+void error_alert_dismiss(void);
+
+/**
+ * 获取错误码累计发生次数 (含被去重合并的次数)
+ * @param code 错误码
+ * @return 发生次数
+ */
+uint32_t error_get_occurrences(uint16_t code);
+
 /**
  * 检查是否有错误
  * @return true=有错误，false=正常
@@ -159,6 +224,22 @@ Error_t* error_get_log(uint8_t index);
  */
 void error_print_serial(uint16_t code);
 
+#ifdef ARDUINO
+/**
+ * 导出错误日志 (JSON 格式)
+ * @return JSON 数组
+ */
+String error_export_json(void);
+#endif
+
+/**
+ * 导出错误日志 (CBOR 格式，结构见 docs/CBOR_SCHEMA.md)
+ * @param buf 输出缓冲区 (建议 ERROR_CBOR_MAX 字节)
+ * @param size 缓冲区大小
+ * @return 编码长度，0 表示缓冲区不足
+ */
+size_t error_export_cbor(uint8_t* buf, size_t size);
+
 /**
  * 系统健康检查
  * @return ERR_SYS_OK=健康，其他=故障
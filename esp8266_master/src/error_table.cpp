@@ -0,0 +1,145 @@
+/*
+ * 错误描述表 - 错误码到描述文本和级别的查表
+ *
+ * 只依赖 error_codes.h，不访问硬件：ESP8266 固件中表和文本位于闪存 (PROGMEM)，
+ * Linux 端工具 (linux_host/microbench) 直接编译同一文件。
+ */
+
+#include "error_codes.h"
+
+// 错误描述文本 (PROGMEM)
+static const char msg_sys_ok[] PROGMEM = "System OK";
+static const char msg_sys_init_fail[] PROGMEM = "SYS Init Fail";
+static const char msg_sys_memory_low[] PROGMEM = "Mem Low";
+static const char msg_sys_wdt_reset[] PROGMEM = "WDT Reset";
+static const char msg_sys_power_low[] PROGMEM = "Power Low";
+static const char msg_sys_overheat[] PROGMEM = "Overheat";
+static const char msg_sensor_water_low[] PROGMEM = "Well Water Low";
+static const char msg_sensor_adc_fail[] PROGMEM = "ADC Fail";
+static const char msg_sensor_out_of_range[] PROGMEM = "Sensor Range";
+static const char msg_sensor_disconnect[] PROGMEM = "Sensor Disc";
+static const char msg_com_lora_timeout[] PROGMEM = "LoRa Timeout";
+static const char msg_com_lora_crc[] PROGMEM = "LoRa CRC Err";
+static const char msg_com_i2c_fail[] PROGMEM = "I2C Fail";
+static const char msg_com_spi_fail[] PROGMEM = "SPI Fail";
+static const char msg_com_wifi_fail[] PROGMEM = "WiFi Fail";
+static const char msg_com_web_fail[] PROGMEM = "Web Server Err";
+static const char msg_rel_stuck_on[] PROGMEM = "Relay Stuck On";
+static const char msg_rel_stuck_off[] PROGMEM = "Relay Stuck Off";
+static const char msg_rel_overload[] PROGMEM = "Relay Overload";
+static const char msg_rel_driver_fail[] PROGMEM = "74HC595 Fail";
+static const char msg_net_no_from[] PROGMEM = "No Slave Data";
+static const char msg_net_timeout[] PROGMEM = "Net Timeout";
+static const char msg_net_invalid_data[] PROGMEM = "Invalid Data";
+static const char msg_tower_overflow[] PROGMEM = "Tower Overflow";
+static const char msg_tower_dry[] PROGMEM = "Tower Dry";
+static const char msg_tower_pump_fail[] PROGMEM = "Pump Fail";
+static const char msg_tower_sensor_fail[] PROGMEM = "Tower Sen Fail";
+static const char msg_unknown[] PROGMEM = "Unknown Error";
+
+// 错误描述表
+typedef struct {
+    uint16_t code;
+    PGM_P message;
+    ErrorLevel_t level;
+} ErrorDesc_t;
+
+// 按 [类别][编号] 排列，空位 message 为 NULL；整表位于闪存，经 pgm_read_xxx() 读取
+static constexpr ErrorDesc_t error_table[ERR_CATEGORY_COUNT][ERR_CATEGORY_SLOTS] PROGMEM = {
+    // 系统错误 (0xx)
+    {
+        {ERR_SYS_OK, msg_sys_ok, ERR_LEVEL_NONE},
+        {ERR_SYS_INIT_FAIL, msg_sys_init_fail, ERR_LEVEL_CRITICAL},
+        {ERR_SYS_MEMORY_LOW, msg_sys_memory_low, ERR_LEVEL_WARNING},
+        {ERR_SYS_WDT_RESET, msg_sys_wdt_reset, ERR_LEVEL_ERROR},
+        {ERR_SYS_POWER_LOW, msg_sys_power_low, ERR_LEVEL_CRITICAL},
+        {ERR_SYS_OVERHEAT, msg_sys_overheat, ERR_LEVEL_ERROR},
+    },
+    // 传感器错误 (1xx)
+    {
+        {},
+        {ERR_SENSOR_WATER_LOW, msg_sensor_water_low, ERR_LEVEL_CRITICAL},
+        {ERR_SENSOR_ADC_FAIL, msg_sensor_adc_fail, ERR_LEVEL_ERROR},
+        {ERR_SENSOR_OUT_OF_RANGE, msg_sensor_out_of_range, ERR_LEVEL_WARNING},
+        {ERR_SENSOR_DISCONNECT, msg_sensor_disconnect, ERR_LEVEL_ERROR},
+    },
+    // 通信错误 (2xx)
+    {
+        {},
+        {ERR_COM_LORA_TIMEOUT, msg_com_lora_timeout, ERR_LEVEL_ERROR},
+        {ERR_COM_LORA_CRC, msg_com_lora_crc, ERR_LEVEL_ERROR},
+        {ERR_COM_I2C_FAIL, msg_com_i2c_fail, ERR_LEVEL_ERROR},
+        {ERR_COM_SPI_FAIL, msg_com_spi_fail, ERR_LEVEL_ERROR},
+        {ERR_COM_WIFI_FAIL, msg_com_wifi_fail, ERR_LEVEL_WARNING},
+        {ERR_COM_WEB_FAIL, msg_com_web_fail, ERR_LEVEL_WARNING},
+    },
+    // 继电器错误 (3xx)
+    {
+        {},
+        {ERR_REL_STUCK_ON, msg_rel_stuck_on, ERR_LEVEL_CRITICAL},
+        {ERR_REL_STUCK_OFF, msg_rel_stuck_off, ERR_LEVEL_ERROR},
+        {ERR_REL_OVERLOAD, msg_rel_overload, ERR_LEVEL_CRITICAL},
+        {ERR_REL_DRIVER_FAIL, msg_rel_driver_fail, ERR_LEVEL_ERROR},
+    },
+    // 网络错误 (4xx)
+    {
+        {},
+        {ERR_NET_NO_FROM, msg_net_no_from, ERR_LEVEL_WARNING},
+        {ERR_NET_TIMEOUT, msg_net_timeout, ERR_LEVEL_ERROR},
+        {ERR_NET_INVALID_DATA, msg_net_invalid_data, ERR_LEVEL_WARNING},
+    },
+    // 水塔错误 (5xx)
+    {
+        {},
+        {ERR_TOWER_OVERFLOW, msg_tower_overflow, ERR_LEVEL_CRITICAL},
+        {ERR_TOWER_DRY, msg_tower_dry, ERR_LEVEL_WARNING},
+        {ERR_TOWER_PUMP_FAIL, msg_tower_pump_fail, ERR_LEVEL_CRITICAL},
+        {ERR_TOWER_SENSOR_FAIL, msg_tower_sensor_fail, ERR_LEVEL_ERROR},
+    },
+};
+
+// 编译期校验：每个非空表项的错误码必须与其位置一致
+static constexpr bool error_table_check(unsigned cat, unsigned slot) {
+    return (cat >= ERR_CATEGORY_COUNT) ? true
+         : (slot >= ERR_CATEGORY_SLOTS) ? error_table_check(cat + 1, 0)
+         : ((error_table[cat][slot].message == nullptr ||
+             error_table[cat][slot].code == cat * 100 + slot) &&
+            error_table_check(cat, slot + 1));
+}
+static_assert(error_table_check(0, 0), "error_table 表项与错误码位置不一致");
+
+// ==================== 内部函数 ====================
+
+/**
+ * 错误码 -> 表项 (O(1))
+ * @return 表项指针，未定义的错误码返回 NULL
+ */
+static inline const ErrorDesc_t* error_find(uint16_t code) {
+    uint16_t cat = code / 100;
+    uint16_t slot = code % 100;
+    if (cat >= ERR_CATEGORY_COUNT || slot >= ERR_CATEGORY_SLOTS) return NULL;
+    const ErrorDesc_t* desc = &error_table[cat][slot];
+    return pgm_read_ptr(&desc->message) ? desc : NULL;
+}
+
+// ==================== 函数实现 ====================
+
+bool error_is_defined(uint16_t code) {
+    return error_find(code) != NULL;
+}
+
+/**
+ * 获取错误描述
+ */
+PGM_P error_get_message(uint16_t code) {
+    const ErrorDesc_t* desc = error_find(code);
+    return desc ? (PGM_P)pgm_read_ptr(&desc->message) : msg_unknown;
+}
+
+/**
+ * 获取错误级别
+ */
+ErrorLevel_t error_get_level(uint16_t code) {
+    const ErrorDesc_t* desc = error_find(code);
+    return desc ? (ErrorLevel_t)pgm_read_dword(&desc->level) : ERR_LEVEL_ERROR;
+}
@@ -0,0 +1,259 @@
+/*
+ * 状态变化推送实现
+ */
+
+#include "event_stream.h"
+#include "pgm_util.h"
+#include "logger.h"
+
+// 外部状态 (在 main.cpp 中定义)
+extern TowerData towers[MAX_TOWERS];
+extern uint16_t tower_count;
+extern SystemStatus sys_status;
+
+#if (SSE_QUEUE_SIZE & (SSE_QUEUE_SIZE - 1)) != 0
+#error "SSE_QUEUE_SIZE 必须为 2 的幂"
+#endif
+
+#define SSE_QUEUE_MASK  (SSE_QUEUE_SIZE - 1)
+
+// 单条事件的数据和完整事件的最大长度
+// 最长的数据是带满采样窗口的水塔 (202 字节)，事件头和结尾不超过 40 字节
+#define SSE_DATA_MAX    208
+#define SSE_EVENT_MAX   (SSE_DATA_MAX + 40)
+
+// 订阅客户端
+typedef struct {
+    WiFiClient client;
+    bool active;
+    bool resync;            // 队列溢出，需要重发快照
+    uint16_t head;          // 写位置
+    uint16_t tail;          // 读位置
+    uint32_t last_write;    // 最后写出时间
+    uint32_t dropped;       // 丢弃的事件数
+    char queue[SSE_QUEUE_SIZE];
+} SseClient_t;
+
+static SseClient_t sse_clients[SSE_MAX_CLIENTS];
+static uint32_t sse_event_id = 0;
+
+// ==================== 队列操作 ====================
+
+static inline size_t queue_used(const SseClient_t* c) {
+    return (c->head - c->tail) & SSE_QUEUE_MASK;
+}
+
+static inline size_t queue_free(const SseClient_t* c) {
+    return SSE_QUEUE_SIZE - 1 - queue_used(c);
+}
+
+/**
+ * 整条入队
+ * @return false=空间不足 (不写入)
+ */
+static bool queue_push(SseClient_t* c, const char* data, size_t len) {
+    if (len > queue_free(c)) return false;
+    for (size_t i = 0; i < len; i++) {
+        c->queue[(c->head + i) & SSE_QUEUE_MASK] = data[i];
+    }
+    c->head = (c->head + len) & SSE_QUEUE_MASK;
+    return true;
+}
+
+// ==================== 事件格式化 ====================
+
+/**
+ * 格式化一条 SSE 事件 (分配新的事件 id)
+ * @param name 事件名 (PROGMEM)
+ * @return 事件长度，0 表示超长
+ */
+static size_t format_event(char* buf, size_t size, PGM_P name, const char* data) {
+    char name_buf[8];
+    strncpy_P(name_buf, name, sizeof(name_buf) - 1);
+    name_buf[sizeof(name_buf) - 1] = '\0';
+
+    sse_event_id++;
+    int n = snprintf_P(buf, size, PSTR("id: %lu\nevent: %s\ndata: %s\n\n"),
+                       (unsigned long)sse_event_id, name_buf, data);
+    if (n < 0 || (size_t)n >= size) return 0;
+    return n;
+}
+
+static const char evt_status[] PROGMEM = "status";
+static const char evt_tower[] PROGMEM = "tower";
+static const char evt_resync[] PROGMEM = "resync";
+
+/**
+ * 水塔事件的数据，与 /api/towers 的水塔对象一致 (另加在线状态)
+ */
+static void format_tower(char* buf, size_t size, const TowerData* t) {
+    int n = snprintf_P(buf, size, PSTR("{\"id\":%u,\"level\":%u,\"pump\":%S,\"online\":%S"),
+                       t->id, t->water_level, bool_P(t->pump_on), bool_P(t->online));
+
+    const TowerWindow* w = &t->window;
+    if (w->samples) {
+        n += snprintf_P(buf + n, size - n,
+                        PSTR(",\"window\":{\"samples\":%u,\"min\":%u,\"max\":%u,\"changes\":%u"),
+                        w->samples, w->level_min, w->level_max, w->changes);
+        for (uint8_t k = 0; k < w->channel_count; k++) {
+            n += snprintf_P(buf + n, size - n, k == 0 ? PSTR(",\"channels\":[%u") : PSTR(",%u"),
+                            w->channels[k]);
+        }
+        if (w->channel_count) n += snprintf_P(buf + n, size - n, PSTR("]"));
+        n += snprintf_P(buf + n, size - n, PSTR("}"));
+    }
+    snprintf_P(buf + n, size - n, PSTR("}"));
+}
+
+static void format_status(char* buf, size_t size) {
+    snprintf_P(buf, size, PSTR("{\"mode\":\"%S\",\"well_water\":%S,\"wifi\":%S,\"towers\":%u}"),
+               sys_status.mode == MODE_AUTO ? PSTR("AUTO") : PSTR("MANUAL"),
+               bool_P(sys_status.well_water_ok),
+               bool_P(sys_status.wifi_connected),
+               tower_count);
+}
+
+/**
+ * 向所有客户端广播一条事件
+ * 队列放不下的客户端丢弃该事件并标记重新同步；
+ * 事件超长时所有客户端都丢弃该事件，同样重新同步
+ */
+static void broadcast(PGM_P name, const char* data) {
+    if (event_stream_clients() == 0) return;
+
+    char event[SSE_EVENT_MAX];
+    size_t len = format_event(event, sizeof(event), name, data);
+    if (len == 0) {
+        LOG_W("⚠️ 推送事件超长，客户端重新同步");
+    }
+
+    for (uint8_t i = 0; i < SSE_MAX_CLIENTS; i++) {
+        SseClient_t* c = &sse_clients[i];
+        if (!c->active || c->resync) continue;
+        if (len == 0 || !queue_push(c, event, len)) {
+            c->dropped++;
+            c->resync = true;
+        }
+    }
+}
+
+/**
+ * 向单个客户端写入完整快照
+ * 任何一条放不下时撤回已写入部分，保证快照完整
+ * @return false=队列空间不足
+ */
+static bool push_snapshot(SseClient_t* c) {
+    char data[SSE_DATA_MAX];
+    char event[SSE_EVENT_MAX];
+    uint16_t saved_head = c->head;
+    bool ok;
+
+    ok = queue_push(c, event, format_event(event, sizeof(event), evt_resync, "{}"));
+
+    format_status(data, sizeof(data));
+    ok = ok && queue_push(c, event, format_event(event, sizeof(event), evt_status, data));
+
+    for (uint8_t i = 0; ok && i < tower_count; i++) {
+        format_tower(data, sizeof(data), &towers[i]);
+        ok = queue_push(c, event, format_event(event, sizeof(event), evt_tower, data));
+    }
+
+    if (!ok) c->head = saved_head;
+    return ok;
+}
+
+// ==================== 函数实现 ====================
+
+/**
+ * 接受一个订阅连接
+ */
+bool event_stream_subscribe(WiFiClient client) {
+    SseClient_t* slot = NULL;
+    for (uint8_t i = 0; i < SSE_MAX_CLIENTS; i++) {
+        if (!sse_clients[i].active) {
+            slot = &sse_clients[i];
+            break;
+        }
+    }
+    if (slot == NULL) return false;
+
+    client.setNoDelay(true);
+    client.print(F("HTTP/1.1 200 OK\r\n"
+                   "Content-Type: text/event-stream\r\n"
+                   "Cache-Control: no-cache\r\n"
+                   "Connection: keep-alive\r\n"
+                   "Access-Control-Allow-Origin: *\r\n\r\n"));
+
+    slot->client = client;
+    slot->active = true;
+    slot->resync = true;    // 首次发送完整快照
+    slot->head = 0;
+    slot->tail = 0;
+    slot->dropped = 0;
+    slot->last_write = millis();
+
+    LOG_I("📡 事件订阅 +1 (%s)", client.remoteIP().toString().c_str());
+    return true;
+}
+
+void event_stream_publish_tower(const TowerData* tower) {
+    char data[SSE_DATA_MAX];
+    format_tower(data, sizeof(data), tower);
+    broadcast(evt_tower, data);
+}
+
+void event_stream_publish_status(void) {
+    char data[SSE_DATA_MAX];
+    format_status(data, sizeof(data));
+    broadcast(evt_status, data);
+}
+
+/**
+ * 发送队列中的事件
+ */
+void event_stream_loop(uint32_t now) {
+    for (uint8_t i = 0; i < SSE_MAX_CLIENTS; i++) {
+        SseClient_t* c = &sse_clients[i];
+        if (!c->active) continue;
+
+        if (!c->client.connected()) {
+            c->client.stop();
+            c->active = false;
+            LOG_I("📡 事件订阅 -1 (丢弃 %lu 条)", (unsigned long)c->dropped);
+            continue;
+        }
+
+        // 溢出后等队列清空再补发快照
+        if (c->resync && queue_used(c) == 0 && push_snapshot(c)) {
+            c->resync = false;
+        }
+
+        // 保活注释行
+        if (queue_used(c) == 0 && now - c->last_write >= SSE_KEEPALIVE_MS) {
+            queue_push(c, ":\n\n", 3);
+        }
+
+        // 按发送窗口写出，不阻塞
+        while (queue_used(c) > 0) {
+            size_t room = c->client.availableForWrite();
+            if (room == 0) break;
+
+            size_t chunk = (c->head >= c->tail) ? (size_t)(c->head - c->tail)
+                                                : (size_t)(SSE_QUEUE_SIZE - c->tail);
+            if (chunk > room) chunk = room;
+
+            size_t written = c->client.write((const uint8_t*)&c->queue[c->tail], chunk);
+            if (written == 0) break;
+            c->tail = (c->tail + written) & SSE_QUEUE_MASK;
+            c->last_write = now;
+        }
+    }
+}
+
+uint8_t event_stream_clients(void) {
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < SSE_MAX_CLIENTS; i++) {
+        if (sse_clients[i].active) count++;
+    }
+    return count;
+}
@@ -0,0 +1,65 @@
+/*
+ * 状态变化推送 - Server-Sent Events (GET /api/events)
+ *
+ * 客户端保持一个 HTTP 长连接，主机在状态变化时推送增量事件，
+ * 取代轮询 /api/towers 和 /api/status。
+ *
+ * 事件格式 (每条带递增 id，客户端可据此发现丢失):
+ *   event: status   data: {"mode":"AUTO","well_water":true,"wifi":true,"towers":3}
+ *   event: tower    data: {"id":1,"level":55,"pump":true,"online":true}
+ *   event: resync   data: {}   (之后紧跟完整的 status + 所有 tower 事件)
+ *
+ * 连接建立时先推送一次完整快照 (resync)。每个客户端有独立的有界发送队列，
+ * 队列满时丢弃增量并标记重新同步，待队列清空后重发快照，
+ * 慢客户端不会阻塞主循环，也不会影响其他客户端。
+ */
+
+#ifndef EVENT_STREAM_H
+#define EVENT_STREAM_H
+
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include "water_system.h"
+
+// 最大订阅客户端数
+#define SSE_MAX_CLIENTS     3
+
+// 每个客户端的发送队列 (字节，必须为 2 的幂)
+#define SSE_QUEUE_SIZE      1024
+
+// 无事件时的保活间隔 (同时用于发现断开的连接)
+#define SSE_KEEPALIVE_MS    15000
+
+// ==================== 函数声明 ====================
+
+/**
+ * 接受一个订阅连接 (在 /api/events 处理函数中调用)
+ * 直接写出 HTTP 响应头，连接由本模块保持
+ * @param client 当前请求的连接
+ * @return false=订阅已满
+ */
+bool event_stream_subscribe(WiFiClient client);
+
+/**
+ * 推送水塔状态变化
+ * @param tower 水塔数据
+ */
+void event_stream_publish_tower(const TowerData* tower);
+
+/**
+ * 推送系统状态变化 (模式、井水、WiFi、水塔数量)
+ */
+void event_stream_publish_status(void);
+
+/**
+ * 发送队列中的事件 (主循环中调用，按 TCP 发送窗口非阻塞写出)
+ * @param now 当前时间 (毫秒)
+ */
+void event_stream_loop(uint32_t now);
+
+/**
+ * 当前订阅数
+ */
+uint8_t event_stream_clients(void);
+
+#endif  // EVENT_STREAM_H
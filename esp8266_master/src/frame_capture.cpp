@@ -0,0 +1,257 @@
+/*
+ * LoRa 帧捕获实现
+ */
+
+#include "frame_capture.h"
+#include "logger.h"
+#include <flash_hal.h>
+
+// 扇区头
+#define CAPTURE_MAGIC       0x50435457UL    // "WTCP"
+#define CAPTURE_RUNNING     0xFFFFFFFFUL    // 擦除后的值
+
+typedef struct {
+    uint32_t magic;
+    uint32_t seq;           // 扇区序号 (每开一个新扇区加 1)
+    uint32_t running;       // CAPTURE_RUNNING=捕获中，0=已停止
+} CaptureSectorHeader_t;
+
+#define CAPTURE_RECORDS_PER_SECTOR \
+    ((FLASH_SECTOR_SIZE - sizeof(CaptureSectorHeader_t)) / sizeof(CaptureRecord_t))
+
+// 闪存读写以 4 字节为单位
+static_assert(sizeof(CapturePacketHeader_t) == 12, "CapturePacketHeader_t 应为 12 字节");
+static_assert(sizeof(CaptureRecord_t) == 48, "CaptureRecord_t 应为 48 字节");
+static_assert(sizeof(CaptureSectorHeader_t) % 4 == 0, "扇区头大小必须为 4 的倍数");
+
+// 环形区
+static uint32_t region_addr = 0;
+static uint16_t region_sectors = 0;
+
+// 当前写入位置
+static bool has_head = false;
+static uint16_t head = 0;
+static uint32_t head_seq = 0;
+static uint16_t slot = 0;
+
+static bool active = false;
+static uint32_t loop_seq = 0;
+static uint32_t write_errors = 0;
+
+// 内存缓冲 (按 4 字节对齐，可直接写入闪存)
+static CaptureRecord_t buffer[CAPTURE_BUFFER_RECORDS];
+static uint8_t buffered = 0;
+static uint32_t last_flush = 0;
+
+// ==================== 内部函数 ====================
+
+static uint32_t sector_addr(uint16_t s) {
+    return region_addr + (uint32_t)s * FLASH_SECTOR_SIZE;
+}
+
+static uint32_t record_addr(uint16_t s, uint16_t index) {
+    return sector_addr(s) + sizeof(CaptureSectorHeader_t) + (uint32_t)index * sizeof(CaptureRecord_t);
+}
+
+static bool read_header(uint16_t s, CaptureSectorHeader_t* h) {
+    return ESP.flashRead(sector_addr(s), (uint32_t*)h, sizeof(*h)) && h->magic == CAPTURE_MAGIC;
+}
+
+/**
+ * 扇区是否属于当前环形区 (排除更早遗留的扇区)
+ */
+static bool sector_valid(uint16_t s) {
+    CaptureSectorHeader_t h;
+    if (!has_head || !read_header(s, &h)) return false;
+    return h.seq <= head_seq && head_seq - h.seq < region_sectors;
+}
+
+/**
+ * 读取一条记录
+ * @return false=空位置 (扇区内其后也没有记录)
+ */
+static bool read_record(uint16_t s, uint16_t index, CaptureRecord_t* rec) {
+    if (!ESP.flashRead(record_addr(s, index), (uint32_t*)rec, sizeof(*rec))) return false;
+    return rec->h.type < CAPTURE_TYPE_COUNT && rec->h.len <= CAPTURE_DATA_MAX;
+}
+
+/**
+ * 擦除扇区并写入扇区头，作为新的写入位置
+ */
+static bool open_sector(uint16_t s, uint32_t seq) {
+    CaptureSectorHeader_t h = { CAPTURE_MAGIC, seq, CAPTURE_RUNNING };
+    if (!ESP.flashEraseSector(sector_addr(s) / FLASH_SECTOR_SIZE) ||
+        !ESP.flashWrite(sector_addr(s), (uint32_t*)&h, sizeof(h))) {
+        write_errors++;
+        return false;
+    }
+    has_head = true;
+    head = s;
+    head_seq = seq;
+    slot = 0;
+    return true;
+}
+
+// ==================== 控制 ====================
+
+bool capture_begin(void) {
+    uint32_t size = FS_PHYS_SIZE < CAPTURE_FLASH_SIZE ? FS_PHYS_SIZE : CAPTURE_FLASH_SIZE;
+    region_addr = FS_PHYS_ADDR;
+    region_sectors = (uint16_t)(size / FLASH_SECTOR_SIZE);
+    if (region_sectors < 2) {
+        region_sectors = 0;
+        LOG_W("⚠️ 没有文件系统分区，帧捕获不可用");
+        return false;
+    }
+
+    // 序号最大的扇区为最新
+    uint32_t running = 0;
+    CaptureSectorHeader_t h;
+    for (uint16_t s = 0; s < region_sectors; s++) {
+        if (!read_header(s, &h)) continue;
+        if (!has_head || h.seq > head_seq) {
+            has_head = true;
+            head = s;
+            head_seq = h.seq;
+            running = h.running;
+        }
+    }
+    if (!has_head || running != CAPTURE_RUNNING) return false;
+
+    LOG_I("📼 上次帧捕获未停止，继续记录");
+    return capture_start();
+}
+
+bool capture_start(void) {
+    if (region_sectors == 0) return false;
+    if (active) capture_stop();
+
+    uint16_t s = has_head ? (uint16_t)((head + 1) % region_sectors) : 0;
+    if (!open_sector(s, has_head ? head_seq + 1 : 1)) return false;
+    active = true;
+    buffered = 0;
+    return true;
+}
+
+void capture_stop(void) {
+    if (!active) return;
+    capture_record(CAPTURE_STOP, NULL, 0);
+    capture_flush();
+    active = false;
+
+    // 已写入的位只能由 1 变 0，清零标志字不需要擦除
+    uint32_t stopped = 0;
+    if (!ESP.flashWrite(sector_addr(head) + offsetof(CaptureSectorHeader_t, running), &stopped, sizeof(stopped))) {
+        write_errors++;
+    }
+}
+
+bool capture_active(void) {
+    return active;
+}
+
+// ==================== 记录 ====================
+
+void capture_loop(uint32_t now) {
+    loop_seq++;
+    if (!active || buffered == 0) {
+        last_flush = now;
+        return;
+    }
+    if (now - last_flush >= CAPTURE_FLUSH_MS) {
+        capture_flush();
+        last_flush = now;
+    }
+}
+
+uint32_t capture_loop_seq(void) {
+    return loop_seq;
+}
+
+void capture_record(uint8_t type, const uint8_t* data, uint8_t len, int16_t rssi, int8_t snr) {
+    if (!active) return;
+    if (len > CAPTURE_DATA_MAX) len = CAPTURE_DATA_MAX;
+
+    CaptureRecord_t* rec = &buffer[buffered];
+    memset(rec, 0, sizeof(*rec));
+    rec->ts_ms = millis();
+    rec->h.type = type;
+    rec->h.len = len;
+    rec->h.rssi = rssi;
+    rec->h.snr = snr;
+    rec->h.loop = loop_seq;
+    if (len > 0) memcpy(rec->data, data, len);
+
+    if (++buffered == CAPTURE_BUFFER_RECORDS) capture_flush();
+}
+
+void capture_flush(void) {
+    uint8_t i = 0;
+    while (i < buffered) {
+        if (slot >= CAPTURE_RECORDS_PER_SECTOR &&
+            !open_sector((uint16_t)((head + 1) % region_sectors), head_seq + 1)) {
+            break;      // 擦除失败，丢弃本批记录
+        }
+        uint8_t n = buffered - i;
+        if (n > CAPTURE_RECORDS_PER_SECTOR - slot) n = (uint8_t)(CAPTURE_RECORDS_PER_SECTOR - slot);
+        if (!ESP.flashWrite(record_addr(head, slot), (uint32_t*)&buffer[i], n * sizeof(CaptureRecord_t))) {
+            write_errors++;
+        }
+        slot += n;
+        i += n;
+    }
+    buffered = 0;
+}
+
+// ==================== 导出 ====================
+
+uint32_t capture_export(Print& out) {
+    capture_flush();
+
+    CapturePcapHeader_t file = {
+        CAPTURE_PCAP_MAGIC, CAPTURE_PCAP_VERSION_MAJOR, CAPTURE_PCAP_VERSION_MINOR,
+        0, 0, CAPTURE_PCAP_SNAPLEN, CAPTURE_PCAP_LINKTYPE
+    };
+    out.write((const uint8_t*)&file, sizeof(file));
+
+    // 从最新扇区的下一个 (最旧) 开始，按环形顺序到最新扇区
+    uint32_t count = 0;
+    CaptureRecord_t rec;
+    for (uint16_t k = 1; has_head && k <= region_sectors; k++) {
+        uint16_t s = (uint16_t)((head + k) % region_sectors);
+        if (!sector_valid(s)) continue;
+
+        for (uint16_t r = 0; r < CAPTURE_RECORDS_PER_SECTOR; r++) {
+            if (!read_record(s, r, &rec)) break;
+
+            CapturePcapPacket_t pkt;
+            pkt.ts_sec = rec.ts_ms / 1000;
+            pkt.ts_usec = (rec.ts_ms % 1000) * 1000;
+            pkt.incl_len = sizeof(rec.h) + rec.h.len;
+            pkt.orig_len = pkt.incl_len;
+            out.write((const uint8_t*)&pkt, sizeof(pkt));
+            out.write((const uint8_t*)&rec.h, sizeof(rec.h));
+            out.write(rec.data, rec.h.len);
+            count++;
+        }
+        yield();
+    }
+    return count;
+}
+
+void capture_get_stats(CaptureStats_t* stats) {
+    memset(stats, 0, sizeof(*stats));
+    stats->active = active;
+    stats->sectors = region_sectors;
+    stats->write_errors = write_errors;
+
+    CaptureRecord_t rec;
+    for (uint16_t s = 0; s < region_sectors; s++) {
+        if (!sector_valid(s)) continue;
+        stats->used_sectors++;
+        for (uint16_t r = 0; r < CAPTURE_RECORDS_PER_SECTOR && read_record(s, r, &rec); r++) {
+            stats->records++;
+        }
+    }
+    stats->records += buffered;
+}
@@ -0,0 +1,97 @@
+/*
+ * LoRa 帧捕获 (闪存环形区)
+ *
+ * 用于复现现场问题：开启后把收到/发出的每一帧 (带时间戳、RSSI、SNR)
+ * 以及影响控制决策的输入和继电器输出写入闪存，断电重启后继续记录。
+ * 记录格式见 capture_format.h，导出为 pcap 文件，可用 wt-replay 在 Linux 上回放。
+ *
+ * 闪存布局：使用文件系统分区 (本固件未使用文件系统) 开头的 CAPTURE_FLASH_SIZE 字节，
+ * 每个 4 KB 扇区 = 扇区头 + 85 条定长记录，写满后擦除最旧的扇区。
+ * 记录先缓存在内存中，攒满 CAPTURE_BUFFER_RECORDS 条或 CAPTURE_FLUSH_MS 后批量写入，
+ * 进入新扇区时擦除一次 (约 40 ms，期间主循环停顿)。
+ *
+ * 捕获状态保存在最新扇区头中 (停止时把标志字清零，闪存无需擦除即可写 0)，
+ * 上电后若上次未停止则自动开始新的一段。
+ */
+
+#ifndef FRAME_CAPTURE_H
+#define FRAME_CAPTURE_H
+
+#include <Arduino.h>
+#include "capture_format.h"
+
+// 环形区大小 (64 个扇区；8 个从机每 5 秒上报时约可保存 10 小时)
+#ifndef CAPTURE_FLASH_SIZE
+#define CAPTURE_FLASH_SIZE      (256UL * 1024)
+#endif
+
+// 内存缓冲记录数与最长写入间隔
+#define CAPTURE_BUFFER_RECORDS  8
+#define CAPTURE_FLUSH_MS        2000
+
+// 统计
+typedef struct {
+    bool active;                // 正在捕获
+    uint16_t sectors;           // 环形区扇区数 (0=没有可用分区)
+    uint16_t used_sectors;      // 有数据的扇区数
+    uint32_t records;           // 闪存中的记录数
+    uint32_t write_errors;      // 擦除/写入失败次数
+} CaptureStats_t;
+
+// ==================== 函数声明 ====================
+
+/**
+ * 初始化：扫描扇区头，恢复序号
+ * @return true=上次未停止，已开始新的一段 (调用方应随后写入快照)
+ */
+bool capture_begin(void);
+
+/**
+ * 开始新的一段捕获 (调用方应随后写入快照)
+ * @return false=没有可用的闪存分区
+ */
+bool capture_start(void);
+
+/**
+ * 写入停止标记并停止捕获
+ */
+void capture_stop(void);
+
+bool capture_active(void);
+
+/**
+ * 主循环开始时调用：循环序号加 1，到时间则把缓冲写入闪存
+ */
+void capture_loop(uint32_t now);
+
+/**
+ * 当前主循环序号
+ */
+uint32_t capture_loop_seq(void);
+
+/**
+ * 记录一条 (未开始捕获时忽略)
+ * @param type CaptureType_t
+ * @param len 超过 CAPTURE_DATA_MAX 的部分被截断
+ * @param rssi dBm (仅 CAPTURE_RX)
+ * @param snr 0.25 dB (仅 CAPTURE_RX)
+ */
+void capture_record(uint8_t type, const uint8_t* data, uint8_t len, int16_t rssi = 0, int8_t snr = 0);
+
+/**
+ * 把缓冲的记录写入闪存
+ */
+void capture_flush(void);
+
+/**
+ * 导出全部记录 (pcap，从最旧到最新)
+ * @return 导出的记录数
+ */
+uint32_t capture_export(Print& out);
+
+/**
+ * 统计 (记录数需要读取扇区，只在查询时调用)
+ */
+void capture_get_stats(CaptureStats_t* stats);
+
+#endif  // FRAME_CAPTURE_H
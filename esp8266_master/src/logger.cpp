@@ -0,0 +1,162 @@
+/*
+ * 异步缓冲日志实现
+ */
+
+#include "logger.h"
+#include <stdarg.h>
+
+uint32_t g_log_dropped = 0;
+
+#if LOG_LEVEL > LOG_LEVEL_NONE
+
+#if (LOG_BUFFER_SIZE & (LOG_BUFFER_SIZE - 1)) != 0
+#error "LOG_BUFFER_SIZE 必须为 2 的幂"
+#endif
+
+#define LOG_MASK (LOG_BUFFER_SIZE - 1)
+
+// 环形缓冲区 (留一个字节区分空/满)
+static char log_buf[LOG_BUFFER_SIZE];
+static volatile uint16_t log_head = 0;  // 写位置 (生产者)
+static volatile uint16_t log_tail = 0;  // 读位置 (消费者)
+
+// 已报告的丢弃数
+static uint32_t log_drop_reported = 0;
+
+// 级别标识 (下标为级别)
+static const char level_chars[] PROGMEM = "-EWIDV";
+
+/**
+ * 整条写入缓冲区
+ * @return false=空间不足 (不写入任何字节)
+ */
+static bool log_push(const char* data, size_t len) {
+    uint16_t head = log_head;
+    uint16_t tail = log_tail;
+    size_t space = (tail - head - 1) & LOG_MASK;
+    if (len > space) return false;
+
+    for (size_t i = 0; i < len; i++) {
+        log_buf[(head + i) & LOG_MASK] = data[i];
+    }
+    log_head = (head + len) & LOG_MASK;
+    return true;
+}
+
+/**
+ * 格式化一条日志
+ * 格式：[毫秒][级别] 内容
+ */
+void log_write(uint8_t level, PGM_P fmt, ...) {
+    char line[LOG_LINE_MAX];
+
+    if (level > LOG_LEVEL_VERBOSE) level = LOG_LEVEL_VERBOSE;
+    int n = snprintf_P(line, sizeof(line), PSTR("[%lu][%c] "),
+                       (unsigned long)millis(), (char)pgm_read_byte(&level_chars[level]));
+
+    va_list args;
+    va_start(args, fmt);
+    int m = vsnprintf_P(line + n, sizeof(line) - n - 1, fmt, args);
+    va_end(args);
+
+    // 超长截断，保留换行
+    size_t len = n;
+    if (m > 0) len += ((size_t)m < sizeof(line) - n - 1) ? (size_t)m : sizeof(line) - n - 2;
+    line[len++] = '\n';
+
+    if (!log_push(line, len)) {
+        g_log_dropped++;
+    }
+}
+
+bool log_pending(void) {
+    return log_head != log_tail;
+}
+
+/**
+ * 输出缓冲区内容
+ * 每次只写串口 FIFO 能立即接收的字节数，不会阻塞
+ */
+size_t log_drain(void) {
+    size_t written = 0;
+
+    // 补报丢弃统计
+    if (g_log_dropped != log_drop_reported) {
+        char note[80];
+        int n = snprintf_P(note, sizeof(note), PSTR("[%lu][W] 日志缓冲区满，丢弃 %lu 条\n"),
+                           (unsigned long)millis(), (unsigned long)(g_log_dropped - log_drop_reported));
+        if (n > 0 && (size_t)n < sizeof(note) && log_push(note, n)) {
+            log_drop_reported = g_log_dropped;
+        }
+    }
+
+    while (log_pending()) {
+        int room = Serial.availableForWrite();
+        if (room <= 0) break;
+
+        uint16_t tail = log_tail;
+        uint16_t head = log_head;
+        size_t chunk = (head >= tail) ? (size_t)(head - tail) : (size_t)(LOG_BUFFER_SIZE - tail);
+        if (chunk > (size_t)room) chunk = room;
+
+        Serial.write((const uint8_t*)&log_buf[tail], chunk);
+        log_tail = (tail + chunk) & LOG_MASK;
+        written += chunk;
+    }
+
+    return written;
+}
+
+void log_flush(void) {
+    while (log_pending() || g_log_dropped != log_drop_reported) {
+        log_drain();
+        yield();
+    }
+}
+
+/**
+ * 空闲等待
+ * 有待输出日志时按 LOG_IDLE_SLICE_MS 分片等待，输出完毕后直接等待剩余时间
+ */
+void log_idle(uint32_t ms) {
+    uint32_t start = millis();
+
+    for (;;) {
+        log_drain();
+
+        uint32_t elapsed = millis() - start;
+        if (elapsed >= ms) break;
+
+        uint32_t remain = ms - elapsed;
+        if (log_pending() && remain > LOG_IDLE_SLICE_MS) {
+            delay(LOG_IDLE_SLICE_MS);
+        } else {
+            delay(remain);
+            break;
+        }
+    }
+}
+
+#else  // LOG_LEVEL == LOG_LEVEL_NONE
+
+void log_write(uint8_t level, PGM_P fmt, ...) {
+    (void)level;
+    (void)fmt;
+}
+
+size_t log_drain(void) {
+    return 0;
+}
+
+bool log_pending(void) {
+    return false;
+}
+
+void log_flush(void) {
+}
+
+void log_idle(uint32_t ms) {
+    delay(ms);
+}
+
+#endif  // LOG_LEVEL
@@ -0,0 +1,118 @@
+/*
+ * 异步缓冲日志
+ *
+ * 日志先格式化到环形缓冲区，再在主循环空闲时间按串口 FIFO 剩余空间
+ * 非阻塞输出，避免 115200 波特率下 FIFO 写满后每行阻塞数毫秒。
+ *
+ * 使用:
+ * - LOG_E / LOG_W / LOG_I / LOG_D / LOG_V (printf 格式，格式串自动放入闪存)
+ * - log_idle(ms)   主循环空闲等待，期间输出日志
+ * - log_flush()    阻塞输出全部日志 (启动阶段或导出调试数据前)
+ *
+ * 级别:
+ * - LOG_LEVEL 未定义时取 CORE_DEBUG_LEVEL (0=无 1=错误 2=警告 3=信息 4=调试 5=详细)
+ * - 高于 LOG_LEVEL 的宏展开为空，参数不求值；LOG_LEVEL=0 时缓冲区也不占内存
+ *
+ * 缓冲区满时整条丢弃并计数，下次输出时补一条丢弃统计。
+ * 单生产者/单消费者无锁环形缓冲，写入与输出均在主循环上下文。
+ */
+
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <Arduino.h>
+
+// ==================== 日志级别 ====================
+#define LOG_LEVEL_NONE      0
+#define LOG_LEVEL_ERROR     1
+#define LOG_LEVEL_WARN      2
+#define LOG_LEVEL_INFO      3
+#define LOG_LEVEL_DEBUG     4
+#define LOG_LEVEL_VERBOSE   5
+
+#ifndef LOG_LEVEL
+#ifdef CORE_DEBUG_LEVEL
+#define LOG_LEVEL CORE_DEBUG_LEVEL
+#else
+#define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+#endif
+
+// 环形缓冲区大小 (必须为 2 的幂)
+#ifndef LOG_BUFFER_SIZE
+#define LOG_BUFFER_SIZE     2048
+#endif
+
+// 单条日志最大长度 (含时间戳前缀)
+#define LOG_LINE_MAX        128
+
+// 空闲等待时的输出间隔 (115200 波特率约 11.5 字节/毫秒，FIFO 128 字节)
+#define LOG_IDLE_SLICE_MS   5
+
+// 丢弃计数
+extern uint32_t g_log_dropped;
+
+// ==================== 函数声明 ====================
+
+/**
+ * 格式化一条日志写入缓冲区 (不阻塞)
+ * @param level 日志级别
+ * @param fmt PROGMEM 格式串
+ */
+void log_write(uint8_t level, PGM_P fmt, ...) __attribute__((format(printf, 2, 3)));
+
+/**
+ * 按串口 FIFO 剩余空间输出缓冲区内容 (不阻塞)
+ * @return 本次输出字节数
+ */
+size_t log_drain(void);
+
+/**
+ * 缓冲区中是否还有待输出内容
+ */
+bool log_pending(void);
+
+/**
+ * 阻塞输出全部日志
+ */
+void log_flush(void);
+
+/**
+ * 空闲等待指定时间，期间持续输出日志
+ * @param ms 等待时间 (毫秒)
+ */
+void log_idle(uint32_t ms);
+
+// ==================== 日志宏 ====================
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_E(fmt, ...) log_write(LOG_LEVEL_ERROR, PSTR(fmt), ##__VA_ARGS__)
+#else
+#define LOG_E(fmt, ...) do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOG_W(fmt, ...) log_write(LOG_LEVEL_WARN, PSTR(fmt), ##__VA_ARGS__)
+#else
+#define LOG_W(fmt, ...) do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_I(fmt, ...) log_write(LOG_LEVEL_INFO, PSTR(fmt), ##__VA_ARGS__)
+#else
+#define LOG_I(fmt, ...) do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_D(fmt, ...) log_write(LOG_LEVEL_DEBUG, PSTR(fmt), ##__VA_ARGS__)
+#else
+#define LOG_D(fmt, ...) do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_VERBOSE
+#define LOG_V(fmt, ...) log_write(LOG_LEVEL_VERBOSE, PSTR(fmt), ##__VA_ARGS__)
+#else
+#define LOG_V(fmt, ...) do {} while (0)
+#endif
+
+#endif  // LOGGER_H
@@ -34,7 +34,20 @@
 
 #include "pan3031.h"
 #include "water_system.h"
+#include "master_core.h"  // 水塔表、帧处理与自动控制
+#include "mesh_master.h"  // 中继网络 (路由通告、经中继的上报帧)
 #include "sr595.h"  // 74HC595 驱动
+#include "trace.h"  // 周期计数器追踪
+#include "frame_capture.h"  // LoRa 帧捕获
+#include "error_codes.h"
+#include "logger.h"   // 异步日志
+#include "warm_boot.h"  // 热启动恢复
+#include "wifi_manager.h"  // WiFi 连接管理
+#include "event_stream.h"  // SSE 状态推送
+#include "api_cache.h"  // REST 响应缓存
+#include "cbor.h"  // CBOR 编码
+#include "mqtt_telemetry.h"  // MQTT 遥测
+#include "dashboard_html.h"  // 网页控制台 (构建时由 web/index.html 生成)
 
 // ==================== 引脚定义 ====================
 // OLED (I2C)
@@ -57,16 +70,37 @@
 // 缺水传感器
 #define WATER_LOW_SENSOR D0  // GPIO16
 
+// ==================== 主循环节拍 ====================
+// 每次循环后的空闲时间 (期间输出缓冲日志)
+#define LOOP_IDLE_MS  100
+
+// ==================== 网页控制台 ====================
+// 浏览器缓存时长 (秒)，过期后按 ETag 验证，内容未变只返回 304
+#define DASHBOARD_MAX_AGE  "86400"
+
+// ==================== 显示调度 ====================
+// OLED 刷新最小间隔 (整屏 I2C 传输较慢，不在每次状态变化时同步刷新)
+#define DISPLAY_INTERVAL_MS  200
+
 // ==================== WiFi 配置 ====================
 const char* WIFI_SSID = "YourWiFiSSID";
 const char* WIFI_PASS = "YourWiFiPassword";
 
+// 备用热点 (路由器不可用时开启，地址 192.168.4.1)
+const char* WIFI_AP_SSID = "WaterTower";
+const char* WIFI_AP_PASS = "watertower";
+
+// ==================== MQTT 配置 ====================
+// 遥测上报服务器 (主题见 mqtt_telemetry.h)
+const char* MQTT_HOST = "192.168.1.100";
+const uint16_t MQTT_PORT = 1883;
+
 // ==================== 全局变量 ====================
 ESP8266WebServer server(80);
 Adafruit_SSD1306 display(128, 64, &Wire, OLED_RST);
 
 TowerData towers[MAX_TOWERS];
-uint8_t tower_count = 0;
+uint16_t tower_count = 0;
 
 SystemStatus sys_status = {
     .mode = MODE_AUTO,
@@ -80,45 +114,152 @@ SystemStatus sys_status = {
 void setup_wifi();
 void setup_oled();
 void setup_pan3031();
-void setup_sr595();
+void setup_sr595(uint8_t relay_state);
 void setup_server();
 void update_oled_display();
+void display_request_refresh();
+void display_task(uint32_t now);
 void handle_network_comm();
 void check_well_water();
 void control_pump(uint8_t tower_id, bool on);
+uint8_t control_pumps(uint8_t set_mask, uint8_t clear_mask);
 void process_auto_mode();
 void save_history();
 void send_history_json(uint8_t tower_id);
-uint8_t find_tower(uint8_t id);
+void handle_serial_command();
+void print_mesh_stats();
+void persist_state();
+void capture_snapshot();
+void send_capture_info();
+
+// ==================== 控制核心 ====================
+// 74HC595 只有 8 路继电器，位图正好一个字节
+static_assert(MASTER_RELAY_BYTES == 1, "74HC595 继电器映像应为 1 字节");
+
+// 最近一次记录到捕获中的继电器输出
+static uint8_t capture_relay_bits = 0;
+
+static bool core_relay_write(void* ctx, const uint8_t* bits, uint16_t count) {
+    sr595_write(bits[0]);
+    if (capture_active() && bits[0] != capture_relay_bits) {
+        capture_relay_bits = bits[0];
+        capture_record(CAPTURE_RELAY, bits, MASTER_RELAY_BYTES);
+    }
+    return true;
+}
+
+static void core_tower_changed(void* ctx, uint16_t index, uint8_t what) {
+    if (what & MASTER_CHANGE_PUMP) {
+        if (towers[index].pump_on) LOG_I("✅ 水塔 %u 开启水泵", index);
+        else LOG_I("❌ 水塔 %u 关闭水泵", index);
+    }
+    event_stream_publish_tower(&towers[index]);
+}
+
+static void core_status_changed(void* ctx) {
+    event_stream_publish_status();
+}
+
+/**
+ * 一批变化处理完：保存到 RTC 内存 (热启动恢复用)，使 REST 缓存失效，请求刷新 OLED
+ */
+static void core_committed(void* ctx) {
+    persist_state();
+    api_cache_invalidate();
+    display_request_refresh();
+}
+
+static void core_alarm(void* ctx, MasterAlarm_t alarm) {
+    if (alarm == MASTER_ALARM_WELL_LOW) {
+        error_log(ERR_SENSOR_WATER_LOW, ERR_LEVEL_CRITICAL, 0xFF);
+        LOG_W("🚨 紧急停止！关闭所有水泵");
+    }
+}
+
+static const MasterHooks_t core_hooks = {
+    .relay_write = core_relay_write,
+    .tower_changed = core_tower_changed,
+    .status_changed = core_status_changed,
+    .committed = core_committed,
+    .alarm = core_alarm
+};
+
+MasterCore_t master = {
+    .towers = towers,
+    .tower_count = &tower_count,
+    .status = &sys_status,
+    .relay_count = 8,
+    .hooks = &core_hooks,
+    .ctx = NULL
+};
+
+MeshMaster_t mesh;  // 中继路由和按跳延迟统计 (重启后由从机上报重新建立)
+
+// ==================== HTTP 分块输出 ====================
+/**
+ * 把 Print 输出按块转发给 Web 服务器 (Transfer-Encoding: chunked)
+ * 用于导出体积较大的数据，避免拼接整段 String 占用堆内存
+ */
+class ServerChunkPrint : public Print {
+public:
+    size_t write(uint8_t c) override {
+        buf_[len_++] = c;
+        if (len_ == sizeof(buf_)) flush_chunk();
+        return 1;
+    }
+    void flush_chunk() {
+        if (len_ > 0) {
+            server.sendContent(buf_, len_);
+            len_ = 0;
+        }
+    }
+private:
+    char buf_[256];
+    size_t len_ = 0;
+};
 
 // ==================== 初始化 ====================
 void setup() {
+    // 热启动：最先恢复继电器输出和控制状态，再进行慢速初始化
+    uint8_t relay_state = 0x00;
+    warm_boot_restore(towers, &tower_count, &sys_status, &relay_state);
+    setup_sr595(relay_state);
+    master_core_begin(&master, &relay_state);
+    mesh_master_begin(&mesh);
+    
     Serial.begin(115200);
-    Serial.println("\n=== 水塔监控主机启动 v2.1 (74HC595) ===");
+    LOG_I("=== 水塔监控主机启动 v2.1 (74HC595) ===");
+    if (warm_boot_is_warm()) {
+        LOG_I("♻️ 热启动：恢复继电器 0x%02X，%u 个水塔", relay_state, tower_count);
+    }
     
     // 初始化各模块
+    error_init();
     setup_oled();
+    boot_phase_mark(BOOT_PHASE_OLED);
     setup_pan3031();
-    setup_sr595();  // 新增：74HC595 初始化
+    boot_phase_mark(BOOT_PHASE_LORA);
+    if (capture_begin()) capture_snapshot();
     setup_wifi();
+    boot_phase_mark(BOOT_PHASE_WIFI);
     setup_server();
+    boot_phase_mark(BOOT_PHASE_SERVER);
     
     // 显示欢迎界面
     display.clearDisplay();
     display.setTextSize(1);
     display.setCursor(0, 0);
-    display.println("水塔监控系统");
-    display.println("主机 v2.1");
-    display.print("WiFi: ");
-    display.println(sys_status.wifi_connected ? "OK" : "NG");
-    display.print("LoRa: 434MHz SF7");
-    display.println("Relay: 74HC595 x8");
+    display.println(F("水塔监控系统"));
+    display.println(F("主机 v2.1"));
+    display.print(F("WiFi: "));
+    display.println(F("connecting"));
+    display.print(F("LoRa: 434MHz SF7"));
+    display.println(F("Relay: 74HC595 x8"));
     display.display();
     
-    Serial.println("系统初始化完成");
-    Serial.print("支持最多 ");
-    Serial.print(MAX_TOWERS);
-    Serial.println(" 个水塔");
+    LOG_I("系统初始化完成");
+    LOG_I("支持最多 %d 个水塔", MAX_TOWERS);
+    log_flush();
 }
 
 // ==================== 模块初始化 ====================
@@ -135,68 +276,239 @@ void setup_pan3031() {
     pan3031_set_sf(7);
     pan3031_set_bw(125000UL);
     pan3031_set_power(20);
-    Serial.println("✅ PAN3031 LoRa 初始化完成");
+    LOG_I("✅ PAN3031 LoRa 初始化完成");
 }
 
-void setup_sr595() {
-    // 初始化 74HC595
-    sr595_init();
+void setup_sr595(uint8_t relay_state) {
+    // 初始化 74HC595 (热启动直接输出恢复的继电器状态)
+    sr595_init_state(relay_state);
+    boot_phase_mark(BOOT_PHASE_RELAY);
+    
+    // 热启动不做继电器测试，避免水泵启停
+    if (warm_boot_is_warm()) return;
     
     // 测试继电器
-    Serial.println("🧪 测试继电器...");
+    LOG_I("🧪 测试继电器...");
     sr595_set_all(0xFF);  // 全部开启
     delay(200);
     sr595_set_all(0x00);  // 全部关闭
 }
 
 void setup_wifi() {
-    Serial.print("Connecting to WiFi: ");
-    Serial.println(WIFI_SSID);
-    WiFi.begin(WIFI_SSID, WIFI_PASS);
-    
-    int timeout = 0;
-    while (WiFi.status() != WL_CONNECTED && timeout < 30) {
-        delay(500);
-        Serial.print(".");
-        timeout++;
+    // 后台连接，不等待 (断线重连和备用热点由 wifi_manager 负责)
+    wifi_manager_begin(WIFI_SSID, WIFI_PASS, WIFI_AP_SSID, WIFI_AP_PASS);
+    
+    // MQTT 在 WiFi 连接后由 mqtt_telemetry_loop() 自动连接
+    mqtt_telemetry_begin(MQTT_HOST, MQTT_PORT);
+}
+
+// ==================== REST 响应 ====================
+// 由 api_cache 在状态版本变化后调用，结果按版本缓存
+
+static void build_status_json(String& json) {
+    json += F("{\"wifi\":");
+    json += sys_status.wifi_connected ? F("true") : F("false");
+    json += F(",\"ap\":");
+    json += wifi_manager_ap_active() ? F("true") : F("false");
+    json += F(",\"mode\":\"");
+    json += sys_status.mode == MODE_AUTO ? F("AUTO") : F("MANUAL");
+    json += F("\",\"well_water\":");
+    json += sys_status.well_water_ok ? F("true") : F("false");
+    json += F(",\"towers\":");
+    json += tower_count;
+    json += F(",\"warm_boot\":");
+    json += warm_boot_is_warm() ? F("true") : F("false");
+    json += F(",\"boot_ms\":");
+    json += boot_time_to_control_ms();
+    json += F(",\"sse_clients\":");
+    json += event_stream_clients();
+    json += '}';
+}
+
+static void build_towers_json(String& json) {
+    json += '[';
+    for (int i = 0; i < tower_count; i++) {
+        if (i > 0) json += ',';
+        json += F("{\"id\":");
+        json += towers[i].id;
+        json += F(",\"level\":");
+        json += towers[i].water_level;
+        json += F(",\"pump\":");
+        json += towers[i].pump_on ? F("true") : F("false");
+
+        // 最近一次上报的采样窗口 (旧格式的从机没有)
+        const TowerWindow& w = towers[i].window;
+        if (w.samples) {
+            json += F(",\"window\":{\"samples\":");
+            json += w.samples;
+            json += F(",\"min\":");
+            json += w.level_min;
+            json += F(",\"max\":");
+            json += w.level_max;
+            json += F(",\"changes\":");
+            json += w.changes;
+            if (w.channel_count) {
+                json += F(",\"channels\":[");
+                for (uint8_t k = 0; k < w.channel_count; k++) {
+                    if (k > 0) json += ',';
+                    json += w.channels[k];
+                }
+                json += ']';
+            }
+            json += '}';
+        }
+        json += '}';
+    }
+    json += ']';
+}
+
+/**
+ * 水塔列表 (CBOR)，每个水塔为定长数组 [id, level, pump, window]
+ * window 为 [samples, min, max, changes, [channels...]]，旧格式的从机为 null
+ */
+static void build_towers_cbor(String& body) {
+    // 每个水塔最多 6 字节，窗口最多 10 字节加每个通道图 3 字节
+    uint8_t buf[4 + MAX_TOWERS * (6 + 10 + WINDOW_SAMPLES_MAX * 3)];
+    CborWriter_t w;
+    cbor_init(&w, buf, sizeof(buf));
+    cbor_array(&w, tower_count);
+    for (int i = 0; i < tower_count; i++) {
+        cbor_array(&w, 4);
+        cbor_uint(&w, towers[i].id);
+        cbor_uint(&w, towers[i].water_level);
+        cbor_bool(&w, towers[i].pump_on);
+
+        const TowerWindow& win = towers[i].window;
+        if (win.samples == 0) {
+            cbor_null(&w);
+            continue;
+        }
+        cbor_array(&w, 5);
+        cbor_uint(&w, win.samples);
+        cbor_uint(&w, win.level_min);
+        cbor_uint(&w, win.level_max);
+        cbor_uint(&w, win.changes);
+        cbor_array(&w, win.channel_count);
+        for (uint8_t k = 0; k < win.channel_count; k++) {
+            cbor_uint(&w, win.channels[k]);
+        }
+    }
+    if (cbor_ok(&w)) body.concat((const char*)buf, w.len);
+}
+
+// ==================== 网页控制台 ====================
+
+/**
+ * 发送网页控制台
+ * 预先压缩的内容直接从闪存发送 (Content-Encoding: gzip)，主机不做解压
+ */
+static void send_dashboard() {
+    server.sendHeader("ETag", DASHBOARD_ETAG);
+    server.sendHeader("Cache-Control", "public, max-age=" DASHBOARD_MAX_AGE);
+    
+    if (api_cache_if_none_match(DASHBOARD_ETAG)) {
+        server.send(304);
+        return;
     }
     
-    if (WiFi.status() == WL_CONNECTED) {
-        sys_status.wifi_connected = true;
-        Serial.println("\n✅ WiFi connected");
-        Serial.print("IP: ");
-        Serial.println(WiFi.localIP());
-    } else {
-        sys_status.wifi_connected = false;
-        Serial.println("\n❌ WiFi timeout");
+    server.sendHeader("Content-Encoding", "gzip");
+    server.send_P(200, PSTR("text/html; charset=utf-8"),
+                  (PGM_P)dashboard_html_gz, DASHBOARD_HTML_GZ_LEN);
+}
+
+// ==================== 批量控制参数 ====================
+
+/**
+ * 解析 8 位掩码 (十进制或 0x 开头的十六进制)
+ * @return false=格式错误或超出 0-255
+ */
+static bool parse_mask(const String& text, uint8_t* mask) {
+    const char* s = text.c_str();
+    uint8_t base = 10;
+    if (s[0] == '0' && (s[1] == 'x' || s[1] == 'X')) {
+        base = 16;
+        s += 2;
+    }
+    if (*s == '\0') return false;
+
+    // 逐位解析 (strtoul 会接受前导空白、符号，并把 0 开头当作八进制)
+    uint16_t value = 0;
+    for (; *s != '\0'; s++) {
+        uint8_t digit;
+        if (*s >= '0' && *s <= '9') digit = *s - '0';
+        else if (base == 16 && *s >= 'a' && *s <= 'f') digit = *s - 'a' + 10;
+        else if (base == 16 && *s >= 'A' && *s <= 'F') digit = *s - 'A' + 10;
+        else return false;
+        value = value * base + digit;
+        if (value > 0xFF) return false;
+    }
+    *mask = (uint8_t)value;
+    return true;
+}
+
+/**
+ * 解析变更列表，例如 "0:on,3:off,5:on"
+ * 水泵编号只接受一位数字 0-7 (不用 strtoul，它会接受前导空白和符号)，不允许空项
+ * @return false=格式错误
+ */
+static bool parse_changes(const String& text, uint8_t* set_mask, uint8_t* clear_mask) {
+    const char* p = text.c_str();
+    while (true) {
+        if (*p < '0' || *p > '7') return false;
+        uint8_t id = *p++ - '0';
+        if (*p++ != ':') return false;
+        
+        if (strncmp(p, "on", 2) == 0) {
+            *set_mask |= (1 << id);
+            p += 2;
+        } else if (strncmp(p, "off", 3) == 0) {
+            *clear_mask |= (1 << id);
+            p += 3;
+        } else {
+            return false;
+        }
+        
+        if (*p == '\0') return true;
+        if (*p++ != ',') return false;
     }
 }
 
 void setup_server() {
+    api_cache_begin();
+    
+    // 网页控制台
+    server.on("/", HTTP_GET, send_dashboard);
+    server.on("/index.html", HTTP_GET, send_dashboard);
+    
     // 系统状态
     server.on("/api/status", HTTP_GET, []() {
-        String json = "{";
-        json += "\"wifi\":" + String(sys_status.wifi_connected ? "true" : "false");
-        json += ",\"mode\":\"" + String(sys_status.mode == MODE_AUTO ? "AUTO" : "MANUAL") + "\"";
-        json += ",\"well_water\":" + String(sys_status.well_water_ok ? "true" : "false");
-        json += ",\"towers\":" + String(tower_count);
-        json += "}";
-        server.send(200, "application/json", json);
+        api_cache_send(API_CACHE_STATUS, "application/json", build_status_json);
     });
     
     // 获取水塔列表
     server.on("/api/towers", HTTP_GET, []() {
-        String json = "[";
-        for (int i = 0; i < tower_count; i++) {
-            if (i > 0) json += ",";
-            json += "{";
-            json += "\"id\":" + String(towers[i].id);
-            json += ",\"level\":" + String(towers[i].water_level);
-            json += ",\"pump\":" + String(towers[i].pump_on ? "true" : "false");
-            json += "}";
+        if (api_cache_accepts("application/cbor")) {
+            api_cache_send(API_CACHE_TOWERS_CBOR, "application/cbor", build_towers_cbor);
+        } else {
+            api_cache_send(API_CACHE_TOWERS, "application/json", build_towers_json);
+        }
+    });
+    
+    // 错误日志
+    server.on("/api/errors", HTTP_GET, []() {
+        if (api_cache_accepts("application/cbor")) {
+            static uint8_t buf[ERROR_CBOR_MAX];
+            size_t len = error_export_cbor(buf, sizeof(buf));
+            server.sendHeader("Vary", "Accept");
+            if (len == 0) {
+                server.send(500, "text/plain", F("CBOR buffer overflow"));
+                return;
+            }
+            server.send(200, "application/cbor", (const char*)buf, len);
+        } else {
+            server.sendHeader("Vary", "Accept");
+            server.send(200, "application/json", error_export_json());
         }
-        json += "]";
-        server.send(200, "application/json", json);
     });
     
     // 控制水泵
@@ -204,181 +516,420 @@ void setup_server() {
         uint8_t tower_id = server.arg("id").toInt();
         bool action = server.arg("action") == "on";
         control_pump(tower_id, action);
-        server.send(200, "text/plain", "OK");
+        server.send(200, "text/plain", F("OK"));
+    });
+    
+    // 批量控制水泵
+    // 参数: set=<掩码> clear=<掩码> 或 changes=0:on,3:off (可组合)
+    // 整个请求校验通过后一次写入继电器，返回切换后的状态
+    server.on("/api/pumps", HTTP_POST, []() {
+        uint8_t set_mask = 0;
+        uint8_t clear_mask = 0;
+        uint8_t mask;
+        bool ok = server.hasArg("set") || server.hasArg("clear") || server.hasArg("changes");
+        
+        if (ok && server.hasArg("set")) {
+            ok = parse_mask(server.arg("set"), &mask);
+            set_mask |= mask;
+        }
+        if (ok && server.hasArg("clear")) {
+            ok = parse_mask(server.arg("clear"), &mask);
+            clear_mask |= mask;
+        }
+        if (ok && server.hasArg("changes")) {
+            ok = parse_changes(server.arg("changes"), &set_mask, &clear_mask);
+        }
+        if (!ok) {
+            server.send(400, "text/plain", F("Invalid set/clear/changes"));
+            return;
+        }
+        if (set_mask & clear_mask) {
+            server.send(400, "text/plain", F("Pump both set and cleared"));
+            return;
+        }
+        uint8_t valid = (tower_count >= 8) ? 0xFF : (uint8_t)((1 << tower_count) - 1);
+        if ((set_mask | clear_mask) & ~valid) {
+            server.send(400, "text/plain", F("Unknown tower"));
+            return;
+        }
+        
+        uint8_t changed = control_pumps(set_mask, clear_mask);
+        
+        String json = F("{\"relays\":");
+        json += sr595_get_state();
+        json += F(",\"changed\":");
+        json += changed;
+        json += F(",\"towers\":");
+        build_towers_json(json);
+        json += '}';
+        server.send(200, "application/json", json);
     });
     
     // 模式切换
     server.on("/api/mode", HTTP_POST, []() {
         String mode = server.arg("mode");
-        sys_status.mode = (mode == "AUTO") ? MODE_AUTO : MODE_MANUAL;
-        server.send(200, "text/plain", "OK");
+        uint8_t value = (mode == "AUTO") ? MODE_AUTO : MODE_MANUAL;
+        capture_record(CAPTURE_MODE, &value, 1);
+        master_core_set_mode(&master, (SystemMode)value);
+        server.send(200, "text/plain", F("OK"));
+    });
+    
+    // 状态变化推送 (Server-Sent Events)
+    server.on("/api/events", HTTP_GET, []() {
+        if (!event_stream_subscribe(server.client())) {
+            server.send(503, "text/plain", F("Too many subscribers"));
+        }
+    });
+    
+    // 导出追踪缓冲区 (Chrome trace-event JSON)
+    server.on("/api/trace", HTTP_GET, []() {
+        server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+        server.send(200, "application/json", emptyString);
+        ServerChunkPrint out;
+        trace_dump(out);
+        out.flush_chunk();
+        server.sendContent("");
+        if (server.arg("reset") == "1") trace_reset();
+    });
+    
+    // LoRa 帧捕获：GET 导出 pcap，POST action=start|stop，/info 查询状态
+    server.on("/api/capture", HTTP_GET, []() {
+        server.sendHeader("Content-Disposition", "attachment; filename=\"capture.pcap\"");
+        server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+        server.send(200, "application/vnd.tcpdump.pcap", emptyString);
+        ServerChunkPrint out;
+        capture_export(out);
+        out.flush_chunk();
+        server.sendContent("");
+    });
+    server.on("/api/capture", HTTP_POST, []() {
+        String action = server.arg("action");
+        if (action == "start") {
+            if (!capture_start()) {
+                server.send(503, "text/plain", F("No flash partition"));
+                return;
+            }
+            capture_snapshot();
+            LOG_I("📼 开始帧捕获");
+        } else if (action == "stop") {
+            capture_stop();
+            LOG_I("📼 停止帧捕获");
+        } else {
+            server.send(400, "text/plain", F("Expected action=start|stop"));
+            return;
+        }
+        send_capture_info();
     });
+    server.on("/api/capture/info", HTTP_GET, send_capture_info);
     
     server.begin();
-    Serial.println("✅ Web 服务器启动");
+    LOG_I("✅ Web 服务器启动");
 }
 
 // ==================== 水泵控制 (使用 74HC595) ====================
 
 /**
  * 控制水泵
- * 使用 74HC595 控制继电器
+ * 由控制核心更新继电器映像并写入 74HC595
  */
 void control_pump(uint8_t tower_id, bool on) {
-    if (tower_id >= tower_count || tower_id > 7) {
-        Serial.println("❌ 无效的水塔 ID");
-        return;
+    if (tower_id < 8) {
+        uint8_t mask = (uint8_t)(1 << tower_id);
+        uint8_t cmd[2] = { on ? mask : (uint8_t)0, on ? (uint8_t)0 : mask };
+        capture_record(CAPTURE_PUMPS, cmd, sizeof(cmd));
     }
-    
-    // 使用 74HC595 控制继电器
-    if (on) {
-        sr595_relay_on(tower_id);
-        towers[tower_id].pump_on = true;
-        Serial.print("✅ 水塔 ");
-        Serial.print(tower_id);
-        Serial.println(" 开启水泵");
-    } else {
-        sr595_relay_off(tower_id);
-        towers[tower_id].pump_on = false;
-        Serial.print("❌ 水塔 ");
-        Serial.print(tower_id);
-        Serial.println(" 关闭水泵");
+    if (!master_core_set_pump(&master, tower_id, on)) {
+        LOG_E("❌ 无效的水塔 ID: %u", tower_id);
     }
+}
+
+/**
+ * 批量控制水泵
+ * 继电器一次写入同时切换，保存、推送和刷新各只做一次
+ * @param set_mask 开启的水泵 (bit i = 水塔 i)
+ * @param clear_mask 关闭的水泵
+ * @return 状态实际发生变化的水泵
+ */
+uint8_t control_pumps(uint8_t set_mask, uint8_t clear_mask) {
+    uint8_t changed = 0;
+    uint8_t cmd[2] = { set_mask, clear_mask };
+    capture_record(CAPTURE_PUMPS, cmd, sizeof(cmd));
+    if (master_core_apply(&master, &set_mask, &clear_mask, &changed) == 0) return 0;
     
-    // 更新 OLED 显示
-    update_oled_display();
+    LOG_I("✅ 批量切换水泵：0x%02X (变化 0x%02X)", sr595_get_state(), changed);
+    return changed;
+}
+
+/**
+ * 保存控制状态到 RTC 内存
+ */
+void persist_state() {
+    warm_boot_save(towers, tower_count, &sys_status, sr595_get_state());
 }
 
+// ==================== 帧捕获 ====================
+
 /**
- * 紧急停止 - 关闭所有水泵
+ * 写入快照：系统状态和全部水塔 (每段捕获的开头，回放从这里重建控制核心)
  */
-void emergency_stop() {
-    Serial.println("🚨 紧急停止！关闭所有水泵");
-    sr595_set_all(0x00);  // 使用 74HC595 关闭所有继电器
+void capture_snapshot() {
+    if (!capture_active()) return;
     
-    for (int i = 0; i < tower_count; i++) {
-        towers[i].pump_on = false;
-    }
+    uint8_t snap[CAPTURE_SNAPSHOT_FIXED + MASTER_RELAY_BYTES];
+    snap[0] = (uint8_t)sys_status.mode;
+    snap[1] = sys_status.well_water_ok ? 1 : 0;
+    snap[2] = (uint8_t)tower_count;
+    snap[3] = (uint8_t)(tower_count >> 8);
+    snap[4] = (uint8_t)master.relay_count;
+    snap[5] = (uint8_t)(master.relay_count >> 8);
+    snap[6] = (uint8_t)MAX_TOWERS;
+    snap[7] = (uint8_t)(MAX_TOWERS >> 8);
+    memcpy(&snap[CAPTURE_SNAPSHOT_FIXED], master.relays, MASTER_RELAY_BYTES);
+    capture_record(CAPTURE_SNAPSHOT, snap, sizeof(snap));
     
-    update_oled_display();
+    for (uint16_t i = 0; i < tower_count; i++) {
+        const TowerData* t = &towers[i];
+        uint8_t rec[CAPTURE_TOWER_LEN] = {
+            t->id, t->water_level, (uint8_t)(t->pump_on ? 1 : 0), (uint8_t)(t->online ? 1 : 0),
+            (uint8_t)t->last_update, (uint8_t)(t->last_update >> 8),
+            (uint8_t)(t->last_update >> 16), (uint8_t)(t->last_update >> 24)
+        };
+        capture_record(CAPTURE_TOWER, rec, sizeof(rec));
+    }
+    capture_relay_bits = master.relays[0];
+}
+
+void send_capture_info() {
+    CaptureStats_t st;
+    capture_get_stats(&st);
+    String json = F("{\"active\":");
+    json += st.active ? F("true") : F("false");
+    json += F(",\"records\":");
+    json += st.records;
+    json += F(",\"sectors\":");
+    json += st.used_sectors;
+    json += F(",\"capacity_sectors\":");
+    json += st.sectors;
+    json += F(",\"write_errors\":");
+    json += st.write_errors;
+    json += '}';
+    server.send(200, "application/json", json);
 }
 
 // ==================== 自动控制逻辑 ====================
 
+/**
+ * 自动控制
+ * 先读取本地缺水传感器，阈值和缺水保护策略见 master_core_auto()
+ */
 void process_auto_mode() {
     if (sys_status.mode != MODE_AUTO) return;
     
-    // 检查井水缺水
     check_well_water();
-    if (!sys_status.well_water_ok) {
-        emergency_stop();
-        return;
-    }
-    
-    // 自动水位控制
-    for (int i = 0; i < tower_count; i++) {
-        // 水位低于 20% 开启水泵
-        if (towers[i].water_level < 20 && !towers[i].pump_on) {
-            control_pump(i, true);
-            Serial.print("水塔 ");
-            Serial.print(i);
-            Serial.println(" 水位低，开启水泵");
-        }
-        // 水位高于 90% 关闭水泵
-        else if (towers[i].water_level > 90 && towers[i].pump_on) {
-            control_pump(i, false);
-            Serial.print("水塔 ");
-            Serial.print(i);
-            Serial.println(" 水位高，关闭水泵");
-        }
-    }
+    master_core_auto(&master);
 }
 
 // ==================== OLED 显示 ====================
 
 void update_oled_display() {
+    TRACE_SCOPE(TRACE_SPAN_OLED);
+    
     display.clearDisplay();
     display.setCursor(0, 0);
     
     // 状态栏
-    display.print("Mode:");
-    display.print(sys_status.mode == MODE_AUTO ? "AUTO" : "MANUAL");
-    display.print(" | Well:");
-    display.println(sys_status.well_water_ok ? "OK" : "LOW");
+    display.print(F("Mode:"));
+    display.print(sys_status.mode == MODE_AUTO ? F("AUTO") : F("MANUAL"));
+    display.print(F(" | Well:"));
+    display.println(sys_status.well_water_ok ? F("OK") : F("LOW"));
     
     // 水塔状态
     for (int i = 0; i < tower_count && i < 4; i++) {
-        display.print("T");
+        display.print(F("T"));
         display.print(i);
-        display.print(":");
+        display.print(F(":"));
         display.print(towers[i].water_level);
-        display.print("% ");
-        display.println(towers[i].pump_on ? "[PUMP]" : "    ");
+        display.print(F("% "));
+        display.println(towers[i].pump_on ? F("[PUMP]") : F("    "));
     }
     
     display.display();
 }
 
+// 是否有待刷新的状态变化
+static bool display_dirty = true;
+static uint32_t display_last = 0;
+
+/**
+ * 请求刷新 OLED
+ * 只置标志，实际绘制在 display_task() 中进行
+ */
+void display_request_refresh() {
+    display_dirty = true;
+}
+
+/**
+ * 显示调度
+ * 按 DISPLAY_INTERVAL_MS 节拍刷新；有报警浮层时绘制浮层 (含闪烁)，否则绘制常规界面
+ */
+void display_task(uint32_t now) {
+    if (now - display_last < DISPLAY_INTERVAL_MS) return;
+    
+    if (error_alert_render(now)) {
+        display_last = now;
+        display_dirty = true;  // 浮层结束后恢复常规界面
+        return;
+    }
+    
+    if (!display_dirty) return;
+    
+    display_last = now;
+    display_dirty = false;
+    update_oled_display();
+}
+
 // ==================== 主循环 ====================
 
 void loop() {
+    TRACE_BEGIN(TRACE_SPAN_LOOP);
+    capture_loop(millis());
+    
+    // WiFi 连接管理 (非阻塞)
+    wifi_manager_loop(millis());
+    static bool ap_active = false;
+    if (sys_status.wifi_connected != wifi_manager_connected()) {
+        sys_status.wifi_connected = wifi_manager_connected();
+        api_cache_invalidate();
+        event_stream_publish_status();
+    }
+    if (ap_active != wifi_manager_ap_active()) {
+        ap_active = wifi_manager_ap_active();
+        api_cache_invalidate();
+    }
+    
     // 处理 Web 服务器
+    TRACE_BEGIN(TRACE_SPAN_WEB);
     server.handleClient();
+    TRACE_END(TRACE_SPAN_WEB);
     
     // 处理 LoRa 通信
+    TRACE_BEGIN(TRACE_SPAN_LORA_RX);
     handle_network_comm();
+    TRACE_END(TRACE_SPAN_LORA_RX);
     
     // 自动控制
     if (sys_status.mode == MODE_AUTO) {
+        TRACE_SCOPE(TRACE_SPAN_AUTO);
         process_auto_mode();
     }
     
+    // 推送状态变化
+    event_stream_loop(millis());
+    static uint8_t sse_clients = 0;
+    if (event_stream_clients() != sse_clients) {
+        sse_clients = event_stream_clients();
+        api_cache_invalidate();  // /api/status 含订阅数
+    }
+    mqtt_telemetry_loop(millis());
+    
+    // 首次控制循环完成，输出启动耗时
+    static bool first_loop = true;
+    if (first_loop) {
+        first_loop = false;
+        boot_phase_mark(BOOT_PHASE_FIRST_CONTROL);
+        boot_phase_report();
+        api_cache_invalidate();  // boot_ms 已确定
+    }
+    
     // 更新显示
-    update_oled_display();
+    display_task(millis());
+    
+    // 串口调试命令
+    handle_serial_command();
+    
+    TRACE_END(TRACE_SPAN_LOOP);
+    
+    // 空闲时间输出缓冲日志
+    log_idle(LOOP_IDLE_MS);
+}
+
+/**
+ * 串口调试命令
+ * - 't': 导出追踪缓冲区
+ * - 'r': 清空追踪缓冲区
+ * - 'c': 输出 API 缓存统计
+ * - 'm': 输出中继网络统计
+ */
+void handle_serial_command() {
+    if (Serial.available() <= 0) return;
     
-    delay(100);
+    int c = Serial.read();
+    if (c == 't') {
+        log_flush();
+        trace_dump(Serial);
+    } else if (c == 'r') {
+        trace_reset();
+        LOG_I("✅ 追踪缓冲区已清空");
+    } else if (c == 'c') {
+        log_flush();
+        api_cache_print_stats(Serial);
+    } else if (c == 'm') {
+        log_flush();
+        print_mesh_stats();
+    }
+}
+
+/**
+ * 中继网络统计: 帧分类、每一跳 (从主机一侧起) 的驻留时间、经中继的水塔路径
+ */
+void print_mesh_stats() {
+    const MeshStats_t& s = mesh.stats;
+    Serial.printf_P(PSTR("中继网络: 直连 %lu, 经中继 %lu, 重复 %lu, 控制 %lu, 错误 %lu, 通告 %lu\n"),
+                    (unsigned long)s.direct, (unsigned long)s.relayed, (unsigned long)s.duplicates,
+                    (unsigned long)s.control, (unsigned long)s.bad, (unsigned long)s.beacons);
+    for (uint8_t j = 0; j < MESH_MAX_RELAYS; j++) {
+        const MeshHopStats_t& h = s.hop[j];
+        if (h.frames == 0) continue;
+        Serial.printf_P(PSTR("  第 %u 跳: %lu 帧, 驻留平均 %lu ms, 最大 %u ms\n"), j + 1,
+                        (unsigned long)h.frames, (unsigned long)(h.residency_sum_ms / h.frames),
+                        h.residency_max_ms);
+    }
+    for (uint16_t i = 0; i < tower_count; i++) {
+        const MeshRoute_t* r = mesh_master_route(&mesh, i);
+        if (r == NULL || r->hops == 0) continue;
+        Serial.printf_P(PSTR("  水塔 %u: 主机"), towers[i].id);
+        for (uint8_t j = 0; j < r->hops; j++) Serial.printf_P(PSTR(" -> %u"), r->path[j]);
+        Serial.printf_P(PSTR(" -> %u, 驻留 %u ms\n"), towers[i].id, r->residency_ms);
+    }
 }
 
 // ==================== LoRa 通信处理 ====================
 
 void handle_network_comm() {
-    uint8_t rx_data[8];
-    uint8_t len = 0;
-    bool ok = pan3031_receive(rx_data, &len);
+    // 中继网络的路由通告
+    uint8_t beacon[MESH_BEACON_LEN];
+    uint8_t beacon_len = mesh_master_beacon(&mesh, millis(), beacon);
+    if (beacon_len) {
+        pan3031_send(beacon, beacon_len);
+        capture_record(CAPTURE_TX, beacon, beacon_len);
+    }
     
-    if (!ok || len < 4) return;
+    uint8_t rx_data[32];  // pan3031_receive() 最多读出 32 字节
+    uint8_t len = 0;
+    if (!pan3031_receive(rx_data, &len)) return;
+    capture_record(CAPTURE_RX, rx_data, len, pan3031_packet_rssi(), pan3031_packet_snr());
     
-    // 处理传感器数据
-    if (rx_data[1] == CMD_QUERY) {
-        uint8_t tower_id = rx_data[0];
-        uint8_t water_level = rx_data[3];
-        uint8_t well_ok = rx_data[4];
-        
-        // 查找或添加水塔
-        int idx = find_tower(tower_id);
-        if (idx < 0 && tower_count < MAX_TOWERS) {
-            idx = tower_count++;
-            towers[idx].id = tower_id;
-            towers[idx].water_level = 0;
-            towers[idx].pump_on = false;
-        }
-        
-        if (idx >= 0) {
-            towers[idx].water_level = water_level;
-            sys_status.well_water_ok = well_ok;
-        }
-    }
+    // 经中继的帧拆出内层；解析、更新水塔表和推送由控制核心完成
+    mesh_master_handle_frame(&mesh, &master, rx_data, len, millis(), NULL);
 }
 
 void check_well_water() {
-    sys_status.well_water_ok = (digitalRead(WATER_LOW_SENSOR) == HIGH);
-}
-
-uint8_t find_tower(uint8_t id) {
-    for (int i = 0; i < tower_count; i++) {
-        if (towers[i].id == id) return i;
+    bool ok = digitalRead(WATER_LOW_SENSOR) == HIGH;
+    if (ok != sys_status.well_water_ok) {
+        uint8_t value = ok ? 1 : 0;
+        capture_record(CAPTURE_WELL, &value, 1);
     }
-    return -1;
+    master_core_set_well(&master, ok);
 }
 
 void save_history() {
@@ -0,0 +1,295 @@
+/*
+ * 主机控制核心实现
+ */
+
+#include "master_core.h"
+#include <string.h>
+
+// ==================== 内部函数 ====================
+
+static inline bool bit_get(const uint8_t* bits, uint16_t i) {
+    return (bits[i >> 3] >> (i & 7)) & 0x01;
+}
+
+static inline void bit_put(uint8_t* bits, uint16_t i, bool on) {
+    if (on) bits[i >> 3] |= (uint8_t)(1 << (i & 7));
+    else bits[i >> 3] &= (uint8_t)~(1 << (i & 7));
+}
+
+static void notify_tower(MasterCore_t* core, uint16_t index, uint8_t what) {
+    if (core->hooks->tower_changed) core->hooks->tower_changed(core->ctx, index, what);
+}
+
+static void notify_status(MasterCore_t* core) {
+    if (core->hooks->status_changed) core->hooks->status_changed(core->ctx);
+}
+
+static void commit(MasterCore_t* core) {
+    if (core->hooks->committed) core->hooks->committed(core->ctx);
+}
+
+/**
+ * 可控制的水泵数量 (水塔数量与继电器路数的较小者)
+ */
+static uint16_t pump_count(const MasterCore_t* core) {
+    return *core->tower_count < core->relay_count ? *core->tower_count : core->relay_count;
+}
+
+// ==================== 初始化 ====================
+
+void master_core_begin(MasterCore_t* core, const uint8_t* relay_state) {
+    if (core->relay_count > MAX_TOWERS) core->relay_count = MAX_TOWERS;
+    if (*core->tower_count > MAX_TOWERS) *core->tower_count = MAX_TOWERS;
+
+    if (relay_state) memcpy(core->relays, relay_state, sizeof(core->relays));
+    else memset(core->relays, 0, sizeof(core->relays));
+
+    core->well_alarm = false;
+    memset(core->index_by_id, 0xFF, sizeof(core->index_by_id));
+    for (uint16_t i = 0; i < *core->tower_count; i++) {
+        core->index_by_id[core->towers[i].id] = (MasterIndex_t)i;
+    }
+}
+
+bool master_core_write_relays(MasterCore_t* core) {
+    return core->hooks->relay_write(core->ctx, core->relays, core->relay_count);
+}
+
+// ==================== 水塔表 ====================
+
+int master_core_find(const MasterCore_t* core, uint8_t id) {
+    MasterIndex_t idx = core->index_by_id[id];
+    return idx == MASTER_NO_INDEX ? -1 : (int)idx;
+}
+
+/**
+ * 加入新水塔
+ * @return 水塔索引，-1=水塔表已满
+ */
+static int add_tower(MasterCore_t* core, uint8_t id) {
+    if (*core->tower_count >= MAX_TOWERS) return -1;
+
+    uint16_t idx = (*core->tower_count)++;
+    TowerData* t = &core->towers[idx];
+    memset(t, 0, sizeof(*t));
+    t->id = id;
+    core->index_by_id[id] = (MasterIndex_t)idx;
+    return idx;
+}
+
+// ==================== 帧处理 ====================
+
+/**
+ * 解析上报帧的采样窗口 (旧格式的帧没有，全部为 0)
+ */
+static void parse_window(const uint8_t* frame, uint8_t len, TowerWindow* w) {
+    memset(w, 0, sizeof(*w));
+    if (len < WINDOW_MAPS) return;
+
+    w->samples = frame[WINDOW_SAMPLES];
+    w->level_min = frame[WINDOW_LEVEL_MIN];
+    w->level_max = frame[WINDOW_LEVEL_MAX];
+    w->changes = frame[WINDOW_CHANGES];
+
+    // 通道图每个 9 位，从旧到新依次排列
+    const uint8_t* packed = frame + WINDOW_MAPS;
+    uint8_t n = (uint8_t)((len - WINDOW_MAPS) * 8 / 9);
+    if (n > WINDOW_SAMPLES_MAX) n = WINDOW_SAMPLES_MAX;
+    for (uint8_t i = 0; i < n; i++) {
+        uint16_t bit = (uint16_t)(i * 9);
+        uint16_t v = (uint16_t)(packed[bit >> 3] | (packed[(bit >> 3) + 1] << 8));
+        w->channels[i] = (uint16_t)((v >> (bit & 7)) & WINDOW_MAP_MASK);
+    }
+    w->channel_count = n;
+}
+
+MasterFrameResult_t master_core_handle_frame(MasterCore_t* core, const uint8_t* frame,
+                                             uint8_t len, uint32_t now) {
+    if (len < 4) return MASTER_FRAME_SHORT;
+    if (frame[1] != CMD_SENSOR_DATA && frame[1] != CMD_QUERY) return MASTER_FRAME_IGNORED;
+
+    uint8_t id = frame[0];
+    uint8_t level = frame[3];
+
+    // 带窗口的帧采样数为 0 时没有读数 (从机上电后还没有采样)：水位和井水状态不可信，
+    // 只刷新在线状态，未知从机等到有读数再加入 (否则水位 0 会让自动控制开泵)
+    bool reading = len < WINDOW_MAPS || frame[WINDOW_SAMPLES] != 0;
+
+    // 查找或添加水塔
+    uint8_t what = 0;
+    int idx = master_core_find(core, id);
+    if (idx < 0) {
+        if (!reading) return MASTER_FRAME_IGNORED;
+        idx = add_tower(core, id);
+        if (idx < 0) return MASTER_FRAME_FULL;
+        what |= MASTER_CHANGE_ADDED;
+    }
+
+    TowerData* t = &core->towers[idx];
+    if (!t->online) what |= MASTER_CHANGE_ONLINE;
+    t->online = true;
+    t->last_update = now;
+
+    bool well_changed = false;
+    bool window_changed = false;
+    if (reading) {
+        if (t->water_level != level || what) what |= MASTER_CHANGE_LEVEL;
+        t->water_level = level;
+
+        // 井水状态字段在第 5 字节 (旧格式的 4 字节帧不带)
+        if (len >= 5) {
+            bool well_ok = frame[4] != 0;
+            well_changed = core->status->well_water_ok != well_ok;
+            core->status->well_water_ok = well_ok;
+        }
+
+        // 采样窗口只影响 REST 输出，变化时保存 (使缓存失效) 但不推送
+        TowerWindow window;
+        parse_window(frame, len, &window);
+        window_changed = memcmp(&t->window, &window, sizeof(window)) != 0;
+        if (window_changed) memcpy(&t->window, &window, sizeof(window));
+    }
+
+    // 只在数值变化时推送和保存
+    if (what) notify_tower(core, (uint16_t)idx, what);
+    if (well_changed || (what & MASTER_CHANGE_ADDED)) notify_status(core);
+    if (what || well_changed || window_changed) commit(core);
+    return MASTER_FRAME_OK;
+}
+
+uint16_t master_core_expire(MasterCore_t* core, uint32_t now, uint32_t timeout_ms) {
+    uint16_t n = 0;
+    for (uint16_t i = 0; i < *core->tower_count; i++) {
+        TowerData* t = &core->towers[i];
+        if (!t->online || now - t->last_update <= timeout_ms) continue;
+        t->online = false;
+        notify_tower(core, i, MASTER_CHANGE_ONLINE);
+        n++;
+    }
+    if (n) commit(core);
+    return n;
+}
+
+// ==================== 继电器 ====================
+
+bool master_core_relay(const MasterCore_t* core, uint16_t index) {
+    return index < core->relay_count && bit_get(core->relays, index);
+}
+
+uint16_t master_core_apply(MasterCore_t* core, const uint8_t* set, const uint8_t* clear,
+                           uint8_t* changed) {
+    uint16_t n = pump_count(core);
+    uint16_t switched = 0;
+    uint8_t next[MASTER_RELAY_BYTES];
+    memcpy(next, core->relays, sizeof(next));
+    if (changed) memset(changed, 0, MASTER_RELAY_BYTES);
+
+    for (uint16_t i = 0; i < n; i++) {
+        bool on = bit_get(next, i);
+        if (set && bit_get(set, i)) on = true;
+        else if (clear && bit_get(clear, i)) on = false;
+        if (on == bit_get(next, i)) continue;
+        bit_put(next, i, on);
+        if (changed) bit_put(changed, i, true);
+        switched++;
+    }
+    if (switched == 0) return 0;
+
+    // 写入成功后才更新映像和水塔状态
+    if (!core->hooks->relay_write(core->ctx, next, core->relay_count)) return 0;
+
+    for (uint16_t i = 0; i < n; i++) {
+        bool on = bit_get(next, i);
+        if (on == bit_get(core->relays, i)) continue;
+        core->towers[i].pump_on = on;
+        notify_tower(core, i, MASTER_CHANGE_PUMP);
+    }
+    memcpy(core->relays, next, sizeof(next));
+    commit(core);
+    return switched;
+}
+
+bool master_core_set_pump(MasterCore_t* core, uint16_t index, bool on) {
+    if (index >= pump_count(core)) return false;
+
+    uint8_t mask[MASTER_RELAY_BYTES];
+    memset(mask, 0, sizeof(mask));
+    bit_put(mask, index, true);
+    master_core_apply(core, on ? mask : NULL, on ? NULL : mask, NULL);
+    return true;
+}
+
+/**
+ * 关闭所有水泵，只在继电器或水泵状态实际变化时推送和保存
+ * @param force true=映像已全部关闭也重新输出
+ */
+static void all_off(MasterCore_t* core, bool force) {
+    bool changed = false;
+    for (uint16_t i = 0; i < MASTER_RELAY_BYTES; i++) {
+        if (core->relays[i]) changed = true;
+    }
+    if (changed || force) {
+        memset(core->relays, 0, sizeof(core->relays));
+        core->hooks->relay_write(core->ctx, core->relays, core->relay_count);
+    }
+
+    for (uint16_t i = 0; i < *core->tower_count; i++) {
+        if (!core->towers[i].pump_on) continue;
+        core->towers[i].pump_on = false;
+        notify_tower(core, i, MASTER_CHANGE_PUMP);
+        changed = true;
+    }
+    if (changed) commit(core);
+}
+
+void master_core_all_off(MasterCore_t* core) {
+    all_off(core, true);
+}
+
+// ==================== 系统状态 ====================
+
+void master_core_set_mode(MasterCore_t* core, SystemMode mode) {
+    core->status->mode = mode;
+    notify_status(core);
+    commit(core);
+}
+
+void master_core_set_well(MasterCore_t* core, bool ok) {
+    if (core->status->well_water_ok == ok) return;
+    core->status->well_water_ok = ok;
+    notify_status(core);
+    commit(core);
+}
+
+// ==================== 自动控制 ====================
+
+uint16_t master_core_auto(MasterCore_t* core) {
+    if (core->status->mode != MODE_AUTO) return 0;
+
+    // 井水缺水：报警 (只在开始缺水时) 并关闭所有水泵 (缺水期间每轮只检查，不重复输出)
+    if (!core->status->well_water_ok) {
+        bool raise = !core->well_alarm;
+        core->well_alarm = true;
+        if (raise && core->hooks->alarm) core->hooks->alarm(core->ctx, MASTER_ALARM_WELL_LOW);
+        all_off(core, raise);
+        return 0;
+    }
+    core->well_alarm = false;
+
+    uint8_t set[MASTER_RELAY_BYTES];
+    uint8_t clear[MASTER_RELAY_BYTES];
+    memset(set, 0, sizeof(set));
+    memset(clear, 0, sizeof(clear));
+
+    uint16_t n = pump_count(core);
+    for (uint16_t i = 0; i < n; i++) {
+        uint8_t level = core->towers[i].water_level;
+        bool on = bit_get(core->relays, i);
+        if (level < MASTER_LEVEL_PUMP_ON && !on) {
+            bit_put(set, i, true);
+        } else if (level > MASTER_LEVEL_PUMP_OFF && on) {
+            bit_put(clear, i, true);
+        }
+    }
+    return master_core_apply(core, set, clear, NULL);
+}
@@ -0,0 +1,187 @@
+/*
+ * 主机控制核心 - 与平台无关的水塔表、LoRa 帧处理、自动控制策略和继电器模型
+ *
+ * 不依赖 Arduino，ESP8266 固件 (main_sr595.cpp) 和 Linux 主机 (linux_host/master)
+ * 共用同一份代码。硬件输出和副作用 (保存、推送、刷新显示、报警) 通过回调交给调用方。
+ *
+ * 水塔表和系统状态由调用方分配；水塔数量上限为 MAX_TOWERS (ESP8266 为 8，
+ * Linux 主机编译时定义为 256，即 8 位从机地址的全部取值)。
+ * 水塔按加入顺序编号 (索引)，索引 i 对应第 i 路继电器。
+ */
+
+#ifndef MASTER_CORE_H
+#define MASTER_CORE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "water_system.h"
+
+// ==================== 自动控制阈值 ====================
+#define MASTER_LEVEL_PUMP_ON    20  // 水位低于此值开启水泵 (%)
+#define MASTER_LEVEL_PUMP_OFF   90  // 水位高于此值关闭水泵 (%)
+
+// 继电器位图字节数 (bit i = 第 i 路继电器)
+#define MASTER_RELAY_BYTES      ((MAX_TOWERS + 7) / 8)
+
+// 从机地址到索引的查找表元素类型 (水塔少时用 8 位节省内存)
+#if MAX_TOWERS < 255
+typedef uint8_t MasterIndex_t;
+#define MASTER_NO_INDEX         0xFF
+#else
+typedef uint16_t MasterIndex_t;
+#define MASTER_NO_INDEX         0xFFFF
+#endif
+
+// ==================== 变化类型 ====================
+// tower_changed 回调的 what 参数 (可组合)
+#define MASTER_CHANGE_LEVEL     0x01  // 水位
+#define MASTER_CHANGE_PUMP      0x02  // 水泵
+#define MASTER_CHANGE_ONLINE    0x04  // 上线/离线
+#define MASTER_CHANGE_ADDED     0x08  // 新加入的水塔
+
+// 报警类型
+typedef enum {
+    MASTER_ALARM_WELL_LOW = 0   // 井水缺水，已紧急停泵
+} MasterAlarm_t;
+
+// 帧处理结果
+typedef enum {
+    MASTER_FRAME_OK = 0,        // 已处理
+    MASTER_FRAME_SHORT,         // 长度不足
+    MASTER_FRAME_IGNORED,       // 不是水位数据帧，或未知从机的帧还没有读数
+    MASTER_FRAME_FULL           // 水塔表已满，新从机被丢弃
+} MasterFrameResult_t;
+
+// ==================== 回调 ====================
+typedef struct {
+    /**
+     * 输出全部继电器 (必需)
+     * @param bits 继电器位图
+     * @param count 继电器路数
+     * @return false=写入失败
+     */
+    bool (*relay_write)(void* ctx, const uint8_t* bits, uint16_t count);
+
+    /**
+     * 水塔状态变化 (推送给订阅客户端)
+     * @param index 水塔索引
+     * @param what MASTER_CHANGE_* 组合
+     */
+    void (*tower_changed)(void* ctx, uint16_t index, uint8_t what);
+
+    /**
+     * 系统状态变化 (模式、井水、水塔数量)
+     */
+    void (*status_changed)(void* ctx);
+
+    /**
+     * 一批变化处理完毕 (保存状态、使缓存失效、刷新显示)
+     * 每次调用核心函数最多触发一次
+     */
+    void (*committed)(void* ctx);
+
+    /**
+     * 报警 (缺水持续期间只在开始时调用一次)
+     */
+    void (*alarm)(void* ctx, MasterAlarm_t alarm);
+} MasterHooks_t;
+
+// ==================== 核心状态 ====================
+typedef struct {
+    // 由调用方在 master_core_begin() 之前填写
+    TowerData* towers;              // 水塔表 (容量 MAX_TOWERS)
+    uint16_t* tower_count;          // 当前水塔数量
+    SystemStatus* status;           // 系统状态
+    uint16_t relay_count;           // 继电器路数 (<= MAX_TOWERS)
+    const MasterHooks_t* hooks;
+    void* ctx;                      // 回调参数
+
+    // 内部状态
+    uint8_t relays[MASTER_RELAY_BYTES];     // 继电器映像
+    MasterIndex_t index_by_id[256];         // 从机地址 -> 水塔索引
+    bool well_alarm;                        // 缺水报警已发出 (自动控制)
+} MasterCore_t;
+
+// ==================== 函数声明 ====================
+
+/**
+ * 初始化核心
+ * 按现有水塔表重建地址索引，载入继电器映像 (不输出，热启动时继电器已由调用方恢复)
+ * @param relay_state 初始继电器位图 (MASTER_RELAY_BYTES 字节)，NULL=全部关闭
+ */
+void master_core_begin(MasterCore_t* core, const uint8_t* relay_state);
+
+/**
+ * 按当前映像输出全部继电器
+ */
+bool master_core_write_relays(MasterCore_t* core);
+
+/**
+ * 按从机地址查找水塔
+ * @return 水塔索引，-1=不存在
+ */
+int master_core_find(const MasterCore_t* core, uint8_t id);
+
+/**
+ * 处理一帧 LoRa 数据
+ * 帧格式: [从机地址][命令][长度][水位][井水正常][采样窗口 (可选，见 water_system.h)]
+ * 接受 CMD_SENSOR_DATA (从机主动上报) 和 CMD_QUERY (查询应答)，采样窗口记入 TowerData.window；
+ * 带窗口且采样数为 0 的帧没有读数，只刷新在线状态 (未知从机返回 MASTER_FRAME_IGNORED)
+ * 未知从机自动加入水塔表；只在数值变化时触发回调
+ * @param now 当前时间 (毫秒)
+ */
+MasterFrameResult_t master_core_handle_frame(MasterCore_t* core, const uint8_t* frame,
+                                             uint8_t len, uint32_t now);
+
+/**
+ * 把超过 timeout_ms 没有上报的水塔标记为离线
+ * @return 本次变为离线的水塔数量
+ */
+uint16_t master_core_expire(MasterCore_t* core, uint32_t now, uint32_t timeout_ms);
+
+/**
+ * 读取继电器状态
+ */
+bool master_core_relay(const MasterCore_t* core, uint16_t index);
+
+/**
+ * 批量控制水泵
+ * 继电器一次写入同时切换，超出水塔数量或继电器路数的位被忽略
+ * @param set 开启的水泵位图 (MASTER_RELAY_BYTES 字节，NULL=无)
+ * @param clear 关闭的水泵位图
+ * @param changed 输出实际变化的位图 (可为 NULL)
+ * @return 实际切换的水泵数量
+ */
+uint16_t master_core_apply(MasterCore_t* core, const uint8_t* set, const uint8_t* clear,
+                           uint8_t* changed);
+
+/**
+ * 控制单个水泵
+ * @return false=索引无效
+ */
+bool master_core_set_pump(MasterCore_t* core, uint16_t index, bool on);
+
+/**
+ * 紧急停止 - 关闭所有水泵 (无论映像如何都重新输出)
+ */
+void master_core_all_off(MasterCore_t* core);
+
+/**
+ * 切换系统模式
+ */
+void master_core_set_mode(MasterCore_t* core, SystemMode mode);
+
+/**
+ * 更新井水状态 (本地传感器读数)
+ */
+void master_core_set_well(MasterCore_t* core, bool ok);
+
+/**
+ * 自动控制 (仅自动模式)
+ * 井水缺水时报警并紧急停止 (只在有水泵开着时输出和保存)；否则水位低于 MASTER_LEVEL_PUMP_ON 开泵，
+ * 高于 MASTER_LEVEL_PUMP_OFF 停泵，所有切换合并为一次继电器写入
+ * @return 切换的水泵数量
+ */
+uint16_t master_core_auto(MasterCore_t* core);
+
+#endif  // MASTER_CORE_H
@@ -0,0 +1,144 @@
+/*
+ * 中继网络主机端实现
+ */
+
+#include "mesh_master.h"
+#include <string.h>
+
+// ==================== 内部函数 ====================
+
+/**
+ * 查去重表，未见过的帧记入表中
+ * @return true=重复
+ */
+static bool seen_before(MeshMaster_t* m, uint8_t id, uint8_t seq) {
+    for (uint8_t i = 0; i < MESH_MASTER_SEEN_SIZE; i++) {
+        if (m->seen[i].id == id && m->seen[i].seq == seq) return true;
+    }
+    m->seen[m->seen_next].id = id;
+    m->seen[m->seen_next].seq = seq;
+    m->seen_next = (uint8_t)((m->seen_next + 1) % MESH_MASTER_SEEN_SIZE);
+    return false;
+}
+
+static MeshRoute_t* route_for(MeshMaster_t* m, const MasterCore_t* core, uint8_t id) {
+    int idx = master_core_find(core, id);
+    return idx < 0 ? NULL : &m->routes[idx];
+}
+
+/**
+ * 经中继的上报帧: 核对格式和逐跳记录，去重后把内层帧交给控制核心
+ */
+static MeshRxResult_t handle_relayed(MeshMaster_t* m, MasterCore_t* core, const uint8_t* frame, uint8_t len,
+                                     uint32_t now, MasterFrameResult_t* result) {
+    uint8_t inner_len = frame[MESH_UP_INNER_LEN];
+    if (len < MESH_UP_HEADER + inner_len) return MESH_RX_BAD;
+
+    // 逐跳记录 [中继地址][驻留时间 (10 ms)]，按经过的顺序 (最后一条是与主机相邻的中继)
+    uint8_t records = (uint8_t)(len - MESH_UP_HEADER - inner_len);
+    uint8_t hops = records / 2;
+    const uint8_t* inner = frame + MESH_UP_HEADER;
+    const uint8_t* rec = inner + inner_len;
+    if (records % 2 != 0 || hops == 0 || hops > MESH_MAX_RELAYS || inner_len == 0 ||
+        inner[0] != frame[MESH_UP_ORIGIN]) {
+        return MESH_RX_BAD;
+    }
+    if (seen_before(m, frame[MESH_UP_ORIGIN], frame[MESH_UP_SEQ])) return MESH_RX_DUPLICATE;
+
+    MasterFrameResult_t r = master_core_handle_frame(core, inner, inner_len, now);
+    if (result) *result = r;
+
+    uint16_t total_ms = 0;
+    MeshRoute_t* route = r == MASTER_FRAME_OK ? route_for(m, core, inner[0]) : NULL;
+    for (uint8_t j = 0; j < hops; j++) {
+        const uint8_t* hop = rec + 2 * (hops - 1 - j);
+        uint16_t residency_ms = (uint16_t)(hop[1] * 10);
+        MeshHopStats_t* s = &m->stats.hop[j];
+        s->frames++;
+        s->residency_sum_ms += residency_ms;
+        if (residency_ms > s->residency_max_ms) s->residency_max_ms = residency_ms;
+        total_ms = (uint16_t)(total_ms + residency_ms);
+        if (route) route->path[j] = hop[0];
+    }
+    if (route) {
+        route->hops = hops;
+        route->residency_ms = total_ms;
+    }
+    m->stats.relayed++;
+    return MESH_RX_RELAYED;
+}
+
+// ==================== 接口 ====================
+
+void mesh_master_begin(MeshMaster_t* m) {
+    memset(m, 0, sizeof(*m));
+    memset(m->seen, 0xFF, sizeof(m->seen));
+}
+
+MeshRxResult_t mesh_master_handle_frame(MeshMaster_t* m, MasterCore_t* core, const uint8_t* frame,
+                                        uint8_t len, uint32_t now, MasterFrameResult_t* result) {
+    uint8_t cmd = len >= 2 ? frame[1] : 0;
+    if (cmd != CMD_MESH_BEACON && cmd != CMD_MESH_UP && cmd != CMD_MESH_DOWN) {
+        // 旧格式的从机帧 (直连)
+        MasterFrameResult_t r = master_core_handle_frame(core, frame, len, now);
+        if (result) *result = r;
+        if (r == MASTER_FRAME_OK) {
+            MeshRoute_t* route = route_for(m, core, frame[0]);
+            if (route) route->hops = 0;
+        }
+        m->stats.direct++;
+        return MESH_RX_DIRECT;
+    }
+
+    // 中继的通告、中继之间转发的帧
+    if (cmd != CMD_MESH_UP || len < MESH_UP_HEADER || frame[MESH_UP_NEXT] != MESH_MASTER_ID) {
+        m->stats.control++;
+        return MESH_RX_CONTROL;
+    }
+
+    MeshRxResult_t rx = handle_relayed(m, core, frame, len, now, result);
+    if (rx == MESH_RX_BAD) m->stats.bad++;
+    else if (rx == MESH_RX_DUPLICATE) m->stats.duplicates++;
+    return rx;
+}
+
+uint8_t mesh_master_beacon(MeshMaster_t* m, uint32_t now, uint8_t* buf) {
+    if (m->beacon_sent && now - m->last_beacon < MESH_BEACON_MS) return 0;
+    m->beacon_sent = true;
+    m->last_beacon = now;
+    m->stats.beacons++;
+
+    buf[0] = MESH_MASTER_ID;
+    buf[1] = CMD_MESH_BEACON;
+    buf[MESH_BEACON_PARENT] = MESH_MASTER_ID;
+    buf[MESH_BEACON_HOPS] = 0;
+    buf[MESH_BEACON_COST] = 0;
+    return MESH_BEACON_LEN;
+}
+
+uint8_t mesh_master_wrap_command(MeshMaster_t* m, uint16_t index, const uint8_t* cmd, uint8_t len,
+                                 uint8_t* out) {
+    if (index >= MAX_TOWERS || len < 2) return 0;
+    const MeshRoute_t* route = &m->routes[index];
+    if (route->hops == 0) {
+        if (len > MESH_DOWN_MAX) return 0;
+        memcpy(out, cmd, len);
+        return len;
+    }
+
+    uint8_t n = (uint8_t)(MESH_DOWN_HEADER + route->hops + len);
+    if (n > MESH_DOWN_MAX) return 0;
+    out[0] = MESH_MASTER_ID;
+    out[1] = CMD_MESH_DOWN;
+    out[MESH_DOWN_TARGET] = cmd[1];
+    out[MESH_DOWN_SEQ] = m->down_seq++;
+    out[MESH_DOWN_PATH_LEN] = route->hops;
+    out[MESH_DOWN_NEXT] = 0;
+    memcpy(out + MESH_DOWN_HEADER, route->path, route->hops);
+    memcpy(out + MESH_DOWN_HEADER + route->hops, cmd, len);
+    return n;
+}
+
+const MeshRoute_t* mesh_master_route(const MeshMaster_t* m, uint16_t index) {
+    return index < MAX_TOWERS ? &m->routes[index] : NULL;
+}
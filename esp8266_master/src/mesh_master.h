@@ -0,0 +1,129 @@
+/*
+ * 中继网络主机端 - 路由通告、拆出经中继转发的上报帧、按跳统计延迟、按路径下发命令
+ *
+ * 从机端和帧格式见 slave_node_stc8g/inc/slave_mesh.h (常量须保持一致)。与控制核心一样
+ * 不依赖 Arduino，ESP8266 固件、Linux 主机和回放工具共用：收到的每一帧先交给
+ * mesh_master_handle_frame()，直接收到的从机帧原样、经中继的帧拆出内层后交给控制核心。
+ *
+ * 路由按水塔索引记录 (容量 MAX_TOWERS)：每收到一帧更新为该帧经过的中继，
+ * 直接收到的帧把跳数清零。主机重启后路由为空，从机下一次上报后恢复。
+ */
+
+#ifndef MESH_MASTER_H
+#define MESH_MASTER_H
+
+#include <stdint.h>
+#include "master_core.h"
+
+// ==================== 参数 (与 slave_mesh.h 相同) ====================
+#define MESH_MASTER_ID          0x00
+#define MESH_MAX_HOPS           5
+#define MESH_MAX_RELAYS         (MESH_MAX_HOPS - 1)
+#define MESH_BEACON_MS          30000UL
+
+#define MESH_BEACON_LEN         5
+#define MESH_BEACON_PARENT      2
+#define MESH_BEACON_HOPS        3
+#define MESH_BEACON_COST        4
+
+#define MESH_UP_NEXT            2
+#define MESH_UP_ORIGIN          3
+#define MESH_UP_SEQ             4
+#define MESH_UP_TTL             5
+#define MESH_UP_INNER_LEN       6
+#define MESH_UP_HEADER          7
+
+#define MESH_DOWN_TARGET        2
+#define MESH_DOWN_SEQ           3
+#define MESH_DOWN_PATH_LEN      4
+#define MESH_DOWN_NEXT          5
+#define MESH_DOWN_HEADER        6
+
+// 主机去重表条目数 (所有中继的上行帧共用)
+#define MESH_MASTER_SEEN_SIZE   32
+
+// 下行帧最大长度 (与从机接收缓冲区相同)
+#define MESH_DOWN_MAX           24
+
+// 帧分类
+typedef enum {
+    MESH_RX_DIRECT = 0,     // 直接收到的从机帧，原样交给了控制核心
+    MESH_RX_RELAYED,        // 经中继转发，内层帧交给了控制核心
+    MESH_RX_DUPLICATE,      // 同一帧经另一条路径已收到
+    MESH_RX_CONTROL,        // 中继的路由通告、发给其他节点的帧
+    MESH_RX_BAD             // 格式错误
+} MeshRxResult_t;
+
+// ==================== 状态 ====================
+typedef struct {
+    uint8_t hops;                       // 经过的中继数，0=直连
+    uint8_t path[MESH_MAX_RELAYS];      // 中继地址，从主机一侧起
+    uint16_t residency_ms;              // 最近一帧在各中继驻留时间之和
+} MeshRoute_t;
+
+typedef struct {
+    uint32_t frames;                    // 经过这一跳的帧
+    uint32_t residency_sum_ms;
+    uint16_t residency_max_ms;
+} MeshHopStats_t;
+
+typedef struct {
+    uint32_t direct;
+    uint32_t relayed;
+    uint32_t duplicates;
+    uint32_t control;
+    uint32_t bad;
+    uint32_t beacons;                   // 主机发出的路由通告
+    MeshHopStats_t hop[MESH_MAX_RELAYS];    // 按中继位置 (0=与主机相邻的中继)
+} MeshStats_t;
+
+typedef struct {
+    MeshRoute_t routes[MAX_TOWERS];     // 按水塔索引
+    struct {
+        uint8_t id;
+        uint8_t seq;
+    } seen[MESH_MASTER_SEEN_SIZE];
+    uint8_t seen_next;
+    uint8_t down_seq;
+    bool beacon_sent;
+    uint32_t last_beacon;
+    MeshStats_t stats;
+} MeshMaster_t;
+
+// ==================== 函数声明 ====================
+
+/**
+ * 初始化 (没有路由，下一次调用 mesh_master_beacon() 即发送通告)
+ */
+void mesh_master_begin(MeshMaster_t* m);
+
+/**
+ * 处理收到的一帧并交给控制核心
+ * @param result 控制核心的处理结果 (DIRECT/RELAYED 时有效，可为 NULL)
+ */
+MeshRxResult_t mesh_master_handle_frame(MeshMaster_t* m, MasterCore_t* core, const uint8_t* frame,
+                                        uint8_t len, uint32_t now, MasterFrameResult_t* result);
+
+/**
+ * 到期时组装路由通告 (调用方负责发送)
+ * @param buf 至少 MESH_BEACON_LEN 字节
+ * @return 帧长度，0=未到期
+ */
+uint8_t mesh_master_beacon(MeshMaster_t* m, uint32_t now, uint8_t* buf);
+
+/**
+ * 按水塔的路由封装一条主机命令 ([源地址][目标地址][命令]...)
+ * 直连的水塔原样复制
+ * @param out 至少 MESH_DOWN_MAX 字节
+ * @return 帧长度，0=索引无效或命令过长
+ */
+uint8_t mesh_master_wrap_command(MeshMaster_t* m, uint16_t index, const uint8_t* cmd, uint8_t len,
+                                 uint8_t* out);
+
+/**
+ * 水塔的路由
+ * @return NULL=索引无效
+ */
+const MeshRoute_t* mesh_master_route(const MeshMaster_t* m, uint16_t index);
+
+#endif  // MESH_MASTER_H
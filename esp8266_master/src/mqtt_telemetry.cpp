@@ -0,0 +1,354 @@
+/*
+ * MQTT 遥测上报实现
+ */
+
+#include "mqtt_telemetry.h"
+#include <AsyncMqttClient.h>
+#include "water_system.h"
+#include "error_codes.h"
+#include "api_cache.h"
+#include "wifi_manager.h"
+#include "pgm_util.h"
+#include "logger.h"
+
+// 外部状态 (在 main.cpp 中定义)
+extern TowerData towers[MAX_TOWERS];
+extern uint16_t tower_count;
+extern SystemStatus sys_status;
+
+#define TOPIC_ONLINE    MQTT_TOPIC_PREFIX "/online"
+#define TOPIC_STATUS    MQTT_TOPIC_PREFIX "/status"
+#define TOPIC_TOWERS    MQTT_TOPIC_PREFIX "/towers"
+#define TOPIC_ALARM     MQTT_TOPIC_PREFIX "/alarm"
+#define TOPIC_METRICS   MQTT_TOPIC_PREFIX "/metrics"
+
+// 已发布的水塔状态 (用于找出变化)
+typedef struct {
+    uint8_t id;
+    uint8_t water_level;
+    bool pump_on;
+    bool online;
+    bool valid;
+} SentTower_t;
+
+// 待发送的报警
+typedef struct {
+    uint16_t code;
+    uint8_t level;
+    uint8_t tower_id;
+    uint32_t timestamp;
+} Alarm_t;
+
+static AsyncMqttClient mqtt;
+static char client_id[24];
+
+// 连接状态 (回调中只置标志)
+static volatile bool evt_connected = false;
+static volatile bool evt_disconnected = false;
+static volatile uint16_t evt_acked_id = 0;
+
+static bool link_up = false;
+static bool connecting = false;
+static uint32_t next_attempt = 0;
+static uint32_t backoff_ms = MQTT_BACKOFF_MIN_MS;
+static uint32_t reconnects = 0;
+
+// 水塔批量
+static SentTower_t sent[MAX_TOWERS];
+static uint32_t checked_version = 0;
+static uint32_t last_batch = 0;
+
+// 系统状态
+static uint32_t sent_status = 0xFFFFFFFF;
+
+// 报警队列
+static Alarm_t alarms[MQTT_ALARM_QUEUE];
+static uint8_t alarm_head = 0;          // 写位置
+static uint8_t alarm_tail = 0;          // 读位置
+static uint8_t alarm_len = 0;
+static uint16_t alarm_inflight = 0;     // 已发出未确认的报文 ID (0=无)
+static uint32_t alarm_sent_at = 0;
+static uint8_t seen_errors = 0;         // 已处理的错误日志条数
+
+// 运行指标
+static uint32_t last_metrics = 0;
+static uint32_t published = 0;
+
+static MqttDropStats_t drops = {0, 0, 0};
+
+// ==================== 报警队列 ====================
+
+static void alarm_push(const Error_t* e) {
+    if (alarm_len == MQTT_ALARM_QUEUE) {
+        // 丢弃最旧的 (若已发出则放弃等待确认)
+        alarm_inflight = 0;
+        alarm_tail = (alarm_tail + 1) % MQTT_ALARM_QUEUE;
+        alarm_len--;
+        drops.alarms++;
+    }
+    Alarm_t* a = &alarms[alarm_head];
+    a->code = e->code;
+    a->level = (uint8_t)e->level;
+    a->tower_id = e->tower_id;
+    a->timestamp = e->timestamp;
+    alarm_head = (alarm_head + 1) % MQTT_ALARM_QUEUE;
+    alarm_len++;
+}
+
+static void alarm_pop(void) {
+    alarm_tail = (alarm_tail + 1) % MQTT_ALARM_QUEUE;
+    alarm_len--;
+    alarm_inflight = 0;
+}
+
+/**
+ * 收集错误日志中的新条目 (警告及以上)
+ * 去重合并的重复发生不产生新条目，也就不会重复报警
+ */
+static void collect_alarms(void) {
+    uint8_t fresh = g_error_count - seen_errors;
+    if (fresh > MAX_ERROR_LOG) {
+        // 日志已被覆盖，只能取到最近的 MAX_ERROR_LOG 条
+        drops.alarms += fresh - MAX_ERROR_LOG;
+        seen_errors = g_error_count - MAX_ERROR_LOG;
+    }
+    while (seen_errors != g_error_count) {
+        const Error_t* e = &g_error_log[seen_errors % MAX_ERROR_LOG];
+        if (e->level >= ERR_LEVEL_WARNING) alarm_push(e);
+        seen_errors++;
+    }
+}
+
+// ==================== 消息生成 ====================
+
+static uint32_t status_signature(void) {
+    return ((uint32_t)sys_status.mode) |
+           ((uint32_t)sys_status.well_water_ok << 8) |
+           ((uint32_t)sys_status.wifi_connected << 9) |
+           ((uint32_t)wifi_manager_ap_active() << 10) |
+           ((uint32_t)tower_count << 16);
+}
+
+static bool tower_changed(uint8_t i) {
+    const SentTower_t* s = &sent[i];
+    const TowerData* t = &towers[i];
+    return !s->valid || s->id != t->id || s->water_level != t->water_level ||
+           s->pump_on != t->pump_on || s->online != t->online;
+}
+
+/**
+ * 生成水塔批量消息 (只含有变化的水塔)
+ * @return 消息长度，0 表示无变化
+ */
+static size_t format_batch(char* buf, size_t size, uint32_t now, uint8_t* mask) {
+    size_t n = snprintf_P(buf, size, PSTR("{\"t\":%lu,\"towers\":["), (unsigned long)now);
+    uint8_t count = 0;
+
+    *mask = 0;
+    for (uint8_t i = 0; i < tower_count; i++) {
+        if (!tower_changed(i)) continue;
+        const TowerData* t = &towers[i];
+        int len = snprintf_P(buf + n, size - n,
+                             PSTR("%S{\"id\":%u,\"level\":%u,\"pump\":%S,\"online\":%S}"),
+                             count > 0 ? PSTR(",") : PSTR(""), t->id, t->water_level,
+                             bool_P(t->pump_on), bool_P(t->online));
+        if (len < 0 || (size_t)len >= size - n - 2) break;  // 剩余水塔留到下个窗口
+        n += len;
+        *mask |= (1 << i);
+        count++;
+    }
+    if (count == 0) return 0;
+
+    buf[n++] = ']';
+    buf[n++] = '}';
+    buf[n] = '\0';
+    return n;
+}
+
+// ==================== 发送 ====================
+
+static bool publish(const char* topic, uint8_t qos, bool retain, const char* payload, size_t len) {
+    if (mqtt.publish(topic, qos, retain, payload, len) == 0) return false;
+    published++;
+    return true;
+}
+
+static void send_batch(uint32_t now) {
+    if (now - last_batch < MQTT_BATCH_WINDOW_MS) return;
+    if (checked_version == api_cache_version()) return;
+    last_batch = now;
+
+    char payload[MQTT_PAYLOAD_MAX];
+    uint8_t mask;
+    size_t len = format_batch(payload, sizeof(payload), now, &mask);
+
+    if (len > 0) {
+        if (!publish(TOPIC_TOWERS, 0, false, payload, len)) {
+            drops.batches++;
+            return;  // 状态保留，下个窗口重发
+        }
+        for (uint8_t i = 0; i < tower_count; i++) {
+            if (!(mask & (1 << i))) continue;
+            sent[i].id = towers[i].id;
+            sent[i].water_level = towers[i].water_level;
+            sent[i].pump_on = towers[i].pump_on;
+            sent[i].online = towers[i].online;
+            sent[i].valid = true;
+        }
+        // 未放入本条消息的水塔留到下个窗口
+        for (uint8_t i = 0; i < tower_count; i++) {
+            if (tower_changed(i)) return;
+        }
+    }
+
+    uint32_t sig = status_signature();
+    if (sig != sent_status) {
+        int n = snprintf_P(payload, sizeof(payload),
+                           PSTR("{\"mode\":\"%S\",\"well_water\":%S,\"wifi\":%S,\"ap\":%S,\"towers\":%u}"),
+                           sys_status.mode == MODE_AUTO ? PSTR("AUTO") : PSTR("MANUAL"),
+                           bool_P(sys_status.well_water_ok),
+                           bool_P(sys_status.wifi_connected),
+                           bool_P(wifi_manager_ap_active()),
+                           tower_count);
+        if (!publish(TOPIC_STATUS, 0, true, payload, n)) {
+            drops.batches++;
+            return;
+        }
+        sent_status = sig;
+    }
+
+    checked_version = api_cache_version();
+}
+
+static void send_alarm(uint32_t now) {
+    // 确认后出队
+    uint16_t acked = evt_acked_id;
+    if (alarm_inflight != 0 && acked == alarm_inflight) {
+        alarm_pop();
+    }
+
+    if (alarm_len == 0) return;
+    if (alarm_inflight != 0 && now - alarm_sent_at < MQTT_ACK_TIMEOUT_MS) return;
+
+    const Alarm_t* a = &alarms[alarm_tail];
+    char message[24];
+    char payload[160];
+    copy_P(message, error_get_message(a->code), sizeof(message));
+    int n = snprintf_P(payload, sizeof(payload),
+                       PSTR("{\"code\":%u,\"level\":%u,\"message\":\"%s\",\"tower\":%u,\"time\":%lu}"),
+                       a->code, a->level, message, a->tower_id, (unsigned long)a->timestamp);
+
+    uint16_t id = mqtt.publish(TOPIC_ALARM, 1, false, payload, n);
+    if (id == 0) return;  // 发送缓冲区满，稍后重试 (报警不丢弃)
+    published++;
+    alarm_inflight = id;
+    alarm_sent_at = now;
+}
+
+static void send_metrics(uint32_t now) {
+    if (now - last_metrics < MQTT_METRICS_INTERVAL_MS) return;
+    last_metrics = now;
+
+    char payload[256];
+    int n = snprintf_P(payload, sizeof(payload),
+                       PSTR("{\"uptime\":%lu,\"heap\":%lu,\"published\":%lu,\"mqtt_reconnects\":%lu,"
+                            "\"wifi_reconnects\":%lu,\"alarm_queue\":%u,"
+                            "\"dropped\":{\"batches\":%lu,\"alarms\":%lu,\"metrics\":%lu}}"),
+                       (unsigned long)(now / 1000), (unsigned long)ESP.getFreeHeap(),
+                       (unsigned long)published, (unsigned long)reconnects,
+                       (unsigned long)wifi_manager_reconnects(), alarm_len,
+                       (unsigned long)drops.batches, (unsigned long)drops.alarms,
+                       (unsigned long)drops.metrics);
+    if (!publish(TOPIC_METRICS, 0, false, payload, n)) {
+        drops.metrics++;
+    }
+}
+
+// ==================== 连接管理 ====================
+
+static void on_link_up(void) {
+    link_up = true;
+    connecting = false;
+    backoff_ms = MQTT_BACKOFF_MIN_MS;
+
+    // 重新发布完整状态
+    for (uint8_t i = 0; i < MAX_TOWERS; i++) sent[i].valid = false;
+    sent_status = 0xFFFFFFFF;
+    checked_version = 0;
+    alarm_inflight = 0;  // 未确认的报警重新发送
+
+    publish(TOPIC_ONLINE, 0, true, "1", 1);
+    LOG_I("✅ MQTT 已连接");
+}
+
+static void on_link_down(uint32_t now) {
+    if (link_up) {
+        reconnects++;
+        LOG_W("⚠️ MQTT 断开，%lu ms 后重连", (unsigned long)backoff_ms);
+    }
+    link_up = false;
+    connecting = false;
+    next_attempt = now + backoff_ms;
+    backoff_ms = (backoff_ms >= MQTT_BACKOFF_MAX_MS / 2) ? MQTT_BACKOFF_MAX_MS : backoff_ms * 2;
+}
+
+// ==================== 函数实现 ====================
+
+void mqtt_telemetry_begin(const char* host, uint16_t port) {
+    snprintf_P(client_id, sizeof(client_id), PSTR("watertower-%06lx"), (unsigned long)ESP.getChipId());
+
+    mqtt.setServer(host, port);
+    mqtt.setClientId(client_id);
+    mqtt.setKeepAlive(30);
+    mqtt.setWill(TOPIC_ONLINE, 1, true, "0", 1);
+
+    mqtt.onConnect([](bool) {
+        evt_connected = true;
+    });
+    mqtt.onDisconnect([](AsyncMqttClientDisconnectReason) {
+        evt_disconnected = true;
+    });
+    mqtt.onPublish([](uint16_t packet_id) {
+        evt_acked_id = packet_id;
+    });
+
+    seen_errors = g_error_count;
+    LOG_I("MQTT broker: %s:%u", host, port);
+}
+
+/**
+ * 连接管理与消息发送
+ */
+void mqtt_telemetry_loop(uint32_t now) {
+    collect_alarms();
+
+    bool connected = evt_connected;
+    bool disconnected = evt_disconnected;
+    evt_connected = false;
+    evt_disconnected = false;
+
+    // 两次循环之间可能先连上又断开：先处理断开，是否上线以客户端当前的状态为准
+    // (此后才断开的，断开事件留到下次循环处理)
+    if (disconnected) on_link_down(now);
+    if (connected && mqtt.connected()) on_link_up();
+
+    if (!link_up) {
+        if (wifi_manager_connected() && !connecting && (int32_t)(now - next_attempt) >= 0) {
+            connecting = true;
+            mqtt.connect();
+        }
+        return;
+    }
+
+    send_alarm(now);
+    send_batch(now);
+    send_metrics(now);
+}
+
+bool mqtt_telemetry_connected(void) {
+    return link_up;
+}
+
+const MqttDropStats_t* mqtt_telemetry_drops(void) {
+    return &drops;
+}
@@ -0,0 +1,90 @@
+/*
+ * MQTT 遥测上报 (AsyncMqttClient)
+ *
+ * 主题 (前缀 MQTT_TOPIC_PREFIX，默认 watertower):
+ *   <前缀>/online    "1"/"0"，保留消息 (遗嘱消息在掉线时置 "0")
+ *   <前缀>/status    系统状态，保留消息，QoS 0
+ *   <前缀>/towers    水塔状态批量消息，QoS 0
+ *                    {"t":12345,"towers":[{"id":1,"level":55,"pump":true,"online":true}]}
+ *   <前缀>/alarm     报警 (错误日志新条目)，QoS 1
+ *                    {"code":101,"level":4,"message":"Well Water Low","tower":255,"time":12345}
+ *   <前缀>/metrics   运行指标 (含各类丢弃计数)，QoS 0
+ *
+ * 批量与背压:
+ * - 水塔状态按 MQTT_BATCH_WINDOW_MS 窗口合并，窗口内多次变化只发最后状态，
+ *   每个窗口最多一条消息，只包含有变化的水塔
+ * - 报警放入有界队列 (MQTT_ALARM_QUEUE)，逐条 QoS 1 发送，收到 PUBACK 后出队；
+ *   队列满时丢弃最旧的报警并计数
+ * - 发布不等待：TCP 发送缓冲区不足时 publish() 立即失败，
+ *   状态类消息留到下个窗口重发，指标消息直接丢弃并计数
+ * - 断线后按指数退避重连，WiFi 未连接时不尝试
+ *
+ * 本地测试:
+ *   mosquitto -v
+ *   mosquitto_sub -h <broker> -t 'watertower/#' -v
+ */
+
+#ifndef MQTT_TELEMETRY_H
+#define MQTT_TELEMETRY_H
+
+#include <Arduino.h>
+
+// 主题前缀
+#ifndef MQTT_TOPIC_PREFIX
+#define MQTT_TOPIC_PREFIX       "watertower"
+#endif
+
+// 水塔状态合并窗口
+#ifndef MQTT_BATCH_WINDOW_MS
+#define MQTT_BATCH_WINDOW_MS    1000
+#endif
+
+// 运行指标上报间隔
+#define MQTT_METRICS_INTERVAL_MS    30000
+
+// 报警队列长度
+#define MQTT_ALARM_QUEUE        8
+
+// 报警未确认时的重发间隔
+#define MQTT_ACK_TIMEOUT_MS     10000
+
+// 重连退避 (初始值与上限)
+#define MQTT_BACKOFF_MIN_MS     2000
+#define MQTT_BACKOFF_MAX_MS     60000
+
+// 单条消息最大长度
+#define MQTT_PAYLOAD_MAX        512
+
+// 丢弃计数
+typedef struct {
+    uint32_t batches;       // 水塔批量消息发送失败次数 (下个窗口重发)
+    uint32_t alarms;        // 队列满丢弃的报警
+    uint32_t metrics;       // 发送失败的指标消息
+} MqttDropStats_t;
+
+// ==================== 函数声明 ====================
+
+/**
+ * 启动 MQTT 客户端 (立即返回，连接在 mqtt_telemetry_loop() 中进行)
+ * @param host 服务器地址
+ * @param port 服务器端口
+ */
+void mqtt_telemetry_begin(const char* host, uint16_t port);
+
+/**
+ * 连接管理与消息发送 (主循环中调用，不阻塞)
+ * @param now 当前时间 (毫秒)
+ */
+void mqtt_telemetry_loop(uint32_t now);
+
+/**
+ * 是否已连接服务器
+ */
+bool mqtt_telemetry_connected(void);
+
+/**
+ * 丢弃计数
+ */
+const MqttDropStats_t* mqtt_telemetry_drops(void);
+
+#endif  // MQTT_TELEMETRY_H
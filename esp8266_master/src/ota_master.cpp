@@ -0,0 +1,359 @@
+/*
+ * 从机空中升级主机端实现
+ */
+
+#include "ota_master.h"
+#include <string.h>
+
+#define OTA_BIT(bits, i)        ((bits)[(i) >> 3] & (1 << ((i) & 7)))
+#define OTA_SET_BIT(bits, i)    ((bits)[(i) >> 3] |= (uint8_t)(1 << ((i) & 7)))
+
+// ==================== 内部函数 ====================
+
+static uint16_t get16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static void put16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void set_all(uint8_t* bits, uint16_t chunks) {
+    memset(bits, 0, OTA_BITMAP_BYTES);
+    for (uint16_t i = 0; i < chunks; i++) OTA_SET_BIT(bits, i);
+}
+
+/**
+ * 当前阶段的下一个目标 (从 from 起)
+ * @return target_count=没有了
+ */
+static uint16_t next_target(const OtaMaster_t* m, uint16_t from) {
+    for (uint16_t i = from; i < m->target_count; i++) {
+        const OtaTarget_t* t = &m->targets[i];
+        switch (m->phase) {
+            case OTA_PHASE_BEGIN:
+                if (t->result == OTA_NODE_PENDING && t->need_begin) return i;
+                break;
+            case OTA_PHASE_QUERY:
+                if (t->result == OTA_NODE_PENDING) return i;
+                break;
+            case OTA_PHASE_ACTIVATE:
+                if (t->result == OTA_NODE_VERIFIED) return i;
+                break;
+            default:
+                break;
+        }
+    }
+    return m->target_count;
+}
+
+static void enter_target_phase(OtaMaster_t* m, OtaPhase_t phase, uint32_t now);
+
+/**
+ * 开始一轮分片发送 (本轮的分片在 send 中)
+ */
+static void enter_send(OtaMaster_t* m) {
+    m->phase = OTA_PHASE_SEND;
+    m->cursor = 0;
+    m->round++;
+}
+
+/**
+ * 一轮查询结束: 还有缺片则开始下一轮，否则激活
+ */
+static void after_query(OtaMaster_t* m, uint32_t now) {
+    bool pending = false, rebegin = false;
+    for (uint16_t i = 0; i < m->target_count; i++) {
+        OtaTarget_t* t = &m->targets[i];
+        if (t->result != OTA_NODE_PENDING) continue;
+        if (m->round >= OTA_MAX_ROUNDS) {
+            t->result = OTA_NODE_FAILED;
+            continue;
+        }
+        pending = true;
+        if (t->need_begin) rebegin = true;
+    }
+
+    if (!pending) {
+        enter_target_phase(m, OTA_PHASE_ACTIVATE, now);
+        return;
+    }
+    memcpy(m->send, m->next, OTA_BITMAP_BYTES);
+    memset(m->next, 0, OTA_BITMAP_BYTES);
+    if (rebegin) enter_target_phase(m, OTA_PHASE_BEGIN, now);
+    else enter_send(m);
+}
+
+/**
+ * 逐个目标收发的阶段 (BEGIN/QUERY/ACTIVATE)，没有目标时直接进入下一阶段
+ */
+static void enter_target_phase(OtaMaster_t* m, OtaPhase_t phase, uint32_t now) {
+    m->phase = phase;
+    m->waiting = false;
+    m->retries = 0;
+    m->query_from = 0;
+    m->current = next_target(m, 0);
+    if (m->current < m->target_count) return;
+
+    switch (phase) {
+        case OTA_PHASE_BEGIN:
+            // 全部目标都已失败时结束，否则开始发送
+            for (uint16_t i = 0; i < m->target_count; i++) {
+                if (m->targets[i].result == OTA_NODE_PENDING) {
+                    enter_send(m);
+                    return;
+                }
+            }
+            m->phase = OTA_PHASE_DONE;
+            m->stats.finished_ms = now;
+            break;
+        case OTA_PHASE_QUERY:
+            after_query(m, now);
+            break;
+        default:
+            m->phase = OTA_PHASE_DONE;
+            m->stats.finished_ms = now;
+            break;
+    }
+}
+
+/**
+ * 当前目标处理完毕，转到下一个
+ */
+static void advance_target(OtaMaster_t* m, uint32_t now) {
+    m->waiting = false;
+    m->retries = 0;
+    m->query_from = 0;
+    m->current = next_target(m, (uint16_t)(m->current + 1));
+    if (m->current < m->target_count) return;
+
+    switch (m->phase) {
+        case OTA_PHASE_BEGIN:
+            enter_target_phase(m, OTA_PHASE_BEGIN, now);
+            break;
+        case OTA_PHASE_QUERY:
+            after_query(m, now);
+            break;
+        default:
+            m->phase = OTA_PHASE_DONE;
+            m->stats.finished_ms = now;
+            break;
+    }
+}
+
+/**
+ * 把 STATUS 中的缺片窗口并入下一轮
+ * @return 窗口中缺片的数量
+ */
+static uint16_t merge_window(OtaMaster_t* m, uint16_t base, const uint8_t* bitmap) {
+    uint16_t n = 0;
+    for (uint16_t i = 0; i < OTA_STATUS_WINDOW && base + i < m->chunks; i++) {
+        if (OTA_BIT(bitmap, i)) {
+            OTA_SET_BIT(m->next, base + i);
+            n++;
+        }
+    }
+    return n;
+}
+
+static void on_status(OtaMaster_t* m, OtaTarget_t* t, const uint8_t* frame, uint32_t now) {
+    uint8_t state = frame[OTA_STATUS_STATE];
+    bool same = frame[OTA_STATUS_SESSION] == m->session;
+    uint16_t missing = get16(frame + OTA_STATUS_MISSING);
+    t->state = state;
+    t->missing = missing;
+    t->silent = 0;
+
+    switch (m->phase) {
+        case OTA_PHASE_BEGIN:
+            if (!same || state == OTA_STATE_REJECTED) t->result = OTA_NODE_FAILED;
+            else t->need_begin = false;
+            advance_target(m, now);
+            break;
+
+        case OTA_PHASE_QUERY:
+            if (!same || state == OTA_STATE_IDLE || state == OTA_STATE_CRC_ERROR) {
+                // 丢失会话 (节点重启) 或校验失败: 重新开始，下一轮发送全部分片
+                t->need_begin = true;
+                set_all(m->next, m->chunks);
+            } else if (state == OTA_STATE_VERIFIED || state == OTA_STATE_ACTIVATING) {
+                t->result = OTA_NODE_VERIFIED;
+            } else if (state == OTA_STATE_RECEIVING) {
+                uint16_t base = get16(frame + OTA_STATUS_BASE);
+                uint16_t n = merge_window(m, base, frame + OTA_STATUS_HEADER);
+                // 窗口之后还有缺片: 继续查询下一个窗口
+                if (missing > n && base + OTA_STATUS_WINDOW < m->chunks) {
+                    m->query_from = (uint16_t)(base + OTA_STATUS_WINDOW);
+                    m->waiting = false;
+                    m->retries = 0;
+                    return;
+                }
+            } else {
+                t->result = OTA_NODE_FAILED;
+            }
+            advance_target(m, now);
+            break;
+
+        case OTA_PHASE_ACTIVATE:
+            if (same && state == OTA_STATE_ACTIVATING) t->result = OTA_NODE_ACTIVATED;
+            // 上一次的应答丢失、节点已复位进入新程序 (会话清空)
+            else if (state == OTA_STATE_IDLE && m->retries > 0) t->result = OTA_NODE_ACTIVATED;
+            else t->result = OTA_NODE_FAILED;
+            advance_target(m, now);
+            break;
+
+        default:
+            break;
+    }
+}
+
+static uint8_t build_target_frame(OtaMaster_t* m, uint8_t* buf) {
+    const OtaTarget_t* t = &m->targets[m->current];
+    buf[0] = 0x00;
+    buf[OTA_TARGET] = t->id;
+    buf[OTA_SESSION] = m->session;
+    switch (m->phase) {
+        case OTA_PHASE_BEGIN:
+            buf[1] = CMD_OTA_BEGIN;
+            put16(buf + OTA_BEGIN_SIZE, m->size);
+            put16(buf + OTA_BEGIN_CRC, m->crc);
+            return OTA_BEGIN_LEN;
+        case OTA_PHASE_QUERY:
+            buf[1] = CMD_OTA_QUERY;
+            put16(buf + OTA_QUERY_FROM, m->query_from);
+            return OTA_QUERY_LEN;
+        default:
+            buf[1] = CMD_OTA_ACTIVATE;
+            return OTA_ACTIVATE_LEN;
+    }
+}
+
+// ==================== 接口 ====================
+
+void ota_master_begin(OtaMaster_t* m) {
+    memset(m, 0, sizeof(*m));
+}
+
+bool ota_master_start(OtaMaster_t* m, const uint8_t* image, uint16_t size, const uint8_t* ids, uint16_t count,
+                      uint8_t session, uint32_t now) {
+    if (size == 0 || size > OTA_IMAGE_MAX || count == 0 || count > MAX_TOWERS) return false;
+
+    ota_master_begin(m);
+    m->image = image;
+    m->size = size;
+    m->crc = ota_crc16(image, size);
+    m->chunks = (uint16_t)((size + OTA_CHUNK_SIZE - 1) / OTA_CHUNK_SIZE);
+    m->session = session;
+    m->target_count = count;
+    for (uint16_t i = 0; i < count; i++) {
+        m->targets[i].id = ids[i];
+        m->targets[i].need_begin = true;
+    }
+    set_all(m->send, m->chunks);
+    m->stats.started_ms = now;
+    enter_target_phase(m, OTA_PHASE_BEGIN, now);
+    return true;
+}
+
+uint8_t ota_master_poll(OtaMaster_t* m, uint32_t now, uint8_t* buf) {
+    switch (m->phase) {
+        case OTA_PHASE_SEND: {
+            while (m->cursor < m->chunks && !OTA_BIT(m->send, m->cursor)) m->cursor++;
+            if (m->cursor >= m->chunks) {
+                enter_target_phase(m, OTA_PHASE_QUERY, now);
+                return ota_master_poll(m, now, buf);
+            }
+            if (m->stats.data_frames && now - m->last_data < OTA_DATA_INTERVAL_MS) return 0;
+
+            uint16_t index = m->cursor++;
+            uint16_t offset = (uint16_t)(index * OTA_CHUNK_SIZE);
+            uint8_t n = (uint8_t)(m->size - offset < OTA_CHUNK_SIZE ? m->size - offset : OTA_CHUNK_SIZE);
+            buf[0] = 0x00;
+            buf[1] = CMD_OTA_DATA;
+            buf[OTA_DATA_SESSION] = m->session;
+            put16(buf + OTA_DATA_INDEX, index);
+            memcpy(buf + OTA_DATA_HEADER, m->image + offset, n);
+
+            m->last_data = now;
+            m->stats.data_frames++;
+            m->stats.data_bytes += n;
+            if (m->round > 1) m->stats.retransmitted++;
+            return (uint8_t)(OTA_DATA_HEADER + n);
+        }
+
+        case OTA_PHASE_BEGIN:
+        case OTA_PHASE_QUERY:
+        case OTA_PHASE_ACTIVATE:
+            if (m->waiting) {
+                if (now - m->sent_at < OTA_REPLY_TIMEOUT_MS) return 0;
+                m->stats.timeouts++;
+                if (m->retries >= (m->phase == OTA_PHASE_BEGIN ? OTA_BEGIN_RETRIES : OTA_RETRIES)) {
+                    // 查询: 本轮跳过，连续几轮无应答才放弃；激活命令可能已执行 (应答丢失)
+                    OtaTarget_t* t = &m->targets[m->current];
+                    if (m->phase == OTA_PHASE_BEGIN ||
+                        (m->phase == OTA_PHASE_QUERY && ++t->silent >= OTA_RETRIES)) {
+                        t->result = OTA_NODE_FAILED;
+                    }
+                    advance_target(m, now);
+                    return ota_master_poll(m, now, buf);
+                }
+                m->retries++;
+            }
+            m->waiting = true;
+            m->sent_at = now;
+            m->stats.control_frames++;
+            return build_target_frame(m, buf);
+
+        default:
+            return 0;
+    }
+}
+
+bool ota_master_handle_frame(OtaMaster_t* m, const uint8_t* frame, uint8_t len, uint32_t now) {
+    if (len < 2 || frame[1] != CMD_OTA_STATUS) return false;
+    if (len < OTA_STATUS_LEN) return true;
+    m->stats.replies++;
+
+    // 只接受当前目标的应答 (迟到的重复应答忽略)
+    if (!m->waiting || m->current >= m->target_count) return true;
+    OtaTarget_t* t = &m->targets[m->current];
+    if (frame[0] != t->id) return true;
+    on_status(m, t, frame, now);
+    return true;
+}
+
+bool ota_master_active(const OtaMaster_t* m) {
+    return m->phase != OTA_PHASE_IDLE && m->phase != OTA_PHASE_DONE;
+}
+
+uint16_t ota_crc16(const uint8_t* data, uint16_t len) {
+    uint16_t crc = OTA_CRC_INIT;
+    for (uint16_t i = 0; i < len; i++) {
+        crc ^= (uint16_t)(data[i] << 8);
+        for (uint8_t j = 0; j < 8; j++) {
+            crc = (uint16_t)((crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1);
+        }
+    }
+    return crc;
+}
+
+const char* ota_phase_name(OtaPhase_t phase) {
+    switch (phase) {
+        case OTA_PHASE_BEGIN: return "begin";
+        case OTA_PHASE_SEND: return "send";
+        case OTA_PHASE_QUERY: return "query";
+        case OTA_PHASE_ACTIVATE: return "activate";
+        case OTA_PHASE_DONE: return "done";
+        default: return "idle";
+    }
+}
+
+const char* ota_node_result_name(uint8_t result) {
+    switch (result) {
+        case OTA_NODE_VERIFIED: return "verified";
+        case OTA_NODE_ACTIVATED: return "activated";
+        case OTA_NODE_FAILED: return "failed";
+        default: return "pending";
+    }
+}
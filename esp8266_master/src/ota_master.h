@@ -0,0 +1,180 @@
+/*
+ * 从机空中升级主机端 - 镜像分片广播、合并缺片位图、选择性重发、激活
+ *
+ * 从机端和帧格式见 slave_node_stc8g/inc/slave_ota.h (常量须保持一致)。与控制核心一样
+ * 不依赖 Arduino：调用方按节拍调用 ota_master_poll() 取出要发送的帧，收到的帧先交给
+ * ota_master_handle_frame() (STATUS 帧在此消费，不再交给控制核心)。
+ *
+ * 一次会话:
+ * 1. BEGIN   逐个目标发送，等待应答 (从机擦除暂存区后应答)
+ * 2. SEND    按 OTA_DATA_INTERVAL_MS 广播本轮的分片 (第一轮为全部)
+ * 3. QUERY   逐个未完成的目标查询缺片位图 (每帧一个窗口，缺片更多时继续查下一个窗口)，
+ *            合并为下一轮要发送的分片；还有缺片则回到 SEND，丢失会话的目标回到 BEGIN
+ * 4. ACTIVATE 逐个校验通过的目标发送激活命令
+ * BEGIN 无应答的目标重发 OTA_BEGIN_RETRIES 次后放弃 (电池节点只在上报后短暂接收，重发须覆盖
+ * 两个上报周期)；查询无应答的目标本轮跳过，连续
+ * OTA_RETRIES 轮无应答才放弃；超过 OTA_MAX_ROUNDS 轮仍未收齐的目标也放弃，其余目标照常激活。
+ *
+ * 镜像由调用方保存，会话期间不能释放。一次只有一个会话。
+ */
+
+#ifndef OTA_MASTER_H
+#define OTA_MASTER_H
+
+#include <stdint.h>
+#include "water_system.h"
+
+// ==================== 参数 (与 slave_ota.h 相同) ====================
+#define OTA_CHUNK_SIZE          24
+#define OTA_IMAGE_MAX           0x1400
+#define OTA_CHUNKS_MAX          ((OTA_IMAGE_MAX + OTA_CHUNK_SIZE - 1) / OTA_CHUNK_SIZE)
+#define OTA_BITMAP_BYTES        ((OTA_CHUNKS_MAX + 7) / 8)
+#define OTA_CRC_INIT            0xFFFF
+
+#define OTA_TARGET              2
+#define OTA_SESSION             3
+#define OTA_BEGIN_SIZE          4
+#define OTA_BEGIN_CRC           6
+#define OTA_BEGIN_LEN           8
+#define OTA_DATA_SESSION        2
+#define OTA_DATA_INDEX          3
+#define OTA_DATA_HEADER         5
+#define OTA_DATA_LEN_MAX        (OTA_DATA_HEADER + OTA_CHUNK_SIZE)
+#define OTA_QUERY_FROM          4
+#define OTA_QUERY_LEN           6
+#define OTA_ACTIVATE_LEN        4
+#define OTA_STATUS_SESSION      2
+#define OTA_STATUS_STATE        3
+#define OTA_STATUS_MISSING      4
+#define OTA_STATUS_BASE         6
+#define OTA_STATUS_HEADER       8
+#define OTA_STATUS_BITMAP       16
+#define OTA_STATUS_WINDOW       (OTA_STATUS_BITMAP * 8)
+#define OTA_STATUS_LEN          (OTA_STATUS_HEADER + OTA_STATUS_BITMAP)
+
+#define OTA_STATE_IDLE          0
+#define OTA_STATE_RECEIVING     1
+#define OTA_STATE_VERIFIED      2
+#define OTA_STATE_CRC_ERROR     3
+#define OTA_STATE_REJECTED      4
+#define OTA_STATE_ACTIVATING    5
+
+// ==================== 主机端参数 ====================
+// 分片之间的间隔 (毫秒): SF7/125kHz 下 29 字节约 67 ms 空中时间，加上从机写 Flash 的余量
+#define OTA_DATA_INTERVAL_MS    100
+#define OTA_REPLY_TIMEOUT_MS    1000    // 等待 STATUS 应答 (含从机擦除暂存区)
+#define OTA_RETRIES             3       // 无应答时的重发次数
+#define OTA_BEGIN_RETRIES       30      // BEGIN 的重发次数 (约 30 秒，从机上报间隔 15 秒)
+#define OTA_MAX_ROUNDS          16      // 分片发送的最大轮数
+
+typedef enum {
+    OTA_PHASE_IDLE = 0,
+    OTA_PHASE_BEGIN,
+    OTA_PHASE_SEND,
+    OTA_PHASE_QUERY,
+    OTA_PHASE_ACTIVATE,
+    OTA_PHASE_DONE
+} OtaPhase_t;
+
+// 目标节点的结果
+typedef enum {
+    OTA_NODE_PENDING = 0,   // 接收中
+    OTA_NODE_VERIFIED,      // 已收齐且校验通过
+    OTA_NODE_ACTIVATED,     // 已确认激活
+    OTA_NODE_FAILED         // 无应答、镜像被拒绝或超过最大轮数
+} OtaNodeResult_t;
+
+// ==================== 状态 ====================
+typedef struct {
+    uint8_t id;
+    uint8_t result;             // OtaNodeResult_t
+    uint8_t state;              // 最近一次应答中的从机状态 (OTA_STATE_*)
+    bool need_begin;            // 需要 (重新) 发送 BEGIN
+    uint8_t silent;             // 连续无应答的查询轮数
+    uint16_t missing;           // 最近一次应答中的缺片数
+} OtaTarget_t;
+
+typedef struct {
+    uint32_t data_frames;       // 发出的分片 (含重发)
+    uint32_t data_bytes;        // 分片数据字节
+    uint32_t retransmitted;     // 第二轮起重发的分片
+    uint32_t control_frames;    // BEGIN/QUERY/ACTIVATE
+    uint32_t replies;           // 收到的 STATUS
+    uint32_t timeouts;          // 等待应答超时
+    uint32_t started_ms;
+    uint32_t finished_ms;
+} OtaStats_t;
+
+typedef struct {
+    OtaPhase_t phase;
+    const uint8_t* image;
+    uint16_t size;
+    uint16_t crc;
+    uint16_t chunks;
+    uint8_t session;
+
+    OtaTarget_t targets[MAX_TOWERS];
+    uint16_t target_count;
+
+    uint8_t send[OTA_BITMAP_BYTES];     // 本轮要发送的分片
+    uint8_t next[OTA_BITMAP_BYTES];     // 查询得到的缺片并集 (下一轮)
+    uint16_t cursor;                    // SEND: 下一个检查的分片
+    uint16_t current;                   // BEGIN/QUERY/ACTIVATE: 当前目标
+    uint16_t query_from;                // QUERY: 当前窗口的起始分片
+    uint8_t round;                      // 分片发送轮数 (1 起)
+
+    bool waiting;                       // 等待当前目标应答
+    uint8_t retries;
+    uint32_t sent_at;
+    uint32_t last_data;
+
+    OtaStats_t stats;
+} OtaMaster_t;
+
+// ==================== 函数声明 ====================
+
+/**
+ * 初始化 (没有会话)
+ */
+void ota_master_begin(OtaMaster_t* m);
+
+/**
+ * 开始一次会话 (取代正在进行的会话)
+ * @param image 镜像，会话结束前不能释放
+ * @param ids 目标从机地址 (不超过 MAX_TOWERS 个，不能重复)
+ * @param session 会话号 (与从机上次的会话不同)
+ * @return false=镜像长度或目标无效
+ */
+bool ota_master_start(OtaMaster_t* m, const uint8_t* image, uint16_t size, const uint8_t* ids, uint16_t count,
+                      uint8_t session, uint32_t now);
+
+/**
+ * 取出现在要发送的帧 (每次最多一帧，调用方发送后再次调用)
+ * @param buf 至少 OTA_DATA_LEN_MAX 字节
+ * @return 帧长度，0=现在没有要发送的
+ */
+uint8_t ota_master_poll(OtaMaster_t* m, uint32_t now, uint8_t* buf);
+
+/**
+ * 处理收到的一帧
+ * @return true=升级应答 (已消费)
+ */
+bool ota_master_handle_frame(OtaMaster_t* m, const uint8_t* frame, uint8_t len, uint32_t now);
+
+/**
+ * 会话是否进行中
+ */
+bool ota_master_active(const OtaMaster_t* m);
+
+/**
+ * 镜像的 CRC-16/CCITT-FALSE (与从机 slave_ota_crc16 相同)
+ */
+uint16_t ota_crc16(const uint8_t* data, uint16_t len);
+
+/**
+ * 阶段、节点结果的名称 (状态接口用)
+ */
+const char* ota_phase_name(OtaPhase_t phase);
+const char* ota_node_result_name(uint8_t result);
+
+#endif  // OTA_MASTER_H
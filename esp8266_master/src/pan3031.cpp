@@ -4,10 +4,15 @@
 
 #include "pan3031.h"
 #include <SPI.h>
+#include "logger.h"
 
 // 引脚
 static uint8_t PIN_CS, PIN_MOSI, PIN_MISO, PIN_SCK, PIN_IRQ;
 
+// 最近一帧的信号质量
+static int16_t packet_rssi = 0;
+static int8_t packet_snr = 0;
+
 // ==================== 初始化 ====================
 void pan3031_init(uint8_t cs, uint8_t mosi, uint8_t miso, uint8_t sck, uint8_t irq) {
     PIN_CS = cs;
@@ -31,8 +36,8 @@ void pan3031_init(uint8_t cs, uint8_t mosi, uint8_t miso, uint8_t sck, uint8_t i
     
     // 读取版本验证
     uint8_t version = pan3031_read_reg(REG_SYNC_WORD);
-    Serial.print("PAN3031 版本：0x");
-    Serial.println(version, HEX);
+    LOG_I("PAN3031 版本：0x%02X", version);
+    (void)version;
     
     // 进入待机模式
     pan3031_write_reg(REG_OP_MODE, MODE_STDBY);
@@ -124,7 +129,7 @@ void pan3031_send(uint8_t *data, uint8_t len) {
     pan3031_write_reg(REG_OP_MODE, MODE_TX);
     
     // 等待完成
-    while ((pan3031_read_reg(REG_IRQ_FLAGS) & 0x08) == 0);
+    while ((pan3031_read_reg(REG_IRQ_FLAGS) & IRQ_TX_DONE) == 0);
     
     // 清除中断
     pan3031_write_reg(REG_IRQ_FLAGS, 0xFF);
@@ -141,7 +146,7 @@ bool pan3031_receive(uint8_t *data, uint8_t *len) {
     // 检查中断
     uint8_t irq_flags = pan3031_read_reg(REG_IRQ_FLAGS);
     
-    if (irq_flags & 0x40) {  // RxDone
+    if (irq_flags & IRQ_RX_DONE) {
         uint8_t rx_len = pan3031_read_reg(REG_RX_NB_BYTES);
         if (rx_len > 32) rx_len = 32;
         *len = rx_len;
@@ -157,6 +162,11 @@ bool pan3031_receive(uint8_t *data, uint8_t *len) {
         }
         digitalWrite(PIN_CS, HIGH);
         
+        // 信号质量 (433 MHz 频段: RSSI = -164 + 寄存器值，SNR 为负时再加 SNR)
+        packet_snr = (int8_t)pan3031_read_reg(REG_PKT_SNR);
+        packet_rssi = -164 + pan3031_read_reg(REG_PKT_RSSI);
+        if (packet_snr < 0) packet_rssi += packet_snr / 4;
+        
         // 清除中断
         pan3031_write_reg(REG_IRQ_FLAGS, 0xFF);
         
@@ -166,6 +176,14 @@ bool pan3031_receive(uint8_t *data, uint8_t *len) {
     return false;
 }
 
+int16_t pan3031_packet_rssi(void) {
+    return packet_rssi;
+}
+
+int8_t pan3031_packet_snr(void) {
+    return packet_snr;
+}
+
 // ==================== 睡眠模式 ====================
 void pan3031_sleep(void) {
     pan3031_write_reg(REG_OP_MODE, MODE_SLEEP);
@@ -0,0 +1,47 @@
+/*
+ * PAN3031 LoRa 寄存器定义
+ *
+ * 不依赖 Arduino，ESP8266 驱动和 Linux 主机 spidev 驱动共用
+ */
+
+#ifndef PAN3031_REGS_H
+#define PAN3031_REGS_H
+
+// 寄存器定义
+#define REG_FIFO            0x00
+#define REG_OP_MODE         0x01
+#define REG_FRF_MSB         0x06
+#define REG_FRF_MID         0x07
+#define REG_FRF_LSB         0x08
+#define REG_PA_CONFIG       0x09
+#define REG_LNA             0x0C
+#define REG_FIFO_ADDR_PTR   0x0D
+#define REG_FIFO_TX_BASE    0x0E
+#define REG_FIFO_RX_BASE    0x0F
+#define REG_FIFO_RX_ADDR    0x10
+#define REG_IRQ_FLAGS       0x12
+#define REG_RX_NB_BYTES     0x13
+#define REG_PKT_SNR         0x19
+#define REG_PKT_RSSI        0x1A
+#define REG_MODEM_CONFIG1   0x1D
+#define REG_MODEM_CONFIG2   0x1E
+#define REG_PREAMBLE        0x20
+#define REG_PAYLOAD_LEN     0x22
+#define REG_MODEM_CONFIG3   0x26
+#define REG_SYNC_WORD       0x39
+
+// 工作模式
+#define MODE_SLEEP          0x00
+#define MODE_STDBY          0x01
+#define MODE_FSTX           0x02
+#define MODE_TX             0x03
+#define MODE_FSRX           0x04
+#define MODE_RXCONT         0x05
+#define MODE_RXSINGLE       0x06
+
+// 中断标志 (REG_IRQ_FLAGS)
+#define IRQ_RX_DONE         0x40
+#define IRQ_CRC_ERROR       0x20
+#define IRQ_TX_DONE         0x08
+
+#endif  // PAN3031_REGS_H
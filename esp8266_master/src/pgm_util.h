@@ -0,0 +1,62 @@
+/*
+ * PROGMEM 字符串辅助
+ *
+ * ESP8266 上普通字符串常量 (.rodata) 会被复制到 DRAM，
+ * 日志、界面和错误描述文本统一放在闪存中：
+ * - 字面量直接打印：Serial.print(F("..."))
+ * - 表格中的字符串：static const char name[] PROGMEM = "...";
+ *   表项保存 PGM_P 指针，使用下列辅助函数打印或复制
+ *
+ * 注意：闪存只能按 4 字节对齐读取，PROGMEM 数据必须经
+ * pgm_read_xxx() / strncpy_P() 等函数访问，不能直接解引用。
+ */
+
+#ifndef PGM_UTIL_H
+#define PGM_UTIL_H
+
+#include <Arduino.h>
+
+/**
+ * 打印 PROGMEM 字符串
+ * @param out 输出目标
+ * @param str PROGMEM 字符串指针
+ * @return 输出字节数
+ */
+static inline size_t print_P(Print& out, PGM_P str) {
+    return out.print(FPSTR(str));
+}
+
+/**
+ * 打印 PROGMEM 字符串并换行
+ * @param out 输出目标
+ * @param str PROGMEM 字符串指针
+ * @return 输出字节数
+ */
+static inline size_t println_P(Print& out, PGM_P str) {
+    return out.println(FPSTR(str));
+}
+
+/**
+ * 复制 PROGMEM 字符串到 RAM 缓冲区 (保证以 '\0' 结尾)
+ * @param dst 目标缓冲区
+ * @param src PROGMEM 字符串指针
+ * @param size 缓冲区大小
+ * @return 复制的字符数
+ */
+static inline size_t copy_P(char* dst, PGM_P src, size_t size) {
+    if (size == 0) return 0;
+    strncpy_P(dst, src, size - 1);
+    dst[size - 1] = '\0';
+    return strlen(dst);
+}
+
+/**
+ * JSON 布尔值的 PROGMEM 字符串，配合 snprintf_P 的 %S 使用
+ * @param value 布尔值
+ * @return "true" / "false"
+ */
+static inline PGM_P bool_P(bool value) {
+    return value ? PSTR("true") : PSTR("false");
+}
+
+#endif  // PGM_UTIL_H
@@ -3,6 +3,8 @@
  */
 
 #include "sr595.h"
+#include "trace.h"
+#include "logger.h"
 
 // 全局变量
 uint8_t g_relay_state = 0x00;  // 初始状态：所有继电器关闭
@@ -11,18 +13,32 @@ uint8_t g_relay_state = 0x00;  // 初始状态：所有继电器关闭
  * 初始化 74HC595
  */
 void sr595_init(void) {
+    sr595_init_state(0x00);
+}
+
+/**
+ * 以指定初始状态初始化 74HC595
+ */
+void sr595_init_state(uint8_t initial) {
     // 配置锁存引脚为输出
     pinMode(SR_LATCH_PIN, OUTPUT);
     pinMode(LORA_CS_PIN, OUTPUT);
-    
+
     // 初始状态：锁存高电平 (保持输出稳定)
     digitalWrite(SR_LATCH_PIN, HIGH);
     digitalWrite(LORA_CS_PIN, HIGH);  // LoRa 禁用
+
+    // 热启动恢复在 SPI.begin() 之前，数据/时钟引脚须先设为输出并拉低，
+    // 否则 shiftOut 不起作用，锁存的是 LoRa 通信残留在移位寄存器中的数据
+    digitalWrite(D7, LOW);   // MOSI
+    digitalWrite(D5, LOW);   // SCK
+    pinMode(D7, OUTPUT);
+    pinMode(D5, OUTPUT);
+
+    // 输出初始状态 (冷启动为全 0)
+    sr595_write(initial);
     
-    // 确保初始输出为全 0
-    sr595_write(0x00);
-    
-    Serial.println("✅ 74HC595 初始化完成");
+    LOG_I("✅ 74HC595 初始化完成");
 }
 
 /**
@@ -35,6 +51,8 @@ void sr595_init(void) {
  * 4. 拉高锁存引脚 (锁存并输出)
  */
 void sr595_write(uint8_t data) {
+    TRACE_SCOPE(TRACE_SPAN_RELAY);
+    
     // 1. 确保 LoRa 禁用 (避免 SPI 冲突)
     digitalWrite(LORA_CS_PIN, HIGH);
     
@@ -61,7 +79,7 @@ void sr595_write(uint8_t data) {
  */
 void sr595_relay_on(uint8_t relay_id) {
     if (relay_id > 7) {
-        Serial.println("❌ 继电器 ID 超出范围 (0-7)");
+        LOG_E("❌ 继电器 ID 超出范围 (0-7)");
         return;
     }
     
@@ -69,9 +87,7 @@ void sr595_relay_on(uint8_t relay_id) {
     g_relay_state |= (1 << relay_id);
     sr595_write(g_relay_state);
     
-    Serial.print("✅ 继电器 ");
-    Serial.print(relay_id);
-    Serial.println(" 开启");
+    LOG_D("✅ 继电器 %u 开启", relay_id);
 }
 
 /**
@@ -79,7 +95,7 @@ void sr595_relay_on(uint8_t relay_id) {
  */
 void sr595_relay_off(uint8_t relay_id) {
     if (relay_id > 7) {
-        Serial.println("❌ 继电器 ID 超出范围 (0-7)");
+        LOG_E("❌ 继电器 ID 超出范围 (0-7)");
         return;
     }
     
@@ -87,9 +103,7 @@ void sr595_relay_off(uint8_t relay_id) {
     g_relay_state &= ~(1 << relay_id);
     sr595_write(g_relay_state);
     
-    Serial.print("❌ 继电器 ");
-    Serial.print(relay_id);
-    Serial.println(" 关闭");
+    LOG_D("❌ 继电器 %u 关闭", relay_id);
 }
 
 /**
@@ -100,11 +114,29 @@ void sr595_set_all(uint8_t mask) {
     g_relay_state = mask;
     sr595_write(mask);
     
-    Serial.print("📊 继电器状态：0b");
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+    char bits[9];
     for (int i = 7; i >= 0; i--) {
-        Serial.print((mask >> i) & 0x01);
+        bits[7 - i] = ((mask >> i) & 0x01) ? '1' : '0';
+    }
+    bits[8] = '\0';
+    LOG_D("📊 继电器状态：0b%s", bits);
+#endif
+}
+
+/**
+ * 批量开启/关闭继电器
+ * 新状态一次移位锁存，避免逐个切换时的先后时差
+ */
+uint8_t sr595_apply(uint8_t set_mask, uint8_t clear_mask) {
+    uint8_t next = (g_relay_state | set_mask) & ~clear_mask;
+    uint8_t changed = next ^ g_relay_state;
+    
+    if (changed != 0) {
+        sr595_write(next);
+        LOG_D("📊 继电器批量切换：状态 0x%02X，变化 0x%02X", next, changed);
     }
-    Serial.println();
+    return changed;
 }
 
 /**
@@ -124,9 +156,7 @@ void sr595_toggle(uint8_t relay_id) {
     g_relay_state ^= (1 << relay_id);
     sr595_write(g_relay_state);
     
-    Serial.print("🔄 继电器 ");
-    Serial.print(relay_id);
-    Serial.println(" 状态切换");
+    LOG_D("🔄 继电器 %u 状态切换", relay_id);
 }
 
 /**
@@ -149,7 +179,7 @@ void sr595_pulse(uint8_t relay_id, uint16_t delay_ms) {
  * 测试所有继电器 (流水灯效果)
  */
 void sr595_test_sequence(void) {
-    Serial.println("🧪 开始继电器测试序列...");
+    LOG_I("🧪 开始继电器测试序列...");
     
     // 依次开启每个继电器
     for (int i = 0; i < 8; i++) {
@@ -165,22 +195,22 @@ void sr595_test_sequence(void) {
     
     // 全部开启
     sr595_set_all(0xFF);
-    Serial.println("所有继电器开启");
+    LOG_I("所有继电器开启");
     delay(500);
     
     // 全部关闭
     sr595_set_all(0x00);
-    Serial.println("所有继电器关闭");
+    LOG_I("所有继电器关闭");
     delay(500);
     
-    Serial.println("✅ 测试完成");
+    LOG_I("✅ 测试完成");
 }
 
 /**
  * 二进制计数测试
  */
 void sr595_test_binary(void) {
-    Serial.println("🧪 开始二进制计数测试...");
+    LOG_I("🧪 开始二进制计数测试...");
     
     for (uint8_t i = 0; i <= 255; i++) {
         sr595_set_all(i);
@@ -188,5 +218,5 @@ void sr595_test_binary(void) {
     }
     
     sr595_set_all(0x00);
-    Serial.println("✅ 测试完成");
+    LOG_I("✅ 测试完成");
 }
@@ -33,6 +33,12 @@ extern uint8_t g_relay_state;  // 继电器当前状态
  */
 void sr595_init(void);
 
+/**
+ * 以指定初始状态初始化 74HC595 (热启动恢复继电器输出，不经过全 0)
+ * @param initial 初始继电器状态
+ */
+void sr595_init_state(uint8_t initial);
+
 /**
  * 写入 8 位数据到 74HC595
  * @param data 8 位数据，每位控制一个继电器
@@ -57,6 +63,14 @@ void sr595_relay_off(uint8_t relay_id);
  */
 void sr595_set_all(uint8_t mask);
 
+/**
+ * 批量开启/关闭继电器 (一次写入，所有继电器同时切换)
+ * @param set_mask 需要开启的继电器
+ * @param clear_mask 需要关闭的继电器 (与 set_mask 重叠时以关闭为准)
+ * @return 状态实际发生变化的继电器
+ */
+uint8_t sr595_apply(uint8_t set_mask, uint8_t clear_mask);
+
 /**
  * 获取当前继电器状态
  * @return 8 位状态值
@@ -0,0 +1,122 @@
+/*
+ * 周期计数器追踪实现
+ */
+
+#include "trace.h"
+#include "pgm_util.h"
+
+// 区段名称 (PROGMEM)
+static const char span_loop[] PROGMEM = "loop";
+static const char span_web[] PROGMEM = "web";
+static const char span_lora_rx[] PROGMEM = "lora_rx";
+static const char span_oled[] PROGMEM = "oled";
+static const char span_auto[] PROGMEM = "auto_ctrl";
+static const char span_error_display[] PROGMEM = "error_display";
+static const char span_relay[] PROGMEM = "relay";
+static const char span_api_build[] PROGMEM = "api_build";
+static const char span_unknown[] PROGMEM = "unknown";
+
+// 区段名称表 (顺序与 TraceSpan_t 一致)
+static const char* const span_names[TRACE_SPAN_COUNT] PROGMEM = {
+    span_loop,
+    span_web,
+    span_lora_rx,
+    span_oled,
+    span_auto,
+    span_error_display,
+    span_relay,
+    span_api_build,
+};
+
+PGM_P trace_span_name(uint8_t span) {
+    if (span >= TRACE_SPAN_COUNT) return span_unknown;
+    return (PGM_P)pgm_read_ptr(&span_names[span]);
+}
+
+#if TRACE_ENABLE
+
+// 全局缓冲区
+TraceEvent_t g_trace_buf[TRACE_BUFFER_SIZE];
+uint32_t g_trace_head = 0;
+bool g_trace_paused = false;
+
+/**
+ * 清空追踪缓冲区
+ */
+void trace_reset(void) {
+    g_trace_paused = true;
+    g_trace_head = 0;
+    memset(g_trace_buf, 0, sizeof(g_trace_buf));
+    g_trace_paused = false;
+}
+
+/**
+ * 导出 Chrome trace-event JSON
+ *
+ * CCOUNT 为 32 位，80MHz 下约 53 秒回绕一次。
+ * 相邻事件间隔远小于回绕周期，因此按相邻差值累加即可得到单调时间轴。
+ */
+uint16_t trace_dump(Print& out) {
+    g_trace_paused = true;
+
+    uint32_t total = g_trace_head;
+    uint32_t count = (total > TRACE_BUFFER_SIZE) ? TRACE_BUFFER_SIZE : total;
+    uint32_t start = total - count;
+    uint32_t mhz = ESP.getCpuFreqMHz();
+    if (mhz == 0) mhz = 80;
+
+    // 每个区段当前打开的层数，用于丢弃起点已被覆盖的 'E' 事件
+    uint8_t depth[TRACE_SPAN_COUNT];
+    memset(depth, 0, sizeof(depth));
+
+    uint64_t elapsed = 0;
+    uint32_t prev = 0;
+    uint16_t emitted = 0;
+    char line[64];
+
+    out.print(F("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["));
+
+    for (uint32_t n = 0; n < count; n++) {
+        const TraceEvent_t* ev = &g_trace_buf[(start + n) & (TRACE_BUFFER_SIZE - 1)];
+        if (n > 0) elapsed += (uint32_t)(ev->cycles - prev);
+        prev = ev->cycles;
+
+        if (ev->span >= TRACE_SPAN_COUNT) continue;
+        if (ev->phase == TRACE_PH_BEGIN) {
+            depth[ev->span]++;
+        } else {
+            if (depth[ev->span] == 0) continue;
+            depth[ev->span]--;
+        }
+
+        uint32_t us = (uint32_t)(elapsed / mhz);
+        uint32_t frac = (uint32_t)((elapsed % mhz) * 1000 / mhz);
+        if (emitted > 0) out.print(',');
+        out.print(F("{\"name\":\""));
+        print_P(out, trace_span_name(ev->span));
+        snprintf_P(line, sizeof(line),
+                   PSTR("\",\"ph\":\"%c\",\"ts\":%lu.%03lu,\"pid\":1,\"tid\":1}"),
+                   ev->phase, (unsigned long)us, (unsigned long)frac);
+        out.print(line);
+        emitted++;
+    }
+
+    out.print(F("],\"otherData\":{\"dropped\":"));
+    out.print(total - count);
+    out.println(F("}}"));
+
+    g_trace_paused = false;
+    return emitted;
+}
+
+#else  // !TRACE_ENABLE
+
+void trace_reset(void) {
+}
+
+uint16_t trace_dump(Print& out) {
+    out.println(F("{\"traceEvents\":[]}"));
+    return 0;
+}
+
+#endif  // TRACE_ENABLE
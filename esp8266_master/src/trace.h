@@ -0,0 +1,127 @@
+/*
+ * 周期计数器追踪 - 热路径耗时采样
+ *
+ * 基于 ESP.getCycleCount() (CCOUNT 寄存器，80MHz 下每周期 12.5ns)，
+ * 把命名区段的开始/结束事件写入静态环形缓冲区，用于定位偶发的长时间卡顿。
+ *
+ * 使用:
+ * - TRACE_SCOPE(TRACE_SPAN_xxx)  当前作用域内计时 (RAII)
+ * - TRACE_BEGIN / TRACE_END       手动成对标记
+ * - trace_dump(Serial)            导出 Chrome trace-event JSON
+ *   (chrome://tracing 或 https://ui.perfetto.dev 打开)
+ *
+ * 编译开关:
+ * - TRACE_ENABLE=1 启用 (见 platformio.ini 的 nodemcuv2_trace 环境)
+ * - 未定义或为 0 时所有宏展开为空，缓冲区不占内存，零开销
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <Arduino.h>
+
+#ifndef TRACE_ENABLE
+#define TRACE_ENABLE 0
+#endif
+
+// 环形缓冲区大小 (必须为 2 的幂，每条事件 8 字节)
+#ifndef TRACE_BUFFER_SIZE
+#define TRACE_BUFFER_SIZE 256
+#endif
+
+// ==================== 区段定义 ====================
+
+typedef enum {
+    TRACE_SPAN_LOOP = 0,        // 主循环一次迭代
+    TRACE_SPAN_WEB,             // Web 请求处理
+    TRACE_SPAN_LORA_RX,         // LoRa 接收处理
+    TRACE_SPAN_OLED,            // OLED 刷新
+    TRACE_SPAN_AUTO,            // 自动控制
+    TRACE_SPAN_ERROR_DISPLAY,   // 错误显示
+    TRACE_SPAN_RELAY,           // 继电器写入
+    TRACE_SPAN_API_BUILD,       // REST 响应体重新生成 (缓存过期)
+    TRACE_SPAN_COUNT
+} TraceSpan_t;
+
+// 事件类型 (与 Chrome trace-event 的 ph 字段一致)
+#define TRACE_PH_BEGIN  'B'
+#define TRACE_PH_END    'E'
+
+#if TRACE_ENABLE
+
+#if (TRACE_BUFFER_SIZE & (TRACE_BUFFER_SIZE - 1)) != 0
+#error "TRACE_BUFFER_SIZE 必须为 2 的幂"
+#endif
+
+// 追踪事件 (8 字节)
+typedef struct {
+    uint32_t cycles;        // CCOUNT 时间戳
+    uint8_t span;           // 区段 ID
+    uint8_t phase;          // 'B' / 'E'
+    uint16_t reserved;
+} TraceEvent_t;
+
+extern TraceEvent_t g_trace_buf[TRACE_BUFFER_SIZE];
+extern uint32_t g_trace_head;      // 写入总数 (低位即索引)
+extern bool g_trace_paused;        // 导出期间暂停记录
+
+/**
+ * 记录一个事件
+ * @param span 区段 ID
+ * @param phase TRACE_PH_BEGIN / TRACE_PH_END
+ */
+static inline void trace_record(uint8_t span, uint8_t phase) {
+    if (g_trace_paused) return;
+    TraceEvent_t* ev = &g_trace_buf[g_trace_head & (TRACE_BUFFER_SIZE - 1)];
+    ev->cycles = ESP.getCycleCount();
+    ev->span = span;
+    ev->phase = phase;
+    g_trace_head++;
+}
+
+// 作用域计时辅助类
+class TraceScope {
+public:
+    explicit TraceScope(uint8_t span) : span_(span) { trace_record(span_, TRACE_PH_BEGIN); }
+    ~TraceScope() { trace_record(span_, TRACE_PH_END); }
+private:
+    uint8_t span_;
+};
+
+#define TRACE_CONCAT_(a, b)   a##b
+#define TRACE_CONCAT(a, b)    TRACE_CONCAT_(a, b)
+#define TRACE_BEGIN(span)     trace_record((span), TRACE_PH_BEGIN)
+#define TRACE_END(span)       trace_record((span), TRACE_PH_END)
+#define TRACE_SCOPE(span)     TraceScope TRACE_CONCAT(_trace_scope_, __LINE__)(span)
+
+#else  // !TRACE_ENABLE
+
+#define TRACE_BEGIN(span)     ((void)0)
+#define TRACE_END(span)       ((void)0)
+#define TRACE_SCOPE(span)     ((void)0)
+
+#endif  // TRACE_ENABLE
+
+// ==================== 函数声明 ====================
+
+/**
+ * 清空追踪缓冲区
+ */
+void trace_reset(void);
+
+/**
+ * 获取区段名称
+ * @param span 区段 ID
+ * @return 区段名称 (PROGMEM)
+ */
+PGM_P trace_span_name(uint8_t span);
+
+/**
+ * 导出缓冲区内容为 Chrome trace-event JSON
+ * 导出期间暂停记录，时间戳单位为微秒 (相对最早事件)
+ * @param out 输出目标 (Serial 或 HTTP 分块输出)
+ * @return 导出的事件数
+ */
+uint16_t trace_dump(Print& out);
+
+#endif  // TRACE_H
@@ -0,0 +1,208 @@
+/*
+ * 热启动恢复实现
+ */
+
+#include "warm_boot.h"
+#include "logger.h"
+
+extern "C" {
+#include <user_interface.h>
+}
+
+// RTC 中保存的单个水塔状态 (4 字节)
+typedef struct {
+    uint8_t id;
+    uint8_t water_level;
+    uint8_t flags;          // bit0=水泵 bit1=在线 bit2=低水位 bit3=溢水 bit4=缺水
+    uint8_t reserved;
+} RtcTower_t;
+
+#define RTC_TOWER_PUMP      0x01
+#define RTC_TOWER_ONLINE    0x02
+#define RTC_TOWER_LOW       0x04
+#define RTC_TOWER_OVERFLOW  0x08
+#define RTC_TOWER_SHORTAGE  0x10
+
+// RTC 中保存的完整状态 (大小必须为 4 的倍数)
+typedef struct {
+    uint32_t magic;
+    uint32_t boot_count;
+    uint8_t relay_state;
+    uint8_t mode;
+    uint8_t tower_count;
+    uint8_t reserved;
+    RtcTower_t towers[MAX_TOWERS];
+    uint32_t crc;
+} RtcState_t;
+
+static_assert(sizeof(RtcState_t) % 4 == 0, "RtcState_t 大小必须为 4 的倍数");
+static_assert(WARM_BOOT_RTC_OFFSET * 4 + sizeof(RtcState_t) <= 512, "RTC 用户内存不足");
+
+static RtcState_t rtc_state;
+static bool boot_warm = false;
+
+// 各阶段完成时刻 (微秒，自复位起)
+static uint32_t phase_us[BOOT_PHASE_COUNT];
+
+static const char phase_restore[] PROGMEM = "restore";
+static const char phase_relay[] PROGMEM = "relay";
+static const char phase_oled[] PROGMEM = "oled";
+static const char phase_lora[] PROGMEM = "lora";
+static const char phase_wifi[] PROGMEM = "wifi";
+static const char phase_server[] PROGMEM = "server";
+static const char phase_first_control[] PROGMEM = "first_control";
+
+static const char* const phase_names[BOOT_PHASE_COUNT] PROGMEM = {
+    phase_restore,
+    phase_relay,
+    phase_oled,
+    phase_lora,
+    phase_wifi,
+    phase_server,
+    phase_first_control,
+};
+
+// ==================== 内部函数 ====================
+
+/**
+ * CRC32 (IEEE 802.3，按位计算，数据量小无需查表)
+ */
+static uint32_t crc32(const uint8_t* data, size_t len) {
+    uint32_t crc = 0xFFFFFFFF;
+    while (len--) {
+        crc ^= *data++;
+        for (uint8_t i = 0; i < 8; i++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+static uint32_t rtc_state_crc(const RtcState_t* state) {
+    return crc32((const uint8_t*)state, offsetof(RtcState_t, crc));
+}
+
+// ==================== 函数实现 ====================
+
+/**
+ * 从 RTC 内存恢复控制状态
+ */
+bool warm_boot_restore(TowerData* towers, uint16_t* tower_count,
+                       SystemStatus* status, uint8_t* relay_state) {
+    uint32_t reason = ESP.getResetInfoPtr()->reason;
+
+    bool valid = ESP.rtcUserMemoryRead(WARM_BOOT_RTC_OFFSET, (uint32_t*)&rtc_state, sizeof(rtc_state)) &&
+                 rtc_state.magic == WARM_BOOT_MAGIC &&
+                 rtc_state.crc == rtc_state_crc(&rtc_state) &&
+                 rtc_state.tower_count <= MAX_TOWERS;
+
+    // 深度睡眠唤醒按冷启动处理 (状态可能已过期很久)
+    boot_warm = valid && reason != REASON_DEEP_SLEEP_AWAKE;
+
+    if (!boot_warm) {
+        memset(&rtc_state, 0, sizeof(rtc_state));
+        rtc_state.magic = WARM_BOOT_MAGIC;
+        *relay_state = 0x00;
+        boot_phase_mark(BOOT_PHASE_RESTORE);
+        return false;
+    }
+
+    rtc_state.boot_count++;
+
+    *relay_state = rtc_state.relay_state;
+    status->mode = (rtc_state.mode == MODE_MANUAL) ? MODE_MANUAL : MODE_AUTO;
+    *tower_count = rtc_state.tower_count;
+
+    for (uint8_t i = 0; i < rtc_state.tower_count; i++) {
+        const RtcTower_t* t = &rtc_state.towers[i];
+        towers[i].id = t->id;
+        towers[i].water_level = t->water_level;
+        towers[i].pump_on = (t->flags & RTC_TOWER_PUMP) != 0;
+        towers[i].online = (t->flags & RTC_TOWER_ONLINE) != 0;
+        towers[i].low_water_alarm = (t->flags & RTC_TOWER_LOW) != 0;
+        towers[i].overflow_alarm = (t->flags & RTC_TOWER_OVERFLOW) != 0;
+        towers[i].shortage_alarm = (t->flags & RTC_TOWER_SHORTAGE) != 0;
+    }
+
+    boot_phase_mark(BOOT_PHASE_RESTORE);
+    return true;
+}
+
+/**
+ * 保存当前控制状态到 RTC 内存
+ */
+void warm_boot_save(const TowerData* towers, uint16_t tower_count,
+                    const SystemStatus* status, uint8_t relay_state) {
+    if (tower_count > MAX_TOWERS) tower_count = MAX_TOWERS;
+
+    rtc_state.magic = WARM_BOOT_MAGIC;
+    rtc_state.relay_state = relay_state;
+    rtc_state.mode = (uint8_t)status->mode;
+    rtc_state.tower_count = (uint8_t)tower_count;
+
+    for (uint8_t i = 0; i < MAX_TOWERS; i++) {
+        RtcTower_t* t = &rtc_state.towers[i];
+        if (i >= tower_count) {
+            memset(t, 0, sizeof(*t));
+            continue;
+        }
+        t->id = towers[i].id;
+        t->water_level = towers[i].water_level;
+        t->flags = (towers[i].pump_on ? RTC_TOWER_PUMP : 0) |
+                   (towers[i].online ? RTC_TOWER_ONLINE : 0) |
+                   (towers[i].low_water_alarm ? RTC_TOWER_LOW : 0) |
+                   (towers[i].overflow_alarm ? RTC_TOWER_OVERFLOW : 0) |
+                   (towers[i].shortage_alarm ? RTC_TOWER_SHORTAGE : 0);
+        t->reserved = 0;
+    }
+
+    rtc_state.crc = rtc_state_crc(&rtc_state);
+    ESP.rtcUserMemoryWrite(WARM_BOOT_RTC_OFFSET, (uint32_t*)&rtc_state, sizeof(rtc_state));
+}
+
+bool warm_boot_is_warm(void) {
+    return boot_warm;
+}
+
+uint32_t warm_boot_count(void) {
+    return rtc_state.boot_count;
+}
+
+// ==================== 启动阶段计时 ====================
+
+void boot_phase_mark(BootPhase_t phase) {
+    if (phase >= BOOT_PHASE_COUNT || phase_us[phase] != 0) return;
+    phase_us[phase] = micros();
+}
+
+uint32_t boot_time_to_control_ms(void) {
+    return phase_us[BOOT_PHASE_FIRST_CONTROL] / 1000;
+}
+
+/**
+ * 输出启动阶段耗时报告
+ * 时刻从复位开始计算 (含 SDK 启动时间)
+ */
+void boot_phase_report(void) {
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+    char name[16];
+    uint32_t prev = 0;
+
+    LOG_I("⏱️ %S启动 (复位原因 %lu，热启动次数 %lu)",
+          boot_warm ? PSTR("热") : PSTR("冷"),
+          (unsigned long)ESP.getResetInfoPtr()->reason,
+          (unsigned long)rtc_state.boot_count);
+
+    for (uint8_t i = 0; i < BOOT_PHASE_COUNT; i++) {
+        if (phase_us[i] == 0) continue;
+        strncpy_P(name, (PGM_P)pgm_read_ptr(&phase_names[i]), sizeof(name) - 1);
+        name[sizeof(name) - 1] = '\0';
+        LOG_I("   %-14s %6lu.%03lu ms (+%lu.%03lu)", name,
+              (unsigned long)(phase_us[i] / 1000), (unsigned long)(phase_us[i] % 1000),
+              (unsigned long)((phase_us[i] - prev) / 1000), (unsigned long)((phase_us[i] - prev) % 1000));
+        prev = phase_us[i];
+    }
+
+    LOG_I("⏱️ 启动到首次控制：%lu ms", (unsigned long)boot_time_to_control_ms());
+#endif
+}
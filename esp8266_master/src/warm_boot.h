@@ -0,0 +1,84 @@
+/*
+ * 热启动恢复 - RTC 内存保存继电器与控制状态
+ *
+ * 看门狗/异常/软复位后 RTC 用户内存保持不变，启动时在任何慢速初始化
+ * (OLED、LoRa、WiFi) 之前恢复继电器输出、系统模式和各水塔控制状态，
+ * 避免复位导致水泵全部断开再重新开启 (水锤) 以及控制空档。
+ *
+ * 断电后 RTC 内存内容随机，依靠魔数和 CRC32 校验识别。
+ *
+ * 同时记录启动各阶段耗时，每次启动输出到首次控制的时间。
+ */
+
+#ifndef WARM_BOOT_H
+#define WARM_BOOT_H
+
+#include <Arduino.h>
+#include "water_system.h"
+
+// RTC 用户内存偏移 (4 字节块)，前 128 字节保留给 OTA (eboot 命令)
+#define WARM_BOOT_RTC_OFFSET    32
+
+#define WARM_BOOT_MAGIC         0x57544D31  // "WTM1"
+
+// ==================== 启动阶段 ====================
+
+typedef enum {
+    BOOT_PHASE_RESTORE = 0,     // RTC 状态恢复 (继电器已输出)
+    BOOT_PHASE_RELAY,           // 74HC595 初始化
+    BOOT_PHASE_OLED,            // OLED 初始化
+    BOOT_PHASE_LORA,            // LoRa 初始化
+    BOOT_PHASE_WIFI,            // WiFi 启动
+    BOOT_PHASE_SERVER,          // Web 服务器启动
+    BOOT_PHASE_FIRST_CONTROL,   // 首次控制循环
+    BOOT_PHASE_COUNT
+} BootPhase_t;
+
+// ==================== 函数声明 ====================
+
+/**
+ * 从 RTC 内存恢复控制状态
+ * 必须在 setup() 最开始调用
+ * @param towers 水塔数组
+ * @param tower_count 水塔数量 (输出)
+ * @param status 系统状态 (恢复模式)
+ * @param relay_state 继电器映像 (输出)
+ * @return true=热启动且状态有效，false=冷启动
+ */
+bool warm_boot_restore(TowerData* towers, uint16_t* tower_count,
+                       SystemStatus* status, uint8_t* relay_state);
+
+/**
+ * 保存当前控制状态到 RTC 内存
+ * 每次继电器、模式或水塔状态变化后调用 (写入约 60 字节，耗时微秒级)
+ */
+void warm_boot_save(const TowerData* towers, uint16_t tower_count,
+                    const SystemStatus* status, uint8_t relay_state);
+
+/**
+ * 是否为热启动
+ */
+bool warm_boot_is_warm(void);
+
+/**
+ * 累计启动次数 (冷启动时清零)
+ */
+uint32_t warm_boot_count(void);
+
+/**
+ * 标记启动阶段完成
+ * @param phase 阶段
+ */
+void boot_phase_mark(BootPhase_t phase);
+
+/**
+ * 启动到首次控制的时间 (毫秒，未到达时为 0)
+ */
+uint32_t boot_time_to_control_ms(void);
+
+/**
+ * 输出启动阶段耗时报告
+ */
+void boot_phase_report(void);
+
+#endif  // WARM_BOOT_H
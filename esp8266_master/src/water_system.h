@@ -7,8 +7,10 @@
 
 #include <stdint.h>
 
-// 最大水塔数量
+// 最大水塔数量 (Linux 主机编译时覆盖)
+#ifndef MAX_TOWERS
 #define MAX_TOWERS 8
+#endif
 
 // 历史记录数量 (每个水塔保存最近 48 小时，每小时 1 条)
 #define HISTORY_SIZE 48
@@ -16,11 +18,30 @@
 // 命令字定义
 #define CMD_HEARTBEAT   0x01  // 心跳包
 #define CMD_QUERY       0x02  // 查询水位
+#define CMD_SENSOR_DATA 0x03  // 传感器数据 (从机主动上报)
 #define CMD_PUMP_CTRL   0x10  // 水泵控制
 #define CMD_SET_AUTO    0x20  // 自动模式
 #define CMD_SET_MANUAL  0x21  // 手动模式
+#define CMD_MESH_BEACON 0x30  // 路由通告 (中继网络，见 mesh_master.h)
+#define CMD_MESH_UP     0x31  // 经中继转发的上行帧
+#define CMD_MESH_DOWN   0x32  // 经中继转发的下行帧
+#define CMD_OTA_BEGIN   0x40  // 开始升级会话 (从机空中升级，见 ota_master.h)
+#define CMD_OTA_DATA    0x41  // 镜像分片 (广播)
+#define CMD_OTA_QUERY   0x42  // 查询缺片
+#define CMD_OTA_STATUS  0x43  // 升级状态和缺片位图 (从机应答)
+#define CMD_OTA_ACTIVATE 0x44 // 激活新镜像
 #define CMD_ALARM       0xFF  // 报警
 
+// 上报帧的采样窗口 (从机见 slave_node_stc8g/inc/slave_window.h，常量须保持一致)
+// [从机地址][CMD_SENSOR_DATA][长度][水位][井水正常][最低水位][最高水位][变化次数][采样数][通道图...]
+#define WINDOW_SAMPLES_MAX      16      // 采样环容量 (2 的幂)
+#define WINDOW_MAP_MASK         0x01FF  // SC09B 通道图 (9 位)
+#define WINDOW_LEVEL_MIN        5
+#define WINDOW_LEVEL_MAX        6
+#define WINDOW_CHANGES          7
+#define WINDOW_SAMPLES          8
+#define WINDOW_MAPS             9       // 其后为通道图
+
 // 系统模式
 typedef enum {
     MODE_AUTO = 0,
@@ -34,6 +55,16 @@ typedef struct {
     bool pump_status;      // 水泵状态
 } HistoryRecord;
 
+// 最近一次上报的采样窗口 (从机每秒采样，旧格式的上报帧不带)
+typedef struct {
+    uint8_t samples;         // 采样数，0=没有窗口
+    uint8_t level_min;       // 最低水位
+    uint8_t level_max;       // 最高水位
+    uint8_t changes;         // 读数变化次数
+    uint8_t channel_count;   // 通道图数量 (最新的几次采样)
+    uint16_t channels[WINDOW_SAMPLES_MAX];  // SC09B 通道图，从旧到新 (bit0=通道 1)
+} TowerWindow;
+
 // 水塔数据
 typedef struct {
     uint8_t id;              // 水塔 ID (从机地址)
@@ -44,6 +75,7 @@ typedef struct {
     bool overflow_alarm;     // 溢水报警
     bool shortage_alarm;     // 缺水报警
     uint32_t last_update;    // 最后更新时间
+    TowerWindow window;      // 最近一次上报的采样窗口
     char name[16];           // 水塔名称
     HistoryRecord history[HISTORY_SIZE];  // 历史记录
     uint8_t history_index;   // 历史记录索引
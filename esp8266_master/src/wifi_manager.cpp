@@ -0,0 +1,164 @@
+/*
+ * WiFi 连接管理实现
+ */
+
+#include "wifi_manager.h"
+#include <ESP8266WiFi.h>
+#include "error_codes.h"
+#include "logger.h"
+
+static const char* sta_ssid = NULL;
+static const char* sta_pass = NULL;
+static const char* fallback_ssid = NULL;
+static const char* fallback_pass = NULL;
+
+static WifiState_t state = WIFI_STATE_IDLE;
+static uint32_t attempt_start = 0;     // 本次连接开始时间
+static uint32_t next_attempt = 0;      // 下次重连时间
+static uint32_t backoff_ms = WIFI_BACKOFF_MIN_MS;
+static uint32_t link_down_since = 0;   // 站点断开时间
+static uint32_t link_up_since = 0;     // 站点连接时间
+static uint32_t reconnects = 0;
+static bool ap_on = false;
+
+// SDK 事件 (回调中只置标志)
+static WiFiEventHandler got_ip_handler;
+static WiFiEventHandler disconnected_handler;
+static volatile bool evt_got_ip = false;
+static volatile bool evt_disconnected = false;
+
+// ==================== 内部函数 ====================
+
+static void start_attempt(uint32_t now) {
+    WiFi.begin(sta_ssid, sta_pass);
+    attempt_start = now;
+    state = WIFI_STATE_CONNECTING;
+}
+
+static void schedule_retry(uint32_t now) {
+    next_attempt = now + backoff_ms;
+    LOG_W("❌ WiFi 连接失败，%lu ms 后重试", (unsigned long)backoff_ms);
+    backoff_ms = (backoff_ms >= WIFI_BACKOFF_MAX_MS / 2) ? WIFI_BACKOFF_MAX_MS : backoff_ms * 2;
+    state = WIFI_STATE_BACKOFF;
+}
+
+static void enter_connected(uint32_t now) {
+    state = WIFI_STATE_CONNECTED;
+    link_up_since = now;
+    backoff_ms = WIFI_BACKOFF_MIN_MS;
+    LOG_I("✅ WiFi connected, IP: %s", WiFi.localIP().toString().c_str());
+}
+
+static void enter_disconnected(uint32_t now) {
+    link_down_since = now;
+    reconnects++;
+    error_log(ERR_COM_WIFI_FAIL, ERR_LEVEL_WARNING, 0xFF);
+    // 断线后立即尝试一次，失败再退避
+    start_attempt(now);
+}
+
+// 热点开关
+static void update_ap(uint32_t now) {
+    if (!ap_on && state != WIFI_STATE_CONNECTED &&
+        now - link_down_since >= WIFI_AP_FALLBACK_MS) {
+        WiFi.mode(WIFI_AP_STA);
+        ap_on = WiFi.softAP(fallback_ssid, fallback_pass);
+        if (ap_on) {
+            LOG_I("📶 开启备用热点 %s (%s)", fallback_ssid, WiFi.softAPIP().toString().c_str());
+        }
+    } else if (ap_on && state == WIFI_STATE_CONNECTED &&
+               now - link_up_since >= WIFI_AP_LINGER_MS &&
+               WiFi.softAPgetStationNum() == 0) {
+        WiFi.softAPdisconnect(true);
+        WiFi.mode(WIFI_STA);
+        ap_on = false;
+        LOG_I("📶 关闭备用热点");
+    }
+}
+
+// ==================== 函数实现 ====================
+
+/**
+ * 启动 WiFi 连接
+ */
+void wifi_manager_begin(const char* ssid, const char* pass,
+                        const char* ap_ssid, const char* ap_pass) {
+    sta_ssid = ssid;
+    sta_pass = pass;
+    fallback_ssid = ap_ssid;
+    fallback_pass = ap_pass;
+
+    // 重连由状态机负责，避免 SDK 自动重连与退避冲突；不写闪存
+    WiFi.persistent(false);
+    WiFi.setAutoReconnect(false);
+    WiFi.mode(WIFI_STA);
+
+    got_ip_handler = WiFi.onStationModeGotIP([](const WiFiEventStationModeGotIP&) {
+        evt_got_ip = true;
+    });
+    disconnected_handler = WiFi.onStationModeDisconnected([](const WiFiEventStationModeDisconnected&) {
+        evt_disconnected = true;
+    });
+
+    uint32_t now = millis();
+    link_down_since = now;
+    LOG_I("Connecting to WiFi: %s", ssid);
+    start_attempt(now);
+}
+
+/**
+ * 连接状态机
+ */
+void wifi_manager_loop(uint32_t now) {
+    if (state == WIFI_STATE_IDLE) return;
+
+    bool got_ip = evt_got_ip;
+    bool disconnected = evt_disconnected;
+    evt_got_ip = false;
+    evt_disconnected = false;
+
+    switch (state) {
+        case WIFI_STATE_CONNECTING:
+            if (got_ip || WiFi.status() == WL_CONNECTED) {
+                enter_connected(now);
+            } else if (now - attempt_start >= WIFI_CONNECT_TIMEOUT_MS) {
+                WiFi.disconnect();
+                schedule_retry(now);
+            }
+            break;
+
+        case WIFI_STATE_CONNECTED:
+            if (disconnected || WiFi.status() != WL_CONNECTED) {
+                LOG_W("⚠️ WiFi 断开");
+                enter_disconnected(now);
+            }
+            break;
+
+        case WIFI_STATE_BACKOFF:
+            if ((int32_t)(now - next_attempt) >= 0) {
+                start_attempt(now);
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    update_ap(now);
+}
+
+bool wifi_manager_connected(void) {
+    return state == WIFI_STATE_CONNECTED;
+}
+
+bool wifi_manager_ap_active(void) {
+    return ap_on;
+}
+
+WifiState_t wifi_manager_state(void) {
+    return state;
+}
+
+uint32_t wifi_manager_reconnects(void) {
+    return reconnects;
+}
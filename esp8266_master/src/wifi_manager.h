@@ -0,0 +1,77 @@
+/*
+ * WiFi 连接管理 (非阻塞)
+ *
+ * - 后台连接路由器，setup() 不再等待，控制循环立即开始
+ * - 连接失败或断线后按指数退避重连 (1s, 2s, 4s ... 最长 60s)
+ * - 站点连接断开超过 WIFI_AP_FALLBACK_MS 时自动开启热点
+ *   (默认地址 192.168.4.1，与 APP 的默认地址一致)
+ * - 站点恢复且热点上无设备连接时关闭热点
+ *
+ * 连接事件由 SDK 回调置标志，状态机在 wifi_manager_loop() 中处理。
+ */
+
+#ifndef WIFI_MANAGER_H
+#define WIFI_MANAGER_H
+
+#include <Arduino.h>
+
+// 单次连接超时
+#define WIFI_CONNECT_TIMEOUT_MS     15000
+
+// 重连退避 (初始值与上限)
+#define WIFI_BACKOFF_MIN_MS         1000
+#define WIFI_BACKOFF_MAX_MS         60000
+
+// 站点断开多久后开启热点
+#define WIFI_AP_FALLBACK_MS         20000
+
+// 站点恢复多久后关闭热点 (热点上有设备时保持)
+#define WIFI_AP_LINGER_MS           60000
+
+// 连接状态
+typedef enum {
+    WIFI_STATE_IDLE = 0,        // 未启动
+    WIFI_STATE_CONNECTING,      // 正在连接
+    WIFI_STATE_CONNECTED,       // 已连接
+    WIFI_STATE_BACKOFF          // 等待重连
+} WifiState_t;
+
+// ==================== 函数声明 ====================
+
+/**
+ * 启动 WiFi 连接 (立即返回)
+ * @param ssid 路由器 SSID
+ * @param pass 路由器密码
+ * @param ap_ssid 备用热点 SSID
+ * @param ap_pass 备用热点密码 (至少 8 位)
+ */
+void wifi_manager_begin(const char* ssid, const char* pass,
+                        const char* ap_ssid, const char* ap_pass);
+
+/**
+ * 连接状态机 (主循环中调用)
+ * @param now 当前时间 (毫秒)
+ */
+void wifi_manager_loop(uint32_t now);
+
+/**
+ * 站点是否已连接
+ */
+bool wifi_manager_connected(void);
+
+/**
+ * 备用热点是否开启
+ */
+bool wifi_manager_ap_active(void);
+
+/**
+ * 当前连接状态
+ */
+WifiState_t wifi_manager_state(void);
+
+/**
+ * 累计重连次数
+ */
+uint32_t wifi_manager_reconnects(void);
+
+#endif  // WIFI_MANAGER_H
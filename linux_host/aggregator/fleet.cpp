@@ -0,0 +1,225 @@
+/*
+ * 水塔集群状态模型实现
+ */
+
+#include "fleet.h"
+#include "json.h"
+
+#include <time.h>
+
+namespace wt {
+
+uint64_t wall_ms() {
+    timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+void FleetModel::add_gateway(const std::string& site, const std::string& name) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    gateways_[name].site = site;
+    gateway_version_++;
+}
+
+/**
+ * 应用网关上报
+ *
+ * 每个网关保存自己对水塔的最新视图。只有网关自己的视图发生变化时才参与合并：
+ * - 与集群当前状态相同：其他网关已经带来了这一帧，计为重复
+ * - 与集群当前状态不同：状态变化，版本加 1
+ * 落后的网关反复上报旧值不会把集群状态改回去。
+ * 在线状态取所有网关视图的"或"：任一网关能听到即在线。
+ */
+void FleetModel::apply(const std::string& gateway, uint64_t seq, const std::vector<TowerReport>& reports,
+                       bool complete, uint64_t now_ms) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto gw_it = gateways_.find(gateway);
+    if (gw_it == gateways_.end()) return;
+    Gateway& gw = gw_it->second;
+    const std::string& site = gw.site;
+    bool changed = false;
+
+    if (seq < gw.seq) {
+        stale_dropped_ += reports.size();
+        return;
+    }
+    gw.seq = seq;
+
+    std::set<uint32_t> listed;
+    for (const TowerReport& r : reports) {
+        reports_++;
+        listed.insert(r.id);
+        gw.towers.insert(r.id);
+
+        auto inserted = towers_.emplace(Key{site, r.id}, Tower());
+        Tower& t = inserted.first->second;
+        bool is_new = inserted.second;
+
+        Heard& view = t.gateways[gateway];
+        bool first_view = view.at_ms == 0;
+        bool view_changed = first_view || view.level != r.level || view.pump != r.pump || view.online != r.online;
+        view.seq = seq;
+        view.at_ms = now_ms;
+        view.level = r.level;
+        view.pump = r.pump;
+        view.online = r.online;
+
+        // 清理长时间未听到的网关
+        for (auto it = t.gateways.begin(); it != t.gateways.end();) {
+            if (now_ms - it->second.at_ms > TOWER_STALE_MS) {
+                it = t.gateways.erase(it);
+                changed = true;
+            } else {
+                ++it;
+            }
+        }
+        if (first_view) changed = true;
+        if (!view_changed) continue;
+
+        bool online = false;
+        for (const auto& g : t.gateways) online = online || g.second.online;
+
+        if (!is_new && t.level == r.level && t.pump == r.pump && t.online == online) {
+            if (t.source != gateway && now_ms - t.changed_ms < DEDUP_WINDOW_MS) duplicates_++;
+            continue;
+        }
+
+        t.level = r.level;
+        t.pump = r.pump;
+        t.online = online;
+        t.changed_ms = now_ms;
+        t.source = gateway;
+        changed = true;
+    }
+
+    // 完整列表中没有的水塔：该网关已听不到
+    if (complete) {
+        for (auto it = gw.towers.begin(); it != gw.towers.end();) {
+            if (listed.count(*it)) {
+                ++it;
+                continue;
+            }
+            auto t_it = towers_.find(Key{site, *it});
+            if (t_it != towers_.end()) {
+                Tower& t = t_it->second;
+                t.gateways.erase(gateway);
+                bool online = false;
+                for (const auto& g : t.gateways) online = online || g.second.online;
+                t.online = online;
+            }
+            it = gw.towers.erase(it);
+            changed = true;
+        }
+    }
+
+    if (changed) version_++;
+}
+
+// ==================== 快照 ====================
+
+void FleetModel::append_tower(std::string& out, const Key& key, const Tower& t) {
+    out += "{\"site\":";
+    json_append_string(out, key.site);
+    out += ",\"id\":";
+    out += std::to_string(key.id);
+    out += ",\"level\":";
+    out += std::to_string(t.level);
+    out += t.pump ? ",\"pump\":true" : ",\"pump\":false";
+    out += t.online ? ",\"online\":true" : ",\"online\":false";
+    out += ",\"changed\":";
+    out += std::to_string(t.changed_ms);
+    out += ",\"gateways\":[";
+    bool first = true;
+    for (const auto& g : t.gateways) {
+        if (!first) out += ',';
+        first = false;
+        json_append_string(out, g.first);
+    }
+    out += "]}";
+}
+
+std::shared_ptr<const std::string> FleetModel::towers_json(uint64_t* version) {
+    std::lock_guard<std::mutex> snap_lock(snapshot_mutex_);
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+
+    if (towers_snapshot_ && towers_snapshot_version_ == version_) {
+        *version = version_;
+        return towers_snapshot_;
+    }
+
+    auto out = std::make_shared<std::string>();
+    out->reserve(towers_.size() * 96 + 64);
+    *out += "{\"version\":";
+    *out += std::to_string(version_);
+    *out += ",\"towers\":[";
+    bool first = true;
+    for (const auto& entry : towers_) {
+        if (!first) *out += ',';
+        first = false;
+        append_tower(*out, entry.first, entry.second);
+    }
+    *out += "]}";
+
+    towers_snapshot_ = out;
+    towers_snapshot_version_ = version_;
+    snapshots_++;
+    *version = version_;
+    return towers_snapshot_;
+}
+
+std::shared_ptr<const std::string> FleetModel::tower_json(const std::string& site, uint32_t id) {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = towers_.find(Key{site, id});
+    if (it == towers_.end()) return nullptr;
+    auto out = std::make_shared<std::string>();
+    append_tower(*out, it->first, it->second);
+    return out;
+}
+
+std::shared_ptr<const std::string> FleetModel::gateways_json(uint64_t* version) {
+    std::lock_guard<std::mutex> snap_lock(snapshot_mutex_);
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+
+    if (gateways_snapshot_ && gateways_snapshot_version_ == gateway_version_) {
+        *version = gateway_version_;
+        return gateways_snapshot_;
+    }
+
+    auto out = std::make_shared<std::string>("[");
+    bool first = true;
+    for (const auto& entry : gateways_) {
+        const GatewayStatus& s = entry.second.status;
+        if (!first) *out += ',';
+        first = false;
+        *out += "{\"name\":";
+        json_append_string(*out, entry.first);
+        *out += ",\"site\":";
+        json_append_string(*out, entry.second.site);
+        *out += s.reachable ? ",\"reachable\":true" : ",\"reachable\":false";
+        *out += s.streaming ? ",\"streaming\":true" : ",\"streaming\":false";
+        *out += ",\"mode\":";
+        json_append_string(*out, s.mode);
+        *out += s.well_water ? ",\"well_water\":true}" : ",\"well_water\":false}";
+    }
+    *out += ']';
+
+    gateways_snapshot_ = out;
+    gateways_snapshot_version_ = gateway_version_;
+    *version = gateway_version_;
+    return gateways_snapshot_;
+}
+
+FleetStats FleetModel::stats() {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    FleetStats s;
+    s.version = version_;
+    s.towers = towers_.size();
+    s.gateways = gateways_.size();
+    s.reports = reports_;
+    s.duplicates = duplicates_;
+    s.stale_dropped = stale_dropped_;
+    s.snapshots = snapshots_.load();
+    return s;
+}
+
+}  // namespace wt
@@ -0,0 +1,178 @@
+/*
+ * 水塔集群状态模型
+ *
+ * 合并多台主机 (网关) 上报的水塔状态，按 (站点, 水塔 ID) 唯一标识。
+ * 覆盖范围重叠的网关会收到同一从机的同一帧，DEDUP_WINDOW_MS 内
+ * 其他网关上报的相同状态只记为重复，不产生新版本。
+ *
+ * 与固件 api_cache 相同的做法：状态每次变化版本号加 1，
+ * 集群快照 JSON 按版本缓存，读取时直接返回共享缓冲。
+ *
+ * 线程安全：写入 (工作线程) 与读取 (事件循环线程) 可并发。
+ */
+
+#ifndef WT_FLEET_H
+#define WT_FLEET_H
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+namespace wt {
+
+// 重叠网关去重窗口
+#define DEDUP_WINDOW_MS     2000
+
+// 网关超过该时间未上报，视为不再听到该水塔
+#define TOWER_STALE_MS      60000
+
+// 单个网关的一条水塔上报
+struct TowerReport {
+    uint32_t id = 0;
+    int level = 0;
+    bool pump = false;
+    bool online = true;
+};
+
+// 网关 (主机) 状态
+struct GatewayStatus {
+    bool reachable = false;
+    bool streaming = false;     // SSE 推送中
+    std::string mode;           // AUTO / MANUAL
+    bool well_water = true;
+    uint64_t last_ok_ms = 0;    // 最后一次成功通信 (墙钟毫秒)
+    uint64_t requests = 0;
+    uint64_t errors = 0;
+    uint64_t not_modified = 0;  // 304 次数
+};
+
+struct FleetStats {
+    uint64_t version;
+    size_t towers;
+    size_t gateways;
+    uint64_t reports;           // 收到的水塔上报
+    uint64_t duplicates;        // 重叠网关的重复上报
+    uint64_t stale_dropped;     // 乱序到达的旧上报
+    uint64_t snapshots;         // 快照重建次数
+};
+
+class FleetModel {
+public:
+    /**
+     * 登记网关
+     */
+    void add_gateway(const std::string& site, const std::string& name);
+
+    /**
+     * 应用网关的一批上报
+     * @param seq 网关内单调递增的序号 (乱序到达的旧批次被忽略)
+     * @param reports 水塔上报
+     * @param complete true=完整列表 (轮询，未列出的水塔视为该网关已听不到)，
+     *                 false=增量 (推送)
+     * @param now_ms 墙钟毫秒
+     */
+    void apply(const std::string& gateway, uint64_t seq, const std::vector<TowerReport>& reports,
+               bool complete, uint64_t now_ms);
+
+    /**
+     * 更新网关状态 (回调在锁内修改，对外可见的字段变化时网关列表版本加 1)
+     */
+    template <typename Fn>
+    void update_gateway(const std::string& name, Fn fn) {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        auto it = gateways_.find(name);
+        if (it == gateways_.end()) return;
+        GatewayStatus before = it->second.status;
+        fn(it->second.status);
+        const GatewayStatus& after = it->second.status;
+        if (before.reachable != after.reachable || before.mode != after.mode ||
+            before.well_water != after.well_water || before.streaming != after.streaming) {
+            gateway_version_++;
+        }
+    }
+
+    /**
+     * 集群水塔快照 (JSON，按版本缓存)
+     * @param version 快照对应的版本
+     */
+    std::shared_ptr<const std::string> towers_json(uint64_t* version);
+
+    /**
+     * 单个水塔 (JSON)
+     * @return 空指针表示不存在
+     */
+    std::shared_ptr<const std::string> tower_json(const std::string& site, uint32_t id);
+
+    /**
+     * 网关列表 (JSON)
+     */
+    std::shared_ptr<const std::string> gateways_json(uint64_t* version);
+
+    FleetStats stats();
+
+private:
+    struct Key {
+        std::string site;
+        uint32_t id;
+        bool operator<(const Key& o) const { return site != o.site ? site < o.site : id < o.id; }
+    };
+
+    // 某个网关对该水塔的最新视图
+    struct Heard {
+        uint64_t seq = 0;
+        uint64_t at_ms = 0;
+        int level = 0;
+        bool pump = false;
+        bool online = false;
+    };
+
+    struct Tower {
+        int level = 0;
+        bool pump = false;
+        bool online = false;
+        uint64_t changed_ms = 0;                    // 状态最后变化时间
+        std::string source;                         // 带来当前状态的网关
+        std::map<std::string, Heard> gateways;      // 听到该水塔的网关
+    };
+
+    struct Gateway {
+        std::string site;
+        GatewayStatus status;
+        std::set<uint32_t> towers;      // 该网关听到的水塔
+        uint64_t seq = 0;               // 最后应用的批次
+    };
+
+    static void append_tower(std::string& out, const Key& key, const Tower& t);
+
+    std::shared_mutex mutex_;
+    std::map<Key, Tower> towers_;
+    std::map<std::string, Gateway> gateways_;
+    uint64_t version_ = 1;
+    uint64_t gateway_version_ = 1;
+    uint64_t reports_ = 0;
+    uint64_t duplicates_ = 0;
+    uint64_t stale_dropped_ = 0;
+
+    // 快照缓存
+    std::mutex snapshot_mutex_;
+    std::shared_ptr<const std::string> towers_snapshot_;
+    uint64_t towers_snapshot_version_ = 0;
+    std::shared_ptr<const std::string> gateways_snapshot_;
+    uint64_t gateways_snapshot_version_ = 0;
+    std::atomic<uint64_t> snapshots_{0};
+};
+
+/**
+ * 墙钟毫秒
+ */
+uint64_t wall_ms();
+
+}  // namespace wt
+
+#endif  // WT_FLEET_H
@@ -0,0 +1,243 @@
+/*
+ * wt-aggregator: 多主机水塔状态汇聚服务
+ *
+ * 用法:
+ *   wt-aggregator [--listen HOST:PORT] [--poll-ms N] [--workers N] [-v]...
+ *                 --master [SITE/]NAME=HOST[:PORT][,push] ...
+ *
+ *   --master  上游主机，可重复。SITE 默认 "default"；
+ *             加 ",push" 订阅 /api/events，否则按 --poll-ms 轮询
+ *   --listen  服务地址 (默认 0.0.0.0:8080)
+ *   --workers 解析/合并线程数 (默认 CPU 核数)
+ *
+ * 接口:
+ *   GET /api/fleet               全部水塔 (ETag "v<版本>"，支持 304)
+ *   GET /api/fleet/<站点>/<ID>   单个水塔
+ *   GET /api/gateways            上游主机状态
+ *   GET /api/stats               运行统计
+ */
+
+#include "event_loop.h"
+#include "fleet.h"
+#include "http_server.h"
+#include "log.h"
+#include "net.h"
+#include "thread_pool.h"
+#include "upstream.h"
+
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace wt;
+
+namespace {
+
+void usage(const char* prog) {
+    fprintf(stderr,
+            "用法: %s [--listen HOST:PORT] [--poll-ms N] [--workers N] [-v]...\n"
+            "          --master [SITE/]NAME=HOST[:PORT][,push] ...\n",
+            prog);
+}
+
+/**
+ * 解析 --master 参数
+ */
+bool parse_master(const std::string& spec, UpstreamConfig* out) {
+    std::string text = spec;
+
+    size_t comma = text.rfind(',');
+    if (comma != std::string::npos) {
+        std::string flag = text.substr(comma + 1);
+        if (flag != "push") return false;
+        out->push = true;
+        text.resize(comma);
+    }
+
+    std::string address = text;
+    size_t eq = text.find('=');
+    if (eq != std::string::npos) {
+        std::string name = text.substr(0, eq);
+        address = text.substr(eq + 1);
+        size_t slash = name.find('/');
+        if (slash != std::string::npos) {
+            out->site = name.substr(0, slash);
+            name = name.substr(slash + 1);
+        }
+        out->name = name;
+    }
+    if (!net_split_host_port(address, &out->host, &out->port, 80)) return false;
+    if (out->name.empty()) out->name = address;
+    if (out->site.empty()) out->site = "default";
+    return true;
+}
+
+/**
+ * 带版本的共享快照应答 (客户端已有当前版本时回 304)
+ */
+void reply_snapshot(const HttpRequest& req, HttpReply& reply, std::shared_ptr<const std::string> body,
+                    uint64_t version) {
+    std::string etag = "\"v" + std::to_string(version) + "\"";
+    reply.headers.emplace_back("ETag", etag);
+    reply.headers.emplace_back("Cache-Control", "no-cache");
+    if (req.header("if-none-match") == etag) {
+        reply.status = 304;
+        return;
+    }
+    reply.shared_body = std::move(body);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::string listen_addr = "0.0.0.0:8080";
+    uint32_t poll_ms = 1000;
+    size_t workers = 0;
+    int verbosity = LOG_LEVEL_INFO;
+    std::vector<UpstreamConfig> masters;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--listen" && has_value) {
+            listen_addr = argv[++i];
+        } else if (arg == "--poll-ms" && has_value) {
+            poll_ms = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--workers" && has_value) {
+            workers = (size_t)strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--master" && has_value) {
+            UpstreamConfig cfg;
+            if (!parse_master(argv[++i], &cfg)) {
+                fprintf(stderr, "无效的 --master: %s\n", argv[i]);
+                return 2;
+            }
+            masters.push_back(cfg);
+        } else if (arg == "-v") {
+            verbosity++;
+        } else if (arg == "-q") {
+            verbosity = LOG_LEVEL_WARN;
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (masters.empty() || poll_ms == 0) {
+        usage(argv[0]);
+        return 2;
+    }
+    log_set_level(verbosity);
+
+    std::string host;
+    uint16_t port;
+    if (!net_split_host_port(listen_addr, &host, &port, 8080)) {
+        fprintf(stderr, "无效的 --listen: %s\n", listen_addr.c_str());
+        return 2;
+    }
+
+    // 信号改由事件循环处理
+    sigset_t mask;
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGINT);
+    sigaddset(&mask, SIGTERM);
+    sigprocmask(SIG_BLOCK, &mask, nullptr);
+    signal(SIGPIPE, SIG_IGN);
+
+    // 析构顺序与声明相反: 线程池 (在下面声明) 先排空，其任务引用的上游、模型和循环仍然有效
+    EventLoop loop;
+    FleetModel fleet;
+    HttpServer server(loop);
+    std::vector<std::unique_ptr<Upstream>> upstreams;
+
+    int sigfd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+    loop.add(sigfd, EPOLLIN, [&](uint32_t) {
+        signalfd_siginfo info;
+        if (read(sigfd, &info, sizeof(info)) == sizeof(info)) {
+            LOG_I("收到信号 %u，退出", info.ssi_signo);
+            loop.stop();
+        }
+    });
+
+    server.route("GET", "/api/fleet", [&](const HttpRequest& req, HttpReply& reply) {
+        uint64_t version;
+        auto body = fleet.towers_json(&version);
+        reply_snapshot(req, reply, std::move(body), version);
+    });
+
+    server.route("GET", "/api/fleet/*", [&](const HttpRequest& req, HttpReply& reply) {
+        // /api/fleet/<站点>/<ID>
+        std::string rest = http_url_decode(req.path.substr(strlen("/api/fleet/")));
+        size_t slash = rest.rfind('/');
+        char* end = nullptr;
+        unsigned long id = slash == std::string::npos ? 0 : strtoul(rest.c_str() + slash + 1, &end, 10);
+        if (slash == std::string::npos || end == rest.c_str() + slash + 1 || *end != '\0') {
+            reply.status = 400;
+            reply.body = "{\"error\":\"expected /api/fleet/<site>/<id>\"}";
+            return;
+        }
+        auto body = fleet.tower_json(rest.substr(0, slash), (uint32_t)id);
+        if (!body) {
+            reply.status = 404;
+            reply.body = "{\"error\":\"unknown tower\"}";
+            return;
+        }
+        reply.shared_body = std::move(body);
+    });
+
+    server.route("GET", "/api/gateways", [&](const HttpRequest& req, HttpReply& reply) {
+        uint64_t version;
+        auto body = fleet.gateways_json(&version);
+        reply_snapshot(req, reply, std::move(body), version);
+    });
+
+    ThreadPool* pool_ref = nullptr;
+    server.route("GET", "/api/stats", [&](const HttpRequest&, HttpReply& reply) {
+        FleetStats s = fleet.stats();
+        char buf[512];
+        snprintf(buf, sizeof(buf),
+                 "{\"version\":%llu,\"towers\":%zu,\"gateways\":%zu,\"reports\":%llu,"
+                 "\"duplicates\":%llu,\"stale_dropped\":%llu,\"snapshots\":%llu,"
+                 "\"http_requests\":%llu,\"http_connections\":%zu,\"workers\":%zu,\"pending\":%zu}",
+                 (unsigned long long)s.version, s.towers, s.gateways, (unsigned long long)s.reports,
+                 (unsigned long long)s.duplicates, (unsigned long long)s.stale_dropped,
+                 (unsigned long long)s.snapshots, (unsigned long long)server.requests(),
+                 server.connections(), pool_ref->size(), pool_ref->pending());
+        reply.body = buf;
+    });
+
+    std::string err;
+    if (!server.listen(host, port, &err)) {
+        LOG_E("监听 %s 失败: %s", listen_addr.c_str(), err.c_str());
+        return 1;
+    }
+
+    ThreadPool pool(workers);
+    pool_ref = &pool;
+
+    for (UpstreamConfig& cfg : masters) {
+        cfg.poll_ms = poll_ms;
+        auto up = std::make_unique<Upstream>(loop, pool, fleet, cfg);
+        if (!up->start(&err)) {
+            LOG_E("%s: 无法解析 %s (%s)", cfg.name.c_str(), cfg.host.c_str(), err.c_str());
+            return 1;
+        }
+        LOG_I("上游 %s/%s -> %s:%u (%s)", cfg.site.c_str(), cfg.name.c_str(), cfg.host.c_str(), cfg.port,
+              cfg.push ? "推送" : "轮询");
+        upstreams.push_back(std::move(up));
+    }
+
+    LOG_I("wt-aggregator 监听 %s:%u，%zu 个上游，%zu 个工作线程", host.c_str(), server.port(),
+          upstreams.size(), pool.size());
+    loop.run();
+
+    // pool 最先析构，等待已提交的合并完成后再销毁上游连接
+    loop.remove(sigfd);
+    close(sigfd);
+    return 0;
+}
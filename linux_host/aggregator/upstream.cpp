@@ -0,0 +1,443 @@
+/*
+ * 上游主机连接实现
+ */
+
+#include "upstream.h"
+
+#include "json.h"
+#include "log.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace wt {
+
+Upstream::Upstream(EventLoop& loop, ThreadPool& pool, FleetModel& fleet, const UpstreamConfig& config)
+    : loop_(loop), pool_(pool), fleet_(fleet), config_(config) {
+    host_header_ = config_.host;
+    if (host_header_.find(':') != std::string::npos) host_header_ = "[" + host_header_ + "]";
+    if (config_.port != 80) host_header_ += ":" + std::to_string(config_.port);
+    push_ = config_.push;
+
+    sse_.on_event = [this](const SseEvent& ev) { on_sse_event(ev); };
+    fleet_.add_gateway(config_.site, config_.name);
+}
+
+Upstream::~Upstream() {
+    close_socket();
+    if (poll_timer_ >= 0) loop_.cancel_timer(poll_timer_);
+    if (retry_timer_ >= 0) loop_.cancel_timer(retry_timer_);
+}
+
+bool Upstream::start(std::string* err) {
+    if (!net_resolve(config_.host, config_.port, &addr_, err)) return false;
+
+    // 推送模式下轮询定时器只在退回轮询后生效
+    poll_timer_ = loop_.add_timer(config_.poll_ms, [this]() { poll_tick(); });
+    if (!push_) queue_ = {REQ_STATUS, REQ_TOWERS};
+    connect();
+    return true;
+}
+
+// ==================== 连接管理 ====================
+
+void Upstream::connect() {
+    std::string err;
+    fd_ = net_connect(addr_, &err);
+    if (fd_ < 0) {
+        LOG_W("%s: 连接失败 (%s)", config_.name.c_str(), err.c_str());
+        fail("connect");
+        return;
+    }
+    state_ = CONNECTING;
+    loop_.add(fd_, EPOLLOUT, [this](uint32_t events) { on_socket(events); });
+    arm_deadline(UPSTREAM_REQUEST_TIMEOUT_MS);
+}
+
+void Upstream::close_socket() {
+    disarm_deadline();
+    if (fd_ >= 0) {
+        loop_.remove(fd_);
+        close(fd_);
+        fd_ = -1;
+    }
+    out_.clear();
+    state_ = DISCONNECTED;
+}
+
+void Upstream::fail(const char* reason) {
+    bool was_streaming = state_ == STREAMING;
+    close_socket();
+    queue_.clear();
+
+    LOG_D("%s: %s，%u ms 后重连", config_.name.c_str(), reason, backoff_ms_);
+    fleet_.update_gateway(config_.name, [](GatewayStatus& s) {
+        s.reachable = false;
+        s.streaming = false;
+        s.errors++;
+    });
+    if (was_streaming) {
+        // 快照收集到一半的流不再可信
+        sse_resync_ = false;
+        sse_snapshot_.clear();
+        sse_batch_.clear();
+    }
+    schedule_retry();
+}
+
+void Upstream::schedule_retry() {
+    if (retry_timer_ >= 0) return;
+    retry_timer_ = loop_.add_timer(backoff_ms_, [this]() {
+        retry_timer_ = -1;
+        if (state_ == DISCONNECTED) {
+            if (!push_) queue_ = {REQ_STATUS, REQ_TOWERS};
+            connect();
+        }
+    }, false);
+    backoff_ms_ = std::min<uint32_t>(backoff_ms_ * 2, UPSTREAM_BACKOFF_MAX_MS);
+}
+
+void Upstream::arm_deadline(uint32_t ms) {
+    disarm_deadline();
+    deadline_timer_ = loop_.add_timer(ms, [this]() {
+        deadline_timer_ = -1;
+        fail("timeout");
+    }, false);
+}
+
+void Upstream::disarm_deadline() {
+    if (deadline_timer_ >= 0) {
+        loop_.cancel_timer(deadline_timer_);
+        deadline_timer_ = -1;
+    }
+}
+
+// ==================== 请求发送 ====================
+
+void Upstream::poll_tick() {
+    if (push_ || !queue_.empty()) return;
+
+    queue_ = {REQ_STATUS, REQ_TOWERS};
+    if (state_ == IDLE) {
+        send_next();
+    } else if (state_ == DISCONNECTED && retry_timer_ < 0) {
+        connect();
+    }
+    // CONNECTING / WAITING: 上一轮还没完成，连接就绪后继续发送
+}
+
+void Upstream::send_next() {
+    HttpHeaderList headers;
+    const char* target;
+
+    if (push_) {
+        inflight_ = REQ_EVENTS;
+        target = "/api/events";
+        headers.emplace_back("Accept", "text/event-stream");
+    } else {
+        if (queue_.empty()) {
+            state_ = IDLE;
+            disarm_deadline();
+            return;
+        }
+        inflight_ = queue_.front();
+        queue_.pop_front();
+        target = inflight_ == REQ_STATUS ? "/api/status" : "/api/towers";
+        const std::string& etag = inflight_ == REQ_STATUS ? status_etag_ : towers_etag_;
+        if (!etag.empty()) headers.emplace_back("If-None-Match", etag);
+        headers.emplace_back("Accept", "application/json");
+    }
+
+    out_ += http_format_request("GET", host_header_, target, headers);
+    parser_.reset();
+    sse_.reset();
+    if (push_) {
+        // 响应头之后的事件可能与头部在同一次读取中到达
+        parser_.on_body = [this](const char* data, size_t len) { sse_.feed(data, len); };
+    } else {
+        parser_.on_body = nullptr;
+    }
+    state_ = WAITING;
+    loop_.modify(fd_, EPOLLIN | EPOLLOUT);
+    arm_deadline(UPSTREAM_REQUEST_TIMEOUT_MS);
+    fleet_.update_gateway(config_.name, [](GatewayStatus& s) { s.requests++; });
+}
+
+// ==================== 读写 ====================
+
+void Upstream::on_socket(uint32_t events) {
+    if (state_ == CONNECTING) {
+        int result = net_connect_result(fd_);
+        if (result != 0) {
+            LOG_W("%s: 连接失败 (%s)", config_.name.c_str(), strerror(result));
+            fail("connect");
+            return;
+        }
+        LOG_D("%s: 已连接", config_.name.c_str());
+        state_ = IDLE;
+        send_next();
+        if (state_ == IDLE) loop_.modify(fd_, EPOLLIN);
+        return;
+    }
+
+    if (events & EPOLLOUT) {
+        while (!out_.empty()) {
+            ssize_t n = ::send(fd_, out_.data(), out_.size(), MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+                fail("send");
+                return;
+            }
+            out_.erase(0, (size_t)n);
+        }
+        if (out_.empty()) loop_.modify(fd_, EPOLLIN);
+    }
+
+    if (events & (EPOLLIN | EPOLLHUP | EPOLLERR)) on_readable();
+}
+
+void Upstream::on_readable() {
+    char buf[16384];
+
+    while (fd_ >= 0) {
+        ssize_t n = ::recv(fd_, buf, sizeof(buf), 0);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            fail("recv");
+            return;
+        }
+
+        if (n == 0) {
+            // 对端关闭: 读到关闭的响应在此完成，其余情况为异常断开
+            if (state_ == WAITING && parser_.finish() == HttpResponseParser::DONE) {
+                RequestKind kind = inflight_;
+                HttpResponse resp = std::move(parser_.response());
+                close_socket();
+                on_response(kind, resp);
+                if (state_ == DISCONNECTED && !queue_.empty()) connect();
+                return;
+            }
+            if (state_ == IDLE) {
+                // 空闲连接被主机关闭 (不支持长连接)，下一轮重新连接
+                close_socket();
+                return;
+            }
+            flush_sse_batch();
+            fail("closed");
+            return;
+        }
+
+        if (state_ == STREAMING) {
+            arm_deadline(UPSTREAM_STREAM_TIMEOUT_MS);
+        } else if (state_ != WAITING) {
+            fail("unexpected data");
+            return;
+        }
+
+        size_t offset = 0;
+        while (offset < (size_t)n && fd_ >= 0) {
+            size_t consumed = 0;
+            HttpResponseParser::Result r = parser_.feed(buf + offset, (size_t)n - offset, &consumed);
+            offset += consumed;
+
+            if (r == HttpResponseParser::ERROR) {
+                fail("bad response");
+                return;
+            }
+
+            if (state_ == WAITING && inflight_ == REQ_EVENTS && parser_.headers_done()) {
+                HttpResponse& head = parser_.response();
+                if (head.status != 200) {
+                    // 订阅已满或主机不支持: 退回轮询
+                    LOG_I("%s: 推送不可用 (HTTP %d)，改为轮询", config_.name.c_str(), head.status);
+                    push_ = false;
+                    close_socket();
+                    queue_ = {REQ_STATUS, REQ_TOWERS};
+                    connect();
+                    return;
+                }
+                state_ = STREAMING;
+                backoff_ms_ = UPSTREAM_BACKOFF_MIN_MS;
+                arm_deadline(UPSTREAM_STREAM_TIMEOUT_MS);
+                fleet_.update_gateway(config_.name, [](GatewayStatus& s) {
+                    s.reachable = true;
+                    s.streaming = true;
+                    s.last_ok_ms = wall_ms();
+                });
+                LOG_I("%s: 推送已建立", config_.name.c_str());
+                continue;
+            }
+
+            if (r == HttpResponseParser::DONE) {
+                if (state_ == STREAMING) {
+                    flush_sse_batch();
+                    fail("stream ended");
+                    return;
+                }
+                RequestKind kind = inflight_;
+                HttpResponse resp = std::move(parser_.response());
+                bool keep_alive = resp.keep_alive;
+                on_response(kind, resp);
+                if (!keep_alive) {
+                    close_socket();
+                    if (!queue_.empty()) connect();
+                    return;
+                }
+                state_ = IDLE;
+                send_next();
+                if (state_ != WAITING) break;   // 主机不会主动发送多余数据
+            }
+        }
+    }
+
+    flush_sse_batch();
+}
+
+// ==================== 响应处理 ====================
+
+void Upstream::on_response(RequestKind kind, HttpResponse& resp) {
+    backoff_ms_ = UPSTREAM_BACKOFF_MIN_MS;
+
+    if (resp.status == 304) {
+        fleet_.update_gateway(config_.name, [](GatewayStatus& s) {
+            s.reachable = true;
+            s.not_modified++;
+            s.last_ok_ms = wall_ms();
+        });
+        return;
+    }
+    if (resp.status != 200) {
+        LOG_W("%s: HTTP %d", config_.name.c_str(), resp.status);
+        fleet_.update_gateway(config_.name, [](GatewayStatus& s) { s.errors++; });
+        return;
+    }
+
+    const std::string& etag = resp.header("etag");
+    if (kind == REQ_STATUS) {
+        status_etag_ = etag;
+        submit([this, body = std::move(resp.body)]() { merge_status(body); });
+    } else {
+        towers_etag_ = etag;
+        submit([this, body = std::move(resp.body)]() { merge_towers(body, true); });
+    }
+}
+
+void Upstream::on_sse_event(const SseEvent& ev) {
+    if (ev.event == "resync") {
+        // 主机随后发送 status 和全部 tower 事件
+        flush_sse_batch();
+        sse_resync_ = true;
+        sse_expect_ = -1;
+        sse_snapshot_.clear();
+        return;
+    }
+
+    if (ev.event == "status") {
+        if (sse_resync_ && sse_expect_ < 0) {
+            JsonValue doc;
+            std::string err;
+            if (JsonValue::parse(ev.data, &doc, &err)) sse_expect_ = (int)doc["towers"].as_int(0);
+        }
+        submit([this, body = ev.data]() { merge_status(body); });
+    } else if (ev.event == "tower") {
+        JsonValue doc;
+        std::string err;
+        if (!JsonValue::parse(ev.data, &doc, &err) || !doc.is_object()) {
+            LOG_W("%s: 事件格式错误 (%s)", config_.name.c_str(), err.c_str());
+            return;
+        }
+        TowerReport r;
+        r.id = (uint32_t)doc["id"].as_int();
+        r.level = (int)doc["level"].as_int();
+        r.pump = doc["pump"].as_bool();
+        r.online = doc["online"].as_bool(true);
+        if (sse_resync_) {
+            sse_snapshot_.push_back(r);
+        } else {
+            sse_batch_.push_back(r);
+        }
+    }
+
+    if (sse_resync_ && sse_expect_ >= 0 && (int)sse_snapshot_.size() >= sse_expect_) {
+        sse_resync_ = false;
+        std::vector<TowerReport> snapshot;
+        snapshot.swap(sse_snapshot_);
+        submit([this, snapshot = std::move(snapshot)]() mutable { merge_reports(std::move(snapshot), true); });
+    }
+}
+
+void Upstream::flush_sse_batch() {
+    if (sse_batch_.empty()) return;
+    std::vector<TowerReport> batch;
+    batch.swap(sse_batch_);
+    submit([this, batch = std::move(batch)]() mutable { merge_reports(std::move(batch), false); });
+}
+
+// ==================== 合并 (工作线程) ====================
+
+void Upstream::submit(std::function<void()> work) {
+    work_.push_back(std::move(work));
+    if (!working_) run_next();
+}
+
+void Upstream::run_next() {
+    working_ = true;
+    std::function<void()> work = std::move(work_.front());
+    work_.pop_front();
+    pool_.submit([this, work = std::move(work)]() {
+        work();
+        loop_.post([this]() {
+            working_ = false;
+            if (!work_.empty()) run_next();
+        });
+    });
+}
+
+void Upstream::merge_status(const std::string& body) {
+    JsonValue doc;
+    std::string err;
+    if (!JsonValue::parse(body, &doc, &err) || !doc.is_object()) {
+        LOG_W("%s: 状态格式错误 (%s)", config_.name.c_str(), err.c_str());
+        return;
+    }
+    std::string mode = doc["mode"].as_string();
+    bool well = doc["well_water"].as_bool(true);
+    fleet_.update_gateway(config_.name, [&](GatewayStatus& s) {
+        s.reachable = true;
+        s.mode = mode;
+        s.well_water = well;
+        s.last_ok_ms = wall_ms();
+    });
+}
+
+void Upstream::merge_towers(const std::string& body, bool complete) {
+    JsonValue doc;
+    std::string err;
+    if (!JsonValue::parse(body, &doc, &err) || !doc.is_array()) {
+        LOG_W("%s: 水塔列表格式错误 (%s)", config_.name.c_str(), err.c_str());
+        return;
+    }
+
+    std::vector<TowerReport> reports;
+    reports.reserve(doc.items().size());
+    for (const JsonValue& item : doc.items()) {
+        TowerReport r;
+        r.id = (uint32_t)item["id"].as_int();
+        r.level = (int)item["level"].as_int();
+        r.pump = item["pump"].as_bool();
+        r.online = item["online"].as_bool(true);
+        reports.push_back(r);
+    }
+    merge_reports(std::move(reports), complete);
+}
+
+void Upstream::merge_reports(std::vector<TowerReport> reports, bool complete) {
+    // 序号在工作线程中分配: 同一网关的任务串行执行，顺序即提交顺序
+    fleet_.apply(config_.name, ++seq_, reports, complete, wall_ms());
+}
+
+}  // namespace wt
@@ -0,0 +1,127 @@
+/*
+ * 上游主机连接 (每台 ESP8266 主机一个)
+ *
+ * 两种方式获取状态：
+ * - 轮询: 按间隔请求 /api/status 和 /api/towers，带 If-None-Match，
+ *         状态未变化时主机只回 304
+ * - 推送: 订阅 /api/events (SSE)，主机订阅已满 (503) 时自动退回轮询
+ *
+ * 所有网络 I/O 在事件循环线程完成；响应体的 JSON 解析与合并
+ * 交给工作线程池，按批次序号保证合并顺序。
+ */
+
+#ifndef WT_UPSTREAM_H
+#define WT_UPSTREAM_H
+
+#include "event_loop.h"
+#include "fleet.h"
+#include "http.h"
+#include "net.h"
+#include "sse.h"
+#include "thread_pool.h"
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace wt {
+
+// 单个请求超时
+#define UPSTREAM_REQUEST_TIMEOUT_MS     5000
+
+// 推送连接无数据超时 (主机每 15 秒发送保活注释)
+#define UPSTREAM_STREAM_TIMEOUT_MS      40000
+
+// 重连退避 (初始值与上限)
+#define UPSTREAM_BACKOFF_MIN_MS         1000
+#define UPSTREAM_BACKOFF_MAX_MS         30000
+
+struct UpstreamConfig {
+    std::string name;           // 网关名称
+    std::string site;           // 站点 (同一站点内的水塔 ID 唯一)
+    std::string host;
+    uint16_t port = 80;
+    bool push = false;          // true=订阅 SSE
+    uint32_t poll_ms = 1000;
+};
+
+class Upstream {
+public:
+    Upstream(EventLoop& loop, ThreadPool& pool, FleetModel& fleet, const UpstreamConfig& config);
+    ~Upstream();
+
+    /**
+     * 解析地址并开始工作
+     * @return false=地址无法解析
+     */
+    bool start(std::string* err);
+
+    const UpstreamConfig& config() const { return config_; }
+
+private:
+    enum State { DISCONNECTED, CONNECTING, IDLE, WAITING, STREAMING };
+    enum RequestKind { REQ_STATUS, REQ_TOWERS, REQ_EVENTS };
+
+    void connect();
+    void on_socket(uint32_t events);
+    void on_readable();
+    void poll_tick();
+    void send_next();
+    void on_response(RequestKind kind, HttpResponse& resp);
+    void on_sse_event(const SseEvent& ev);
+    void flush_sse_batch();
+    void fail(const char* reason);
+    void close_socket();
+    void arm_deadline(uint32_t ms);
+    void disarm_deadline();
+    void schedule_retry();
+
+    // 解析与合并在线程池中执行，同一网关的任务串行 (保证顺序)
+    void submit(std::function<void()> work);
+    void run_next();
+
+    void merge_status(const std::string& body);
+    void merge_towers(const std::string& body, bool complete);
+    void merge_reports(std::vector<TowerReport> reports, bool complete);
+
+    EventLoop& loop_;
+    ThreadPool& pool_;
+    FleetModel& fleet_;
+    UpstreamConfig config_;
+    std::string host_header_;
+    SockAddr addr_;
+
+    State state_ = DISCONNECTED;
+    int fd_ = -1;
+    std::string out_;
+    HttpResponseParser parser_;
+    SseParser sse_;
+    std::deque<RequestKind> queue_;         // 待发送
+    RequestKind inflight_ = REQ_STATUS;
+
+    bool push_ = false;                     // 当前是否使用推送 (503 后退回轮询)
+    std::string status_etag_;
+    std::string towers_etag_;
+    uint64_t seq_ = 0;
+
+    // 推送: 一次读取中收到的水塔事件合并为一批；
+    // resync 之后按 status 中的水塔数收集完整快照
+    std::vector<TowerReport> sse_batch_;
+    std::vector<TowerReport> sse_snapshot_;
+    bool sse_resync_ = false;
+    int sse_expect_ = -1;
+
+    std::deque<std::function<void()>> work_;
+    bool working_ = false;
+
+    int poll_timer_ = -1;
+    int deadline_timer_ = -1;
+    int retry_timer_ = -1;
+    uint32_t backoff_ms_ = UPSTREAM_BACKOFF_MIN_MS;
+};
+
+}  // namespace wt
+
+#endif  // WT_UPSTREAM_H
@@ -0,0 +1,142 @@
+/*
+ * epoll 事件循环实现
+ */
+
+#include "event_loop.h"
+#include "log.h"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace wt {
+
+// 每次 epoll_wait 处理的最大事件数
+#define EVENT_BATCH     256
+
+EventLoop::EventLoop() {
+    epfd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epfd_ < 0) throw std::runtime_error(std::string("epoll_create1: ") + strerror(errno));
+
+    wakefd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakefd_ < 0) throw std::runtime_error(std::string("eventfd: ") + strerror(errno));
+
+    add(wakefd_, EPOLLIN, [this](uint32_t) {
+        uint64_t value;
+        while (read(wakefd_, &value, sizeof(value)) > 0) {}
+        drain_posted();
+    });
+}
+
+EventLoop::~EventLoop() {
+    for (auto& entry : handlers_) {
+        if (entry.first != wakefd_) epoll_ctl(epfd_, EPOLL_CTL_DEL, entry.first, nullptr);
+    }
+    close(wakefd_);
+    close(epfd_);
+}
+
+void EventLoop::add(int fd, uint32_t events, Handler handler) {
+    epoll_event ev{};
+    ev.events = events;
+    ev.data.fd = fd;
+    if (epoll_ctl(epfd_, EPOLL_CTL_ADD, fd, &ev) < 0) {
+        throw std::runtime_error(std::string("epoll_ctl ADD: ") + strerror(errno));
+    }
+    handlers_[fd] = std::make_shared<Handler>(std::move(handler));
+}
+
+void EventLoop::modify(int fd, uint32_t events) {
+    epoll_event ev{};
+    ev.events = events;
+    ev.data.fd = fd;
+    if (epoll_ctl(epfd_, EPOLL_CTL_MOD, fd, &ev) < 0) {
+        LOG_W("epoll_ctl MOD fd=%d: %s", fd, strerror(errno));
+    }
+}
+
+void EventLoop::remove(int fd) {
+    epoll_ctl(epfd_, EPOLL_CTL_DEL, fd, nullptr);
+    handlers_.erase(fd);
+}
+
+int EventLoop::add_timer(uint32_t interval_ms, std::function<void()> callback, bool repeat) {
+    int tfd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (tfd < 0) throw std::runtime_error(std::string("timerfd_create: ") + strerror(errno));
+
+    itimerspec spec{};
+    spec.it_value.tv_sec = interval_ms / 1000;
+    spec.it_value.tv_nsec = (long)(interval_ms % 1000) * 1000000L;
+    if (spec.it_value.tv_sec == 0 && spec.it_value.tv_nsec == 0) spec.it_value.tv_nsec = 1;
+    if (repeat) spec.it_interval = spec.it_value;
+    timerfd_settime(tfd, 0, &spec, nullptr);
+
+    add(tfd, EPOLLIN, [this, tfd, repeat, callback = std::move(callback)](uint32_t) {
+        uint64_t expirations;
+        if (read(tfd, &expirations, sizeof(expirations)) != sizeof(expirations)) return;
+        if (!repeat) cancel_timer(tfd);
+        callback();
+    });
+    return tfd;
+}
+
+void EventLoop::cancel_timer(int id) {
+    if (handlers_.count(id) == 0) return;
+    remove(id);
+    close(id);
+}
+
+void EventLoop::post(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(post_mutex_);
+        posted_.push_back(std::move(task));
+    }
+    uint64_t one = 1;
+    ssize_t n = write(wakefd_, &one, sizeof(one));
+    (void)n;
+}
+
+void EventLoop::drain_posted() {
+    std::vector<std::function<void()>> tasks;
+    {
+        std::lock_guard<std::mutex> lock(post_mutex_);
+        tasks.swap(posted_);
+    }
+    for (auto& task : tasks) task();
+}
+
+void EventLoop::run() {
+    epoll_event events[EVENT_BATCH];
+    running_ = true;
+
+    while (running_) {
+        int n = epoll_wait(epfd_, events, EVENT_BATCH, -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            throw std::runtime_error(std::string("epoll_wait: ") + strerror(errno));
+        }
+        for (int i = 0; i < n; i++) {
+            auto it = handlers_.find(events[i].data.fd);
+            if (it == handlers_.end()) continue;  // 本轮中已被注销
+            std::shared_ptr<Handler> handler = it->second;
+            (*handler)(events[i].events);
+        }
+    }
+}
+
+void EventLoop::stop() {
+    post([this] { running_ = false; });
+}
+
+uint64_t EventLoop::now_ms() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+}  // namespace wt
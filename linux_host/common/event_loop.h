@@ -0,0 +1,98 @@
+/*
+ * epoll 事件循环
+ *
+ * 单线程分发文件描述符事件和 timerfd 定时器；
+ * 其他线程通过 post() 把任务投递到循环线程执行 (eventfd 唤醒)。
+ * 回调中可以安全地增删自身或其他描述符。
+ */
+
+#ifndef WT_EVENT_LOOP_H
+#define WT_EVENT_LOOP_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace wt {
+
+class EventLoop {
+public:
+    // 参数为 epoll 事件位 (EPOLLIN / EPOLLOUT / EPOLLERR ...)
+    using Handler = std::function<void(uint32_t events)>;
+
+    EventLoop();
+    ~EventLoop();
+
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    /**
+     * 注册描述符 (只能在循环线程中调用)
+     * @param fd 非阻塞描述符
+     * @param events 关注的事件
+     * @param handler 事件回调
+     */
+    void add(int fd, uint32_t events, Handler handler);
+
+    /**
+     * 修改关注的事件
+     */
+    void modify(int fd, uint32_t events);
+
+    /**
+     * 注销描述符 (不关闭)
+     */
+    void remove(int fd);
+
+    /**
+     * 添加定时器 (timerfd)
+     * @param interval_ms 间隔 (毫秒)
+     * @param callback 回调
+     * @param repeat false=只触发一次
+     * @return 定时器 ID，用于 cancel_timer()
+     */
+    int add_timer(uint32_t interval_ms, std::function<void()> callback, bool repeat = true);
+
+    /**
+     * 取消定时器
+     */
+    void cancel_timer(int id);
+
+    /**
+     * 投递任务到循环线程 (线程安全)
+     */
+    void post(std::function<void()> task);
+
+    /**
+     * 运行直到 stop()
+     */
+    void run();
+
+    /**
+     * 停止循环 (线程安全)
+     */
+    void stop();
+
+    /**
+     * 单调时钟 (毫秒)
+     */
+    static uint64_t now_ms();
+
+private:
+    void drain_posted();
+
+    int epfd_;
+    int wakefd_;
+    bool running_ = false;
+    std::unordered_map<int, std::shared_ptr<Handler>> handlers_;
+
+    std::mutex post_mutex_;
+    std::vector<std::function<void()>> posted_;
+};
+
+}  // namespace wt
+
+#endif  // WT_EVENT_LOOP_H
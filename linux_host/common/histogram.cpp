@@ -0,0 +1,68 @@
+/*
+ * 延迟直方图实现
+ */
+
+#include "histogram.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace wt {
+
+size_t LatencyHistogram::index_of(uint64_t value) {
+    if (value < HISTOGRAM_LINEAR) return (size_t)value;
+    unsigned e = 63 - (unsigned)__builtin_clzll(value);     // value 位于 [2^e, 2^(e+1))，e >= 6
+    size_t sub = (size_t)(value >> (e - 5)) & (HISTOGRAM_SUB_BUCKETS - 1);
+    return HISTOGRAM_LINEAR + (e - 6) * HISTOGRAM_SUB_BUCKETS + sub;
+}
+
+uint64_t LatencyHistogram::upper_bound(size_t index) {
+    if (index < HISTOGRAM_LINEAR) return index;
+    size_t e = (index - HISTOGRAM_LINEAR) / HISTOGRAM_SUB_BUCKETS + 6;
+    uint64_t sub = (index - HISTOGRAM_LINEAR) % HISTOGRAM_SUB_BUCKETS;
+    uint64_t width = 1ULL << (e - 5);
+    return (1ULL << e) + (sub + 1) * width - 1;
+}
+
+void LatencyHistogram::record(uint64_t value) {
+    buckets_[index_of(value)]++;
+    if (value < min_) min_ = value;
+    if (value > max_) max_ = value;
+    sum_ += value;
+    count_++;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    if (other.count_ == 0) return;
+    for (size_t i = 0; i < HISTOGRAM_BUCKETS; i++) buckets_[i] += other.buckets_[i];
+    if (other.min_ < min_) min_ = other.min_;
+    if (other.max_ > max_) max_ = other.max_;
+    sum_ += other.sum_;
+    count_ += other.count_;
+}
+
+void LatencyHistogram::reset() {
+    memset(buckets_, 0, sizeof(buckets_));
+    count_ = 0;
+    min_ = UINT64_MAX;
+    max_ = 0;
+    sum_ = 0;
+}
+
+uint64_t LatencyHistogram::percentile(double p) const {
+    if (count_ == 0) return 0;
+    uint64_t rank = (uint64_t)std::ceil(p / 100.0 * count_);
+    if (rank == 0) rank = 1;
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        seen += buckets_[i];
+        if (seen >= rank) {
+            uint64_t v = upper_bound(i);
+            return v < max_ ? v : max_;
+        }
+    }
+    return max_;
+}
+
+}  // namespace wt
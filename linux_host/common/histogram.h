@@ -0,0 +1,54 @@
+/*
+ * 延迟直方图
+ *
+ * 对数-线性分桶：小于 64 的值精确记录，其余每个 2 的幂区间再分 32 个子桶
+ * (相对误差 < 3.2%)，覆盖全部 uint64 取值，记录为 O(1) 且不分配内存。
+ * 单位由调用方决定 (通常为纳秒或微秒)。非线程安全，多线程时各自记录后 merge()。
+ */
+
+#ifndef WT_HISTOGRAM_H
+#define WT_HISTOGRAM_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace wt {
+
+// 精确记录的范围与每个 2 的幂区间的子桶数
+#define HISTOGRAM_LINEAR        64
+#define HISTOGRAM_SUB_BUCKETS   32
+#define HISTOGRAM_BUCKETS       (HISTOGRAM_LINEAR + (64 - 6) * HISTOGRAM_SUB_BUCKETS)
+
+class LatencyHistogram {
+public:
+    LatencyHistogram() { reset(); }
+
+    void record(uint64_t value);
+    void merge(const LatencyHistogram& other);
+    void reset();
+
+    uint64_t count() const { return count_; }
+    uint64_t min() const { return count_ ? min_ : 0; }
+    uint64_t max() const { return max_; }
+    double mean() const { return count_ ? (double)sum_ / count_ : 0; }
+
+    /**
+     * 百分位数 (桶上界，不超过最大值)
+     * @param p 0-100，例如 99.9
+     */
+    uint64_t percentile(double p) const;
+
+private:
+    static size_t index_of(uint64_t value);
+    static uint64_t upper_bound(size_t index);
+
+    uint64_t buckets_[HISTOGRAM_BUCKETS];
+    uint64_t count_;
+    uint64_t min_;
+    uint64_t max_;
+    uint64_t sum_;
+};
+
+}  // namespace wt
+
+#endif  // WT_HISTOGRAM_H
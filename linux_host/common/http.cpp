@@ -0,0 +1,404 @@
+/*
+ * HTTP/1.1 报文解析与生成实现
+ */
+
+#include "http.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace wt {
+
+static const std::string empty_string;
+
+static std::string to_lower(std::string s) {
+    std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return (char)tolower(c); });
+    return s;
+}
+
+static std::string trim(const std::string& s) {
+    size_t b = s.find_first_not_of(" \t");
+    if (b == std::string::npos) return "";
+    size_t e = s.find_last_not_of(" \t\r");
+    return s.substr(b, e - b + 1);
+}
+
+static bool header_has_token(const std::string& value, const char* token) {
+    return to_lower(value).find(token) != std::string::npos;
+}
+
+/**
+ * 解析头部字段行 (首行之后的部分)
+ * @return false=格式错误
+ */
+static bool parse_header_lines(const std::string& block, size_t pos, HttpHeaders* headers) {
+    while (pos < block.size()) {
+        size_t eol = block.find("\r\n", pos);
+        if (eol == std::string::npos) eol = block.size();
+        if (eol == pos) break;
+        size_t colon = block.find(':', pos);
+        if (colon == std::string::npos || colon > eol) return false;
+        std::string name = to_lower(block.substr(pos, colon - pos));
+        std::string value = trim(block.substr(colon + 1, eol - colon - 1));
+        auto it = headers->find(name);
+        if (it != headers->end()) {
+            it->second += ", " + value;  // 重复字段合并
+        } else {
+            (*headers)[name] = value;
+        }
+        pos = eol + 2;
+    }
+    return true;
+}
+
+const std::string& HttpRequest::header(const std::string& name) const {
+    auto it = headers.find(name);
+    return it == headers.end() ? empty_string : it->second;
+}
+
+const std::string& HttpResponse::header(const std::string& name) const {
+    auto it = headers.find(name);
+    return it == headers.end() ? empty_string : it->second;
+}
+
+static bool find_param(const std::string& text, const std::string& name, std::string* value) {
+    size_t pos = 0;
+    while (pos <= text.size()) {
+        size_t amp = text.find('&', pos);
+        if (amp == std::string::npos) amp = text.size();
+        size_t eq = text.find('=', pos);
+        std::string key = http_url_decode(text.substr(pos, (eq < amp ? eq : amp) - pos));
+        if (key == name) {
+            *value = eq < amp ? http_url_decode(text.substr(eq + 1, amp - eq - 1)) : "";
+            return true;
+        }
+        pos = amp + 1;
+    }
+    return false;
+}
+
+bool HttpRequest::param(const std::string& name, std::string* value) const {
+    if (find_param(query, name, value)) return true;
+    if (header_has_token(header("content-type"), "application/x-www-form-urlencoded")) {
+        return find_param(body, name, value);
+    }
+    return false;
+}
+
+// ==================== 请求解析 ====================
+
+HttpRequestParser::Result HttpRequestParser::parse(std::string& buffer, HttpRequest* req) {
+    size_t end = buffer.find("\r\n\r\n");
+    if (end == std::string::npos) {
+        return buffer.size() > HTTP_MAX_HEADER_SIZE ? ERROR : NEED_MORE;
+    }
+
+    // 请求行
+    size_t eol = buffer.find("\r\n");
+    std::string line = buffer.substr(0, eol);
+    size_t sp1 = line.find(' ');
+    size_t sp2 = line.rfind(' ');
+    if (sp1 == std::string::npos || sp2 == sp1) return ERROR;
+
+    HttpRequest r;
+    r.method = line.substr(0, sp1);
+    r.target = line.substr(sp1 + 1, sp2 - sp1 - 1);
+    std::string version = line.substr(sp2 + 1);
+    if (version.compare(0, 5, "HTTP/") != 0) return ERROR;
+
+    std::string block = buffer.substr(0, end + 2);
+    if (!parse_header_lines(block, eol + 2, &r.headers)) return ERROR;
+
+    size_t q = r.target.find('?');
+    r.path = r.target.substr(0, q);
+    if (q != std::string::npos) r.query = r.target.substr(q + 1);
+
+    const std::string& connection = r.header("connection");
+    if (version == "HTTP/1.0") {
+        r.keep_alive = header_has_token(connection, "keep-alive");
+    } else {
+        r.keep_alive = !header_has_token(connection, "close");
+    }
+
+    if (!r.header("transfer-encoding").empty()) return ERROR;  // 不支持分块请求体
+
+    size_t body_len = 0;
+    const std::string& cl = r.header("content-length");
+    if (!cl.empty()) {
+        char* stop;
+        unsigned long long value = strtoull(cl.c_str(), &stop, 10);
+        if (*stop != '\0' || value > HTTP_MAX_BODY_SIZE) return ERROR;
+        body_len = (size_t)value;
+    }
+
+    size_t total = end + 4 + body_len;
+    if (buffer.size() < total) return NEED_MORE;
+
+    r.body = buffer.substr(end + 4, body_len);
+    buffer.erase(0, total);
+    *req = std::move(r);
+    return DONE;
+}
+
+// ==================== 响应解析 ====================
+
+void HttpResponseParser::reset(bool head_request) {
+    state_ = HEADER;
+    head_request_ = head_request;
+    header_buf_.clear();
+    line_buf_.clear();
+    remaining_ = 0;
+    resp_ = HttpResponse();
+}
+
+void HttpResponseParser::emit_body(const char* data, size_t len) {
+    if (len == 0) return;
+    if (on_body) {
+        on_body(data, len);
+    } else {
+        resp_.body.append(data, len);
+    }
+}
+
+HttpResponseParser::Result HttpResponseParser::parse_header() {
+    size_t eol = header_buf_.find("\r\n");
+    std::string line = header_buf_.substr(0, eol);
+
+    // HTTP/1.1 200 OK
+    if (line.compare(0, 5, "HTTP/") != 0 || line.size() < 12) return ERROR;
+    resp_.status = atoi(line.c_str() + 9);
+    if (resp_.status < 100 || resp_.status > 999) return ERROR;
+    bool http10 = line.compare(0, 8, "HTTP/1.0") == 0;
+
+    if (!parse_header_lines(header_buf_, eol + 2, &resp_.headers)) return ERROR;
+
+    const std::string& connection = resp_.header("connection");
+    resp_.keep_alive = http10 ? header_has_token(connection, "keep-alive")
+                              : !header_has_token(connection, "close");
+
+    // 无响应体
+    if (head_request_ || resp_.status == 204 || resp_.status == 304 || resp_.status < 200) {
+        state_ = COMPLETE;
+        return DONE;
+    }
+
+    if (header_has_token(resp_.header("transfer-encoding"), "chunked")) {
+        state_ = CHUNK_SIZE;
+        return NEED_MORE;
+    }
+
+    const std::string& cl = resp_.header("content-length");
+    if (!cl.empty()) {
+        char* stop;
+        unsigned long long value = strtoull(cl.c_str(), &stop, 10);
+        if (*stop != '\0' || value > HTTP_MAX_BODY_SIZE) return ERROR;
+        remaining_ = (size_t)value;
+        if (remaining_ == 0) {
+            state_ = COMPLETE;
+            return DONE;
+        }
+        state_ = BODY_LENGTH;
+        return NEED_MORE;
+    }
+
+    // 无长度：读到连接关闭 (SSE 等流式响应)
+    resp_.keep_alive = false;
+    state_ = BODY_UNTIL_CLOSE;
+    return NEED_MORE;
+}
+
+HttpResponseParser::Result HttpResponseParser::feed(const char* data, size_t len, size_t* consumed) {
+    size_t pos = 0;
+
+    while (pos < len && state_ != COMPLETE) {
+        switch (state_) {
+            case HEADER: {
+                // 逐段追加，找到空行为止
+                size_t old = header_buf_.size();
+                header_buf_.append(data + pos, len - pos);
+                size_t end = header_buf_.find("\r\n\r\n", old >= 3 ? old - 3 : 0);
+                if (end == std::string::npos) {
+                    pos = len;
+                    if (header_buf_.size() > HTTP_MAX_HEADER_SIZE) return ERROR;
+                    break;
+                }
+                pos += end + 4 - old;
+                header_buf_.resize(end + 2);
+                Result r = parse_header();
+                if (r != NEED_MORE) {
+                    *consumed = pos;
+                    return r;
+                }
+                break;
+            }
+
+            case BODY_LENGTH: {
+                size_t n = std::min(remaining_, len - pos);
+                emit_body(data + pos, n);
+                pos += n;
+                remaining_ -= n;
+                if (remaining_ == 0) state_ = COMPLETE;
+                break;
+            }
+
+            case CHUNK_SIZE:
+            case CHUNK_CRLF:
+            case TRAILER: {
+                // 按行处理
+                const char* nl = (const char*)memchr(data + pos, '\n', len - pos);
+                if (nl == nullptr) {
+                    line_buf_.append(data + pos, len - pos);
+                    pos = len;
+                    if (line_buf_.size() > 1024) return ERROR;
+                    break;
+                }
+                line_buf_.append(data + pos, nl - (data + pos));
+                pos = nl - data + 1;
+                if (!line_buf_.empty() && line_buf_.back() == '\r') line_buf_.pop_back();
+
+                if (state_ == CHUNK_SIZE) {
+                    char* stop;
+                    unsigned long size = strtoul(line_buf_.c_str(), &stop, 16);
+                    if (stop == line_buf_.c_str() || size > HTTP_MAX_BODY_SIZE) return ERROR;
+                    remaining_ = size;
+                    state_ = size == 0 ? TRAILER : CHUNK_DATA;
+                } else if (state_ == CHUNK_CRLF) {
+                    if (!line_buf_.empty()) return ERROR;
+                    state_ = CHUNK_SIZE;
+                } else if (line_buf_.empty()) {
+                    state_ = COMPLETE;  // 尾部字段结束
+                }
+                line_buf_.clear();
+                break;
+            }
+
+            case CHUNK_DATA: {
+                size_t n = std::min(remaining_, len - pos);
+                emit_body(data + pos, n);
+                pos += n;
+                remaining_ -= n;
+                if (remaining_ == 0) state_ = CHUNK_CRLF;
+                break;
+            }
+
+            case BODY_UNTIL_CLOSE:
+                emit_body(data + pos, len - pos);
+                pos = len;
+                break;
+
+            case COMPLETE:
+                break;
+        }
+    }
+
+    *consumed = pos;
+    return state_ == COMPLETE ? DONE : NEED_MORE;
+}
+
+HttpResponseParser::Result HttpResponseParser::finish() {
+    if (state_ == BODY_UNTIL_CLOSE || state_ == COMPLETE) {
+        state_ = COMPLETE;
+        return DONE;
+    }
+    return ERROR;
+}
+
+// ==================== 生成 ====================
+
+const char* http_status_text(int status) {
+    switch (status) {
+        case 200: return "OK";
+        case 204: return "No Content";
+        case 304: return "Not Modified";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 413: return "Payload Too Large";
+        case 500: return "Internal Server Error";
+        case 503: return "Service Unavailable";
+        default: return "Unknown";
+    }
+}
+
+std::string http_format_header(int status, const std::string& content_type, size_t body_len,
+                               const HttpHeaderList& headers, bool keep_alive) {
+    std::string out;
+    out.reserve(160);
+    out += "HTTP/1.1 ";
+    out += std::to_string(status);
+    out += ' ';
+    out += http_status_text(status);
+    out += "\r\n";
+    if (!content_type.empty() && status != 304) {
+        out += "Content-Type: ";
+        out += content_type;
+        out += "\r\n";
+    }
+    for (const auto& h : headers) {
+        out += h.first;
+        out += ": ";
+        out += h.second;
+        out += "\r\n";
+    }
+    if (status != 304 && status != 204) {
+        out += "Content-Length: ";
+        out += std::to_string(body_len);
+        out += "\r\n";
+    }
+    out += keep_alive ? "Connection: keep-alive\r\n\r\n" : "Connection: close\r\n\r\n";
+    return out;
+}
+
+std::string http_format_response(int status, const std::string& content_type, const std::string& body,
+                                 const HttpHeaderList& headers, bool keep_alive) {
+    std::string out = http_format_header(status, content_type, body.size(), headers, keep_alive);
+    if (status != 304 && status != 204) out += body;
+    return out;
+}
+
+std::string http_format_request(const std::string& method, const std::string& host, const std::string& target,
+                                const HttpHeaderList& headers, const std::string& body) {
+    std::string out;
+    out.reserve(128 + body.size());
+    out += method;
+    out += ' ';
+    out += target;
+    out += " HTTP/1.1\r\nHost: ";
+    out += host;
+    out += "\r\n";
+    for (const auto& h : headers) {
+        out += h.first;
+        out += ": ";
+        out += h.second;
+        out += "\r\n";
+    }
+    if (!body.empty() || method == "POST") {
+        out += "Content-Length: ";
+        out += std::to_string(body.size());
+        out += "\r\n";
+    }
+    out += "\r\n";
+    out += body;
+    return out;
+}
+
+std::string http_url_decode(const std::string& text) {
+    std::string out;
+    out.reserve(text.size());
+    for (size_t i = 0; i < text.size(); i++) {
+        char c = text[i];
+        if (c == '+') {
+            out.push_back(' ');
+        } else if (c == '%' && i + 2 < text.size() && isxdigit((unsigned char)text[i + 1]) &&
+                   isxdigit((unsigned char)text[i + 2])) {
+            out.push_back((char)strtol(text.substr(i + 1, 2).c_str(), nullptr, 16));
+            i += 2;
+        } else {
+            out.push_back(c);
+        }
+    }
+    return out;
+}
+
+}  // namespace wt
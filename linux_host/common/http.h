@@ -0,0 +1,149 @@
+/*
+ * HTTP/1.1 报文解析与生成
+ *
+ * - HttpRequestParser:  服务端解析请求 (Content-Length 请求体)
+ * - HttpResponseParser: 客户端增量解析响应 (Content-Length / chunked / 读到关闭)，
+ *                       设置 on_body 后响应体按到达顺序回调而不缓存 (用于 SSE)
+ */
+
+#ifndef WT_HTTP_H
+#define WT_HTTP_H
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace wt {
+
+// 请求头上限
+#define HTTP_MAX_HEADER_SIZE    16384
+
+// 请求/响应体上限
+#define HTTP_MAX_BODY_SIZE      (4 * 1024 * 1024)
+
+// 头部字段 (名称统一为小写)
+using HttpHeaders = std::map<std::string, std::string>;
+using HttpHeaderList = std::vector<std::pair<std::string, std::string>>;
+
+struct HttpRequest {
+    std::string method;
+    std::string target;         // 原始请求目标 (路径 + 查询串)
+    std::string path;           // 解码前的路径
+    std::string query;          // '?' 之后的部分
+    HttpHeaders headers;
+    std::string body;
+    bool keep_alive = true;
+
+    /**
+     * 取头部字段 (名称小写)，不存在返回空串
+     */
+    const std::string& header(const std::string& name) const;
+
+    /**
+     * 取查询参数或表单参数 (application/x-www-form-urlencoded 请求体)
+     * @return false=不存在
+     */
+    bool param(const std::string& name, std::string* value) const;
+};
+
+struct HttpResponse {
+    int status = 0;
+    HttpHeaders headers;
+    std::string body;
+    bool keep_alive = true;
+
+    const std::string& header(const std::string& name) const;
+};
+
+// ==================== 请求解析 ====================
+
+class HttpRequestParser {
+public:
+    enum Result { NEED_MORE, DONE, ERROR };
+
+    /**
+     * 从缓冲区解析一个完整请求，成功时从 buffer 中移除已解析的字节
+     */
+    Result parse(std::string& buffer, HttpRequest* req);
+};
+
+// ==================== 响应解析 ====================
+
+class HttpResponseParser {
+public:
+    enum Result { NEED_MORE, DONE, ERROR };
+
+    // 设置后响应体不缓存，逐段回调
+    std::function<void(const char* data, size_t len)> on_body;
+
+    /**
+     * 开始解析新的响应
+     * @param head_request 对应请求是否为 HEAD (无响应体)
+     */
+    void reset(bool head_request = false);
+
+    /**
+     * 输入数据
+     * @param consumed 实际使用的字节数 (DONE 时其后可能是下一个响应)
+     */
+    Result feed(const char* data, size_t len, size_t* consumed);
+
+    /**
+     * 连接已关闭 (完成"读到关闭"类型的响应体)
+     */
+    Result finish();
+
+    bool headers_done() const { return state_ > HEADER; }
+    HttpResponse& response() { return resp_; }
+
+private:
+    enum State { HEADER, BODY_LENGTH, CHUNK_SIZE, CHUNK_DATA, CHUNK_CRLF, TRAILER, BODY_UNTIL_CLOSE, COMPLETE };
+
+    Result parse_header();
+    void emit_body(const char* data, size_t len);
+
+    State state_ = HEADER;
+    bool head_request_ = false;
+    std::string header_buf_;
+    std::string line_buf_;
+    size_t remaining_ = 0;
+    HttpResponse resp_;
+};
+
+// ==================== 生成 ====================
+
+/**
+ * 状态码说明文字
+ */
+const char* http_status_text(int status);
+
+/**
+ * 生成响应头部 (含空行)
+ * @param body_len 响应体长度 (写入 Content-Length)
+ */
+std::string http_format_header(int status, const std::string& content_type, size_t body_len,
+                               const HttpHeaderList& headers = {}, bool keep_alive = true);
+
+/**
+ * 生成完整响应报文
+ */
+std::string http_format_response(int status, const std::string& content_type, const std::string& body,
+                                 const HttpHeaderList& headers = {}, bool keep_alive = true);
+
+/**
+ * 生成请求报文
+ */
+std::string http_format_request(const std::string& method, const std::string& host, const std::string& target,
+                                const HttpHeaderList& headers = {}, const std::string& body = "");
+
+/**
+ * URL 解码 (含 '+' -> ' ')
+ */
+std::string http_url_decode(const std::string& text);
+
+}  // namespace wt
+
+#endif  // WT_HTTP_H
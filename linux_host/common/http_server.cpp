@@ -0,0 +1,232 @@
+/*
+ * epoll HTTP/1.1 服务端实现
+ */
+
+#include "http_server.h"
+#include "log.h"
+#include "net.h"
+
+#include <cerrno>
+#include <cstring>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace wt {
+
+// 单次 writev 的最大分段数
+#define WRITEV_MAX_IOV  16
+
+HttpServer::HttpServer(EventLoop& loop) : loop_(loop) {}
+
+HttpServer::~HttpServer() {
+    std::vector<int> fds;
+    for (auto& entry : conns_) fds.push_back(entry.first);
+    for (int fd : fds) close_conn(fd);
+    if (sweep_timer_ >= 0) loop_.cancel_timer(sweep_timer_);
+    if (listen_fd_ >= 0) {
+        loop_.remove(listen_fd_);
+        close(listen_fd_);
+    }
+}
+
+bool HttpServer::listen(const std::string& host, uint16_t port, std::string* err) {
+    listen_fd_ = net_listen(host, port, &port_, err);
+    if (listen_fd_ < 0) return false;
+
+    loop_.add(listen_fd_, EPOLLIN, [this](uint32_t) { on_accept(); });
+    sweep_timer_ = loop_.add_timer(HTTP_IDLE_TIMEOUT_MS / 4, [this] { sweep_idle(); });
+    return true;
+}
+
+void HttpServer::route(const std::string& method, const std::string& path, HttpRouteHandler handler) {
+    Route r;
+    r.method = method;
+    r.prefix = !path.empty() && path.back() == '*';
+    r.path = r.prefix ? path.substr(0, path.size() - 1) : path;
+    r.handler = std::move(handler);
+    routes_.push_back(std::move(r));
+}
+
+void HttpServer::on_accept() {
+    while (true) {
+        int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                LOG_W("accept: %s", strerror(errno));
+            }
+            return;
+        }
+        if (conns_.size() >= HTTP_MAX_CONNECTIONS) {
+            close(fd);
+            continue;
+        }
+
+        Conn& c = conns_[fd];
+        c.fd = fd;
+        c.last_active = EventLoop::now_ms();
+        loop_.add(fd, EPOLLIN | EPOLLRDHUP, [this, fd](uint32_t events) { on_event(fd, events); });
+    }
+}
+
+void HttpServer::on_event(int fd, uint32_t events) {
+    auto it = conns_.find(fd);
+    if (it == conns_.end()) return;
+    Conn& c = it->second;
+    c.last_active = EventLoop::now_ms();
+
+    if (events & EPOLLERR) {
+        close_conn(fd);
+        return;
+    }
+
+    if (events & EPOLLOUT) {
+        if (!flush(c)) {
+            close_conn(fd);
+            return;
+        }
+    }
+
+    if (events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP)) {
+        char buf[16384];
+        bool peer_closed = false;
+        while (true) {
+            ssize_t n = read(fd, buf, sizeof(buf));
+            if (n > 0) {
+                c.in.append(buf, n);
+                continue;
+            }
+            if (n == 0) peer_closed = true;
+            else if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) peer_closed = true;
+            break;
+        }
+
+        // 依次处理缓冲区中的完整请求 (流水线)
+        HttpRequestParser parser;
+        while (!c.close_after_write) {
+            HttpRequest req;
+            HttpRequestParser::Result r = parser.parse(c.in, &req);
+            if (r == HttpRequestParser::NEED_MORE) break;
+            if (r == HttpRequestParser::ERROR) {
+                auto resp = std::make_shared<const std::string>(
+                    http_format_response(400, "text/plain", "Bad Request\n", {}, false));
+                c.out.push_back({resp, 0});
+                c.close_after_write = true;
+                c.in.clear();
+                break;
+            }
+            handle_request(c, req);
+        }
+
+        if (!flush(c) || (peer_closed && c.out.empty())) {
+            close_conn(fd);
+            return;
+        }
+        if (peer_closed) c.close_after_write = true;
+    }
+}
+
+void HttpServer::handle_request(Conn& c, const HttpRequest& req) {
+    requests_++;
+
+    HttpReply reply;
+    const Route* match = nullptr;
+    bool path_found = false;
+    for (const Route& r : routes_) {
+        bool path_ok = r.prefix ? req.path.compare(0, r.path.size(), r.path) == 0 : req.path == r.path;
+        if (!path_ok) continue;
+        path_found = true;
+        if (r.method == req.method || (r.method == "GET" && req.method == "HEAD")) {
+            match = &r;
+            break;
+        }
+    }
+
+    if (match) {
+        match->handler(req, reply);
+    } else {
+        reply.status = path_found ? 405 : 404;
+        reply.content_type = "text/plain";
+        reply.body = std::string(http_status_text(reply.status)) + "\n";
+    }
+
+    const std::string& body = reply.shared_body ? *reply.shared_body : reply.body;
+    bool head = req.method == "HEAD";
+
+    // 头部单独生成，响应体直接引用 (共享缓冲不复制)
+    std::string header = http_format_header(reply.status, reply.content_type, body.size(),
+                                            reply.headers, req.keep_alive);
+    c.out.push_back({std::make_shared<const std::string>(std::move(header)), 0});
+
+    if (!head && !body.empty() && reply.status != 304 && reply.status != 204) {
+        if (reply.shared_body) {
+            c.out.push_back({reply.shared_body, 0});
+        } else {
+            c.out.push_back({std::make_shared<const std::string>(std::move(reply.body)), 0});
+        }
+    }
+
+    if (!req.keep_alive) c.close_after_write = true;
+}
+
+/**
+ * 尽量写出待发送数据
+ * @return false=连接应关闭
+ */
+bool HttpServer::flush(Conn& c) {
+    while (!c.out.empty()) {
+        iovec iov[WRITEV_MAX_IOV];
+        int count = 0;
+        for (auto it = c.out.begin(); it != c.out.end() && count < WRITEV_MAX_IOV; ++it, ++count) {
+            iov[count].iov_base = (void*)(it->data->data() + it->offset);
+            iov[count].iov_len = it->data->size() - it->offset;
+        }
+
+        ssize_t n = writev(c.fd, iov, count);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            if (errno == EINTR) continue;
+            return false;
+        }
+
+        size_t left = (size_t)n;
+        while (left > 0 && !c.out.empty()) {
+            Chunk& front = c.out.front();
+            size_t avail = front.data->size() - front.offset;
+            if (left >= avail) {
+                left -= avail;
+                c.out.pop_front();
+            } else {
+                front.offset += left;
+                left = 0;
+            }
+        }
+    }
+
+    if (c.out.empty() && c.close_after_write) return false;
+
+    bool want_write = !c.out.empty();
+    if (want_write != c.want_write) {
+        c.want_write = want_write;
+        loop_.modify(c.fd, EPOLLIN | EPOLLRDHUP | (want_write ? (uint32_t)EPOLLOUT : 0u));
+    }
+    return true;
+}
+
+void HttpServer::close_conn(int fd) {
+    loop_.remove(fd);
+    close(fd);
+    conns_.erase(fd);
+}
+
+void HttpServer::sweep_idle() {
+    uint64_t now = EventLoop::now_ms();
+    std::vector<int> idle;
+    for (auto& entry : conns_) {
+        if (now - entry.second.last_active > HTTP_IDLE_TIMEOUT_MS) idle.push_back(entry.first);
+    }
+    for (int fd : idle) close_conn(fd);
+}
+
+}  // namespace wt
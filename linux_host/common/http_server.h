@@ -0,0 +1,103 @@
+/*
+ * epoll HTTP/1.1 服务端
+ *
+ * 运行在 EventLoop 线程，支持 keep-alive 和流水线请求。
+ * 响应体可以是共享的只读缓冲 (shared_body)，发送时用 writev 直接引用，
+ * 同一份缓存快照发给多个客户端不复制。
+ */
+
+#ifndef WT_HTTP_SERVER_H
+#define WT_HTTP_SERVER_H
+
+#include "event_loop.h"
+#include "http.h"
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace wt {
+
+// 空闲连接超时
+#define HTTP_IDLE_TIMEOUT_MS    60000
+
+// 最大并发连接数
+#define HTTP_MAX_CONNECTIONS    4096
+
+struct HttpReply {
+    int status = 200;
+    std::string content_type = "application/json";
+    std::string body;
+    std::shared_ptr<const std::string> shared_body;     // 非空时代替 body
+    HttpHeaderList headers;
+};
+
+using HttpRouteHandler = std::function<void(const HttpRequest& req, HttpReply& reply)>;
+
+class HttpServer {
+public:
+    explicit HttpServer(EventLoop& loop);
+    ~HttpServer();
+
+    /**
+     * 开始监听
+     * @return false=失败 (err 中为原因)
+     */
+    bool listen(const std::string& host, uint16_t port, std::string* err);
+
+    /**
+     * 注册路由
+     * @param method "GET" / "POST" ...
+     * @param path 完整路径；以 '*' 结尾时按前缀匹配
+     */
+    void route(const std::string& method, const std::string& path, HttpRouteHandler handler);
+
+    uint16_t port() const { return port_; }
+    uint64_t requests() const { return requests_; }
+    size_t connections() const { return conns_.size(); }
+
+private:
+    struct Chunk {
+        std::shared_ptr<const std::string> data;
+        size_t offset;
+    };
+
+    struct Conn {
+        int fd;
+        std::string in;
+        std::deque<Chunk> out;
+        bool close_after_write = false;
+        bool want_write = false;
+        uint64_t last_active;
+    };
+
+    struct Route {
+        std::string method;
+        std::string path;
+        bool prefix;
+        HttpRouteHandler handler;
+    };
+
+    void on_accept();
+    void on_event(int fd, uint32_t events);
+    void handle_request(Conn& c, const HttpRequest& req);
+    bool flush(Conn& c);
+    void close_conn(int fd);
+    void sweep_idle();
+
+    EventLoop& loop_;
+    int listen_fd_ = -1;
+    int sweep_timer_ = -1;
+    uint16_t port_ = 0;
+    uint64_t requests_ = 0;
+    std::vector<Route> routes_;
+    std::unordered_map<int, Conn> conns_;
+};
+
+}  // namespace wt
+
+#endif  // WT_HTTP_SERVER_H
@@ -0,0 +1,268 @@
+/*
+ * 精简 JSON 解析与生成实现
+ */
+
+#include "json.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace wt {
+
+// 嵌套深度上限 (防止恶意输入耗尽栈)
+#define JSON_MAX_DEPTH  32
+
+static const JsonValue json_null;
+
+const JsonValue& JsonValue::operator[](const std::string& key) const {
+    if (type_ != OBJECT) return json_null;
+    auto it = object_.find(key);
+    return it == object_.end() ? json_null : it->second;
+}
+
+// ==================== 解析器 ====================
+
+class JsonParser {
+public:
+    JsonParser(const char* text, size_t len) : p_(text), begin_(text), end_(text + len) {}
+
+    bool parse(JsonValue* out, std::string* err) {
+        skip_ws();
+        if (!parse_value(out, 0)) {
+            if (err) *err = error_ + " at offset " + std::to_string(p_ - begin_);
+            return false;
+        }
+        skip_ws();
+        if (p_ != end_) {
+            if (err) *err = "trailing data at offset " + std::to_string(p_ - begin_);
+            return false;
+        }
+        return true;
+    }
+
+private:
+    void skip_ws() {
+        while (p_ < end_ && (*p_ == ' ' || *p_ == '\t' || *p_ == '\n' || *p_ == '\r')) p_++;
+    }
+
+    bool fail(const char* message) {
+        error_ = message;
+        return false;
+    }
+
+    bool literal(const char* word, size_t len) {
+        if ((size_t)(end_ - p_) < len || std::string(p_, len) != word) return fail("invalid literal");
+        p_ += len;
+        return true;
+    }
+
+    bool parse_value(JsonValue* out, int depth) {
+        if (depth > JSON_MAX_DEPTH) return fail("nesting too deep");
+        if (p_ >= end_) return fail("unexpected end");
+
+        switch (*p_) {
+            case '{': return parse_object(out, depth);
+            case '[': return parse_array(out, depth);
+            case '"':
+                out->type_ = JsonValue::STRING;
+                return parse_string(&out->string_);
+            case 't':
+                out->type_ = JsonValue::BOOL;
+                out->bool_ = true;
+                return literal("true", 4);
+            case 'f':
+                out->type_ = JsonValue::BOOL;
+                out->bool_ = false;
+                return literal("false", 5);
+            case 'n':
+                out->type_ = JsonValue::NUL;
+                return literal("null", 4);
+            default:
+                return parse_number(out);
+        }
+    }
+
+    bool parse_number(JsonValue* out) {
+        const char* start = p_;
+        if (p_ < end_ && *p_ == '-') p_++;
+        while (p_ < end_ && ((*p_ >= '0' && *p_ <= '9') || *p_ == '.' || *p_ == 'e' ||
+                             *p_ == 'E' || *p_ == '+' || *p_ == '-')) {
+            p_++;
+        }
+        if (p_ == start) return fail("unexpected character");
+
+        std::string text(start, p_);
+        char* stop;
+        out->number_ = strtod(text.c_str(), &stop);
+        if (*stop != '\0') return fail("invalid number");
+        out->type_ = JsonValue::NUMBER;
+        return true;
+    }
+
+    static void append_utf8(std::string* out, uint32_t cp) {
+        if (cp < 0x80) {
+            out->push_back((char)cp);
+        } else if (cp < 0x800) {
+            out->push_back((char)(0xC0 | (cp >> 6)));
+            out->push_back((char)(0x80 | (cp & 0x3F)));
+        } else if (cp < 0x10000) {
+            out->push_back((char)(0xE0 | (cp >> 12)));
+            out->push_back((char)(0x80 | ((cp >> 6) & 0x3F)));
+            out->push_back((char)(0x80 | (cp & 0x3F)));
+        } else {
+            out->push_back((char)(0xF0 | (cp >> 18)));
+            out->push_back((char)(0x80 | ((cp >> 12) & 0x3F)));
+            out->push_back((char)(0x80 | ((cp >> 6) & 0x3F)));
+            out->push_back((char)(0x80 | (cp & 0x3F)));
+        }
+    }
+
+    bool parse_hex4(uint32_t* value) {
+        if (end_ - p_ < 4) return fail("truncated \\u escape");
+        *value = 0;
+        for (int i = 0; i < 4; i++) {
+            char c = *p_++;
+            *value <<= 4;
+            if (c >= '0' && c <= '9') *value |= c - '0';
+            else if (c >= 'a' && c <= 'f') *value |= c - 'a' + 10;
+            else if (c >= 'A' && c <= 'F') *value |= c - 'A' + 10;
+            else return fail("invalid \\u escape");
+        }
+        return true;
+    }
+
+    bool parse_string(std::string* out) {
+        p_++;  // '"'
+        out->clear();
+        while (p_ < end_) {
+            char c = *p_++;
+            if (c == '"') return true;
+            if (c != '\\') {
+                out->push_back(c);
+                continue;
+            }
+            if (p_ >= end_) break;
+            char e = *p_++;
+            switch (e) {
+                case '"': out->push_back('"'); break;
+                case '\\': out->push_back('\\'); break;
+                case '/': out->push_back('/'); break;
+                case 'b': out->push_back('\b'); break;
+                case 'f': out->push_back('\f'); break;
+                case 'n': out->push_back('\n'); break;
+                case 'r': out->push_back('\r'); break;
+                case 't': out->push_back('\t'); break;
+                case 'u': {
+                    uint32_t cp;
+                    if (!parse_hex4(&cp)) return false;
+                    if (cp >= 0xD800 && cp < 0xDC00 && end_ - p_ >= 6 && p_[0] == '\\' && p_[1] == 'u') {
+                        p_ += 2;
+                        uint32_t low;
+                        if (!parse_hex4(&low)) return false;
+                        cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                    }
+                    append_utf8(out, cp);
+                    break;
+                }
+                default:
+                    return fail("invalid escape");
+            }
+        }
+        return fail("unterminated string");
+    }
+
+    bool parse_array(JsonValue* out, int depth) {
+        p_++;  // '['
+        out->type_ = JsonValue::ARRAY;
+        skip_ws();
+        if (p_ < end_ && *p_ == ']') {
+            p_++;
+            return true;
+        }
+        while (true) {
+            out->array_.emplace_back();
+            skip_ws();
+            if (!parse_value(&out->array_.back(), depth + 1)) return false;
+            skip_ws();
+            if (p_ >= end_) return fail("unterminated array");
+            if (*p_ == ',') {
+                p_++;
+                continue;
+            }
+            if (*p_ == ']') {
+                p_++;
+                return true;
+            }
+            return fail("expected ',' or ']'");
+        }
+    }
+
+    bool parse_object(JsonValue* out, int depth) {
+        p_++;  // '{'
+        out->type_ = JsonValue::OBJECT;
+        skip_ws();
+        if (p_ < end_ && *p_ == '}') {
+            p_++;
+            return true;
+        }
+        while (true) {
+            skip_ws();
+            if (p_ >= end_ || *p_ != '"') return fail("expected key");
+            std::string key;
+            if (!parse_string(&key)) return false;
+            skip_ws();
+            if (p_ >= end_ || *p_ != ':') return fail("expected ':'");
+            p_++;
+            skip_ws();
+            if (!parse_value(&out->object_[key], depth + 1)) return false;
+            skip_ws();
+            if (p_ >= end_) return fail("unterminated object");
+            if (*p_ == ',') {
+                p_++;
+                continue;
+            }
+            if (*p_ == '}') {
+                p_++;
+                return true;
+            }
+            return fail("expected ',' or '}'");
+        }
+    }
+
+    const char* p_;
+    const char* begin_;
+    const char* end_;
+    std::string error_;
+};
+
+bool JsonValue::parse(const char* text, size_t len, JsonValue* out, std::string* err) {
+    *out = JsonValue();
+    JsonParser parser(text, len);
+    return parser.parse(out, err);
+}
+
+// ==================== 生成 ====================
+
+void json_append_string(std::string& out, const std::string& value) {
+    out.push_back('"');
+    for (unsigned char c : value) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (c < 0x20) {
+                    char buf[8];
+                    snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    out += buf;
+                } else {
+                    out.push_back((char)c);
+                }
+        }
+    }
+    out.push_back('"');
+}
+
+}  // namespace wt
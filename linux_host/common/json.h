@@ -0,0 +1,69 @@
+/*
+ * 精简 JSON 解析与生成
+ *
+ * 只覆盖主机 REST 接口用到的子集：对象、数组、数字、字符串、布尔、null。
+ * 数字统一按 double 保存 (主机接口中的整数都在 2^53 以内)。
+ */
+
+#ifndef WT_JSON_H
+#define WT_JSON_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace wt {
+
+class JsonValue {
+public:
+    enum Type { NUL, BOOL, NUMBER, STRING, ARRAY, OBJECT };
+
+    JsonValue() = default;
+
+    Type type() const { return type_; }
+    bool is_null() const { return type_ == NUL; }
+    bool is_object() const { return type_ == OBJECT; }
+    bool is_array() const { return type_ == ARRAY; }
+
+    bool as_bool(bool fallback = false) const { return type_ == BOOL ? bool_ : fallback; }
+    double as_number(double fallback = 0) const { return type_ == NUMBER ? number_ : fallback; }
+    int64_t as_int(int64_t fallback = 0) const { return type_ == NUMBER ? (int64_t)number_ : fallback; }
+    const std::string& as_string() const { return string_; }
+
+    const std::vector<JsonValue>& items() const { return array_; }
+    const std::map<std::string, JsonValue>& members() const { return object_; }
+
+    /**
+     * 取对象成员，不存在时返回 null 值
+     */
+    const JsonValue& operator[](const std::string& key) const;
+
+    /**
+     * 解析 JSON 文本
+     * @return false=格式错误 (err 中为错误位置和原因)
+     */
+    static bool parse(const char* text, size_t len, JsonValue* out, std::string* err);
+    static bool parse(const std::string& text, JsonValue* out, std::string* err) {
+        return parse(text.data(), text.size(), out, err);
+    }
+
+private:
+    friend class JsonParser;
+
+    Type type_ = NUL;
+    bool bool_ = false;
+    double number_ = 0;
+    std::string string_;
+    std::vector<JsonValue> array_;
+    std::map<std::string, JsonValue> object_;
+};
+
+/**
+ * 追加 JSON 转义后的字符串 (带引号)
+ */
+void json_append_string(std::string& out, const std::string& value);
+
+}  // namespace wt
+
+#endif  // WT_JSON_H
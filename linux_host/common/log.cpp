@@ -0,0 +1,48 @@
+/*
+ * 主机端日志实现
+ */
+
+#include "log.h"
+
+#include <atomic>
+#include <cstdarg>
+#include <cstdio>
+#include <time.h>
+
+namespace wt {
+
+static std::atomic<int> g_level{LOG_LEVEL_INFO};
+
+static const char level_chars[] = "-EWIDV";
+
+void log_set_level(int level) {
+    g_level.store(level, std::memory_order_relaxed);
+}
+
+int log_get_level() {
+    return g_level.load(std::memory_order_relaxed);
+}
+
+void log_write(int level, const char* fmt, ...) {
+    if (level > log_get_level() || level <= LOG_LEVEL_NONE) return;
+
+    char line[512];
+    timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    int n = snprintf(line, sizeof(line), "[%ld.%03ld][%c] ",
+                     (long)ts.tv_sec, ts.tv_nsec / 1000000, level_chars[level]);
+
+    va_list ap;
+    va_start(ap, fmt);
+    int m = vsnprintf(line + n, sizeof(line) - n - 1, fmt, ap);
+    va_end(ap);
+
+    size_t len = n + (m < 0 ? 0 : (size_t)m);
+    if (len > sizeof(line) - 2) len = sizeof(line) - 2;
+    line[len++] = '\n';
+
+    // 单次写出，多线程输出不交错
+    fwrite(line, 1, len, stderr);
+}
+
+}  // namespace wt
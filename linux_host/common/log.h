@@ -0,0 +1,37 @@
+/*
+ * 主机端日志
+ *
+ * 与固件 logger.h 相同的级别和宏名，输出到 stderr:
+ *   [秒.毫秒][级别] 内容
+ * 运行时级别由 log_set_level() 设置 (默认 INFO)。
+ */
+
+#ifndef WT_LOG_H
+#define WT_LOG_H
+
+#define LOG_LEVEL_NONE      0
+#define LOG_LEVEL_ERROR     1
+#define LOG_LEVEL_WARN      2
+#define LOG_LEVEL_INFO      3
+#define LOG_LEVEL_DEBUG     4
+#define LOG_LEVEL_VERBOSE   5
+
+namespace wt {
+
+void log_set_level(int level);
+int log_get_level();
+
+/**
+ * 输出一行日志 (线程安全，自动换行)
+ */
+void log_write(int level, const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+
+}  // namespace wt
+
+#define LOG_E(fmt, ...) wt::log_write(LOG_LEVEL_ERROR, fmt, ##__VA_ARGS__)
+#define LOG_W(fmt, ...) wt::log_write(LOG_LEVEL_WARN, fmt, ##__VA_ARGS__)
+#define LOG_I(fmt, ...) wt::log_write(LOG_LEVEL_INFO, fmt, ##__VA_ARGS__)
+#define LOG_D(fmt, ...) wt::log_write(LOG_LEVEL_DEBUG, fmt, ##__VA_ARGS__)
+#define LOG_V(fmt, ...) wt::log_write(LOG_LEVEL_VERBOSE, fmt, ##__VA_ARGS__)
+
+#endif  // WT_LOG_H
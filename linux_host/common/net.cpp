@@ -0,0 +1,124 @@
+/*
+ * 套接字辅助函数实现
+ */
+
+#include "net.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <unistd.h>
+
+namespace wt {
+
+bool net_resolve(const std::string& host, uint16_t port, SockAddr* out, std::string* err) {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    addrinfo* res = nullptr;
+    std::string service = std::to_string(port);
+    int rc = getaddrinfo(host.empty() ? nullptr : host.c_str(), service.c_str(), &hints, &res);
+    if (rc != 0 || res == nullptr) {
+        if (err) *err = gai_strerror(rc);
+        return false;
+    }
+    memcpy(&out->addr, res->ai_addr, res->ai_addrlen);
+    out->len = res->ai_addrlen;
+    freeaddrinfo(res);
+    return true;
+}
+
+bool net_set_nonblocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+int net_connect(const SockAddr& addr, std::string* err) {
+    int fd = socket(addr.addr.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        if (err) *err = strerror(errno);
+        return -1;
+    }
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    if (connect(fd, (const sockaddr*)&addr.addr, addr.len) < 0 && errno != EINPROGRESS) {
+        if (err) *err = strerror(errno);
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int net_connect_result(int fd) {
+    int so_error = 0;
+    socklen_t len = sizeof(so_error);
+    if (getsockopt(fd, SOL_SOCKET, SO_ERROR, &so_error, &len) < 0) return errno;
+    return so_error;
+}
+
+int net_listen(const std::string& host, uint16_t port, uint16_t* bound_port, std::string* err) {
+    SockAddr addr;
+    if (!net_resolve(host.empty() ? "0.0.0.0" : host, port, &addr, err)) return -1;
+
+    int fd = socket(addr.addr.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        if (err) *err = strerror(errno);
+        return -1;
+    }
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    if (bind(fd, (const sockaddr*)&addr.addr, addr.len) < 0 || listen(fd, SOMAXCONN) < 0) {
+        if (err) *err = strerror(errno);
+        close(fd);
+        return -1;
+    }
+
+    if (bound_port) {
+        sockaddr_storage local{};
+        socklen_t len = sizeof(local);
+        getsockname(fd, (sockaddr*)&local, &len);
+        *bound_port = ntohs(local.ss_family == AF_INET6 ? ((sockaddr_in6*)&local)->sin6_port
+                                                        : ((sockaddr_in*)&local)->sin_port);
+    }
+    return fd;
+}
+
+bool net_split_host_port(const std::string& text, std::string* host, uint16_t* port, uint16_t default_port) {
+    std::string port_text;
+
+    if (!text.empty() && text[0] == '[') {
+        // [IPv6]:port
+        size_t close_bracket = text.find(']');
+        if (close_bracket == std::string::npos) return false;
+        *host = text.substr(1, close_bracket - 1);
+        if (close_bracket + 1 < text.size()) {
+            if (text[close_bracket + 1] != ':') return false;
+            port_text = text.substr(close_bracket + 2);
+        }
+    } else if (std::count(text.begin(), text.end(), ':') == 1) {
+        size_t colon = text.find(':');
+        *host = text.substr(0, colon);
+        port_text = text.substr(colon + 1);
+    } else {
+        *host = text;   // 无端口 (或不带括号的 IPv6)
+    }
+
+    *port = default_port;
+    if (!port_text.empty()) {
+        char* end;
+        unsigned long value = strtoul(port_text.c_str(), &end, 10);
+        if (*end != '\0' || value == 0 || value > 65535) return false;
+        *port = (uint16_t)value;
+    }
+    return !host->empty();
+}
+
+}  // namespace wt
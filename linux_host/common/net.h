@@ -0,0 +1,59 @@
+/*
+ * 套接字辅助函数 (IPv4/IPv6，非阻塞)
+ */
+
+#ifndef WT_NET_H
+#define WT_NET_H
+
+#include <cstdint>
+#include <string>
+#include <sys/socket.h>
+
+namespace wt {
+
+// 解析后的地址
+struct SockAddr {
+    sockaddr_storage addr;
+    socklen_t len = 0;
+};
+
+/**
+ * 解析主机名 (阻塞，只在启动时调用)
+ * @return false=解析失败
+ */
+bool net_resolve(const std::string& host, uint16_t port, SockAddr* out, std::string* err);
+
+/**
+ * 发起非阻塞连接
+ * @return 套接字，-1 表示失败 (连接结果在 EPOLLOUT 时用 net_connect_result() 取得)
+ */
+int net_connect(const SockAddr& addr, std::string* err);
+
+/**
+ * 非阻塞连接的结果
+ * @return 0=成功，否则为 errno
+ */
+int net_connect_result(int fd);
+
+/**
+ * 创建监听套接字 (非阻塞，SO_REUSEADDR)
+ * @param port 端口 (0=随机)
+ * @param bound_port 实际端口
+ * @return 套接字，-1 表示失败
+ */
+int net_listen(const std::string& host, uint16_t port, uint16_t* bound_port, std::string* err);
+
+/**
+ * 设为非阻塞
+ */
+bool net_set_nonblocking(int fd);
+
+/**
+ * 拆分 "host:port"
+ * @return false=格式错误
+ */
+bool net_split_host_port(const std::string& text, std::string* host, uint16_t* port, uint16_t default_port);
+
+}  // namespace wt
+
+#endif  // WT_NET_H
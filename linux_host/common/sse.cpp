@@ -0,0 +1,63 @@
+/*
+ * Server-Sent Events 流解析实现
+ */
+
+#include "sse.h"
+
+namespace wt {
+
+// 单行长度上限 (超出视为异常流，丢弃该行)
+#define SSE_MAX_LINE    65536
+
+void SseParser::reset() {
+    line_.clear();
+    current_ = SseEvent();
+    has_data_ = false;
+}
+
+void SseParser::feed(const char* data, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        char c = data[i];
+        if (c == '\n') {
+            if (!line_.empty() && line_.back() == '\r') line_.pop_back();
+            process_line(line_);
+            line_.clear();
+        } else if (line_.size() < SSE_MAX_LINE) {
+            line_.push_back(c);
+        }
+    }
+}
+
+void SseParser::process_line(const std::string& line) {
+    if (line.empty()) {
+        // 事件结束
+        if (has_data_ && on_event) {
+            if (current_.event.empty()) current_.event = "message";
+            on_event(current_);
+        }
+        current_ = SseEvent();
+        has_data_ = false;
+        return;
+    }
+    if (line[0] == ':') return;
+
+    size_t colon = line.find(':');
+    std::string field = line.substr(0, colon);
+    std::string value;
+    if (colon != std::string::npos) {
+        value = line.substr(colon + 1);
+        if (!value.empty() && value[0] == ' ') value.erase(0, 1);
+    }
+
+    if (field == "data") {
+        if (has_data_) current_.data.push_back('\n');
+        current_.data += value;
+        has_data_ = true;
+    } else if (field == "event") {
+        current_.event = value;
+    } else if (field == "id") {
+        current_.id = value;
+    }
+}
+
+}  // namespace wt
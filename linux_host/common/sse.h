@@ -0,0 +1,39 @@
+/*
+ * Server-Sent Events 流解析
+ *
+ * 输入任意切分的字节流，每解析出一条完整事件 (空行结束) 回调一次。
+ * 注释行 (':' 开头，主机用作保活) 被忽略。
+ */
+
+#ifndef WT_SSE_H
+#define WT_SSE_H
+
+#include <functional>
+#include <string>
+
+namespace wt {
+
+struct SseEvent {
+    std::string id;
+    std::string event;      // 未指定时为 "message"
+    std::string data;       // 多行 data 以 '\n' 连接
+};
+
+class SseParser {
+public:
+    std::function<void(const SseEvent&)> on_event;
+
+    void feed(const char* data, size_t len);
+    void reset();
+
+private:
+    void process_line(const std::string& line);
+
+    std::string line_;
+    SseEvent current_;
+    bool has_data_ = false;
+};
+
+}  // namespace wt
+
+#endif  // WT_SSE_H
@@ -0,0 +1,57 @@
+/*
+ * 固定大小的工作线程池 (共享任务队列)
+ */
+
+#ifndef WT_THREAD_POOL_H
+#define WT_THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace wt {
+
+class ThreadPool {
+public:
+    /**
+     * @param threads 线程数 (0=CPU 核数)
+     */
+    explicit ThreadPool(size_t threads);
+
+    /**
+     * 等待已提交的任务完成后退出
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * 提交任务 (线程安全)
+     */
+    void submit(std::function<void()> task);
+
+    size_t size() const { return workers_.size(); }
+
+    /**
+     * 排队中的任务数
+     */
+    size_t pending();
+
+private:
+    void worker();
+
+    std::vector<std::thread> workers_;
+    std::deque<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+};
+
+}  // namespace wt
+
+#endif  // WT_THREAD_POOL_H
@@ -0,0 +1,94 @@
+/*
+ * 工作窃取线程池实现
+ */
+
+#include "work_stealing_pool.h"
+
+namespace wt {
+
+WorkStealingPool::WorkStealingPool(size_t threads) {
+    if (threads == 0) threads = std::thread::hardware_concurrency();
+    if (threads == 0) threads = 1;
+    for (size_t i = 0; i < threads; i++) queues_.push_back(std::make_unique<Queue>());
+    for (size_t i = 0; i < threads; i++) {
+        workers_.emplace_back([this, i] { worker(i); });
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    start_cv_.notify_all();
+    for (auto& t : workers_) t.join();
+}
+
+void WorkStealingPool::run(size_t count, const Task& fn) {
+    if (count == 0) return;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    // 先设置回调和计数再入队: 上一批刚做完、仍在窃取的线程可能立即取到新任务
+    task_.store(&fn, std::memory_order_relaxed);
+    remaining_.store(count, std::memory_order_relaxed);
+
+    // 按连续区间分配，相邻任务 (同一段文件) 留在同一线程
+    size_t n = queues_.size();
+    for (size_t w = 0; w < n; w++) {
+        size_t begin = count * w / n;
+        size_t end = count * (w + 1) / n;
+        std::lock_guard<std::mutex> qlock(queues_[w]->mutex);
+        for (size_t t = begin; t < end; t++) queues_[w]->tasks.push_back(t);
+    }
+
+    generation_++;
+    start_cv_.notify_all();
+    done_cv_.wait(lock, [this] { return remaining_.load(std::memory_order_acquire) == 0; });
+}
+
+bool WorkStealingPool::pop_local(size_t index, size_t* task) {
+    Queue& q = *queues_[index];
+    std::lock_guard<std::mutex> lock(q.mutex);
+    if (q.tasks.empty()) return false;
+    *task = q.tasks.front();
+    q.tasks.pop_front();
+    return true;
+}
+
+bool WorkStealingPool::steal(size_t index, size_t* task) {
+    size_t n = queues_.size();
+    for (size_t k = 1; k < n; k++) {
+        Queue& q = *queues_[(index + k) % n];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (q.tasks.empty()) continue;
+        *task = q.tasks.back();
+        q.tasks.pop_back();
+        steals_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+void WorkStealingPool::worker(size_t index) {
+    uint64_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            start_cv_.wait(lock, [&] { return stopping_ || generation_ != seen; });
+            if (stopping_) return;
+            seen = generation_;
+        }
+
+        size_t task;
+        while (pop_local(index, &task) || steal(index, &task)) {
+            // 队列锁保证能看到入队前设置的回调
+            (*task_.load(std::memory_order_relaxed))(task, index);
+            if (remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                done_cv_.notify_all();
+            }
+        }
+    }
+}
+
+}  // namespace wt
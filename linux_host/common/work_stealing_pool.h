@@ -0,0 +1,75 @@
+/*
+ * 工作窃取线程池 (批量并行任务)
+ *
+ * run() 把一批任务按连续区间分给各线程的本地队列，线程先按顺序处理
+ * 自己的区间 (从队头取)，做完后从其他线程队尾窃取，任务耗时不均时
+ * 也能保持所有线程忙碌。回调带线程序号，便于各线程使用独立的累加器。
+ */
+
+#ifndef WT_WORK_STEALING_POOL_H
+#define WT_WORK_STEALING_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace wt {
+
+class WorkStealingPool {
+public:
+    using Task = std::function<void(size_t task, size_t worker)>;
+
+    /**
+     * @param threads 线程数 (0=CPU 核数)
+     */
+    explicit WorkStealingPool(size_t threads);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    size_t size() const { return workers_.size(); }
+
+    /**
+     * 执行任务 0..count-1，全部完成后返回 (不可重入)
+     */
+    void run(size_t count, const Task& fn);
+
+    /**
+     * 累计窃取次数
+     */
+    uint64_t steals() const { return steals_.load(std::memory_order_relaxed); }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<size_t> tasks;
+    };
+
+    void worker(size_t index);
+    bool pop_local(size_t index, size_t* task);
+    bool steal(size_t index, size_t* task);
+
+    std::vector<std::thread> workers_;
+    std::vector<std::unique_ptr<Queue>> queues_;
+
+    std::mutex mutex_;
+    std::condition_variable start_cv_;
+    std::condition_variable done_cv_;
+    uint64_t generation_ = 0;
+    bool stopping_ = false;
+    std::atomic<const Task*> task_{nullptr};
+    std::atomic<size_t> remaining_{0};
+    std::atomic<uint64_t> steals_{0};
+};
+
+}  // namespace wt
+
+#endif  // WT_WORK_STEALING_POOL_H
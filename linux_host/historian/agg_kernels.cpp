@@ -0,0 +1,232 @@
+/*
+ * 聚合内核实现
+ */
+
+#include "agg_kernels.h"
+
+#include "column.h"
+
+#include <algorithm>
+#include <cstring>
+#include <immintrin.h>
+
+namespace wt {
+
+// 块数据最大长度 (位宽 32)，另留 8 字节让越过末尾的整字读取不越界
+#define PACKED_MAX      (COLUMN_BLOCK / 8 * 32)
+#define PACKED_PAD      8
+
+// ==================== 标量 ====================
+
+static void unpack_scalar(const uint8_t* packed, unsigned width, int32_t base, int32_t* out) {
+    if (width == 0) {
+        std::fill(out, out + COLUMN_BLOCK, base);
+        return;
+    }
+
+    uint8_t buf[PACKED_MAX + PACKED_PAD];
+    size_t bytes = COLUMN_BLOCK / 8 * width;
+    memcpy(buf, packed, bytes);
+    memset(buf + bytes, 0, PACKED_PAD);
+
+    uint64_t mask = (1ULL << width) - 1;
+    size_t bit = 0;
+    for (size_t i = 0; i < COLUMN_BLOCK; i++, bit += width) {
+        uint64_t word;
+        memcpy(&word, buf + (bit >> 3), 8);
+        out[i] = (int32_t)((uint32_t)base + (uint32_t)((word >> (bit & 7)) & mask));
+    }
+}
+
+static void range_stats_scalar(const int32_t* v, size_t n, int32_t* min, int32_t* max, int64_t* sum) {
+    int32_t lo = *min, hi = *max;
+    int64_t s = 0;
+    for (size_t i = 0; i < n; i++) {
+        lo = std::min(lo, v[i]);
+        hi = std::max(hi, v[i]);
+        s += v[i];
+    }
+    *min = lo;
+    *max = hi;
+    *sum += s;
+}
+
+static int64_t masked_sum_scalar(const int32_t* flags, const int32_t* values, size_t n) {
+    int64_t s = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (flags[i]) s += values[i];
+    }
+    return s;
+}
+
+// ==================== SSE4.1 ====================
+
+__attribute__((target("sse4.1")))
+static void range_stats_sse41(const int32_t* v, size_t n, int32_t* min, int32_t* max, int64_t* sum) {
+    __m128i vmin = _mm_set1_epi32(*min);
+    __m128i vmax = _mm_set1_epi32(*max);
+    __m128i acc = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i x = _mm_loadu_si128((const __m128i*)(v + i));
+        vmin = _mm_min_epi32(vmin, x);
+        vmax = _mm_max_epi32(vmax, x);
+        acc = _mm_add_epi64(acc, _mm_cvtepi32_epi64(x));
+        acc = _mm_add_epi64(acc, _mm_cvtepi32_epi64(_mm_srli_si128(x, 8)));
+    }
+
+    int32_t lanes_min[4], lanes_max[4];
+    int64_t lanes_sum[2];
+    _mm_storeu_si128((__m128i*)lanes_min, vmin);
+    _mm_storeu_si128((__m128i*)lanes_max, vmax);
+    _mm_storeu_si128((__m128i*)lanes_sum, acc);
+    int32_t lo = std::min(std::min(lanes_min[0], lanes_min[1]), std::min(lanes_min[2], lanes_min[3]));
+    int32_t hi = std::max(std::max(lanes_max[0], lanes_max[1]), std::max(lanes_max[2], lanes_max[3]));
+    int64_t s = lanes_sum[0] + lanes_sum[1];
+    for (; i < n; i++) {
+        lo = std::min(lo, v[i]);
+        hi = std::max(hi, v[i]);
+        s += v[i];
+    }
+    *min = lo;
+    *max = hi;
+    *sum += s;
+}
+
+__attribute__((target("sse4.1")))
+static int64_t masked_sum_sse41(const int32_t* flags, const int32_t* values, size_t n) {
+    __m128i acc = _mm_setzero_si128();
+    __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i f = _mm_loadu_si128((const __m128i*)(flags + i));
+        __m128i x = _mm_loadu_si128((const __m128i*)(values + i));
+        x = _mm_and_si128(x, _mm_sub_epi32(zero, f));     // flag 0/1 -> 掩码 0/全 1
+        acc = _mm_add_epi64(acc, _mm_cvtepi32_epi64(x));
+        acc = _mm_add_epi64(acc, _mm_cvtepi32_epi64(_mm_srli_si128(x, 8)));
+    }
+    int64_t lanes[2];
+    _mm_storeu_si128((__m128i*)lanes, acc);
+    int64_t s = lanes[0] + lanes[1];
+    for (; i < n; i++) {
+        if (flags[i]) s += values[i];
+    }
+    return s;
+}
+
+// ==================== AVX2 ====================
+
+__attribute__((target("avx2")))
+static void unpack_avx2(const uint8_t* packed, unsigned width, int32_t base, int32_t* out) {
+    // 位宽超过 25 时 32 位读取装不下 (移位最多 7 位)，走标量
+    if (width == 0 || width > 25) {
+        unpack_scalar(packed, width, base, out);
+        return;
+    }
+
+    uint8_t buf[PACKED_MAX + PACKED_PAD];
+    size_t bytes = COLUMN_BLOCK / 8 * width;
+    memcpy(buf, packed, bytes);
+    memset(buf + bytes, 0, PACKED_PAD);
+
+    __m256i bits = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32((int)width));
+    __m256i step = _mm256_set1_epi32((int)(8 * width));
+    __m256i mask = _mm256_set1_epi32((int)((1u << width) - 1));
+    __m256i seven = _mm256_set1_epi32(7);
+    __m256i vbase = _mm256_set1_epi32(base);
+
+    for (size_t i = 0; i < COLUMN_BLOCK; i += 8) {
+        __m256i byte = _mm256_srli_epi32(bits, 3);
+        __m256i shift = _mm256_and_si256(bits, seven);
+        __m256i x = _mm256_i32gather_epi32((const int*)buf, byte, 1);
+        x = _mm256_and_si256(_mm256_srlv_epi32(x, shift), mask);
+        _mm256_storeu_si256((__m256i*)(out + i), _mm256_add_epi32(x, vbase));
+        bits = _mm256_add_epi32(bits, step);
+    }
+}
+
+__attribute__((target("avx2")))
+static inline __m256i widen_add(__m256i acc, __m256i x) {
+    acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(x)));
+    return _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(x, 1)));
+}
+
+__attribute__((target("avx2")))
+static void range_stats_avx2(const int32_t* v, size_t n, int32_t* min, int32_t* max, int64_t* sum) {
+    __m256i vmin = _mm256_set1_epi32(*min);
+    __m256i vmax = _mm256_set1_epi32(*max);
+    __m256i acc = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)(v + i));
+        vmin = _mm256_min_epi32(vmin, x);
+        vmax = _mm256_max_epi32(vmax, x);
+        acc = widen_add(acc, x);
+    }
+
+    int32_t lanes_min[8], lanes_max[8];
+    int64_t lanes_sum[4];
+    _mm256_storeu_si256((__m256i*)lanes_min, vmin);
+    _mm256_storeu_si256((__m256i*)lanes_max, vmax);
+    _mm256_storeu_si256((__m256i*)lanes_sum, acc);
+    int32_t lo = *std::min_element(lanes_min, lanes_min + 8);
+    int32_t hi = *std::max_element(lanes_max, lanes_max + 8);
+    int64_t s = lanes_sum[0] + lanes_sum[1] + lanes_sum[2] + lanes_sum[3];
+    for (; i < n; i++) {
+        lo = std::min(lo, v[i]);
+        hi = std::max(hi, v[i]);
+        s += v[i];
+    }
+    *min = lo;
+    *max = hi;
+    *sum += s;
+}
+
+__attribute__((target("avx2")))
+static int64_t masked_sum_avx2(const int32_t* flags, const int32_t* values, size_t n) {
+    __m256i acc = _mm256_setzero_si256();
+    __m256i zero = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i f = _mm256_loadu_si256((const __m256i*)(flags + i));
+        __m256i x = _mm256_loadu_si256((const __m256i*)(values + i));
+        acc = widen_add(acc, _mm256_and_si256(x, _mm256_sub_epi32(zero, f)));
+    }
+    int64_t lanes[4];
+    _mm256_storeu_si256((__m256i*)lanes, acc);
+    int64_t s = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    for (; i < n; i++) {
+        if (flags[i]) s += values[i];
+    }
+    return s;
+}
+
+// ==================== 选择 ====================
+
+static const AggKernels kernels_avx2 = {"avx2", unpack_avx2, range_stats_avx2, masked_sum_avx2};
+static const AggKernels kernels_sse41 = {"sse4.1", unpack_scalar, range_stats_sse41, masked_sum_sse41};
+static const AggKernels kernels_scalar = {"scalar", unpack_scalar, range_stats_scalar, masked_sum_scalar};
+
+const AggKernels* const* agg_kernels_available() {
+    static const AggKernels* list[4] = {};
+    static bool init = [] {
+        size_t n = 0;
+        if (__builtin_cpu_supports("avx2")) list[n++] = &kernels_avx2;
+        if (__builtin_cpu_supports("sse4.1")) list[n++] = &kernels_sse41;
+        list[n++] = &kernels_scalar;
+        return true;
+    }();
+    (void)init;
+    return list;
+}
+
+const AggKernels* agg_kernels(const char* name) {
+    const AggKernels* const* list = agg_kernels_available();
+    if (name == nullptr) return list[0];
+    for (size_t i = 0; list[i] != nullptr; i++) {
+        if (strcmp(list[i]->name, name) == 0) return list[i];
+    }
+    return nullptr;
+}
+
+}  // namespace wt
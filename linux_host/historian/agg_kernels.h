@@ -0,0 +1,53 @@
+/*
+ * 聚合内核: 位打包块解包 + 区间 min/max/sum + 掩码求和
+ *
+ * 三套实现，运行时按 CPU 选择 (同一文件内用 target 属性编译，不需要全局 -mavx2):
+ *   avx2    8 路 gather 解包，256 位比较/累加
+ *   sse4.1  标量 64 位读取解包，128 位比较/累加
+ *   scalar  纯标量，作为对照和兜底
+ * 三者结果完全一致。
+ */
+
+#ifndef WT_AGG_KERNELS_H
+#define WT_AGG_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace wt {
+
+struct AggKernels {
+    const char* name;
+
+    /**
+     * 解包一块 (COLUMN_BLOCK 个值) 并加上 base
+     * @param packed 块数据 (不含块头)，位宽不超过 32
+     */
+    void (*unpack)(const uint8_t* packed, unsigned width, int32_t base, int32_t* out);
+
+    /**
+     * 区间统计 (n > 0)，结果并入 *min / *max / *sum
+     */
+    void (*range_stats)(const int32_t* v, size_t n, int32_t* min, int32_t* max, int64_t* sum);
+
+    /**
+     * sum(values[i]，flags[i] != 0)，flags 为 0/1
+     */
+    int64_t (*masked_sum)(const int32_t* flags, const int32_t* values, size_t n);
+};
+
+/**
+ * 取内核
+ * @param name "avx2" / "sse4.1" / "scalar"，空指针=当前 CPU 支持的最快实现
+ * @return 空指针表示名称未知或 CPU 不支持
+ */
+const AggKernels* agg_kernels(const char* name);
+
+/**
+ * 当前 CPU 支持的全部内核 (最快的在前)，以空指针结束
+ */
+const AggKernels* const* agg_kernels_available();
+
+}  // namespace wt
+
+#endif  // WT_AGG_KERNELS_H
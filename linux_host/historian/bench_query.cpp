@@ -0,0 +1,146 @@
+/*
+ * wt-historian-bench: 聚合查询吞吐测试
+ *
+ * 用法:
+ *   wt-historian gen /tmp/wt-bench --towers 1000 --days 30
+ *   wt-historian-bench /tmp/wt-bench [--threads N] [--bucket-s N] [--repeat N]
+ *
+ * 对当前 CPU 支持的每套内核分别用 1 个线程和 N 个线程 (默认 CPU 核数)
+ * 执行全量 "每桶 min/max/mean + 水泵运行时间" 查询，取最快一次，
+ * 输出总吞吐和每核吞吐 (行/秒)。各内核的结果与标量内核逐桶比对。
+ * 段文件应已在页缓存中 (先跑一遍 query 或 cat 一次)，否则测的是磁盘。
+ */
+
+#include "historian.h"
+#include "log.h"
+#include "query.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace wt;
+
+namespace {
+
+struct BenchResult {
+    double seconds;
+    AggResult result;
+};
+
+bool run_best(const Historian& h, const AggQuery& q, const AggKernels* k, size_t threads, int repeat,
+              BenchResult* best, uint64_t* steals) {
+    WorkStealingPool pool(threads);
+    AggregateEngine engine(pool, k);
+    std::string err;
+    best->seconds = 1e30;
+    for (int i = 0; i < repeat; i++) {
+        AggResult r;
+        auto t0 = std::chrono::steady_clock::now();
+        if (!engine.run(h, q, &r, &err)) {
+            LOG_E("%s", err.c_str());
+            return false;
+        }
+        double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        if (s < best->seconds) {
+            best->seconds = s;
+            best->result = std::move(r);
+        }
+    }
+    *steals = pool.steals();
+    return true;
+}
+
+bool same_result(const AggResult& a, const AggResult& b) {
+    if (a.rows != b.rows || a.buckets != b.buckets || a.towers.size() != b.towers.size()) return false;
+    for (const auto& kv : a.towers) {
+        auto it = b.towers.find(kv.first);
+        if (it == b.towers.end()) return false;
+        for (size_t i = 0; i < a.buckets; i++) {
+            const BucketStats& x = kv.second[i];
+            const BucketStats& y = it->second[i];
+            if (x.count != y.count || x.sum != y.sum || x.pump_on_ms != y.pump_on_ms ||
+                (x.count && (x.min != y.min || x.max != y.max))) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "用法: %s DIR [--threads N] [--bucket-s N] [--repeat N]\n", argv[0]);
+        return 2;
+    }
+    size_t threads = std::thread::hardware_concurrency();
+    uint32_t bucket_s = 3600;
+    int repeat = 5;
+    for (int i = 2; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--threads") {
+            threads = strtoul(argv[i + 1], nullptr, 10);
+        } else if (arg == "--bucket-s") {
+            bucket_s = (uint32_t)strtoul(argv[i + 1], nullptr, 10);
+        } else if (arg == "--repeat") {
+            repeat = atoi(argv[i + 1]);
+        }
+    }
+    if (threads == 0) threads = 1;
+    if (repeat <= 0) repeat = 1;
+
+    std::string err;
+    auto h = Historian::open(argv[1], HistorianOptions(), &err);
+    if (!h) {
+        LOG_E("%s", err.c_str());
+        return 1;
+    }
+
+    AggQuery q;
+    q.bucket_ms = (int64_t)(bucket_s ? bucket_s : 3600) * 1000;
+    q.from_ms = INT64_MAX;
+    q.to_ms = INT64_MIN;
+    uint64_t bytes = 0;
+    for (const auto& seg : h->segments()) {
+        if (seg->header().row_count == 0) continue;
+        q.from_ms = std::min(q.from_ms, seg->header().t_min);
+        q.to_ms = std::max(q.to_ms, seg->header().t_max + 1);
+        bytes += seg->file_size();
+    }
+    if (q.from_ms >= q.to_ms) {
+        LOG_E("没有已封存的数据，先运行 wt-historian gen");
+        return 1;
+    }
+    q.from_ms = q.from_ms / q.bucket_ms * q.bucket_ms;
+
+    printf("数据: %zu 段，%.1f MB，桶宽 %u 秒\n\n", h->segments().size(), bytes / 1e6, bucket_s);
+    printf("%-8s %7s %10s %14s %14s %8s %6s\n", "kernel", "threads", "ms", "rows/s", "rows/s/core", "steals",
+           "check");
+
+    std::vector<size_t> thread_counts = {1};
+    if (threads > 1) thread_counts.push_back(threads);
+
+    BenchResult reference;
+    uint64_t steals;
+    if (!run_best(*h, q, agg_kernels("scalar"), 1, 1, &reference, &steals)) return 1;
+
+    const AggKernels* const* list = agg_kernels_available();
+    for (size_t i = 0; list[i] != nullptr; i++) {
+        for (size_t n : thread_counts) {
+            BenchResult r;
+            if (!run_best(*h, q, list[i], n, repeat, &r, &steals)) return 1;
+            double rate = r.result.rows / r.seconds;
+            printf("%-8s %7zu %10.2f %14.0f %14.0f %8" PRIu64 " %6s\n", list[i]->name, n, r.seconds * 1e3, rate,
+                   rate / n, steals, same_result(r.result, reference.result) ? "ok" : "DIFF");
+        }
+    }
+    printf("\n%" PRIu64 " 行，%zu 座水塔\n", reference.result.rows, reference.result.towers.size());
+    return 0;
+}
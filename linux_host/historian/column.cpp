@@ -0,0 +1,144 @@
+/*
+ * 列编码实现
+ */
+
+#include "column.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace wt {
+
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "segment format is little-endian");
+
+static unsigned bit_width(uint64_t range) {
+    return range == 0 ? 0 : 64 - __builtin_clzll(range);
+}
+
+void bitpack_encode(const uint64_t* in, unsigned width, uint8_t* out) {
+    size_t bytes = COLUMN_BLOCK / 8 * width;
+    memset(out, 0, bytes);
+    if (width == 0) return;
+
+    size_t bit = 0;
+    for (size_t i = 0; i < COLUMN_BLOCK; i++, bit += width) {
+        uint64_t v = in[i];
+        size_t byte = bit >> 3;
+        unsigned shift = bit & 7;
+        unsigned total = shift + width;     // 涉及的位数 (最多 71)
+
+        // 低 64 位
+        uint64_t lo = v << shift;
+        size_t n = std::min<size_t>((total + 7) / 8, 8);
+        for (size_t k = 0; k < n; k++) out[byte + k] |= (uint8_t)(lo >> (8 * k));
+        // 超出 64 位的部分
+        if (total > 64) out[byte + 8] |= (uint8_t)(v >> (64 - shift));
+    }
+}
+
+void bitpack_decode(const uint8_t* in, unsigned width, uint64_t* out) {
+    if (width == 0) {
+        std::fill(out, out + COLUMN_BLOCK, 0);
+        return;
+    }
+
+    size_t bytes = COLUMN_BLOCK / 8 * width;
+    uint64_t mask = width == 64 ? ~0ULL : (1ULL << width) - 1;
+    size_t bit = 0;
+    for (size_t i = 0; i < COLUMN_BLOCK; i++, bit += width) {
+        size_t byte = bit >> 3;
+        unsigned shift = bit & 7;
+        uint64_t word = 0;
+        memcpy(&word, in + byte, std::min<size_t>(8, bytes - byte));
+        uint64_t v = word >> shift;
+        if (shift + width > 64) v |= (uint64_t)in[byte + 8] << (64 - shift);
+        out[i] = v & mask;
+    }
+}
+
+void column_encode(const int64_t* values, size_t rows, std::string& out) {
+    uint64_t offsets[COLUMN_BLOCK];
+    uint8_t packed[COLUMN_BLOCK / 8 * 64];
+
+    for (size_t start = 0; start < rows; start += COLUMN_BLOCK) {
+        size_t n = std::min<size_t>(COLUMN_BLOCK, rows - start);
+        const int64_t* v = values + start;
+
+        int64_t lo = v[0], hi = v[0];
+        for (size_t i = 1; i < n; i++) {
+            lo = std::min(lo, v[i]);
+            hi = std::max(hi, v[i]);
+        }
+        unsigned width = bit_width((uint64_t)hi - (uint64_t)lo);
+
+        for (size_t i = 0; i < COLUMN_BLOCK; i++) {
+            offsets[i] = i < n ? (uint64_t)v[i] - (uint64_t)lo : 0;
+        }
+        bitpack_encode(offsets, width, packed);
+
+        char header[COLUMN_BLOCK_HEADER];
+        memcpy(header, &lo, 8);
+        header[8] = (char)width;
+        out.append(header, sizeof(header));
+        out.append((const char*)packed, COLUMN_BLOCK / 8 * width);
+    }
+}
+
+bool column_validate(const ColumnView& col) {
+    size_t pos = 0;
+    for (size_t b = 0; b < column_block_count(col.rows); b++) {
+        if (col.bytes - pos < COLUMN_BLOCK_HEADER) return false;
+        unsigned width = col.data[pos + 8];
+        if (width > 64) return false;
+        size_t len = column_block_bytes(width);
+        if (col.bytes - pos < len) return false;
+        pos += len;
+    }
+    return pos == col.bytes;
+}
+
+template <typename T>
+static void decode_column(const ColumnView& col, T* out) {
+    uint64_t offsets[COLUMN_BLOCK];
+    const uint8_t* p = col.data;
+
+    for (size_t start = 0; start < col.rows; start += COLUMN_BLOCK) {
+        int64_t base;
+        memcpy(&base, p, 8);
+        unsigned width = p[8];
+        bitpack_decode(p + COLUMN_BLOCK_HEADER, width, offsets);
+
+        size_t n = std::min<size_t>(COLUMN_BLOCK, col.rows - start);
+        for (size_t i = 0; i < n; i++) out[start + i] = (T)(int64_t)((uint64_t)base + offsets[i]);
+        p += column_block_bytes(width);
+    }
+}
+
+void column_decode(const ColumnView& col, int64_t* out) {
+    decode_column(col, out);
+}
+
+void column_decode(const ColumnView& col, int32_t* out) {
+    decode_column(col, out);
+}
+
+void timestamp_to_dod(const int64_t* ts, size_t rows, int64_t* dod) {
+    int64_t prev_delta = 0;
+    for (size_t i = 0; i < rows; i++) {
+        int64_t delta = i == 0 ? 0 : ts[i] - ts[i - 1];
+        dod[i] = delta - prev_delta;
+        prev_delta = delta;
+    }
+}
+
+void dod_to_timestamp(int64_t first, const int64_t* dod, size_t rows, int64_t* ts) {
+    int64_t delta = 0;
+    int64_t t = first;
+    for (size_t i = 0; i < rows; i++) {
+        delta += dod[i];
+        t += delta;
+        ts[i] = t;
+    }
+}
+
+}  // namespace wt
@@ -0,0 +1,77 @@
+/*
+ * 列编码: 分块 FOR (frame of reference) + 定宽位打包
+ *
+ * 一列按 COLUMN_BLOCK 个值分块，每块:
+ *   int64  base    块内最小值
+ *   uint8  width   (值 - base) 的位宽 (0~64)
+ *   bytes  data    COLUMN_BLOCK * width / 8 字节，低位在前的连续位流
+ * 最后一块不足时用 base 补齐，块长度只由位宽决定，可以直接跳块。
+ *
+ * 水位、水泵这类变化慢的列位宽通常只有 0~7 位；
+ * 时间戳列先做二阶差分 (delta-of-delta)，固定间隔采样时整块位宽为 0。
+ */
+
+#ifndef WT_COLUMN_H
+#define WT_COLUMN_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace wt {
+
+// 每块值的个数 (位宽为 w 时数据恰好 16*w 字节)
+#define COLUMN_BLOCK            128
+
+// 块头长度 (base + width)
+#define COLUMN_BLOCK_HEADER     9
+
+// 一块编码后的字节数
+inline size_t column_block_bytes(unsigned width) {
+    return COLUMN_BLOCK_HEADER + COLUMN_BLOCK / 8 * width;
+}
+
+inline size_t column_block_count(size_t rows) {
+    return (rows + COLUMN_BLOCK - 1) / COLUMN_BLOCK;
+}
+
+// 映射文件中的一列 (只读)
+struct ColumnView {
+    const uint8_t* data = nullptr;
+    size_t bytes = 0;
+    size_t rows = 0;
+};
+
+/**
+ * 追加编码一列
+ */
+void column_encode(const int64_t* values, size_t rows, std::string& out);
+
+/**
+ * 检查列结构 (块头位宽合法、总长度与行数一致)
+ */
+bool column_validate(const ColumnView& col);
+
+/**
+ * 解码一列
+ * @param out 至少 col.rows 个元素
+ */
+void column_decode(const ColumnView& col, int64_t* out);
+void column_decode(const ColumnView& col, int32_t* out);
+
+/**
+ * 解包一块 (COLUMN_BLOCK 个无符号偏移量，不加 base)
+ */
+void bitpack_encode(const uint64_t* in, unsigned width, uint8_t* out);
+void bitpack_decode(const uint8_t* in, unsigned width, uint64_t* out);
+
+/**
+ * 时间戳二阶差分编码/还原
+ * dod[0]=0, dod[1]=t1-t0, dod[i]=(ti-ti-1)-(ti-1-ti-2)；首个时间戳另存
+ */
+void timestamp_to_dod(const int64_t* ts, size_t rows, int64_t* dod);
+void dod_to_timestamp(int64_t first, const int64_t* dod, size_t rows, int64_t* ts);
+
+}  // namespace wt
+
+#endif  // WT_COLUMN_H
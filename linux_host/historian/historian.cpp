@@ -0,0 +1,324 @@
+/*
+ * 水塔历史数据库实现
+ */
+
+#include "historian.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace wt {
+
+#define WAL_MAGIC       "WTHWAL1"
+#define WAL_NAME        "active.wal"
+
+struct WalHeader {
+    char magic[8];
+    uint64_t seq;       // 这些采样将写入的段序号
+};
+static_assert(sizeof(WalHeader) == 16, "WalHeader layout");
+
+// WAL 定长记录
+struct WalRecord {
+    int64_t ts_ms;
+    uint32_t tower;
+    int32_t level;
+    int32_t rssi;
+    uint16_t alarm;
+    uint8_t pump;
+    uint8_t check;      // 前 23 字节之和，识别写了一半的记录
+};
+static_assert(sizeof(WalRecord) == 24, "WalRecord layout");
+
+static uint8_t wal_check(const WalRecord& r) {
+    const uint8_t* p = (const uint8_t*)&r;
+    uint8_t sum = 0x5a;
+    for (size_t i = 0; i < offsetof(WalRecord, check); i++) sum += p[i];
+    return sum;
+}
+
+static bool write_all(int fd, const void* data, size_t len) {
+    const char* p = (const char*)data;
+    while (len > 0) {
+        ssize_t n = write(fd, p, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+static bool sample_less(const Sample& a, const Sample& b) {
+    return a.tower != b.tower ? a.tower < b.tower : a.ts_ms < b.ts_ms;
+}
+
+// ==================== 打开与恢复 ====================
+
+std::unique_ptr<Historian> Historian::open(const std::string& dir, const HistorianOptions& options,
+                                           std::string* err) {
+    if (mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST) {
+        *err = dir + ": " + strerror(errno);
+        return nullptr;
+    }
+    DIR* d = opendir(dir.c_str());
+    if (d == nullptr) {
+        *err = dir + ": " + strerror(errno);
+        return nullptr;
+    }
+
+    std::unique_ptr<Historian> h(new Historian());
+    h->dir_ = dir;
+    h->options_ = options;
+    if (h->options_.segment_rows == 0) h->options_.segment_rows = HISTORIAN_SEGMENT_ROWS;
+
+    std::vector<uint64_t> seqs;
+    while (dirent* e = readdir(d)) {
+        std::string name = e->d_name;
+        if (name.compare(0, 4, "seg-") != 0) continue;
+
+        // 封存中途退出留下的临时文件
+        if (name.size() > 4 && name.compare(name.size() - 4, 4, ".tmp") == 0) {
+            unlink((dir + "/" + name).c_str());
+            continue;
+        }
+        uint64_t seq;
+        int len = 0;
+        if (sscanf(name.c_str(), "seg-%16" SCNx64 SEGMENT_SUFFIX "%n", &seq, &len) == 1 &&
+            (size_t)len == name.size()) {
+            seqs.push_back(seq);
+        }
+    }
+    closedir(d);
+
+    std::sort(seqs.begin(), seqs.end());
+    for (uint64_t seq : seqs) {
+        auto seg = Segment::open(h->segment_path(seq), err);
+        if (!seg) return nullptr;
+        h->segments_.push_back(seg);
+        h->next_seq_ = seq + 1;
+    }
+
+    if (!h->open_wal(err)) return nullptr;
+    return h;
+}
+
+Historian::~Historian() {
+    if (wal_fd_ >= 0) close(wal_fd_);
+}
+
+std::string Historian::segment_path(uint64_t seq) const {
+    char name[64];
+    snprintf(name, sizeof(name), "/seg-%016" PRIx64 SEGMENT_SUFFIX, seq);
+    return dir_ + name;
+}
+
+bool Historian::open_wal(std::string* err) {
+    std::string path = dir_ + "/" WAL_NAME;
+    wal_fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (wal_fd_ < 0) {
+        *err = path + ": " + strerror(errno);
+        return false;
+    }
+
+    WalHeader header;
+    ssize_t n = pread(wal_fd_, &header, sizeof(header), 0);
+    if (n != sizeof(header) || memcmp(header.magic, WAL_MAGIC, sizeof(header.magic)) != 0) {
+        return reset_wal(err);
+    }
+    if (header.seq < next_seq_) {
+        // 段已封存，只是没来得及清空 WAL
+        return reset_wal(err);
+    }
+    next_seq_ = header.seq;
+
+    // 重放
+    off_t pos = sizeof(header);
+    WalRecord batch[1024];
+    for (;;) {
+        n = pread(wal_fd_, batch, sizeof(batch), pos);
+        if (n <= 0) break;
+        size_t count = (size_t)n / sizeof(WalRecord);
+        size_t valid = 0;
+        while (valid < count && wal_check(batch[valid]) == batch[valid].check) {
+            const WalRecord& r = batch[valid];
+            Sample s;
+            s.ts_ms = r.ts_ms;
+            s.tower = r.tower;
+            s.level = r.level;
+            s.pump = r.pump != 0;
+            s.rssi = r.rssi;
+            s.alarm = r.alarm;
+            pending_.push_back(s);
+            valid++;
+        }
+        pos += (off_t)(valid * sizeof(WalRecord));
+        if (valid < count || (size_t)n % sizeof(WalRecord) != 0) break;
+    }
+
+    // 截掉末尾不完整或损坏的记录，之后的追加从这里开始
+    if (ftruncate(wal_fd_, pos) != 0 || lseek(wal_fd_, pos, SEEK_SET) < 0) {
+        *err = path + ": " + strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+bool Historian::reset_wal(std::string* err) {
+    WalHeader header{};
+    memcpy(header.magic, WAL_MAGIC, sizeof(header.magic));
+    header.seq = next_seq_;
+    if (ftruncate(wal_fd_, 0) != 0 || lseek(wal_fd_, 0, SEEK_SET) < 0 ||
+        !write_all(wal_fd_, &header, sizeof(header)) || fdatasync(wal_fd_) != 0) {
+        *err = dir_ + "/" WAL_NAME ": " + strerror(errno);
+        return false;
+    }
+    wal_failed_ = false;
+    return true;
+}
+
+// ==================== 写入 ====================
+
+bool Historian::append(const Sample* rows, size_t count, std::string* err) {
+    std::vector<WalRecord> records(count);
+    for (size_t i = 0; i < count; i++) {
+        WalRecord& r = records[i];
+        r.ts_ms = rows[i].ts_ms;
+        r.tower = rows[i].tower;
+        r.level = rows[i].level;
+        r.rssi = rows[i].rssi;
+        r.alarm = rows[i].alarm;
+        r.pump = rows[i].pump ? 1 : 0;
+        r.check = wal_check(r);
+    }
+    if (wal_failed_) {
+        *err = dir_ + "/" WAL_NAME ": 之前的写入失败且无法截断，拒绝写入";
+        return false;
+    }
+
+    // 写到一半失败时截回原长度，否则后续记录接在半条记录后面，重放时整段被丢弃
+    off_t start = lseek(wal_fd_, 0, SEEK_CUR);
+    if (start < 0) {
+        *err = dir_ + "/" WAL_NAME ": " + strerror(errno);
+        return false;
+    }
+    if (!write_all(wal_fd_, records.data(), records.size() * sizeof(WalRecord)) ||
+        (options_.sync && fdatasync(wal_fd_) != 0)) {
+        *err = dir_ + "/" WAL_NAME ": " + strerror(errno);
+        if (ftruncate(wal_fd_, start) != 0 || lseek(wal_fd_, start, SEEK_SET) < 0) {
+            wal_failed_ = true;
+        }
+        return false;
+    }
+
+    pending_.insert(pending_.end(), rows, rows + count);
+    if (pending_.size() >= options_.segment_rows) return seal(err);
+    return true;
+}
+
+bool Historian::seal(std::string* err) {
+    if (pending_.empty()) return true;
+
+    // 同一水塔同一时间戳的重复采样保留最后写入的一条
+    std::stable_sort(pending_.begin(), pending_.end(), sample_less);
+    size_t out = 0;
+    for (size_t i = 0; i < pending_.size(); i++) {
+        if (out > 0 && pending_[out - 1].tower == pending_[i].tower && pending_[out - 1].ts_ms == pending_[i].ts_ms) {
+            pending_[out - 1] = pending_[i];
+        } else {
+            pending_[out++] = pending_[i];
+        }
+    }
+    pending_.resize(out);
+
+    std::string path = segment_path(next_seq_);
+    if (!segment_write(path, pending_, err)) return false;
+    auto seg = Segment::open(path, err);
+    if (!seg) return false;
+
+    segments_.push_back(seg);
+    next_seq_++;
+    pending_.clear();
+    return reset_wal(err);
+}
+
+// ==================== 读取 ====================
+
+void series_slice(SeriesData* data, int64_t from_ms, int64_t to_ms) {
+    auto first = std::lower_bound(data->ts.begin(), data->ts.end(), from_ms);
+    auto last = std::upper_bound(first, data->ts.end(), to_ms);
+    size_t begin = first - data->ts.begin();
+    size_t end = last - data->ts.begin();
+    if (begin == 0 && end == data->size()) return;
+
+    auto cut = [&](auto& v) {
+        v.erase(v.begin() + end, v.end());
+        v.erase(v.begin(), v.begin() + begin);
+    };
+    cut(data->ts);
+    cut(data->level);
+    cut(data->pump);
+    cut(data->rssi);
+    cut(data->alarm);
+}
+
+bool Historian::scan(uint32_t tower, int64_t from_ms, int64_t to_ms,
+                     const std::function<void(const SeriesData&)>& fn, std::string* err) {
+    SeriesData data;
+
+    for (const auto& seg : segments_) {
+        const SegmentHeader& h = seg->header();
+        if (h.row_count == 0 || h.t_max < from_ms || h.t_min > to_ms) continue;
+
+        size_t first = 0, last = seg->series_count();
+        if (tower != HIST_ALL_TOWERS) {
+            const SeriesIndex* s = seg->find(tower);
+            if (s == nullptr) continue;
+            first = s - &seg->series(0);
+            last = first + 1;
+        }
+        for (size_t i = first; i < last; i++) {
+            const SeriesIndex& s = seg->series(i);
+            if (s.t_max < from_ms || s.t_min > to_ms) continue;
+            if (!seg->decode(s, &data, err)) return false;
+            series_slice(&data, from_ms, to_ms);
+            if (data.size() > 0) fn(data);
+        }
+    }
+
+    // 尚未封存的采样
+    std::vector<Sample> rows;
+    for (const Sample& s : pending_) {
+        if ((tower == HIST_ALL_TOWERS || s.tower == tower) && s.ts_ms >= from_ms && s.ts_ms <= to_ms) {
+            rows.push_back(s);
+        }
+    }
+    std::stable_sort(rows.begin(), rows.end(), sample_less);
+    for (size_t start = 0; start < rows.size();) {
+        size_t end = start;
+        while (end < rows.size() && rows[end].tower == rows[start].tower) end++;
+        data.tower = rows[start].tower;
+        data.resize(end - start);
+        for (size_t i = start; i < end; i++) {
+            data.ts[i - start] = rows[i].ts_ms;
+            data.level[i - start] = rows[i].level;
+            data.pump[i - start] = rows[i].pump ? 1 : 0;
+            data.rssi[i - start] = rows[i].rssi;
+            data.alarm[i - start] = rows[i].alarm;
+        }
+        fn(data);
+        start = end;
+    }
+    return true;
+}
+
+}  // namespace wt
@@ -0,0 +1,108 @@
+/*
+ * 水塔历史数据库
+ *
+ * 目录结构:
+ *   <dir>/active.wal                 未封存的采样 (追加写入的定长记录)
+ *   <dir>/seg-<序号 16 位十六进制>.wts  已封存的列式段文件，只读
+ *
+ * 写入: append() 一批采样一次 write() 追加到 active.wal，同时留在内存中；
+ *       累计达到 segment_rows 时排序、列式编码为新段并清空 WAL。
+ * 崩溃恢复: WAL 头记录下一个段的序号，若该段已存在说明封存已完成、
+ *       只差清空 WAL，重放时丢弃；末尾不完整的记录被截掉。
+ * 读取: scan() 按时间范围跳过无关段，已封存段经 mmap 按列解码，
+ *       最后合并 WAL 中尚未封存的采样。
+ *
+ * 单写者；已封存的段可以被多个线程同时读取。
+ */
+
+#ifndef WT_HISTORIAN_H
+#define WT_HISTORIAN_H
+
+#include "segment.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace wt {
+
+// 每段默认行数 (约 1~4 MB)
+#define HISTORIAN_SEGMENT_ROWS      (1u << 20)
+
+// scan() 的水塔参数: 全部水塔
+#define HIST_ALL_TOWERS             UINT32_MAX
+
+struct HistorianOptions {
+    size_t segment_rows = HISTORIAN_SEGMENT_ROWS;
+    bool sync = false;              // 每次 append() 后 fdatasync
+};
+
+class Historian {
+public:
+    /**
+     * 打开 (不存在则创建) 数据目录，重放 WAL
+     * @return 空指针表示失败
+     */
+    static std::unique_ptr<Historian> open(const std::string& dir, const HistorianOptions& options,
+                                           std::string* err);
+
+    ~Historian();
+    Historian(const Historian&) = delete;
+    Historian& operator=(const Historian&) = delete;
+
+    /**
+     * 批量写入
+     * 写日志失败时截回写入前的长度；截断也失败则拒绝之后的写入，直到 seal() 重建日志
+     */
+    bool append(const Sample* rows, size_t count, std::string* err);
+
+    /**
+     * 立即把未封存的采样写成一个段
+     */
+    bool seal(std::string* err);
+
+    /**
+     * 读取一个水塔 (或全部水塔) 在 [from_ms, to_ms] 内的数据
+     * @param fn 每个段中的每个序列回调一次 (同一水塔可能回调多次，按时间先后)
+     * @return false=段数据损坏
+     */
+    bool scan(uint32_t tower, int64_t from_ms, int64_t to_ms,
+              const std::function<void(const SeriesData&)>& fn, std::string* err);
+
+    /**
+     * 已封存的段 (按序号升序，即写入顺序)
+     */
+    const std::vector<std::shared_ptr<Segment>>& segments() const { return segments_; }
+
+    /**
+     * 尚未封存的采样 (写入顺序)
+     */
+    const std::vector<Sample>& pending() const { return pending_; }
+    size_t pending_rows() const { return pending_.size(); }
+
+private:
+    Historian() = default;
+
+    bool open_wal(std::string* err);
+    bool reset_wal(std::string* err);
+    std::string segment_path(uint64_t seq) const;
+
+    std::string dir_;
+    HistorianOptions options_;
+    int wal_fd_ = -1;
+    bool wal_failed_ = false;       // 日志末尾可能有半条记录，不再追加
+    uint64_t next_seq_ = 1;
+    std::vector<Sample> pending_;
+    std::vector<std::shared_ptr<Segment>> segments_;
+};
+
+/**
+ * 按时间裁剪序列 (保留 [from_ms, to_ms])
+ */
+void series_slice(SeriesData* data, int64_t from_ms, int64_t to_ms);
+
+}  // namespace wt
+
+#endif  // WT_HISTORIAN_H
@@ -0,0 +1,217 @@
+/*
+ * 历史数据聚合查询实现
+ */
+
+#include "query.h"
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+
+namespace wt {
+
+void BucketStats::merge(const BucketStats& o) {
+    if (o.count == 0 && o.pump_on_ms == 0) return;
+    min = std::min(min, o.min);
+    max = std::max(max, o.max);
+    sum += o.sum;
+    count += o.count;
+    pump_on_ms += o.pump_on_ms;
+}
+
+namespace {
+
+// 每个工作线程独立的缓冲与累加器
+struct WorkerState {
+    std::vector<int64_t> ts;
+    std::vector<int32_t> dt;
+    alignas(32) int32_t level[COLUMN_BLOCK];
+    alignas(32) int32_t pump[COLUMN_BLOCK];
+    std::unordered_map<uint32_t, std::vector<BucketStats>> towers;
+    uint64_t rows = 0;
+    uint64_t series = 0;
+};
+
+struct Task {
+    const Segment* segment;
+    const SeriesIndex* series;
+};
+
+/**
+ * 每行到下一行的时间 (水泵运行时间按它累加)，最后一行沿用前一个间隔
+ */
+void compute_dt(const int64_t* ts, size_t rows, int64_t max_gap, int32_t* dt) {
+    for (size_t i = 0; i + 1 < rows; i++) {
+        int64_t d = ts[i + 1] - ts[i];
+        dt[i] = d > max_gap ? 0 : (int32_t)d;
+    }
+    if (rows > 0) dt[rows - 1] = rows > 1 ? dt[rows - 2] : 0;
+}
+
+/**
+ * 把 [r0, r1) 行按时间桶拆分累加
+ * @param level, pump 第 base 行起的值
+ */
+void accumulate(const AggKernels* k, const AggQuery& q, const int64_t* ts, const int32_t* dt,
+                const int32_t* level, const int32_t* pump, size_t base, size_t r0, size_t r1,
+                std::vector<BucketStats>& buckets) {
+    while (r0 < r1) {
+        size_t b = (size_t)((ts[r0] - q.from_ms) / q.bucket_ms);
+        int64_t bucket_end = q.from_ms + (int64_t)(b + 1) * q.bucket_ms;
+        size_t r = std::lower_bound(ts + r0, ts + r1, bucket_end) - ts;
+
+        BucketStats& s = buckets[b];
+        k->range_stats(level + (r0 - base), r - r0, &s.min, &s.max, &s.sum);
+        s.pump_on_ms += k->masked_sum(pump + (r0 - base), dt + r0, r - r0);
+        s.count += (uint32_t)(r - r0);
+        r0 = r;
+    }
+}
+
+}  // namespace
+
+AggregateEngine::AggregateEngine(WorkStealingPool& pool, const AggKernels* kernels)
+    : pool_(pool), kernels_(kernels ? kernels : agg_kernels(nullptr)) {}
+
+bool AggregateEngine::run(const Historian& h, const AggQuery& q, AggResult* out, std::string* err) {
+    if (q.bucket_ms <= 0 || q.to_ms <= q.from_ms) {
+        *err = "时间范围或桶宽无效";
+        return false;
+    }
+    int64_t span = q.to_ms - q.from_ms;
+    size_t buckets = (size_t)((span + q.bucket_ms - 1) / q.bucket_ms);
+
+    // 按段和序列的时间范围筛出任务
+    std::vector<Task> tasks;
+    for (const auto& seg : h.segments()) {
+        const SegmentHeader& hd = seg->header();
+        if (hd.row_count == 0 || hd.t_max < q.from_ms || hd.t_min >= q.to_ms) continue;
+        for (size_t i = 0; i < seg->series_count(); i++) {
+            const SeriesIndex& s = seg->series(i);
+            if (q.tower != HIST_ALL_TOWERS && s.tower != q.tower) continue;
+            if (s.t_max < q.from_ms || s.t_min >= q.to_ms) continue;
+            tasks.push_back({seg.get(), &s});
+        }
+    }
+
+    std::vector<WorkerState> workers(pool_.size());
+    std::mutex err_mutex;
+    std::string task_err;
+    const AggKernels* k = kernels_;
+
+    pool_.run(tasks.size(), [&](size_t index, size_t worker) {
+        const Segment& seg = *tasks[index].segment;
+        const SeriesIndex& s = *tasks[index].series;
+        WorkerState& w = workers[worker];
+
+        ColumnView time_col = seg.column(s, HCOL_TIME);
+        ColumnView level_col = seg.column(s, HCOL_LEVEL);
+        ColumnView pump_col = seg.column(s, HCOL_PUMP);
+        if (!column_validate(time_col) || !column_validate(level_col) || !column_validate(pump_col)) {
+            std::lock_guard<std::mutex> lock(err_mutex);
+            task_err = seg.path() + ": 水塔 " + std::to_string(s.tower) + " 列数据损坏";
+            return;
+        }
+
+        // 时间列 (二阶差分通常为 0 位宽，解码很便宜)
+        w.ts.resize(s.rows);
+        w.dt.resize(s.rows);
+        column_decode(time_col, w.ts.data());
+        dod_to_timestamp(s.t_min, w.ts.data(), s.rows, w.ts.data());
+        compute_dt(w.ts.data(), s.rows, q.max_gap_ms, w.dt.data());
+
+        size_t lo = std::lower_bound(w.ts.begin(), w.ts.end(), q.from_ms) - w.ts.begin();
+        size_t hi = std::lower_bound(w.ts.begin() + lo, w.ts.end(), q.to_ms) - w.ts.begin();
+        if (lo >= hi) return;
+
+        std::vector<BucketStats>& acc = w.towers[s.tower];
+        if (acc.empty()) acc.resize(buckets);
+
+        // 水位和水泵列逐块解包，跳过范围之外的块
+        const uint8_t* lp = level_col.data;
+        const uint8_t* pp = pump_col.data;
+        for (size_t b0 = 0; b0 < hi; b0 += COLUMN_BLOCK) {
+            unsigned lw = lp[8], pw = pp[8];
+            if (b0 + COLUMN_BLOCK > lo) {
+                if (lw > 32 || pw > 32) {
+                    std::lock_guard<std::mutex> lock(err_mutex);
+                    task_err = seg.path() + ": 水塔 " + std::to_string(s.tower) + " 位宽超出 32";
+                    return;
+                }
+                int64_t lbase, pbase;
+                memcpy(&lbase, lp, 8);
+                memcpy(&pbase, pp, 8);
+                k->unpack(lp + COLUMN_BLOCK_HEADER, lw, (int32_t)lbase, w.level);
+                k->unpack(pp + COLUMN_BLOCK_HEADER, pw, (int32_t)pbase, w.pump);
+
+                size_t r0 = std::max(lo, b0);
+                size_t r1 = std::min(hi, b0 + COLUMN_BLOCK);
+                accumulate(k, q, w.ts.data(), w.dt.data(), w.level, w.pump, b0, r0, r1, acc);
+            }
+            lp += column_block_bytes(lw);
+            pp += column_block_bytes(pw);
+        }
+        w.rows += hi - lo;
+        w.series++;
+    });
+
+    if (!task_err.empty()) {
+        *err = task_err;
+        return false;
+    }
+
+    out->buckets = buckets;
+    out->towers.clear();
+    out->rows = 0;
+    out->series = 0;
+    for (WorkerState& w : workers) {
+        for (auto& kv : w.towers) {
+            std::vector<BucketStats>& dst = out->towers[kv.first];
+            if (dst.empty()) {
+                dst = std::move(kv.second);
+            } else {
+                for (size_t b = 0; b < buckets; b++) dst[b].merge(kv.second[b]);
+            }
+        }
+        out->rows += w.rows;
+        out->series += w.series;
+    }
+
+    // 尚未封存的采样
+    std::vector<Sample> rows;
+    for (const Sample& s : h.pending()) {
+        if ((q.tower == HIST_ALL_TOWERS || s.tower == q.tower) && s.ts_ms >= q.from_ms && s.ts_ms < q.to_ms) {
+            rows.push_back(s);
+        }
+    }
+    std::stable_sort(rows.begin(), rows.end(), [](const Sample& a, const Sample& b) {
+        return a.tower != b.tower ? a.tower < b.tower : a.ts_ms < b.ts_ms;
+    });
+    std::vector<int64_t> ts;
+    std::vector<int32_t> dt, level, pump;
+    for (size_t start = 0; start < rows.size();) {
+        size_t end = start;
+        while (end < rows.size() && rows[end].tower == rows[start].tower) end++;
+        size_t n = end - start;
+        ts.resize(n);
+        dt.resize(n);
+        level.resize(n);
+        pump.resize(n);
+        for (size_t i = 0; i < n; i++) {
+            ts[i] = rows[start + i].ts_ms;
+            level[i] = rows[start + i].level;
+            pump[i] = rows[start + i].pump ? 1 : 0;
+        }
+        compute_dt(ts.data(), n, q.max_gap_ms, dt.data());
+
+        std::vector<BucketStats>& acc = out->towers[rows[start].tower];
+        if (acc.empty()) acc.resize(buckets);
+        accumulate(k, q, ts.data(), dt.data(), level.data(), pump.data(), 0, 0, n, acc);
+        out->rows += n;
+        start = end;
+    }
+    return true;
+}
+
+}  // namespace wt
@@ -0,0 +1,75 @@
+/*
+ * 历史数据聚合查询
+ *
+ * 按固定时间桶统计每座水塔的水位 min/max/mean 和水泵运行时间，例如
+ * "最近 90 天每小时"。已封存段按 (段, 序列) 拆成任务交给工作窃取线程池，
+ * 每个任务直接在映射的位打包块上解包并聚合 (AggKernels)，不生成中间行；
+ * 各线程独立累加，最后合并。WAL 中尚未封存的采样在调用线程中补充统计。
+ */
+
+#ifndef WT_QUERY_H
+#define WT_QUERY_H
+
+#include "agg_kernels.h"
+#include "historian.h"
+#include "work_stealing_pool.h"
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace wt {
+
+// 相邻采样间隔超过该值时，这段时间不计入水泵运行时间 (视为数据缺失)
+#define AGG_MAX_GAP_MS      (10 * 60 * 1000)
+
+struct BucketStats {
+    int32_t min = INT32_MAX;
+    int32_t max = INT32_MIN;
+    int64_t sum = 0;
+    uint32_t count = 0;
+    int64_t pump_on_ms = 0;
+
+    void merge(const BucketStats& o);
+    double mean() const { return count ? (double)sum / count : 0.0; }
+};
+
+struct AggQuery {
+    int64_t from_ms = 0;                    // [from_ms, to_ms)
+    int64_t to_ms = 0;
+    int64_t bucket_ms = 3600 * 1000;
+    uint32_t tower = HIST_ALL_TOWERS;
+    int64_t max_gap_ms = AGG_MAX_GAP_MS;
+};
+
+struct AggResult {
+    size_t buckets = 0;
+    std::map<uint32_t, std::vector<BucketStats>> towers;    // 每座水塔 buckets 个桶
+    uint64_t rows = 0;                      // 参与统计的采样数
+    uint64_t series = 0;                    // 解码的序列数
+};
+
+class AggregateEngine {
+public:
+    /**
+     * @param kernels 空指针=当前 CPU 最快的实现
+     */
+    AggregateEngine(WorkStealingPool& pool, const AggKernels* kernels = nullptr);
+
+    const AggKernels* kernels() const { return kernels_; }
+
+    /**
+     * 执行查询
+     * @return false=参数错误或段数据损坏
+     */
+    bool run(const Historian& h, const AggQuery& q, AggResult* out, std::string* err);
+
+private:
+    WorkStealingPool& pool_;
+    const AggKernels* kernels_;
+};
+
+}  // namespace wt
+
+#endif  // WT_QUERY_H
@@ -0,0 +1,240 @@
+/*
+ * 历史数据段文件实现
+ */
+
+#include "segment.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace wt {
+
+void SeriesData::resize(size_t rows) {
+    ts.resize(rows);
+    level.resize(rows);
+    pump.resize(rows);
+    rssi.resize(rows);
+    alarm.resize(rows);
+}
+
+// ==================== 写入 ====================
+
+static bool write_all(int fd, const char* data, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(fd, data, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+/**
+ * 同步目录项 (改名后持久化)
+ */
+static void sync_dir(const std::string& path) {
+    size_t slash = path.rfind('/');
+    std::string dir = slash == std::string::npos ? "." : path.substr(0, slash);
+    int fd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd >= 0) {
+        fsync(fd);
+        close(fd);
+    }
+}
+
+bool segment_write(const std::string& path, const std::vector<Sample>& rows, std::string* err) {
+    std::string buf(sizeof(SegmentHeader), '\0');
+    std::vector<SeriesIndex> index;
+    std::vector<int64_t> values;
+    std::vector<int64_t> ts;
+
+    SegmentHeader header{};
+    memcpy(header.magic, SEGMENT_MAGIC, sizeof(header.magic));
+    header.version = SEGMENT_VERSION;
+    header.row_count = rows.size();
+    header.t_min = INT64_MAX;
+    header.t_max = INT64_MIN;
+
+    for (size_t start = 0; start < rows.size();) {
+        size_t end = start;
+        while (end < rows.size() && rows[end].tower == rows[start].tower) end++;
+        size_t n = end - start;
+
+        SeriesIndex s{};
+        s.tower = rows[start].tower;
+        s.rows = (uint32_t)n;
+        s.t_min = rows[start].ts_ms;
+        s.t_max = rows[end - 1].ts_ms;
+        header.t_min = std::min(header.t_min, s.t_min);
+        header.t_max = std::max(header.t_max, s.t_max);
+
+        ts.resize(n);
+        values.resize(n);
+        for (size_t i = 0; i < n; i++) ts[i] = rows[start + i].ts_ms;
+
+        for (int col = 0; col < HCOL_COUNT; col++) {
+            const Sample* r = &rows[start];
+            switch (col) {
+                case HCOL_TIME:  timestamp_to_dod(ts.data(), n, values.data()); break;
+                case HCOL_LEVEL: for (size_t i = 0; i < n; i++) values[i] = r[i].level; break;
+                case HCOL_PUMP:  for (size_t i = 0; i < n; i++) values[i] = r[i].pump ? 1 : 0; break;
+                case HCOL_RSSI:  for (size_t i = 0; i < n; i++) values[i] = r[i].rssi; break;
+                case HCOL_ALARM: for (size_t i = 0; i < n; i++) values[i] = r[i].alarm; break;
+            }
+            s.offset[col] = buf.size();
+            column_encode(values.data(), n, buf);
+            s.bytes[col] = (uint32_t)(buf.size() - s.offset[col]);
+        }
+        index.push_back(s);
+        start = end;
+    }
+
+    // 索引按 8 字节对齐，映射后可直接按结构体访问
+    buf.resize((buf.size() + 7) & ~(size_t)7, '\0');
+    header.series_count = (uint32_t)index.size();
+    header.index_offset = buf.size();
+    buf.append((const char*)index.data(), index.size() * sizeof(SeriesIndex));
+    header.file_size = buf.size();
+    if (rows.empty()) header.t_min = header.t_max = 0;
+    memcpy(&buf[0], &header, sizeof(header));
+
+    std::string tmp = path + ".tmp";
+    int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        *err = tmp + ": " + strerror(errno);
+        return false;
+    }
+    bool ok = write_all(fd, buf.data(), buf.size()) && fsync(fd) == 0;
+    int saved = errno;
+    close(fd);
+    if (!ok || rename(tmp.c_str(), path.c_str()) != 0) {
+        *err = path + ": " + strerror(ok ? errno : saved);
+        unlink(tmp.c_str());
+        return false;
+    }
+    sync_dir(path);
+    return true;
+}
+
+// ==================== 读取 ====================
+
+std::shared_ptr<Segment> Segment::open(const std::string& path, std::string* err) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        *err = path + ": " + strerror(errno);
+        return nullptr;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(SegmentHeader)) {
+        *err = path + ": 文件过短";
+        close(fd);
+        return nullptr;
+    }
+    size_t size = (size_t)st.st_size;
+    void* map = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        *err = path + ": mmap: " + strerror(errno);
+        return nullptr;
+    }
+
+    std::shared_ptr<Segment> seg(new Segment());
+    seg->path_ = path;
+    seg->base_ = (const uint8_t*)map;
+    seg->size_ = size;
+    seg->header_ = (const SegmentHeader*)map;
+
+    const SegmentHeader& h = *seg->header_;
+    if (memcmp(h.magic, SEGMENT_MAGIC, sizeof(h.magic)) != 0 || h.version != SEGMENT_VERSION) {
+        *err = path + ": 不是段文件或版本不支持";
+        return nullptr;
+    }
+    if (h.file_size != size || h.index_offset % 8 != 0 || h.index_offset < sizeof(SegmentHeader) ||
+        h.index_offset > size || (size - h.index_offset) / sizeof(SeriesIndex) != h.series_count) {
+        *err = path + ": 文件不完整";
+        return nullptr;
+    }
+    seg->index_ = (const SeriesIndex*)(seg->base_ + h.index_offset);
+
+    // 只检查各列范围，块结构在解码时检查
+    for (size_t i = 0; i < h.series_count; i++) {
+        const SeriesIndex& s = seg->index_[i];
+        if (i > 0 && seg->index_[i - 1].tower >= s.tower) {
+            *err = path + ": 索引未排序";
+            return nullptr;
+        }
+        for (int col = 0; col < HCOL_COUNT; col++) {
+            if (s.offset[col] < sizeof(SegmentHeader) || s.offset[col] + s.bytes[col] > h.index_offset) {
+                *err = path + ": 列越界";
+                return nullptr;
+            }
+        }
+    }
+    return seg;
+}
+
+Segment::~Segment() {
+    if (base_ != nullptr) munmap((void*)base_, size_);
+}
+
+const SeriesIndex* Segment::find(uint32_t tower) const {
+    size_t lo = 0, hi = series_count();
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (index_[mid].tower < tower) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo < series_count() && index_[lo].tower == tower ? &index_[lo] : nullptr;
+}
+
+ColumnView Segment::column(const SeriesIndex& s, HistColumn col) const {
+    ColumnView view;
+    view.data = base_ + s.offset[col];
+    view.bytes = s.bytes[col];
+    view.rows = s.rows;
+    return view;
+}
+
+bool Segment::decode(const SeriesIndex& s, SeriesData* out, std::string* err) const {
+    for (int col = 0; col < HCOL_COUNT; col++) {
+        if (!column_validate(column(s, (HistColumn)col))) {
+            *err = path_ + ": 水塔 " + std::to_string(s.tower) + " 列数据损坏";
+            return false;
+        }
+    }
+
+    out->tower = s.tower;
+    out->resize(s.rows);
+    column_decode(column(s, HCOL_TIME), out->ts.data());
+    dod_to_timestamp(s.t_min, out->ts.data(), s.rows, out->ts.data());
+    column_decode(column(s, HCOL_LEVEL), out->level.data());
+    column_decode(column(s, HCOL_PUMP), out->pump.data());
+    column_decode(column(s, HCOL_RSSI), out->rssi.data());
+    column_decode(column(s, HCOL_ALARM), out->alarm.data());
+    return true;
+}
+
+bool Segment::verify(std::string* err) const {
+    for (size_t i = 0; i < series_count(); i++) {
+        for (int col = 0; col < HCOL_COUNT; col++) {
+            if (!column_validate(column(index_[i], (HistColumn)col))) {
+                *err = path_ + ": 水塔 " + std::to_string(index_[i].tower) + " 列数据损坏";
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+}  // namespace wt
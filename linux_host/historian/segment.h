@@ -0,0 +1,152 @@
+/*
+ * 历史数据段文件 (*.wts)
+ *
+ * 一个段包含一批水塔在一段时间内的全部采样，写完 (封存) 后不再修改。
+ * 文件结构 (小端):
+ *
+ *   SegmentHeader                64 字节
+ *   列数据                        每个序列 (水塔) 依次为 时间/水位/水泵/信号/报警 五列
+ *   SeriesIndex[series_count]    按水塔 ID 排序，位于文件末尾
+ *
+ * 读取时整个文件 mmap 只读映射，列数据不复制，按需解码。
+ */
+
+#ifndef WT_SEGMENT_H
+#define WT_SEGMENT_H
+
+#include "column.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace wt {
+
+#define SEGMENT_MAGIC       "WTHSEG1"
+#define SEGMENT_VERSION     1
+#define SEGMENT_SUFFIX      ".wts"
+
+// 列编号
+enum HistColumn {
+    HCOL_TIME = 0,      // 毫秒时间戳 (二阶差分)
+    HCOL_LEVEL,         // 水位百分比
+    HCOL_PUMP,          // 水泵 0/1
+    HCOL_RSSI,          // 信号强度 dBm
+    HCOL_ALARM,         // 报警位 (HIST_ALARM_*)
+    HCOL_COUNT
+};
+
+// 报警位
+#define HIST_ALARM_LOW_WATER    0x01
+#define HIST_ALARM_OVERFLOW     0x02
+#define HIST_ALARM_SHORTAGE     0x04
+
+// 一条采样
+struct Sample {
+    int64_t ts_ms = 0;
+    uint32_t tower = 0;
+    int32_t level = 0;
+    bool pump = false;
+    int32_t rssi = 0;
+    uint16_t alarm = 0;
+};
+
+struct SegmentHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t series_count;
+    uint64_t row_count;
+    int64_t t_min;
+    int64_t t_max;
+    uint64_t index_offset;
+    uint64_t file_size;         // 用于检查截断
+    uint64_t reserved;
+};
+static_assert(sizeof(SegmentHeader) == 64, "SegmentHeader layout");
+
+struct SeriesIndex {
+    uint32_t tower;
+    uint32_t rows;
+    int64_t t_min;
+    int64_t t_max;
+    uint64_t offset[HCOL_COUNT];
+    uint32_t bytes[HCOL_COUNT];
+    uint32_t reserved;
+};
+static_assert(sizeof(SeriesIndex) == 88, "SeriesIndex layout");
+
+// 解码后的一个序列
+struct SeriesData {
+    uint32_t tower = 0;
+    std::vector<int64_t> ts;
+    std::vector<int32_t> level;
+    std::vector<int32_t> pump;
+    std::vector<int32_t> rssi;
+    std::vector<int32_t> alarm;
+
+    size_t size() const { return ts.size(); }
+    void resize(size_t rows);
+};
+
+/**
+ * 写出段文件 (先写临时文件，fsync 后改名，保证不会出现写了一半的段)
+ * @param rows 采样，需按 (tower, ts_ms) 排序
+ */
+bool segment_write(const std::string& path, const std::vector<Sample>& rows, std::string* err);
+
+class Segment {
+public:
+    /**
+     * 映射并校验段文件
+     * @return 空指针表示失败
+     */
+    static std::shared_ptr<Segment> open(const std::string& path, std::string* err);
+
+    ~Segment();
+    Segment(const Segment&) = delete;
+    Segment& operator=(const Segment&) = delete;
+
+    const std::string& path() const { return path_; }
+    const SegmentHeader& header() const { return *header_; }
+    size_t file_size() const { return size_; }
+
+    size_t series_count() const { return header_->series_count; }
+    const SeriesIndex& series(size_t i) const { return index_[i]; }
+
+    /**
+     * 按水塔 ID 查找序列
+     * @return 空指针表示该段中没有
+     */
+    const SeriesIndex* find(uint32_t tower) const;
+
+    /**
+     * 取某一列的原始编码数据
+     */
+    ColumnView column(const SeriesIndex& s, HistColumn col) const;
+
+    /**
+     * 解码整个序列 (先检查各列块结构，损坏的列不解码)
+     * @return false=列数据损坏
+     */
+    bool decode(const SeriesIndex& s, SeriesData* out, std::string* err) const;
+
+    /**
+     * 完整校验所有列的块结构
+     */
+    bool verify(std::string* err) const;
+
+private:
+    Segment() = default;
+
+    std::string path_;
+    const uint8_t* base_ = nullptr;
+    size_t size_ = 0;
+    const SegmentHeader* header_ = nullptr;
+    const SeriesIndex* index_ = nullptr;
+};
+
+}  // namespace wt
+
+#endif  // WT_SEGMENT_H
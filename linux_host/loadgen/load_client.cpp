@@ -0,0 +1,168 @@
+/*
+ * 压测连接实现
+ */
+
+#include "load_client.h"
+
+#include <cerrno>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace wt {
+
+const char* load_error_name(LoadError err) {
+    switch (err) {
+        case LOAD_OK:           return "ok";
+        case LOAD_ERR_CONNECT:  return "connect";
+        case LOAD_ERR_TIMEOUT:  return "timeout";
+        case LOAD_ERR_CLOSED:   return "closed";
+        case LOAD_ERR_PARSE:    return "parse";
+        default:                return "?";
+    }
+}
+
+uint64_t load_now_ns() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+LoadClient::LoadClient(EventLoop& loop, const SockAddr& addr, bool keep_alive, uint32_t timeout_ms,
+                       DoneHandler done)
+    : loop_(loop), addr_(addr), keep_alive_(keep_alive), timeout_ms_(timeout_ms), done_(std::move(done)) {}
+
+LoadClient::~LoadClient() {
+    if (deadline_ >= 0) loop_.cancel_timer(deadline_);
+    close_socket();
+}
+
+void LoadClient::send(LoadRequest req) {
+    req_ = std::move(req);
+    busy_ = true;
+    out_ = req_.wire;
+    parser_.reset();
+    deadline_ = loop_.add_timer(timeout_ms_, [this]() {
+        deadline_ = -1;
+        finish(LOAD_ERR_TIMEOUT);
+    }, false);
+
+    if (fd_ < 0) {
+        connect();
+    } else {
+        loop_.modify(fd_, EPOLLIN | EPOLLOUT);
+    }
+}
+
+void LoadClient::connect() {
+    std::string err;
+    fd_ = net_connect(addr_, &err);
+    if (fd_ < 0) {
+        finish(LOAD_ERR_CONNECT);
+        return;
+    }
+    connected_ = false;
+    loop_.add(fd_, EPOLLOUT, [this](uint32_t events) { on_socket(events); });
+}
+
+void LoadClient::close_socket() {
+    if (fd_ >= 0) {
+        loop_.remove(fd_);
+        close(fd_);
+        fd_ = -1;
+    }
+    connected_ = false;
+}
+
+void LoadClient::finish(LoadError err, HttpResponse* resp) {
+    if (deadline_ >= 0) {
+        loop_.cancel_timer(deadline_);
+        deadline_ = -1;
+    }
+    if (err != LOAD_OK) close_socket();
+    busy_ = false;
+
+    LoadResult result;
+    result.error = err;
+    if (resp != nullptr) {
+        result.status = resp->status;
+        result.etag = resp->header("etag");
+        if (req_.want_body) result.body = std::move(resp->body);
+    }
+    result.done_ns = load_now_ns();
+    LoadRequest req = std::move(req_);
+    done_(*this, req, result);      // 回调中可能立即发送下一个请求
+}
+
+void LoadClient::on_socket(uint32_t events) {
+    if (!connected_) {
+        if (net_connect_result(fd_) != 0) {
+            finish(LOAD_ERR_CONNECT);
+            return;
+        }
+        connected_ = true;
+        connects_++;
+    }
+
+    if (events & EPOLLOUT) {
+        while (!out_.empty()) {
+            ssize_t n = ::send(fd_, out_.data(), out_.size(), MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+                finish(LOAD_ERR_CLOSED);
+                return;
+            }
+            out_.erase(0, (size_t)n);
+        }
+        if (out_.empty()) loop_.modify(fd_, EPOLLIN);
+    }
+
+    if (events & (EPOLLIN | EPOLLHUP | EPOLLERR)) on_readable();
+}
+
+void LoadClient::on_readable() {
+    char buf[16384];
+
+    while (fd_ >= 0) {
+        ssize_t n = ::recv(fd_, buf, sizeof(buf), 0);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return;
+            if (busy_) finish(LOAD_ERR_CLOSED);
+            else close_socket();
+            return;
+        }
+
+        if (n == 0) {
+            // 对端关闭: 读到关闭的响应在此完成；空闲长连接被服务端关闭时下次重连
+            if (busy_ && parser_.finish() == HttpResponseParser::DONE) {
+                close_socket();
+                finish(LOAD_OK, &parser_.response());
+            } else if (busy_) {
+                finish(LOAD_ERR_CLOSED);
+            } else {
+                close_socket();
+            }
+            return;
+        }
+
+        if (!busy_) {
+            close_socket();     // 没有请求时不应收到数据
+            return;
+        }
+
+        size_t consumed = 0;
+        HttpResponseParser::Result r = parser_.feed(buf, (size_t)n, &consumed);
+        if (r == HttpResponseParser::ERROR) {
+            finish(LOAD_ERR_PARSE);
+            return;
+        }
+        if (r == HttpResponseParser::DONE) {
+            if (!keep_alive_ || !parser_.response().keep_alive) close_socket();
+            finish(LOAD_OK, &parser_.response());
+            return;
+        }
+    }
+}
+
+}  // namespace wt
@@ -0,0 +1,98 @@
+/*
+ * 压测连接
+ *
+ * 每个连接同一时刻只有一个请求在途 (ESP8266WebServer 逐个处理请求，流水线没有意义)。
+ * 长连接模式下复用套接字；短连接模式每个请求新建连接并发送 Connection: close，
+ * 延迟包含建立连接的时间。所有 I/O 在事件循环线程中完成。
+ */
+
+#ifndef WT_LOAD_CLIENT_H
+#define WT_LOAD_CLIENT_H
+
+#include "event_loop.h"
+#include "http.h"
+#include "net.h"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace wt {
+
+// 失败类型
+enum LoadError {
+    LOAD_OK = 0,
+    LOAD_ERR_CONNECT,       // 连接失败
+    LOAD_ERR_TIMEOUT,       // 超时
+    LOAD_ERR_CLOSED,        // 响应完成前连接断开
+    LOAD_ERR_PARSE,         // 响应格式错误
+    LOAD_ERR_COUNT
+};
+
+const char* load_error_name(LoadError err);
+
+struct LoadRequest {
+    int endpoint = 0;           // 接口编号 (由调用方定义)
+    uint64_t intended_ns = 0;   // 计划发送时刻 (开环模式下排队时间也计入延迟)
+    std::string wire;           // 完整请求报文 (短连接模式需带 Connection: close)
+    bool want_body = false;     // 结果中带回响应体
+};
+
+struct LoadResult {
+    LoadError error = LOAD_OK;
+    int status = 0;
+    std::string etag;
+    std::string body;           // 仅 want_body 时有效
+    uint64_t done_ns = 0;
+};
+
+class LoadClient {
+public:
+    using DoneHandler = std::function<void(LoadClient& client, const LoadRequest& req, const LoadResult& result)>;
+
+    LoadClient(EventLoop& loop, const SockAddr& addr, bool keep_alive, uint32_t timeout_ms, DoneHandler done);
+    ~LoadClient();
+
+    LoadClient(const LoadClient&) = delete;
+    LoadClient& operator=(const LoadClient&) = delete;
+
+    bool busy() const { return busy_; }
+
+    /**
+     * 发送请求 (必须空闲)，完成或失败时回调 DoneHandler
+     */
+    void send(LoadRequest req);
+
+    uint64_t connects() const { return connects_; }
+
+private:
+    void connect();
+    void on_socket(uint32_t events);
+    void on_readable();
+    void finish(LoadError err, HttpResponse* resp = nullptr);
+    void close_socket();
+
+    EventLoop& loop_;
+    SockAddr addr_;
+    bool keep_alive_;
+    uint32_t timeout_ms_;
+    DoneHandler done_;
+
+    int fd_ = -1;
+    bool connected_ = false;
+    bool busy_ = false;
+    int deadline_ = -1;
+    std::string out_;
+    HttpResponseParser parser_;
+    LoadRequest req_;
+    uint64_t connects_ = 0;
+};
+
+/**
+ * 单调时钟 (纳秒)
+ */
+uint64_t load_now_ns();
+
+}  // namespace wt
+
+#endif  // WT_LOAD_CLIENT_H
@@ -0,0 +1,514 @@
+/*
+ * wt-loadgen: 主机 REST 接口压测工具
+ *
+ * 按比例混合 /api/status、/api/towers、/api/pump 请求，给出吞吐、延迟百分位和错误率。
+ * 目标可以是 ESP8266 主机 (端口 80) 或 wt-master。
+ *
+ * 用法:
+ *   wt-loadgen [--target HOST:PORT] [--mix status=80,towers=20,pump=0] [--pump-ids A-B]
+ *              [--connections N] [--rate R [--poisson]] [--duration S] [--warmup S]
+ *              [--no-keepalive] [--etag] [--timeout-ms N] [--seed N]
+ *              [--probe trace|stats[:PATH]] [--probe-ms N] [-v]...
+ *
+ * 两种模式:
+ * - 闭环 (默认): 每个连接收到响应后立即发下一个请求，测最大吞吐
+ * - 开环 (--rate): 按固定速率 (--poisson 为泊松到达) 产生请求，与响应快慢无关；
+ *   没有空闲连接时排队，延迟从计划发送时刻算起，包含排队时间
+ *   (闭环测试在服务变慢时自动少发请求，会掩盖尾延迟)
+ *
+ * pump 请求会真实切换水泵 (在 --pump-ids 范围内轮流开、关)，只应对模拟继电器或断开负载的主机使用。
+ */
+
+#include "event_loop.h"
+#include "histogram.h"
+#include "http.h"
+#include "load_client.h"
+#include "log.h"
+#include "net.h"
+#include "probe.h"
+
+#include <algorithm>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <random>
+#include <string>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace wt;
+
+namespace {
+
+// 开环调度与阶段检查周期
+#define TICK_MS                 1
+
+// 逐秒输出周期
+#define REPORT_MS               1000
+
+// 连接失败后该连接暂停的时间 (避免对拒绝连接的目标空转)
+#define CONNECT_RETRY_MS        100
+
+enum Endpoint {
+    EP_STATUS = 0,
+    EP_TOWERS,
+    EP_PUMP,
+    EP_COUNT
+};
+
+const char* const endpoint_names[EP_COUNT] = {"status", "towers", "pump"};
+
+struct EndpointStats {
+    LatencyHistogram latency;       // 微秒
+    uint64_t errors[LOAD_ERR_COUNT] = {};
+    uint64_t status_2xx = 0;
+    uint64_t status_304 = 0;
+    uint64_t status_4xx = 0;
+    uint64_t status_5xx = 0;
+
+    uint64_t failed() const {
+        uint64_t n = status_4xx + status_5xx;
+        for (int i = LOAD_OK + 1; i < LOAD_ERR_COUNT; i++) n += errors[i];
+        return n;
+    }
+
+    void merge(const EndpointStats& other) {
+        latency.merge(other.latency);
+        for (int i = 0; i < LOAD_ERR_COUNT; i++) errors[i] += other.errors[i];
+        status_2xx += other.status_2xx;
+        status_304 += other.status_304;
+        status_4xx += other.status_4xx;
+        status_5xx += other.status_5xx;
+    }
+};
+
+// 开环模式下等待空闲连接的请求
+struct Pending {
+    int endpoint;
+    uint64_t intended_ns;
+};
+
+void usage(const char* prog) {
+    fprintf(stderr,
+            "用法: %s [--target HOST:PORT] [--mix status=80,towers=20,pump=0] [--pump-ids A-B]\n"
+            "          [--connections N] [--rate R [--poisson]] [--duration S] [--warmup S]\n"
+            "          [--no-keepalive] [--etag] [--timeout-ms N] [--seed N]\n"
+            "          [--probe trace|stats[:PATH]] [--probe-ms N] [-v]...\n",
+            prog);
+}
+
+/**
+ * 解析 "status=80,towers=20,pump=0"
+ */
+bool parse_mix(const std::string& text, uint32_t* weights) {
+    for (int i = 0; i < EP_COUNT; i++) weights[i] = 0;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t comma = text.find(',', pos);
+        if (comma == std::string::npos) comma = text.size();
+        std::string item = text.substr(pos, comma - pos);
+        pos = comma + 1;
+
+        size_t eq = item.find('=');
+        if (eq == std::string::npos) return false;
+        std::string name = item.substr(0, eq);
+        char* end;
+        unsigned long weight = strtoul(item.c_str() + eq + 1, &end, 10);
+        if (end == item.c_str() + eq + 1 || *end != '\0') return false;
+
+        int ep = -1;
+        for (int i = 0; i < EP_COUNT; i++) {
+            if (name == endpoint_names[i]) ep = i;
+        }
+        if (ep < 0) return false;
+        weights[ep] = (uint32_t)weight;
+    }
+    uint64_t total = 0;
+    for (int i = 0; i < EP_COUNT; i++) total += weights[i];
+    return total > 0;
+}
+
+/**
+ * 解析 "A-B" 或 "A"
+ */
+bool parse_range(const std::string& text, uint32_t* first, uint32_t* last) {
+    char* end;
+    *first = (uint32_t)strtoul(text.c_str(), &end, 10);
+    if (end == text.c_str()) return false;
+    if (*end == '\0') {
+        *last = *first;
+        return true;
+    }
+    if (*end != '-') return false;
+    const char* p = end + 1;
+    *last = (uint32_t)strtoul(p, &end, 10);
+    return end != p && *end == '\0' && *last >= *first && *last <= 0xFFFF;
+}
+
+double ms(uint64_t us) {
+    return us / 1000.0;
+}
+
+void print_row(const char* name, const EndpointStats& s, double seconds) {
+    const LatencyHistogram& h = s.latency;
+    uint64_t total = h.count();
+    double fail = total ? 100.0 * s.failed() / total : 0;
+    printf("%-8s %9llu %9.1f %8.2f %8.2f %8.2f %8.2f %8llu %7llu %6llu %6llu %7.2f%%\n", name,
+           (unsigned long long)total, total / seconds, ms(h.percentile(50)), ms(h.percentile(99)),
+           ms(h.percentile(99.9)), ms(h.max()), (unsigned long long)s.status_2xx, (unsigned long long)s.status_304,
+           (unsigned long long)s.status_4xx, (unsigned long long)s.status_5xx, fail);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::string target = "127.0.0.1:8081";
+    std::string mix = "status=80,towers=20";
+    std::string pump_ids = "0";
+    uint32_t connections = 4;
+    double rate = 0;
+    bool poisson = false;
+    double duration_s = 10;
+    double warmup_s = 0;
+    bool keep_alive = true;
+    bool use_etag = false;
+    uint32_t timeout_ms = 2000;
+    uint64_t seed = 1;
+    std::string probe_spec;
+    uint32_t probe_ms = 1000;
+    int verbosity = LOG_LEVEL_INFO;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--target" && has_value) {
+            target = argv[++i];
+        } else if (arg == "--mix" && has_value) {
+            mix = argv[++i];
+        } else if (arg == "--pump-ids" && has_value) {
+            pump_ids = argv[++i];
+        } else if (arg == "--connections" && has_value) {
+            connections = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--rate" && has_value) {
+            rate = strtod(argv[++i], nullptr);
+        } else if (arg == "--poisson") {
+            poisson = true;
+        } else if (arg == "--duration" && has_value) {
+            duration_s = strtod(argv[++i], nullptr);
+        } else if (arg == "--warmup" && has_value) {
+            warmup_s = strtod(argv[++i], nullptr);
+        } else if (arg == "--no-keepalive") {
+            keep_alive = false;
+        } else if (arg == "--etag") {
+            use_etag = true;
+        } else if (arg == "--timeout-ms" && has_value) {
+            timeout_ms = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--seed" && has_value) {
+            seed = strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--probe" && has_value) {
+            probe_spec = argv[++i];
+        } else if (arg == "--probe-ms" && has_value) {
+            probe_ms = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "-v") {
+            verbosity++;
+        } else if (arg == "-q") {
+            verbosity = LOG_LEVEL_WARN;
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    log_set_level(verbosity);
+
+    uint32_t weights[EP_COUNT];
+    uint32_t pump_first, pump_last;
+    if (!parse_mix(mix, weights)) {
+        fprintf(stderr, "无效的 --mix: %s\n", mix.c_str());
+        return 2;
+    }
+    if (!parse_range(pump_ids, &pump_first, &pump_last)) {
+        fprintf(stderr, "无效的 --pump-ids: %s\n", pump_ids.c_str());
+        return 2;
+    }
+    if (connections == 0 || rate < 0 || duration_s <= 0 || warmup_s < 0 || timeout_ms == 0 || probe_ms == 0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    ProbeKind probe_kind = PROBE_NONE;
+    std::string probe_path;
+    if (!probe_spec.empty()) {
+        std::string kind = probe_spec.substr(0, probe_spec.find(':'));
+        if (probe_spec.size() > kind.size()) probe_path = probe_spec.substr(kind.size() + 1);
+        if (kind == "trace") probe_kind = PROBE_TRACE;
+        else if (kind == "stats") probe_kind = PROBE_STATS;
+        else {
+            fprintf(stderr, "无效的 --probe: %s\n", probe_spec.c_str());
+            return 2;
+        }
+    }
+
+    std::string host;
+    uint16_t port;
+    if (!net_split_host_port(target, &host, &port, 80)) {
+        fprintf(stderr, "无效的 --target: %s\n", target.c_str());
+        return 2;
+    }
+    SockAddr addr;
+    std::string err;
+    if (!net_resolve(host, port, &addr, &err)) {
+        LOG_E("%s", err.c_str());
+        return 1;
+    }
+    std::string host_header = port == 80 ? host : host + ":" + std::to_string(port);
+
+    if (weights[EP_PUMP] > 0) {
+        LOG_W("pump 请求会真实切换水泵 %u-%u", pump_first, pump_last);
+    }
+
+    // 信号改由事件循环处理 (提前结束时照常输出报告)
+    sigset_t mask;
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGINT);
+    sigaddset(&mask, SIGTERM);
+    sigprocmask(SIG_BLOCK, &mask, nullptr);
+    signal(SIGPIPE, SIG_IGN);
+
+    EventLoop loop;
+
+    // ==================== 请求生成 ====================
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<uint32_t> pick(0, weights[EP_STATUS] + weights[EP_TOWERS] + weights[EP_PUMP] - 1);
+    std::exponential_distribution<double> gap(rate > 0 ? rate : 1);
+    std::string etags[EP_COUNT];
+    std::vector<bool> pump_on(pump_last - pump_first + 1, false);
+    uint32_t pump_next = 0;
+
+    auto pick_endpoint = [&]() {
+        uint32_t r = pick(rng);
+        int ep = 0;
+        while (r >= weights[ep]) r -= weights[ep++];
+        return ep;
+    };
+
+    auto build = [&](int ep, uint64_t intended_ns) {
+        LoadRequest req;
+        req.endpoint = ep;
+        req.intended_ns = intended_ns;
+        HttpHeaderList headers;
+        if (!keep_alive) headers.emplace_back("Connection", "close");
+        if (ep == EP_PUMP) {
+            uint32_t index = pump_next;
+            pump_next = (pump_next + 1) % (uint32_t)pump_on.size();
+            pump_on[index] = !pump_on[index];
+            headers.emplace_back("Content-Type", "application/x-www-form-urlencoded");
+            std::string body = "id=" + std::to_string(pump_first + index) + "&action=" + (pump_on[index] ? "on" : "off");
+            req.wire = http_format_request("POST", host_header, "/api/pump", headers, body);
+        } else {
+            if (use_etag && !etags[ep].empty()) headers.emplace_back("If-None-Match", etags[ep]);
+            req.wire = http_format_request("GET", host_header, ep == EP_STATUS ? "/api/status" : "/api/towers", headers);
+        }
+        return req;
+    };
+
+    // ==================== 运行状态 ====================
+    const bool open_loop = rate > 0;
+    const uint64_t start_ns = load_now_ns();
+    const uint64_t measure_ns = start_ns + (uint64_t)(warmup_s * 1e9);
+    uint64_t end_ns = measure_ns + (uint64_t)(duration_s * 1e9);
+    uint64_t next_arrival_ns = start_ns;
+    bool producing = true;
+    bool measuring = false;
+    bool finishing = false;
+
+    std::vector<std::unique_ptr<LoadClient>> clients;
+    std::vector<LoadClient*> idle;
+    std::deque<Pending> backlog;
+    uint64_t in_flight = 0;
+    size_t max_backlog = 0;
+    uint64_t unsent = 0;
+
+    EndpointStats stats[EP_COUNT];
+    LatencyHistogram window;            // 逐秒窗口 (含预热)
+    uint64_t window_errors = 0;
+
+    std::unique_ptr<Probe> probe;
+    if (probe_kind != PROBE_NONE) {
+        probe.reset(new Probe(loop, addr, host_header, probe_kind, probe_path, timeout_ms));
+    }
+
+    auto maybe_finish = [&]() {
+        if (producing || in_flight > 0 || finishing) return;
+        finishing = true;
+        if (probe) probe->finish([&loop]() { loop.stop(); });
+        else loop.stop();
+    };
+
+    auto send = [&](LoadClient& client, LoadRequest req) {
+        in_flight++;
+        client.send(std::move(req));      // 连接失败时在此同步回调
+    };
+
+    // 连接空闲：闭环模式立即发下一个，开环模式取排队的请求
+    std::function<void(LoadClient&)> dispatch = [&](LoadClient& client) {
+        if (!producing) {
+            idle.push_back(&client);
+            maybe_finish();
+            return;
+        }
+        if (!open_loop) {
+            send(client, build(pick_endpoint(), load_now_ns()));
+        } else if (!backlog.empty()) {
+            Pending p = backlog.front();
+            backlog.pop_front();
+            send(client, build(p.endpoint, p.intended_ns));
+        } else {
+            idle.push_back(&client);
+        }
+    };
+
+    auto on_done = [&](LoadClient& client, const LoadRequest& req, const LoadResult& result) {
+        in_flight--;
+        uint64_t us = (result.done_ns - req.intended_ns) / 1000;
+        bool failed = result.error != LOAD_OK || result.status >= 400;
+        window.record(us);
+        if (failed) window_errors++;
+
+        if (req.intended_ns >= measure_ns) {
+            EndpointStats& s = stats[req.endpoint];
+            s.latency.record(us);
+            s.errors[result.error]++;
+            if (result.error == LOAD_OK) {
+                if (result.status == 304) s.status_304++;
+                else if (result.status >= 500) s.status_5xx++;
+                else if (result.status >= 400) s.status_4xx++;
+                else if (result.status >= 200 && result.status < 300) s.status_2xx++;
+            }
+        }
+        if (result.error == LOAD_OK && !result.etag.empty()) etags[req.endpoint] = result.etag;
+
+        if (result.error == LOAD_ERR_CONNECT) {
+            LoadClient* c = &client;
+            loop.add_timer(CONNECT_RETRY_MS, [&dispatch, c]() { dispatch(*c); }, false);
+            return;
+        }
+        dispatch(client);
+    };
+
+    for (uint32_t i = 0; i < connections; i++) {
+        clients.emplace_back(new LoadClient(loop, addr, keep_alive, timeout_ms, on_done));
+    }
+
+    auto stop_producing = [&]() {
+        if (!producing) return;
+        producing = false;
+        unsent = backlog.size();
+        backlog.clear();
+        maybe_finish();
+    };
+
+    // ==================== 调度 ====================
+    loop.add_timer(TICK_MS, [&]() {
+        uint64_t now = load_now_ns();
+        if (!measuring && now >= measure_ns) {
+            measuring = true;
+            if (probe) probe->begin();
+        }
+        if (now >= end_ns) {
+            stop_producing();
+            return;
+        }
+        if (!open_loop) return;
+
+        while (next_arrival_ns <= now) {
+            backlog.push_back({pick_endpoint(), next_arrival_ns});
+            next_arrival_ns += (uint64_t)((poisson ? gap(rng) : 1.0 / rate) * 1e9);
+        }
+        max_backlog = std::max(max_backlog, backlog.size());
+        while (!idle.empty() && !backlog.empty()) {
+            LoadClient* client = idle.back();
+            idle.pop_back();
+            dispatch(*client);
+        }
+    });
+
+    if (probe) {
+        loop.add_timer(probe_ms, [&]() {
+            if (producing) probe->poll();
+        });
+    }
+
+    printf("目标 %s，%s，%u 个连接，%s，%.0f 秒 (预热 %.0f 秒)\n", target.c_str(),
+           open_loop ? (poisson ? "开环泊松到达" : "开环定速") : "闭环", connections, keep_alive ? "长连接" : "短连接",
+           duration_s, warmup_s);
+    if (open_loop) printf("目标速率 %.1f 请求/秒\n", rate);
+    printf("%6s %9s %9s %9s %7s %7s  %s\n", "秒", "rps", "p50(ms)", "p99(ms)", "错误", "排队",
+           probe ? "主机" : "");
+
+    uint64_t last_report_ns = start_ns;
+    loop.add_timer(REPORT_MS, [&]() {
+        uint64_t now = load_now_ns();
+        double seconds = (now - last_report_ns) / 1e9;
+        last_report_ns = now;
+        std::string probe_text = probe ? probe->window_text() : "";
+        printf("%5.0f%s %9.1f %9.2f %9.2f %7llu %7zu  %s\n", (now - start_ns) / 1e9, now < measure_ns ? "*" : " ",
+               window.count() / seconds, ms(window.percentile(50)), ms(window.percentile(99)),
+               (unsigned long long)window_errors, backlog.size(), probe_text.c_str());
+        fflush(stdout);
+        window.reset();
+        window_errors = 0;
+    });
+
+    int sigfd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+    loop.add(sigfd, EPOLLIN, [&](uint32_t) {
+        signalfd_siginfo info;
+        if (read(sigfd, &info, sizeof(info)) == sizeof(info)) {
+            if (finishing) {
+                loop.stop();
+                return;
+            }
+            end_ns = std::max(std::min(end_ns, load_now_ns()), measure_ns);
+            stop_producing();
+        }
+    });
+
+    // 开始：闭环模式每个连接发第一个请求，开环模式全部空闲
+    for (auto& client : clients) {
+        if (open_loop) idle.push_back(client.get());
+        else dispatch(*client);
+    }
+    loop.run();
+
+    // ==================== 报告 ====================
+    double seconds = std::max((double)(end_ns - measure_ns) / 1e9, 1e-3);
+    printf("\n%-8s %9s %9s %8s %8s %8s %8s %8s %7s %6s %6s %8s\n", "接口", "请求", "rps", "p50", "p99", "p999",
+           "max(ms)", "2xx", "304", "4xx", "5xx", "失败率");
+    EndpointStats total;
+    for (int ep = 0; ep < EP_COUNT; ep++) {
+        if (weights[ep] == 0) continue;
+        print_row(endpoint_names[ep], stats[ep], seconds);
+        total.merge(stats[ep]);
+    }
+    print_row("全部", total, seconds);
+
+    printf("\n传输错误:");
+    for (int i = LOAD_OK + 1; i < LOAD_ERR_COUNT; i++) {
+        printf(" %s %llu", load_error_name((LoadError)i), (unsigned long long)total.errors[i]);
+    }
+    uint64_t connects = 0;
+    for (auto& client : clients) connects += client->connects();
+    printf("\n建立连接 %llu 次\n", (unsigned long long)connects);
+    if (open_loop) {
+        printf("最大排队 %zu，结束时未发送 %llu\n", max_backlog, (unsigned long long)unsent);
+    }
+    if (probe) probe->report(stdout);
+
+    loop.remove(sigfd);
+    close(sigfd);
+    return total.failed() > 0 ? 1 : 0;
+}
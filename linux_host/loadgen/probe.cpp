@@ -0,0 +1,177 @@
+/*
+ * 主机侧延迟探针实现
+ */
+
+#include "probe.h"
+
+#include "log.h"
+
+#include <vector>
+
+namespace wt {
+
+Probe::Probe(EventLoop& loop, const SockAddr& addr, const std::string& host, ProbeKind kind, const std::string& path,
+             uint32_t timeout_ms)
+    : kind_(kind) {
+    std::string target = path;
+    if (target.empty()) target = kind == PROBE_TRACE ? "/api/trace" : "/api/stats";
+    target += target.find('?') == std::string::npos ? "?reset=1" : "&reset=1";
+    wire_ = http_format_request("GET", host, target);
+
+    client_.reset(new LoadClient(loop, addr, true, timeout_ms,
+                                 [this](LoadClient&, const LoadRequest&, const LoadResult& result) {
+                                     on_result(result);
+                                 }));
+}
+
+void Probe::poll() {
+    if (client_->busy()) {
+        skipped_++;
+        return;
+    }
+    LoadRequest req;
+    req.wire = wire_;
+    req.want_body = true;
+    client_->send(std::move(req));
+}
+
+void Probe::begin() {
+    measuring_ = true;
+    baseline_pending_ = true;
+    spans_.clear();
+    window_loop_.reset();
+    dropped_ = 0;
+    unmatched_ = 0;
+    worst_p99_ = 0;
+    worst_max_ = 0;
+}
+
+void Probe::finish(std::function<void()> done) {
+    done_ = std::move(done);
+    if (!client_->busy()) poll();       // 否则等在途的那次完成
+}
+
+void Probe::on_result(const LoadResult& result) {
+    if (result.error != LOAD_OK || result.status != 200) {
+        if (failures_++ == 0) {
+            if (result.error != LOAD_OK) LOG_W("探针读取失败: %s", load_error_name(result.error));
+            else LOG_W("探针读取失败: HTTP %d", result.status);
+        }
+    } else {
+        JsonValue doc;
+        std::string err;
+        if (!JsonValue::parse(result.body, &doc, &err)) {
+            if (failures_++ == 0) LOG_W("探针响应无法解析: %s", err.c_str());
+        } else {
+            fetches_++;
+            if (kind_ == PROBE_TRACE) parse_trace(doc);
+            else parse_stats(doc);
+        }
+    }
+
+    if (done_) {
+        auto done = std::move(done_);
+        done_ = nullptr;
+        done();
+    }
+}
+
+void Probe::parse_trace(const JsonValue& doc) {
+    // 每次读取后固件清空缓冲区，跨两次读取的区段起点已被清除，只能丢弃
+    std::map<std::string, std::vector<double>> open;
+    for (const JsonValue& ev : doc["traceEvents"].items()) {
+        const std::string& name = ev["name"].as_string();
+        const std::string& ph = ev["ph"].as_string();
+        double ts = ev["ts"].as_number();
+        if (ph == "B") {
+            open[name].push_back(ts);
+        } else if (ph == "E") {
+            std::vector<double>& stack = open[name];
+            if (stack.empty()) {
+                unmatched_++;
+                continue;
+            }
+            double us = ts - stack.back();
+            stack.pop_back();
+            uint64_t value = us > 0 ? (uint64_t)(us + 0.5) : 0;
+            if (name == "loop") window_loop_.record(value);
+            if (measuring_) spans_[name].record(value);
+        }
+    }
+    if (measuring_) dropped_ += (uint64_t)doc["otherData"]["dropped"].as_int();
+}
+
+void Probe::parse_stats(const JsonValue& doc) {
+    if (!doc["loop_lag_p99_us"].is_null()) {
+        window_valid_ = true;
+        window_p99_ = (uint64_t)doc["loop_lag_p99_us"].as_int();
+        window_max_ = (uint64_t)doc["loop_lag_max_us"].as_int();
+        if (measuring_ && !baseline_pending_) {
+            if (window_p99_ > worst_p99_) worst_p99_ = window_p99_;
+            if (window_max_ > worst_max_) worst_max_ = window_max_;
+        }
+    }
+    if (baseline_pending_) {
+        first_ = doc;
+        baseline_pending_ = false;
+    }
+    last_ = doc;
+}
+
+std::string Probe::window_text() {
+    char buf[64];
+    if (kind_ == PROBE_TRACE) {
+        if (window_loop_.count() == 0) return "-";
+        snprintf(buf, sizeof(buf), "loop p99 %lluus max %lluus",
+                 (unsigned long long)window_loop_.percentile(99), (unsigned long long)window_loop_.max());
+        window_loop_.reset();
+        return buf;
+    }
+    if (!window_valid_) return "-";
+    snprintf(buf, sizeof(buf), "lag p99 %lluus max %lluus", (unsigned long long)window_p99_,
+             (unsigned long long)window_max_);
+    window_valid_ = false;
+    return buf;
+}
+
+void Probe::report(FILE* out) const {
+    fprintf(out, "\n主机探针 (%s): 读取 %llu 次，失败 %llu，跳过 %llu\n", kind_ == PROBE_TRACE ? "trace" : "stats",
+            (unsigned long long)fetches_, (unsigned long long)failures_, (unsigned long long)skipped_);
+
+    if (kind_ == PROBE_TRACE) {
+        if (spans_.empty()) {
+            fprintf(out, "  没有区段数据 (固件需以 TRACE_ENABLE 编译)\n");
+            return;
+        }
+        fprintf(out, "  %-14s %10s %10s %10s %10s %10s\n", "区段", "次数", "p50(us)", "p99(us)", "max(us)",
+                "mean(us)");
+        for (const auto& kv : spans_) {
+            const LatencyHistogram& h = kv.second;
+            fprintf(out, "  %-14s %10llu %10llu %10llu %10llu %10.1f\n", kv.first.c_str(),
+                    (unsigned long long)h.count(), (unsigned long long)h.percentile(50),
+                    (unsigned long long)h.percentile(99), (unsigned long long)h.max(), h.mean());
+        }
+        fprintf(out, "  缓冲区覆盖丢弃 %llu 个事件，未配对结束 %llu 个\n", (unsigned long long)dropped_,
+                (unsigned long long)unmatched_);
+        return;
+    }
+
+    if (!first_.is_object() || !last_.is_object()) {
+        fprintf(out, "  没有数据\n");
+        return;
+    }
+    if (!last_["loop_lag_p99_us"].is_null()) {
+        fprintf(out, "  事件循环延迟: 各窗口 p99 最大 %lluus，最大 %lluus\n", (unsigned long long)worst_p99_,
+                (unsigned long long)worst_max_);
+    }
+    // 计数器增量 (只列出有变化的数值字段，loop_lag_* 为窗口值不做差)
+    for (const auto& kv : last_.members()) {
+        if (kv.second.type() != JsonValue::NUMBER || kv.first.compare(0, 9, "loop_lag_") == 0) continue;
+        const JsonValue& before = first_[kv.first];
+        if (before.type() != JsonValue::NUMBER) continue;
+        double delta = kv.second.as_number() - before.as_number();
+        if (delta != 0) fprintf(out, "  %-20s %+.0f\n", kv.first.c_str(), delta);
+    }
+}
+
+}  // namespace wt
@@ -0,0 +1,104 @@
+/*
+ * 主机侧延迟探针
+ *
+ * 压测期间用单独的连接定期读取主机自身的循环延迟数据，与客户端看到的延迟对照：
+ * - trace: ESP8266 固件 (TRACE_ENABLE 编译) 的 /api/trace?reset=1，
+ *          按区段 (loop、web、lora_rx ...) 统计 B/E 事件的持续时间
+ * - stats: wt-master 的 /api/stats?reset=1，取事件循环延迟 (loop_lag_*) 并
+ *          对比压测前后的计数器
+ *
+ * 探针请求本身也是负载 (固件导出追踪缓冲区要占用主循环)，间隔不宜过短。
+ */
+
+#ifndef WT_PROBE_H
+#define WT_PROBE_H
+
+#include "histogram.h"
+#include "json.h"
+#include "load_client.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+
+namespace wt {
+
+enum ProbeKind {
+    PROBE_NONE = 0,
+    PROBE_TRACE,
+    PROBE_STATS
+};
+
+class Probe {
+public:
+    /**
+     * @param path 接口路径 (空=按类型取默认值)
+     */
+    Probe(EventLoop& loop, const SockAddr& addr, const std::string& host, ProbeKind kind, const std::string& path,
+          uint32_t timeout_ms);
+
+    ProbeKind kind() const { return kind_; }
+
+    /**
+     * 发起一次读取 (上一次未完成时跳过)
+     */
+    void poll();
+
+    /**
+     * 开始正式统计 (丢弃预热阶段的数据)；stats 类型下一次读取作为基准
+     */
+    void begin();
+
+    /**
+     * 最后读取一次，完成后回调
+     */
+    void finish(std::function<void()> done);
+
+    /**
+     * 上次调用以来的窗口摘要 (逐秒输出的一列)，没有数据返回 "-"
+     */
+    std::string window_text();
+
+    /**
+     * 输出最终报告
+     */
+    void report(FILE* out) const;
+
+private:
+    void on_result(const LoadResult& result);
+    void parse_trace(const JsonValue& doc);
+    void parse_stats(const JsonValue& doc);
+
+    ProbeKind kind_;
+    std::string wire_;
+    std::unique_ptr<LoadClient> client_;
+    std::function<void()> done_;
+
+    bool measuring_ = false;
+    bool baseline_pending_ = false;
+    uint64_t fetches_ = 0;
+    uint64_t failures_ = 0;
+    uint64_t skipped_ = 0;
+
+    // trace: 区段持续时间 (微秒)
+    std::map<std::string, LatencyHistogram> spans_;
+    LatencyHistogram window_loop_;
+    uint64_t dropped_ = 0;
+    uint64_t unmatched_ = 0;
+
+    // stats
+    JsonValue first_;
+    JsonValue last_;
+    bool window_valid_ = false;
+    uint64_t window_p99_ = 0;
+    uint64_t window_max_ = 0;
+    uint64_t worst_p99_ = 0;
+    uint64_t worst_max_ = 0;
+};
+
+}  // namespace wt
+
+#endif  // WT_PROBE_H
@@ -0,0 +1,335 @@
+/*
+ * Linux 主机控制器实现
+ */
+
+#include "controller.h"
+
+#include "log.h"
+
+#include <cstdio>
+#include <cstring>
+
+namespace wt {
+
+// 下发查询后等待应答的时间 (此后收到的帧不再算作应答)
+#define QUERY_REPLY_MS      3000
+
+const MasterHooks_t MasterController::hooks_ = {
+    hook_relay_write,
+    hook_tower_changed,
+    nullptr,                // 状态变化随后都会 committed
+    hook_committed,
+    hook_alarm,
+};
+
+MasterController::MasterController(RelayBackend& relays)
+    : relays_(relays), towers_(MAX_TOWERS), query_state_(MAX_TOWERS), query_sent_(MAX_TOWERS) {
+    memset(&status_, 0, sizeof(status_));
+    memset(&core_, 0, sizeof(core_));
+    mesh_master_begin(&mesh_);
+    ota_master_begin(&ota_);
+}
+
+bool MasterController::start(SystemMode mode, std::string* err) {
+    if (relays_.count() > MAX_TOWERS) {
+        *err = "继电器路数超过 " + std::to_string(MAX_TOWERS);
+        return false;
+    }
+
+    status_.mode = mode;
+    status_.well_water_ok = true;
+
+    core_.towers = towers_.data();
+    core_.tower_count = &tower_count_;
+    core_.status = &status_;
+    core_.relay_count = relays_.count();
+    core_.hooks = &hooks_;
+    core_.ctx = this;
+    master_core_begin(&core_, nullptr);
+
+    if (!master_core_write_relays(&core_)) {
+        *err = "初始化继电器失败";
+        return false;
+    }
+    return true;
+}
+
+// ==================== 核心回调 ====================
+
+bool MasterController::hook_relay_write(void* ctx, const uint8_t* bits, uint16_t) {
+    auto* self = static_cast<MasterController*>(ctx);
+    std::string err;
+    self->stats_.relay_writes++;
+    if (!self->relays_.write(bits, &err)) {
+        self->stats_.relay_errors++;
+        LOG_E("继电器输出失败: %s", err.c_str());
+        return false;
+    }
+    return true;
+}
+
+void MasterController::hook_tower_changed(void* ctx, uint16_t index, uint8_t what) {
+    auto* self = static_cast<MasterController*>(ctx);
+    const TowerData& t = self->towers_[index];
+    if (what & MASTER_CHANGE_ADDED) LOG_I("新水塔 %u (索引 %u)", t.id, index);
+    if (what & MASTER_CHANGE_PUMP) {
+        self->stats_.switched++;
+        LOG_D("水塔 %u %s水泵 (水位 %u%%)", t.id, t.pump_on ? "开启" : "关闭", t.water_level);
+    }
+    if ((what & MASTER_CHANGE_ONLINE) && !t.online) {
+        self->stats_.offline++;
+        LOG_W("水塔 %u 离线", t.id);
+    }
+}
+
+void MasterController::hook_committed(void* ctx) {
+    static_cast<MasterController*>(ctx)->version_++;
+}
+
+void MasterController::hook_alarm(void* ctx, MasterAlarm_t alarm) {
+    auto* self = static_cast<MasterController*>(ctx);
+    if (alarm != MASTER_ALARM_WELL_LOW) return;
+
+    // 控制核心只在开始缺水时报警
+    self->stats_.well_alarms++;
+    LOG_W("井水缺水，紧急停止所有水泵");
+}
+
+// ==================== 操作 ====================
+
+void MasterController::handle_frames(const std::vector<RadioFrame>& frames, uint32_t now) {
+    for (const RadioFrame& f : frames) {
+        stats_.frames++;
+        if (ota_master_handle_frame(&ota_, f.data, f.len, now)) continue;
+        MasterFrameResult_t result = MASTER_FRAME_OK;
+        MeshRxResult_t rx = mesh_master_handle_frame(&mesh_, &core_, f.data, f.len, now, &result);
+        switch (rx) {
+            case MESH_RX_DIRECT:
+                break;
+            case MESH_RX_RELAYED:
+                stats_.relayed++;
+                break;
+            case MESH_RX_DUPLICATE:
+                stats_.duplicates++;
+                continue;
+            case MESH_RX_CONTROL:
+                stats_.mesh_control++;
+                continue;
+            case MESH_RX_BAD:
+                stats_.mesh_bad++;
+                continue;
+        }
+        switch (result) {
+            case MASTER_FRAME_OK:
+                on_tower_frame(rx == MESH_RX_RELAYED ? f.data[MESH_UP_ORIGIN] : f.data[0], now);
+                break;
+            case MASTER_FRAME_SHORT:
+                stats_.short_frames++;
+                break;
+            case MASTER_FRAME_IGNORED:
+                stats_.ignored++;
+                break;
+            case MASTER_FRAME_FULL:
+                if (stats_.table_full++ == 0) LOG_W("水塔表已满 (%d)，丢弃从机 %u", MAX_TOWERS, f.data[0]);
+                break;
+        }
+    }
+}
+
+bool MasterController::mesh_beacon(uint32_t now, RadioFrame* out) {
+    out->len = mesh_master_beacon(&mesh_, now, out->data);
+    return out->len > 0;
+}
+
+void MasterController::on_tower_frame(uint8_t id, uint32_t now) {
+    int idx = master_core_find(&core_, id);
+    if (idx < 0) return;
+
+    if (query_state_[idx] == QUERY_SENT) {
+        query_state_[idx] = QUERY_NONE;
+        if (now - query_sent_[idx] < QUERY_REPLY_MS) {
+            stats_.downlink_replies++;
+            LOG_I("水塔 %u 应答查询 (%u 个中继，往返 %u ms)", id, mesh_.routes[idx].hops, now - query_sent_[idx]);
+            return;
+        }
+    }
+    if (query_state_[idx] != QUERY_PENDING) return;
+
+    // 主机命令 [源地址][目标地址][命令][保留]，经中继时封装为 CMD_MESH_DOWN
+    const uint8_t cmd[] = {MESH_MASTER_ID, id, CMD_SENSOR_DATA, 0};
+    RadioFrame f;
+    f.len = mesh_master_wrap_command(&mesh_, (uint16_t)idx, cmd, sizeof(cmd), f.data);
+    if (f.len == 0) return;
+    downlink_.push_back(f);
+    query_state_[idx] = QUERY_SENT;
+    query_sent_[idx] = now;
+    stats_.downlinks++;
+}
+
+bool MasterController::query(uint8_t id) {
+    int idx = master_core_find(&core_, id);
+    if (idx < 0) return false;
+    query_state_[idx] = QUERY_PENDING;
+    return true;
+}
+
+bool MasterController::downlink_poll(RadioFrame* out) {
+    if (downlink_.empty()) return false;
+    *out = downlink_.front();
+    downlink_.pop_front();
+    return true;
+}
+
+bool MasterController::ota_start(std::string image, std::vector<uint8_t> ids, uint32_t now, std::string* err) {
+    if (ota_master_active(&ota_)) {
+        *err = "升级进行中";
+        return false;
+    }
+    if (image.empty() || image.size() > OTA_IMAGE_MAX) {
+        *err = "镜像长度须为 1-" + std::to_string(OTA_IMAGE_MAX) + " 字节";
+        return false;
+    }
+    if (ids.empty()) {
+        for (uint16_t i = 0; i < tower_count_; i++) {
+            if (towers_[i].online) ids.push_back(towers_[i].id);
+        }
+        if (ids.empty()) {
+            *err = "没有在线的水塔";
+            return false;
+        }
+    }
+
+    ota_image_ = std::move(image);
+    if (++ota_session_ == 0) ota_session_ = 1;     // 0 是从机上电后的会话号
+    if (!ota_master_start(&ota_, (const uint8_t*)ota_image_.data(), (uint16_t)ota_image_.size(), ids.data(),
+                          (uint16_t)ids.size(), ota_session_, now)) {
+        *err = "目标无效";
+        return false;
+    }
+    LOG_I("开始空中升级: 会话 %u，镜像 %zu 字节 (%u 片，CRC %04X)，%zu 个从机", ota_session_, ota_image_.size(),
+          ota_.chunks, ota_.crc, ids.size());
+    return true;
+}
+
+bool MasterController::ota_poll(uint32_t now, RadioFrame* out) {
+    bool was_active = ota_master_active(&ota_);
+    out->len = ota_master_poll(&ota_, now, out->data);
+    if (was_active && !ota_master_active(&ota_)) {
+        uint16_t activated = 0;
+        for (uint16_t i = 0; i < ota_.target_count; i++) {
+            if (ota_.targets[i].result == OTA_NODE_ACTIVATED) activated++;
+        }
+        LOG_I("空中升级结束: %u/%u 个从机已激活，%u 轮，发送分片 %u 个 (镜像 %u 片)", activated, ota_.target_count,
+              ota_.round, ota_.stats.data_frames, ota_.chunks);
+    }
+    return out->len > 0;
+}
+
+std::string MasterController::ota_json(uint32_t now) const {
+    const OtaStats_t& s = ota_.stats;
+    uint32_t end = ota_master_active(&ota_) ? now : s.finished_ms;
+    char buf[512];
+    snprintf(buf, sizeof(buf),
+             "{\"phase\":\"%s\",\"session\":%u,\"size\":%u,\"chunks\":%u,\"crc\":%u,\"round\":%u,"
+             "\"data_frames\":%u,\"data_bytes\":%u,\"retransmitted\":%u,\"control_frames\":%u,"
+             "\"replies\":%u,\"timeouts\":%u,\"elapsed_ms\":%u,\"data_ratio\":%.3f,\"targets\":[",
+             ota_phase_name(ota_.phase), ota_.session, ota_.size, ota_.chunks, ota_.crc, ota_.round,
+             s.data_frames, s.data_bytes, s.retransmitted, s.control_frames, s.replies, s.timeouts,
+             ota_.phase == OTA_PHASE_IDLE ? 0 : end - s.started_ms,
+             ota_.size ? (double)s.data_bytes / ota_.size : 0.0);
+    std::string out = buf;
+    for (uint16_t i = 0; i < ota_.target_count; i++) {
+        const OtaTarget_t& t = ota_.targets[i];
+        snprintf(buf, sizeof(buf), "%s{\"id\":%u,\"result\":\"%s\",\"state\":%u,\"missing\":%u}", i ? "," : "",
+                 t.id, ota_node_result_name(t.result), t.state, t.missing);
+        out += buf;
+    }
+    out += "]}";
+    return out;
+}
+
+void MasterController::run_auto() {
+    master_core_auto(&core_);
+}
+
+void MasterController::expire(uint32_t now, uint32_t timeout_ms) {
+    master_core_expire(&core_, now, timeout_ms);
+}
+
+bool MasterController::set_pump(uint16_t index, bool on) {
+    return master_core_set_pump(&core_, index, on);
+}
+
+uint16_t MasterController::apply(const uint8_t* set, const uint8_t* clear) {
+    return master_core_apply(&core_, set, clear, nullptr);
+}
+
+void MasterController::set_mode(SystemMode mode) {
+    master_core_set_mode(&core_, mode);
+}
+
+bool MasterController::pump_for_id(uint8_t id) const {
+    int idx = master_core_find(&core_, id);
+    return idx >= 0 && master_core_relay(&core_, (uint16_t)idx);
+}
+
+uint16_t MasterController::pump_count() const {
+    return tower_count_ < core_.relay_count ? tower_count_ : core_.relay_count;
+}
+
+// ==================== JSON 快照 ====================
+
+std::shared_ptr<const std::string> MasterController::status_json() {
+    if (status_version_ == version_ && status_body_) return status_body_;
+
+    char buf[256];
+    snprintf(buf, sizeof(buf), "{\"mode\":\"%s\",\"well_water\":%s,\"towers\":%u,\"relays\":%u}",
+             status_.mode == MODE_AUTO ? "AUTO" : "MANUAL", status_.well_water_ok ? "true" : "false",
+             tower_count_, core_.relay_count);
+    status_body_ = std::make_shared<const std::string>(buf);
+    status_version_ = version_;
+    return status_body_;
+}
+
+std::shared_ptr<const std::string> MasterController::towers_json() {
+    if (towers_version_ == version_ && towers_body_) return towers_body_;
+
+    towers_body_ = std::make_shared<const std::string>(towers_json_build(towers_.data(), tower_count_));
+    towers_version_ = version_;
+    return towers_body_;
+}
+
+std::string towers_json_build(const TowerData* towers, uint16_t count) {
+    std::string out;
+    out.reserve(count * 56 + 2);
+    out.push_back('[');
+    char buf[96];
+    for (uint16_t i = 0; i < count; i++) {
+        const TowerData& t = towers[i];
+        int n = snprintf(buf, sizeof(buf), "%s{\"id\":%u,\"level\":%u,\"pump\":%s,\"online\":%s", i ? "," : "",
+                         t.id, t.water_level, t.pump_on ? "true" : "false", t.online ? "true" : "false");
+        out.append(buf, n);
+
+        // 最近一次上报的采样窗口 (旧格式的从机没有)
+        const TowerWindow& w = t.window;
+        if (w.samples) {
+            n = snprintf(buf, sizeof(buf), ",\"window\":{\"samples\":%u,\"min\":%u,\"max\":%u,\"changes\":%u",
+                         w.samples, w.level_min, w.level_max, w.changes);
+            out.append(buf, n);
+            if (w.channel_count) {
+                out += ",\"channels\":[";
+                for (uint8_t k = 0; k < w.channel_count; k++) {
+                    if (k) out.push_back(',');
+                    out += std::to_string(w.channels[k]);
+                }
+                out.push_back(']');
+            }
+            out.push_back('}');
+        }
+        out.push_back('}');
+    }
+    out.push_back(']');
+    return out;
+}
+
+}  // namespace wt
@@ -0,0 +1,195 @@
+/*
+ * Linux 主机控制器
+ *
+ * 包装与 ESP8266 固件共用的控制核心 (esp8266_master/src/master_core.h)：
+ * 水塔表、帧处理、自动控制和继电器映像都在核心中，这里只提供继电器输出、
+ * 变化计数 (REST 快照版本) 和统计。收到的帧先经中继网络主机端 (mesh_master.h)
+ * 拆出经中继转发的上报帧，下发给从机的命令按该从机的路由封装；从机空中升级
+ * (ota_master.h) 的会话也在这里，升级应答不交给核心。只在事件循环线程中使用。
+ */
+
+#ifndef WT_CONTROLLER_H
+#define WT_CONTROLLER_H
+
+#include "master_core.h"
+#include "mesh_master.h"
+#include "ota_master.h"
+#include "radio.h"
+#include "relay.h"
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace wt {
+
+struct ControllerStats {
+    uint64_t frames = 0;            // 交给核心处理的帧
+    uint64_t ignored = 0;           // 非数据帧
+    uint64_t relayed = 0;           // 经中继转发的帧
+    uint64_t duplicates = 0;        // 经另一条中继路径重复收到
+    uint64_t mesh_control = 0;      // 中继的路由通告等
+    uint64_t mesh_bad = 0;          // 格式错误的中继帧
+    uint64_t short_frames = 0;      // 长度不足
+    uint64_t table_full = 0;        // 水塔表已满被丢弃
+    uint64_t offline = 0;           // 超时离线次数
+    uint64_t switched = 0;          // 水泵切换次数
+    uint64_t relay_writes = 0;
+    uint64_t relay_errors = 0;
+    uint64_t well_alarms = 0;
+    uint64_t downlinks = 0;         // 下发的查询命令
+    uint64_t downlink_replies = 0;  // 从机按查询立即上报
+};
+
+class MasterController {
+public:
+    explicit MasterController(RelayBackend& relays);
+
+    MasterController(const MasterController&) = delete;
+    MasterController& operator=(const MasterController&) = delete;
+
+    /**
+     * 初始化核心并输出初始继电器状态 (全部关闭)
+     */
+    bool start(SystemMode mode, std::string* err);
+
+    /**
+     * 处理一批接收到的帧
+     * @param now 单调时钟 (毫秒)
+     */
+    void handle_frames(const std::vector<RadioFrame>& frames, uint32_t now);
+
+    /**
+     * 到期时组装中继网络的路由通告 (由调用方发送)
+     * @return false=未到期
+     */
+    bool mesh_beacon(uint32_t now, RadioFrame* out);
+
+    /**
+     * 请求从机立即上报 (CMD_SENSOR_DATA，从机按 CMD_READ_SENSOR 处理)
+     * 电池节点只在上报后的短暂窗口内接收，命令在收到该从机的下一帧后按其路由
+     * (直连或经中继，mesh_master_wrap_command) 下发
+     * @return false=水塔表中没有该地址
+     */
+    bool query(uint8_t id);
+
+    /**
+     * 取出待下发的命令帧 (由调用方在 handle_frames() 之后立即发送)
+     * @return false=没有
+     */
+    bool downlink_poll(RadioFrame* out);
+
+    /**
+     * 开始从机空中升级
+     * @param ids 目标从机地址，空=水塔表中的全部在线水塔
+     * @return false=升级进行中、镜像或目标无效 (err 中为原因)
+     */
+    bool ota_start(std::string image, std::vector<uint8_t> ids, uint32_t now, std::string* err);
+
+    /**
+     * 取出升级会话现在要发送的帧 (由调用方发送，每次最多一帧)
+     * @return false=没有
+     */
+    bool ota_poll(uint32_t now, RadioFrame* out);
+
+    bool ota_active() const { return ota_master_active(&ota_); }
+
+    /**
+     * 升级会话的进度 JSON (GET /api/ota)
+     */
+    std::string ota_json(uint32_t now) const;
+
+    /**
+     * 自动控制一轮
+     */
+    void run_auto();
+
+    /**
+     * 超时离线检查
+     */
+    void expire(uint32_t now, uint32_t timeout_ms);
+
+    /**
+     * 控制单个水泵
+     * @return false=索引无效
+     */
+    bool set_pump(uint16_t index, bool on);
+
+    /**
+     * 批量控制水泵 (位图各 MASTER_RELAY_BYTES 字节)
+     * @return 实际切换的数量
+     */
+    uint16_t apply(const uint8_t* set, const uint8_t* clear);
+
+    void set_mode(SystemMode mode);
+
+    /**
+     * 从机地址对应的水泵状态 (模拟从机用)
+     */
+    bool pump_for_id(uint8_t id) const;
+
+    uint16_t tower_count() const { return tower_count_; }
+    uint16_t pump_count() const;
+    const SystemStatus& status() const { return status_; }
+
+    /**
+     * 状态版本，每批变化加 1
+     */
+    uint64_t version() const { return version_; }
+
+    /**
+     * JSON 快照 (格式与 ESP8266 主机 /api/status、/api/towers 相同)，按版本缓存
+     */
+    std::shared_ptr<const std::string> status_json();
+    std::shared_ptr<const std::string> towers_json();
+
+    const ControllerStats& stats() const { return stats_; }
+    const MeshStats_t& mesh_stats() const { return mesh_.stats; }
+
+private:
+    static bool hook_relay_write(void* ctx, const uint8_t* bits, uint16_t count);
+    static void hook_tower_changed(void* ctx, uint16_t index, uint8_t what);
+    static void hook_committed(void* ctx);
+    static void hook_alarm(void* ctx, MasterAlarm_t alarm);
+
+    static const MasterHooks_t hooks_;
+
+    /**
+     * 收到从机 id 的一帧: 有待下发的查询时封装入队，已下发的查询记为应答
+     */
+    void on_tower_frame(uint8_t id, uint32_t now);
+
+    // 查询状态 (按水塔索引)
+    enum : uint8_t { QUERY_NONE = 0, QUERY_PENDING, QUERY_SENT };
+
+    RelayBackend& relays_;
+    std::vector<TowerData> towers_;
+    uint16_t tower_count_ = 0;
+    SystemStatus status_;
+    MasterCore_t core_;
+    MeshMaster_t mesh_;
+    OtaMaster_t ota_;
+    std::string ota_image_;         // 会话期间保留
+    uint8_t ota_session_ = 0;
+    std::vector<uint8_t> query_state_;
+    std::vector<uint32_t> query_sent_;  // 下发时刻
+    std::deque<RadioFrame> downlink_;
+
+    uint64_t version_ = 1;
+    uint64_t status_version_ = 0;
+    uint64_t towers_version_ = 0;
+    std::shared_ptr<const std::string> status_body_;
+    std::shared_ptr<const std::string> towers_body_;
+    ControllerStats stats_;
+};
+
+/**
+ * 水塔列表 JSON (towers_json() 的内容，基准测试也直接调用)
+ */
+std::string towers_json_build(const TowerData* towers, uint16_t count);
+
+}  // namespace wt
+
+#endif  // WT_CONTROLLER_H
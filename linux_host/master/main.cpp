@@ -0,0 +1,468 @@
+/*
+ * wt-master: Linux 网关主机
+ *
+ * 与 ESP8266 主机运行同一份控制核心 (水塔表、帧处理、自动控制)，
+ * 继电器和 LoRa 换成 Linux 设备，单个网关可管理数百座水塔。
+ *
+ * 用法:
+ *   wt-master [--listen HOST:PORT] [--relays SPEC] [--radio SPEC] [--manual]
+ *             [--auto-ms N] [--offline-s N] [--radio-poll-ms N] [-v]...
+ *
+ *   --relays  sim:N (默认 sim:8)
+ *             gpio:CHIP:L1,L2,...[:active-low][+CHIP:...]
+ *             例如 gpio:gpiochip0:5,6,13,19:active-low
+ *   --radio   sim:N[,REPORT_MS[,LOSS[,HIDDEN]]] (默认 sim:8)
+ *             HIDDEN 个模拟从机 (地址最大的) 只能经中继 (地址 1) 与主机通信
+ *             spi:DEVICE  PAN3031，例如 spi:/dev/spidev0.0 (按 --radio-poll-ms 轮询)
+ *   --auto-ms 自动控制周期 (默认 100，与固件主循环节拍相同)
+ *
+ * 接口 (与 ESP8266 主机兼容，可直接作为 wt-aggregator 的 --master 上游):
+ *   GET  /api/status    系统状态 (ETag，支持 304)
+ *   GET  /api/towers    水塔列表 (ETag，支持 304)
+ *   POST /api/pump      id=<索引>&action=on|off
+ *   POST /api/pumps     changes=0:on,3:off,...
+ *   POST /api/mode      mode=AUTO|MANUAL
+ *   GET  /api/stats     运行统计 (reset=1 读取后清零事件循环延迟统计)
+ *   POST /api/ota       从机空中升级: 请求体为镜像 (slave_node_stc8g 的 make ota)，
+ *                       targets=1,2,... 为目标从机地址，省略时为全部在线水塔
+ *   GET  /api/ota       升级进度 (每个从机的结果、发送的分片数和重发数)
+ *   POST /api/query     id=<从机地址>: 请求从机立即上报 (在收到它的下一帧后按其路由下发)
+ *
+ * 每 30 秒发送中继网络的路由通告，经中继转发的上报帧拆出后交给控制核心
+ * (esp8266_master/src/mesh_master.h)；/api/stats 的 mesh_hops 为每一跳 (从主机一侧起) 的驻留时间。
+ * 下发的命令按上行帧记住的路径封装 (CMD_MESH_DOWN)，紧接在收到该从机的帧之后发送，
+ * 电池节点只在上报后的短暂窗口内接收。
+ *
+ * 空中升级 (esp8266_master/src/ota_master.h) 广播分片，只重发各从机缺片的并集；
+ * 升级只面向直连的从机 (分片不经中继转发)。
+ */
+
+#include "controller.h"
+#include "event_loop.h"
+#include "histogram.h"
+#include "http_server.h"
+#include "log.h"
+#include "net.h"
+#include "radio.h"
+#include "relay.h"
+
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace wt;
+
+namespace {
+
+// 超时离线检查周期
+#define EXPIRE_INTERVAL_MS  1000
+
+// 事件循环延迟采样周期
+#define LOOP_LAG_INTERVAL_MS    10
+
+// 路由通告的检查周期 (通告间隔为 MESH_BEACON_MS)
+#define MESH_BEACON_CHECK_MS    1000
+
+// 空中升级的发送节拍 (分片间隔为 OTA_DATA_INTERVAL_MS)
+#define OTA_POLL_MS             10
+
+uint64_t monotonic_us() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+}
+
+void usage(const char* prog) {
+    fprintf(stderr,
+            "用法: %s [--listen HOST:PORT] [--relays SPEC] [--radio SPEC] [--manual]\n"
+            "          [--auto-ms N] [--offline-s N] [--radio-poll-ms N] [-v]...\n",
+            prog);
+}
+
+/**
+ * 带版本的快照应答 (客户端已有当前版本时回 304)
+ */
+void reply_snapshot(const HttpRequest& req, HttpReply& reply, std::shared_ptr<const std::string> body,
+                    uint64_t version) {
+    std::string etag = "\"v" + std::to_string(version) + "\"";
+    reply.headers.emplace_back("ETag", etag);
+    reply.headers.emplace_back("Cache-Control", "no-cache");
+    if (req.header("if-none-match") == etag) {
+        reply.status = 304;
+        return;
+    }
+    reply.shared_body = std::move(body);
+}
+
+/**
+ * 解析变更列表，例如 "0:on,3:off,5:on" (与固件 /api/pumps 相同)
+ * @return false=格式错误或索引超出 count
+ */
+bool parse_changes(const std::string& text, uint16_t count, uint8_t* set, uint8_t* clear) {
+    const char* p = text.c_str();
+    while (true) {
+        // 逐位解析索引 (strtoul 会接受前导空白和符号)
+        if (*p < '0' || *p > '9') return false;
+        unsigned long id = 0;
+        while (*p >= '0' && *p <= '9') {
+            id = id * 10 + (*p++ - '0');
+            if (id >= count) return false;
+        }
+        if (*p++ != ':') return false;
+
+        uint8_t* bits;
+        if (strncmp(p, "on", 2) == 0) {
+            bits = set;
+            p += 2;
+        } else if (strncmp(p, "off", 3) == 0) {
+            bits = clear;
+            p += 3;
+        } else {
+            return false;
+        }
+        if ((set[id >> 3] | clear[id >> 3]) & (1 << (id & 7))) return false;     // 同一水泵重复
+        bits[id >> 3] |= (uint8_t)(1 << (id & 7));
+
+        if (*p == '\0') return true;
+        if (*p++ != ',') return false;   // 逗号后必须还有一项
+    }
+}
+
+/**
+ * 解析从机地址列表，例如 "1,2,17"
+ * @return false=格式错误、地址超出 1-255 或重复
+ */
+bool parse_ids(const std::string& text, std::vector<uint8_t>* ids) {
+    bool seen[256] = {};
+    const char* p = text.c_str();
+    while (*p != '\0') {
+        char* end;
+        unsigned long id = strtoul(p, &end, 10);
+        if (end == p || id == 0 || id > 255 || seen[id]) return false;
+        seen[id] = true;
+        ids->push_back((uint8_t)id);
+        p = end;
+        if (*p == ',') p++;
+        else if (*p != '\0') return false;
+    }
+    return !ids->empty();
+}
+
+void reply_error(HttpReply& reply, int status, const char* message) {
+    reply.status = status;
+    reply.body = std::string("{\"error\":\"") + message + "\"}";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::string listen_addr = "0.0.0.0:8081";
+    std::string relay_spec = "sim:8";
+    std::string radio_spec = "sim:8";
+    uint32_t auto_ms = 100;
+    uint32_t offline_s = 60;
+    uint32_t radio_poll_ms = 10;
+    SystemMode mode = MODE_AUTO;
+    int verbosity = LOG_LEVEL_INFO;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--listen" && has_value) {
+            listen_addr = argv[++i];
+        } else if (arg == "--relays" && has_value) {
+            relay_spec = argv[++i];
+        } else if (arg == "--radio" && has_value) {
+            radio_spec = argv[++i];
+        } else if (arg == "--auto-ms" && has_value) {
+            auto_ms = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--offline-s" && has_value) {
+            offline_s = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--radio-poll-ms" && has_value) {
+            radio_poll_ms = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--manual") {
+            mode = MODE_MANUAL;
+        } else if (arg == "-v") {
+            verbosity++;
+        } else if (arg == "-q") {
+            verbosity = LOG_LEVEL_WARN;
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (auto_ms == 0 || offline_s == 0 || radio_poll_ms == 0) {
+        usage(argv[0]);
+        return 2;
+    }
+    log_set_level(verbosity);
+
+    std::string host;
+    uint16_t port;
+    if (!net_split_host_port(listen_addr, &host, &port, 8081)) {
+        fprintf(stderr, "无效的 --listen: %s\n", listen_addr.c_str());
+        return 2;
+    }
+
+    // 信号改由事件循环处理
+    sigset_t mask;
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGINT);
+    sigaddset(&mask, SIGTERM);
+    sigprocmask(SIG_BLOCK, &mask, nullptr);
+    signal(SIGPIPE, SIG_IGN);
+
+    std::string err;
+    auto relays = relay_open(relay_spec, &err);
+    if (!relays) {
+        LOG_E("%s", err.c_str());
+        return 1;
+    }
+    MasterController controller(*relays);
+    if (!controller.start(mode, &err)) {
+        LOG_E("%s", err.c_str());
+        return 1;
+    }
+    auto radio = radio_open(radio_spec, [&controller](uint8_t id) { return controller.pump_for_id(id); }, &err);
+    if (!radio) {
+        LOG_E("%s", err.c_str());
+        return 1;
+    }
+
+    EventLoop loop;
+    HttpServer server(loop);
+
+    int sigfd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+    loop.add(sigfd, EPOLLIN, [&](uint32_t) {
+        signalfd_siginfo info;
+        if (read(sigfd, &info, sizeof(info)) == sizeof(info)) {
+            LOG_I("收到信号 %u，退出", info.ssi_signo);
+            loop.stop();
+        }
+    });
+
+    // ==================== LoRa 接收 ====================
+    std::vector<RadioFrame> frames;
+    bool radio_failed = false;
+    auto on_radio = [&]() {
+        frames.clear();
+        std::string rx_err;
+        bool ok = radio->receive(&frames, &rx_err);
+        if (!ok && !radio_failed) LOG_E("LoRa 接收失败: %s", rx_err.c_str());
+        radio_failed = !ok;
+        if (frames.empty()) return;
+        controller.handle_frames(frames, (uint32_t)EventLoop::now_ms());
+
+        // 下发的命令紧接在从机的帧之后发送 (电池节点只在上报后的窗口内接收)
+        RadioFrame down;
+        while (controller.downlink_poll(&down)) {
+            std::string tx_err;
+            if (!radio->send(down.data, down.len, &tx_err)) LOG_E("下发命令失败: %s", tx_err.c_str());
+        }
+    };
+    if (radio->fd() >= 0) {
+        loop.add(radio->fd(), EPOLLIN, [&](uint32_t) { on_radio(); });
+    } else {
+        loop.add_timer(radio_poll_ms, on_radio);
+    }
+
+    // ==================== 中继网络路由通告 ====================
+    bool beacon_failed = false;
+    loop.add_timer(MESH_BEACON_CHECK_MS, [&]() {
+        RadioFrame beacon;
+        if (!controller.mesh_beacon((uint32_t)EventLoop::now_ms(), &beacon)) return;
+        std::string tx_err;
+        bool ok = radio->send(beacon.data, beacon.len, &tx_err);
+        if (!ok && !beacon_failed) LOG_E("发送路由通告失败: %s", tx_err.c_str());
+        beacon_failed = !ok;
+    });
+
+    // ==================== 空中升级 ====================
+    // 每个节拍最多发一帧 (PAN3031 发送时阻塞到发送结束)
+    bool ota_failed = false;
+    loop.add_timer(OTA_POLL_MS, [&]() {
+        RadioFrame frame;
+        if (!controller.ota_poll((uint32_t)EventLoop::now_ms(), &frame)) return;
+        std::string tx_err;
+        bool ok = radio->send(frame.data, frame.len, &tx_err);
+        if (!ok && !ota_failed) LOG_E("发送升级帧失败: %s", tx_err.c_str());
+        ota_failed = !ok;
+    });
+
+    // ==================== 控制调度 ====================
+    loop.add_timer(auto_ms, [&]() { controller.run_auto(); });
+    loop.add_timer(EXPIRE_INTERVAL_MS, [&]() {
+        controller.expire((uint32_t)EventLoop::now_ms(), offline_s * 1000);
+    });
+
+    // ==================== 事件循环延迟 ====================
+    // 固定节拍定时器实际触发时刻与计划时刻之差：请求处理或帧处理占住循环多久，
+    // 自动控制和 LoRa 接收就被推迟多久 (压测时与 wt-loadgen 的结果对照)
+    LatencyHistogram loop_lag;      // 微秒
+    const uint64_t lag_period = LOOP_LAG_INTERVAL_MS * 1000;
+    uint64_t lag_expected = monotonic_us() + lag_period;
+    loop.add_timer(LOOP_LAG_INTERVAL_MS, [&]() {
+        uint64_t now = monotonic_us();
+        loop_lag.record(now > lag_expected ? now - lag_expected : 0);
+        // timerfd 按固定网格触发，错过的节拍合并为一次
+        lag_expected += (now > lag_expected ? (now - lag_expected) / lag_period + 1 : 1) * lag_period;
+    });
+
+    // ==================== REST 接口 ====================
+    server.route("GET", "/api/status", [&](const HttpRequest& req, HttpReply& reply) {
+        reply_snapshot(req, reply, controller.status_json(), controller.version());
+    });
+
+    server.route("GET", "/api/towers", [&](const HttpRequest& req, HttpReply& reply) {
+        reply_snapshot(req, reply, controller.towers_json(), controller.version());
+    });
+
+    server.route("POST", "/api/pump", [&](const HttpRequest& req, HttpReply& reply) {
+        std::string id, action;
+        char* end = nullptr;
+        unsigned long index = req.param("id", &id) ? strtoul(id.c_str(), &end, 10) : 0;
+        if (end == nullptr || end == id.c_str() || *end != '\0' || !req.param("action", &action) ||
+            (action != "on" && action != "off")) {
+            reply_error(reply, 400, "expected id=<index>&action=on|off");
+            return;
+        }
+        if (index > 0xFFFF || !controller.set_pump((uint16_t)index, action == "on")) {
+            reply_error(reply, 400, "unknown tower");
+            return;
+        }
+        reply.content_type = "text/plain";
+        reply.body = "OK";
+    });
+
+    server.route("POST", "/api/pumps", [&](const HttpRequest& req, HttpReply& reply) {
+        std::string changes;
+        uint8_t set[MASTER_RELAY_BYTES] = {};
+        uint8_t clear[MASTER_RELAY_BYTES] = {};
+        if (!req.param("changes", &changes) || !parse_changes(changes, controller.pump_count(), set, clear)) {
+            reply_error(reply, 400, "invalid changes");
+            return;
+        }
+        uint16_t changed = controller.apply(set, clear);
+        reply.body = "{\"changed\":" + std::to_string(changed) + ",\"towers\":" + *controller.towers_json() + "}";
+    });
+
+    server.route("POST", "/api/mode", [&](const HttpRequest& req, HttpReply& reply) {
+        std::string value;
+        if (!req.param("mode", &value) || (value != "AUTO" && value != "MANUAL")) {
+            reply_error(reply, 400, "expected mode=AUTO|MANUAL");
+            return;
+        }
+        controller.set_mode(value == "AUTO" ? MODE_AUTO : MODE_MANUAL);
+        LOG_I("切换为%s模式", value == "AUTO" ? "自动" : "手动");
+        reply.content_type = "text/plain";
+        reply.body = "OK";
+    });
+
+    server.route("POST", "/api/ota", [&](const HttpRequest& req, HttpReply& reply) {
+        std::string targets;
+        std::vector<uint8_t> ids;
+        if (req.param("targets", &targets) && !parse_ids(targets, &ids)) {
+            reply_error(reply, 400, "expected targets=<id>,<id>,...");
+            return;
+        }
+        if (controller.ota_active()) {
+            reply_error(reply, 409, "update in progress");
+            return;
+        }
+        std::string start_err;
+        if (!controller.ota_start(req.body, ids, (uint32_t)EventLoop::now_ms(), &start_err)) {
+            LOG_W("空中升级未开始: %s", start_err.c_str());
+            reply_error(reply, 400, "invalid image or no targets");
+            return;
+        }
+        reply.body = controller.ota_json((uint32_t)EventLoop::now_ms());
+    });
+
+    server.route("GET", "/api/ota", [&](const HttpRequest&, HttpReply& reply) {
+        reply.body = controller.ota_json((uint32_t)EventLoop::now_ms());
+    });
+
+    server.route("POST", "/api/query", [&](const HttpRequest& req, HttpReply& reply) {
+        std::string id;
+        char* end = nullptr;
+        unsigned long addr = req.param("id", &id) ? strtoul(id.c_str(), &end, 10) : 0;
+        if (end == nullptr || end == id.c_str() || *end != '\0' || addr == 0 || addr > 255) {
+            reply_error(reply, 400, "expected id=<address>");
+            return;
+        }
+        if (!controller.query((uint8_t)addr)) {
+            reply_error(reply, 400, "unknown tower");
+            return;
+        }
+        reply.content_type = "text/plain";
+        reply.body = "OK";
+    });
+
+    server.route("GET", "/api/stats", [&](const HttpRequest& req, HttpReply& reply) {
+        const ControllerStats& s = controller.stats();
+        const RadioStats& r = radio->stats();
+        const MeshStats_t& m = controller.mesh_stats();
+        std::string hops;
+        for (uint8_t j = 0; j < MESH_MAX_RELAYS; j++) {
+            const MeshHopStats_t& h = m.hop[j];
+            char item[96];
+            snprintf(item, sizeof(item), "%s{\"frames\":%u,\"residency_avg_ms\":%u,\"residency_max_ms\":%u}",
+                     j ? "," : "", h.frames, h.frames ? h.residency_sum_ms / h.frames : 0, h.residency_max_ms);
+            hops += item;
+        }
+        char buf[1536];
+        snprintf(buf, sizeof(buf),
+                 "{\"version\":%llu,\"towers\":%u,\"relays\":\"%s\",\"radio\":\"%s\","
+                 "\"radio_frames\":%llu,\"radio_crc_errors\":%llu,\"radio_lost\":%llu,\"radio_sent\":%llu,"
+                 "\"frames\":%llu,\"ignored\":%llu,\"short\":%llu,\"table_full\":%llu,\"offline\":%llu,"
+                 "\"relayed\":%llu,\"duplicates\":%llu,\"mesh_control\":%llu,\"mesh_bad\":%llu,"
+                 "\"mesh_beacons\":%u,\"mesh_hops\":[%s],\"downlinks\":%llu,\"downlink_replies\":%llu,"
+                 "\"switched\":%llu,\"relay_writes\":%llu,\"relay_errors\":%llu,\"well_alarms\":%llu,"
+                 "\"http_requests\":%llu,\"http_connections\":%zu,"
+                 "\"loop_lag_samples\":%llu,\"loop_lag_p50_us\":%llu,\"loop_lag_p99_us\":%llu,"
+                 "\"loop_lag_max_us\":%llu}",
+                 (unsigned long long)controller.version(), controller.tower_count(), relays->name(),
+                 radio->name(), (unsigned long long)r.frames, (unsigned long long)r.crc_errors,
+                 (unsigned long long)r.lost, (unsigned long long)r.sent, (unsigned long long)s.frames,
+                 (unsigned long long)s.ignored, (unsigned long long)s.short_frames,
+                 (unsigned long long)s.table_full, (unsigned long long)s.offline,
+                 (unsigned long long)s.relayed, (unsigned long long)s.duplicates,
+                 (unsigned long long)s.mesh_control, (unsigned long long)s.mesh_bad, m.beacons, hops.c_str(),
+                 (unsigned long long)s.downlinks, (unsigned long long)s.downlink_replies,
+                 (unsigned long long)s.switched,
+                 (unsigned long long)s.relay_writes, (unsigned long long)s.relay_errors,
+                 (unsigned long long)s.well_alarms, (unsigned long long)server.requests(),
+                 server.connections(), (unsigned long long)loop_lag.count(),
+                 (unsigned long long)loop_lag.percentile(50), (unsigned long long)loop_lag.percentile(99),
+                 (unsigned long long)loop_lag.max());
+        reply.body = buf;
+        std::string reset;
+        if (req.param("reset", &reset) && reset == "1") loop_lag.reset();
+    });
+
+    if (!server.listen(host, port, &err)) {
+        LOG_E("监听 %s 失败: %s", listen_addr.c_str(), err.c_str());
+        return 1;
+    }
+
+    LOG_I("wt-master 监听 %s:%u，继电器 %s (%u 路)，LoRa %s，%s模式", host.c_str(), server.port(),
+          relays->name(), relays->count(), radio->name(), mode == MODE_AUTO ? "自动" : "手动");
+    loop.run();
+
+    // 退出时关闭全部水泵
+    uint8_t all[MASTER_RELAY_BYTES];
+    memset(all, 0xFF, sizeof(all));
+    controller.apply(nullptr, all);
+
+    loop.remove(sigfd);
+    close(sigfd);
+    return 0;
+}
@@ -0,0 +1,392 @@
+/*
+ * LoRa 收发后端实现
+ */
+
+#include "radio.h"
+
+#include "log.h"
+#include "pan3031_regs.h"
+#include "water_system.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/spi/spidev.h>
+#include <sys/ioctl.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace wt {
+
+// 等待发送完成的上限 (SF12 下 32 字节约 1.8 秒)
+#define RADIO_TX_TIMEOUT_MS     3000
+
+// ==================== 模拟从机 ====================
+
+/**
+ * 水位对应的 SC09B 通道图 (通道 k 在水位不低于 10k% 时有水)
+ */
+static unsigned int sim_channels(uint8_t level) {
+    unsigned int map = 0;
+    for (unsigned int k = 1; k <= 9; k++) {
+        if (level >= k * 10) map |= 1u << (k - 1);
+    }
+    return map;
+}
+
+// 模拟链路的接收信号强度 (按 slave_mesh.h 为代价 1 的好链路)
+#define SIM_RSSI                (-90)
+
+SimRadio::SimRadio(const SimRadioConfig& config, PumpQuery pump)
+    : config_(config), pump_(std::move(pump)), rng_(config.seed) {}
+
+SimRadio::~SimRadio() {
+    if (timerfd_ >= 0) close(timerfd_);
+}
+
+std::unique_ptr<SimRadio> SimRadio::open(const SimRadioConfig& config, PumpQuery pump, std::string* err) {
+    if (config.towers == 0 || config.towers > 255 || config.report_ms == 0 || config.tick_ms == 0 ||
+        config.hidden >= config.towers) {
+        *err = "无效的模拟参数";
+        return nullptr;
+    }
+
+    std::unique_ptr<SimRadio> radio(new SimRadio(config, std::move(pump)));
+    std::uniform_real_distribution<double> level(10, 95), drain(0.05, 0.3), fill(0.5, 1.0);
+    std::uniform_int_distribution<uint32_t> phase(0, config.report_ms - 1);
+    for (uint16_t i = 0; i < config.towers; i++) {
+        Node n;
+        n.id = (uint8_t)(i + 1);
+        n.level = level(radio->rng_);
+        n.drain = drain(radio->rng_);
+        n.fill = fill(radio->rng_);
+        n.next_report = phase(radio->rng_);     // 上报时刻错开
+        n.hidden = i >= config.towers - config.hidden;
+        slave_init(&n.proto, n.id);
+        slave_window_init(&n.window, 1);
+        slave_ota_init(&n.ota, n.id);
+        slave_mesh_init(&n.mesh, n.id, config.hidden && i == 0 ? 1 : 0);
+
+        // 与从机相同，上电先采样一次，第一帧就带读数
+        uint8_t first = (uint8_t)(n.level + 0.5);
+        slave_window_add(&n.window, &n.proto, first, 1, sim_channels(first), 0);
+        radio->nodes_.push_back(n);
+    }
+
+    radio->timerfd_ = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (radio->timerfd_ < 0) {
+        *err = std::string("timerfd: ") + strerror(errno);
+        return nullptr;
+    }
+    itimerspec spec;
+    spec.it_interval.tv_sec = config.tick_ms / 1000;
+    spec.it_interval.tv_nsec = (long)(config.tick_ms % 1000) * 1000000;
+    spec.it_value = spec.it_interval;
+    timerfd_settime(radio->timerfd_, 0, &spec, nullptr);
+    return radio;
+}
+
+bool SimRadio::listening(const Node& n) const {
+    unsigned long now = (unsigned long)sim_ms_;
+    return slave_mesh_listen(&n.mesh, now) || slave_rx_window(&n.proto, now) || n.ota.state != OTA_STATE_IDLE;
+}
+
+void SimRadio::deliver(Node& n, const uint8_t* data, uint8_t len) {
+    std::uniform_real_distribution<double> chance(0, 1);
+    if (!listening(n)) return;
+    if (config_.loss > 0 && chance(rng_) < config_.loss) {
+        stats_.lost++;
+        return;
+    }
+
+    // 与 STC8G 从机 handle_host_command() 相同: 先交给中继网络，下行命令拆出内层帧
+    uint8_t rx[SLAVE_MESH_FRAME_MAX];
+    len = std::min<uint8_t>(len, sizeof(rx));
+    memcpy(rx, data, len);
+    if (slave_mesh_receive(&n.mesh, rx, &len, SIM_RSSI, (unsigned long)sim_ms_) == MESH_RX_DONE) return;
+
+    if (len < 2 || rx[1] < CMD_OTA_BEGIN || rx[1] > CMD_OTA_ACTIVATE) {
+        if (slave_handle_command(&n.proto, rx, len)) report(n);
+        return;
+    }
+
+    // 与 STC8G 从机 handle_ota() 相同的动作，暂存区是内存
+    RadioFrame reply;
+    uint8_t act = slave_ota_receive(&n.ota, rx, len, reply.data);
+    if (act & OTA_DO_ERASE) n.stage.assign(OTA_IMAGE_MAX, 0xFF);
+    if (act & OTA_DO_WRITE) memcpy(&n.stage[n.ota.write_offset], rx + OTA_DATA_HEADER, n.ota.write_len);
+    if (act & OTA_DO_VERIFY) {
+        unsigned int crc = OTA_CRC_INIT;
+        for (unsigned int i = 0; i < n.ota.size; i++) crc = slave_ota_crc16(crc, n.stage[i]);
+        slave_ota_verified(&n.ota, crc);
+    }
+    if (act & OTA_DO_REPLY) {
+        reply.len = OTA_STATUS_LEN;
+        transmit(n, reply);
+    }
+    if (act & OTA_DO_ACTIVATE) {
+        // 复位进入新程序，会话清空
+        LOG_I("模拟从机 %u 激活新镜像 (%u 字节，CRC %04X)", n.id, n.ota.size, n.ota.crc);
+        slave_ota_init(&n.ota, n.id);
+    }
+}
+
+void SimRadio::transmit(Node& n, const RadioFrame& f) {
+    std::uniform_real_distribution<double> chance(0, 1);
+    if (!n.hidden) {
+        if (config_.loss > 0 && chance(rng_) < config_.loss) stats_.lost++;
+        else uplink_.push_back(f);
+    }
+
+    // 中继 (地址 1) 与隐藏从机之间
+    if (n.mesh.relay) {
+        for (Node& h : nodes_) {
+            if (h.hidden) deliver(h, f.data, f.len);
+        }
+    } else if (n.hidden) {
+        deliver(nodes_[0], f.data, f.len);
+    }
+}
+
+void SimRadio::report(Node& n) {
+    // 与 STC8G 从机 send_sensor_data() 相同 (slave_window.c，装有 SC09B): 发出后开始新的窗口
+    RadioFrame f;
+    f.len = slave_window_build_report(&n.window, &n.proto, f.data, slave_mesh_report_room(&n.mesh));
+    f.len = slave_mesh_wrap_report(&n.mesh, f.data, f.len);
+    slave_window_report_sent(&n.window, &n.proto, (unsigned long)sim_ms_);
+    transmit(n, f);
+}
+
+bool SimRadio::receive(std::vector<RadioFrame>* out, std::string*) {
+    uint64_t ticks;
+    if (read(timerfd_, &ticks, sizeof(ticks)) != sizeof(ticks)) return true;
+
+    // 积压的步长合并计算 (循环被阻塞时不会一次补发大量帧)
+    double dt = ticks * config_.tick_ms / 1000.0;
+    sim_ms_ += ticks * config_.tick_ms;
+
+    for (Node& n : nodes_) {
+        n.level += ((pump_(n.id) ? n.fill : 0) - n.drain) * dt;
+        n.level = std::min(100.0, std::max(0.0, n.level));
+        if (slave_window_sample_due(&n.window, (unsigned long)sim_ms_)) {
+            uint8_t level = (uint8_t)(n.level + 0.5);
+            slave_window_add(&n.window, &n.proto, level, 1, sim_channels(level), (unsigned long)sim_ms_);
+        }
+        if (sim_ms_ >= n.next_report) {
+            while (n.next_report <= sim_ms_) n.next_report += config_.report_ms;
+            report(n);
+        }
+
+        // 与从机主循环相同，每一步最多转发一帧或发送一次路由通告
+        RadioFrame f;
+        f.len = slave_mesh_poll(&n.mesh, (unsigned long)sim_ms_, f.data);
+        if (f.len) transmit(n, f);
+    }
+
+    stats_.frames += uplink_.size();
+    out->insert(out->end(), uplink_.begin(), uplink_.end());
+    uplink_.clear();
+    return true;
+}
+
+bool SimRadio::send(const uint8_t* data, uint8_t len, std::string*) {
+    stats_.sent++;
+    for (Node& n : nodes_) {
+        if (!n.hidden) deliver(n, data, len);
+    }
+    return true;
+}
+
+// ==================== PAN3031 (spidev) ====================
+
+Pan3031Radio::~Pan3031Radio() {
+    if (fd_ >= 0) {
+        write_reg(REG_OP_MODE, MODE_STDBY);
+        close(fd_);
+    }
+}
+
+bool Pan3031Radio::transfer(uint8_t* buf, size_t len) {
+    spi_ioc_transfer t;
+    memset(&t, 0, sizeof(t));
+    t.tx_buf = (uintptr_t)buf;
+    t.rx_buf = (uintptr_t)buf;
+    t.len = (uint32_t)len;
+    t.speed_hz = speed_hz_;
+    t.bits_per_word = 8;
+    return ioctl(fd_, SPI_IOC_MESSAGE(1), &t) >= 0;
+}
+
+bool Pan3031Radio::write_reg(uint8_t addr, uint8_t value) {
+    uint8_t buf[2] = {(uint8_t)(addr | 0x80), value};
+    return transfer(buf, sizeof(buf));
+}
+
+bool Pan3031Radio::read_reg(uint8_t addr, uint8_t* value) {
+    uint8_t buf[2] = {(uint8_t)(addr & ~0x80), 0x00};
+    if (!transfer(buf, sizeof(buf))) return false;
+    *value = buf[1];
+    return true;
+}
+
+std::unique_ptr<Pan3031Radio> Pan3031Radio::open(const Pan3031Config& config, std::string* err) {
+    std::unique_ptr<Pan3031Radio> radio(new Pan3031Radio());
+    radio->fd_ = ::open(config.device.c_str(), O_RDWR | O_CLOEXEC);
+    if (radio->fd_ < 0) {
+        *err = config.device + ": " + strerror(errno);
+        return nullptr;
+    }
+    radio->speed_hz_ = config.speed_hz;
+
+    uint8_t mode = SPI_MODE_0, bits = 8;
+    if (ioctl(radio->fd_, SPI_IOC_WR_MODE, &mode) < 0 || ioctl(radio->fd_, SPI_IOC_WR_BITS_PER_WORD, &bits) < 0 ||
+        ioctl(radio->fd_, SPI_IOC_WR_MAX_SPEED_HZ, &config.speed_hz) < 0) {
+        *err = config.device + ": 配置 SPI 失败: " + strerror(errno);
+        return nullptr;
+    }
+
+    uint8_t version = 0;
+    if (!radio->read_reg(REG_SYNC_WORD, &version)) {
+        *err = config.device + ": 读取寄存器失败: " + strerror(errno);
+        return nullptr;
+    }
+    LOG_I("PAN3031 版本: 0x%02X", version);
+
+    // 与 ESP8266 setup_pan3031() 相同的参数
+    uint32_t frf = (uint32_t)(((uint64_t)config.freq_hz << 19) / 32000000);
+    uint8_t bw_val;
+    if (config.bw_hz <= 7800) bw_val = 0;
+    else if (config.bw_hz <= 10400) bw_val = 1;
+    else if (config.bw_hz <= 15600) bw_val = 2;
+    else if (config.bw_hz <= 20800) bw_val = 3;
+    else if (config.bw_hz <= 31250) bw_val = 4;
+    else if (config.bw_hz <= 41700) bw_val = 5;
+    else if (config.bw_hz <= 62500) bw_val = 6;
+    else if (config.bw_hz <= 125000) bw_val = 7;
+    else if (config.bw_hz <= 250000) bw_val = 8;
+    else bw_val = 9;
+    uint8_t power = std::min<uint8_t>(17, std::max<uint8_t>(2, config.power_dbm));
+
+    uint8_t config1 = 0, config2 = 0;
+    bool ok = radio->write_reg(REG_OP_MODE, MODE_STDBY) &&
+              radio->write_reg(REG_FRF_MSB, (frf >> 16) & 0xFF) &&
+              radio->write_reg(REG_FRF_MID, (frf >> 8) & 0xFF) &&
+              radio->write_reg(REG_FRF_LSB, frf & 0xFF) &&
+              radio->read_reg(REG_MODEM_CONFIG2, &config2) &&
+              radio->write_reg(REG_MODEM_CONFIG2, (config2 & 0x0F) | ((config.sf << 4) & 0xF0)) &&
+              radio->read_reg(REG_MODEM_CONFIG1, &config1) &&
+              radio->write_reg(REG_MODEM_CONFIG1, (config1 & 0x0F) | (bw_val << 4)) &&
+              radio->write_reg(REG_PA_CONFIG, 0x80 | (power - 2)) &&
+              radio->write_reg(REG_IRQ_FLAGS, 0xFF) &&
+              radio->write_reg(REG_OP_MODE, MODE_RXCONT);
+    if (!ok) {
+        *err = config.device + ": 配置 PAN3031 失败: " + strerror(errno);
+        return nullptr;
+    }
+    return radio;
+}
+
+bool Pan3031Radio::receive(std::vector<RadioFrame>* out, std::string* err) {
+    uint8_t flags;
+    if (!read_reg(REG_IRQ_FLAGS, &flags)) {
+        *err = std::string("读取中断标志失败: ") + strerror(errno);
+        return false;
+    }
+    if (!(flags & IRQ_RX_DONE)) return true;
+
+    bool ok = true;
+    if (flags & IRQ_CRC_ERROR) {
+        stats_.crc_errors++;
+    } else {
+        uint8_t len = 0, addr = 0;
+        ok = read_reg(REG_RX_NB_BYTES, &len) && read_reg(REG_FIFO_RX_ADDR, &addr) &&
+             write_reg(REG_FIFO_ADDR_PTR, addr);
+        if (ok) {
+            // 一次传输读出整帧: 地址字节之后依次是 FIFO 内容
+            len = std::min<uint8_t>(len, RADIO_MAX_FRAME);
+            uint8_t buf[1 + RADIO_MAX_FRAME] = {REG_FIFO};
+            ok = transfer(buf, 1 + len);
+            if (ok) {
+                RadioFrame f;
+                memcpy(f.data, buf + 1, len);
+                f.len = len;
+                out->push_back(f);
+                stats_.frames++;
+            }
+        }
+    }
+
+    // 清除中断，保持连续接收
+    ok = write_reg(REG_IRQ_FLAGS, 0xFF) && ok;
+    if (!ok) *err = std::string("读取 FIFO 失败: ") + strerror(errno);
+    return ok;
+}
+
+bool Pan3031Radio::send(const uint8_t* data, uint8_t len, std::string* err) {
+    len = std::min<uint8_t>(len, RADIO_MAX_FRAME);
+    uint8_t buf[1 + RADIO_MAX_FRAME] = {(uint8_t)(REG_FIFO | 0x80)};
+    memcpy(buf + 1, data, len);
+
+    bool ok = write_reg(REG_OP_MODE, MODE_STDBY) && write_reg(REG_FIFO_ADDR_PTR, 0x00) &&
+              write_reg(REG_FIFO_TX_BASE, 0x00) && transfer(buf, 1 + len) &&
+              write_reg(REG_PAYLOAD_LEN, len) && write_reg(REG_OP_MODE, MODE_TX);
+
+    // 轮询发送完成 (发送期间不接收，事件循环阻塞一帧的空中时间)
+    bool done = false;
+    for (uint32_t waited = 0; ok && waited < RADIO_TX_TIMEOUT_MS; waited++) {
+        uint8_t flags;
+        ok = read_reg(REG_IRQ_FLAGS, &flags);
+        if (ok && (flags & IRQ_TX_DONE)) {
+            done = true;
+            break;
+        }
+        struct timespec ts = {0, 1000000};
+        nanosleep(&ts, nullptr);
+    }
+
+    // 清除中断，恢复连续接收
+    bool restored = write_reg(REG_IRQ_FLAGS, 0xFF) && write_reg(REG_OP_MODE, MODE_RXCONT);
+    if (!ok || !restored) {
+        *err = std::string("发送失败: ") + strerror(errno);
+        return false;
+    }
+    if (!done) {
+        *err = "发送超时";
+        return false;
+    }
+    stats_.sent++;
+    return true;
+}
+
+// ==================== 参数解析 ====================
+
+std::unique_ptr<Radio> radio_open(const std::string& spec, SimRadio::PumpQuery pump, std::string* err) {
+    if (spec.compare(0, 4, "sim:") == 0) {
+        SimRadioConfig cfg;
+        const char* p = spec.c_str() + 4;
+        char* end;
+        cfg.towers = (uint16_t)strtoul(p, &end, 10);
+        if (*end == ',') cfg.report_ms = (uint32_t)strtoul(end + 1, &end, 10);
+        if (*end == ',') cfg.loss = strtod(end + 1, &end);
+        if (*end == ',') cfg.hidden = (uint16_t)strtoul(end + 1, &end, 10);
+        if (*end != '\0' || cfg.loss < 0 || cfg.loss > 1) {
+            *err = "无效的模拟参数: " + spec;
+            return nullptr;
+        }
+        return SimRadio::open(cfg, std::move(pump), err);
+    }
+
+    if (spec.compare(0, 4, "spi:") == 0) {
+        Pan3031Config cfg;
+        cfg.device = spec.substr(4);
+        return Pan3031Radio::open(cfg, err);
+    }
+
+    *err = "未知的 LoRa 后端: " + spec;
+    return nullptr;
+}
+
+}  // namespace wt
@@ -0,0 +1,195 @@
+/*
+ * LoRa 收发后端 (主机发送中继网络的路由通告和从机空中升级的帧)
+ *
+ * - SimRadio:     进程内模拟的从机 (水位随用水下降、随水泵上升)，按周期上报
+ *                 与 STC8G 从机相同格式的帧 (slave_window.c，每秒采样并附带通道图)，
+ *                 用于开发和数百座水塔的压力测试；空中升级由与 STC8G 从机同一份 slave_ota.c 处理，
+ *                 路由和转发由同一份 slave_mesh.c 处理 (可模拟只能经中继到达的从机)，
+ *                 与电池节点一样只在上报后的接收窗口、预计的路由通告前后和升级会话中收到帧
+ * - Pan3031Radio: 通过 spidev 访问 PAN3031 (寄存器与 ESP8266 驱动共用 pan3031_regs.h)
+ *
+ * 后端提供可读描述符时由事件循环唤醒，否则按固定间隔轮询。
+ */
+
+#ifndef WT_RADIO_H
+#define WT_RADIO_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "slave_mesh.h"
+#include "slave_ota.h"
+#include "slave_window.h"
+
+namespace wt {
+
+// 单帧最大长度 (与 ESP8266 驱动一致)
+#define RADIO_MAX_FRAME     32
+
+struct RadioFrame {
+    uint8_t data[RADIO_MAX_FRAME];
+    uint8_t len;
+};
+
+struct RadioStats {
+    uint64_t frames = 0;        // 收到的帧
+    uint64_t crc_errors = 0;    // CRC 错误丢弃
+    uint64_t lost = 0;          // 模拟丢失的帧 (仅 SimRadio)
+    uint64_t sent = 0;          // 发出的帧
+};
+
+class Radio {
+public:
+    virtual ~Radio() = default;
+
+    virtual const char* name() const = 0;
+
+    /**
+     * 有帧到达时可读的描述符，-1=需要轮询
+     */
+    virtual int fd() const { return -1; }
+
+    /**
+     * 读出已到达的帧 (追加到 out)
+     * @return false=设备错误 (err 中为原因)
+     */
+    virtual bool receive(std::vector<RadioFrame>* out, std::string* err) = 0;
+
+    /**
+     * 发送一帧 (阻塞到发送结束，之后恢复接收)
+     * @return false=设备错误 (err 中为原因)
+     */
+    virtual bool send(const uint8_t* data, uint8_t len, std::string* err) = 0;
+
+    const RadioStats& stats() const { return stats_; }
+
+protected:
+    RadioStats stats_;
+};
+
+// ==================== 模拟从机 ====================
+
+struct SimRadioConfig {
+    uint16_t towers = 16;           // 从机数量 (地址 1..N，最多 255)
+    uint32_t report_ms = 5000;      // 上报周期
+    uint32_t tick_ms = 100;         // 模拟步长
+    double loss = 0.0;              // 丢帧概率 (0-1)
+    uint16_t hidden = 0;            // 只能经中继 (地址 1) 与主机通信的从机数 (地址最大的几个)
+    uint32_t seed = 1;
+};
+
+class SimRadio : public Radio {
+public:
+    // 查询某个从机对应水泵的当前状态 (由主机继电器决定)
+    using PumpQuery = std::function<bool(uint8_t id)>;
+
+    ~SimRadio() override;
+
+    /**
+     * @return nullptr=失败
+     */
+    static std::unique_ptr<SimRadio> open(const SimRadioConfig& config, PumpQuery pump, std::string* err);
+
+    const char* name() const override { return "sim"; }
+    int fd() const override { return timerfd_; }
+    bool receive(std::vector<RadioFrame>* out, std::string* err) override;
+    // 交给与主机直连、正在接收的从机 (各自按丢帧概率丢失)，应答在下一步返回
+    bool send(const uint8_t* data, uint8_t len, std::string* err) override;
+
+private:
+    struct Node {
+        uint8_t id;
+        double level;           // 水位 (%)
+        double drain;           // 用水速度 (%/秒)
+        double fill;            // 水泵开启时的进水速度 (%/秒)
+        uint64_t next_report;   // 下次上报时刻 (模拟时间，毫秒)
+        SlaveNode_t proto;      // 最新读数
+        SlaveWindow_t window;   // 每秒采样，上报帧带窗口摘要和通道图
+        SlaveOta_t ota;         // 升级会话
+        SlaveMesh_t mesh;       // 路由、待转发的帧 (地址 1 在有隐藏从机时是中继)
+        bool hidden;            // 只与中继互相收到
+        std::vector<uint8_t> stage;     // 暂存区
+    };
+
+    SimRadio(const SimRadioConfig& config, PumpQuery pump);
+
+    /**
+     * 与从机 radio_listen() 相同: 射频是否在接收
+     */
+    bool listening(const Node& n) const;
+
+    /**
+     * 从机 n 收到一帧 (不在接收或按丢帧概率丢失时无动作)
+     */
+    void deliver(Node& n, const uint8_t* data, uint8_t len);
+
+    /**
+     * 从机 n 发出一帧: 直连的从机发给主机，中继与隐藏从机之间互相收到
+     */
+    void transmit(Node& n, const RadioFrame& f);
+
+    /**
+     * 从机 n 上报一次 (按路由封装)
+     */
+    void report(Node& n);
+
+    SimRadioConfig config_;
+    PumpQuery pump_;
+    int timerfd_ = -1;
+    uint64_t sim_ms_ = 0;
+    std::vector<Node> nodes_;
+    std::vector<RadioFrame> uplink_;    // 从机发给主机、下一步返回的帧
+    std::mt19937 rng_;
+};
+
+// ==================== PAN3031 (spidev) ====================
+
+struct Pan3031Config {
+    std::string device = "/dev/spidev0.0";
+    uint32_t speed_hz = 1000000;
+    uint32_t freq_hz = 434000000;
+    uint8_t sf = 7;
+    uint32_t bw_hz = 125000;
+    uint8_t power_dbm = 17;
+};
+
+class Pan3031Radio : public Radio {
+public:
+    ~Pan3031Radio() override;
+
+    /**
+     * 打开设备并配置为连续接收
+     * @return nullptr=失败
+     */
+    static std::unique_ptr<Pan3031Radio> open(const Pan3031Config& config, std::string* err);
+
+    const char* name() const override { return "pan3031"; }
+    bool receive(std::vector<RadioFrame>* out, std::string* err) override;
+    bool send(const uint8_t* data, uint8_t len, std::string* err) override;
+
+private:
+    Pan3031Radio() = default;
+
+    bool transfer(uint8_t* buf, size_t len);
+    bool write_reg(uint8_t addr, uint8_t value);
+    bool read_reg(uint8_t addr, uint8_t* value);
+
+    int fd_ = -1;
+    uint32_t speed_hz_ = 0;
+};
+
+/**
+ * 按命令行参数创建后端
+ *   sim:N[,REPORT_MS[,LOSS[,HIDDEN]]]
+ *                                 模拟 N 个从机，其中 HIDDEN 个只能经中继 (地址 1) 到达
+ *   spi:DEVICE                    PAN3031 (例如 spi:/dev/spidev0.0)
+ */
+std::unique_ptr<Radio> radio_open(const std::string& spec, SimRadio::PumpQuery pump, std::string* err);
+
+}  // namespace wt
+
+#endif  // WT_RADIO_H
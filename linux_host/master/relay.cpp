@@ -0,0 +1,171 @@
+/*
+ * 继电器输出后端实现
+ */
+
+#include "relay.h"
+
+#include "log.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/gpio.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+namespace wt {
+
+static inline bool bit_get(const uint8_t* bits, uint32_t i) {
+    return (bits[i >> 3] >> (i & 7)) & 0x01;
+}
+
+// ==================== 模拟 ====================
+
+SimRelay::SimRelay(uint16_t count) : count_(count), state_((count + 7) / 8, 0) {}
+
+bool SimRelay::write(const uint8_t* bits, std::string*) {
+    for (uint16_t i = 0; i < count_; i++) {
+        if (bit_get(bits, i) != bit_get(state_.data(), i)) {
+            LOG_D("继电器 %u -> %s", i, bit_get(bits, i) ? "开" : "关");
+        }
+    }
+    memcpy(state_.data(), bits, state_.size());
+    return true;
+}
+
+// ==================== GPIO ====================
+
+GpioRelay::~GpioRelay() {
+    for (Request& r : requests_) close(r.fd);
+}
+
+std::unique_ptr<GpioRelay> GpioRelay::open(const std::vector<GpioRelayGroup>& groups, std::string* err) {
+    std::unique_ptr<GpioRelay> relay(new GpioRelay());
+
+    for (const GpioRelayGroup& g : groups) {
+        int chip = ::open(g.chip.c_str(), O_RDWR | O_CLOEXEC);
+        if (chip < 0) {
+            *err = g.chip + ": " + strerror(errno);
+            return nullptr;
+        }
+
+        for (size_t start = 0; start < g.lines.size(); start += GPIO_V2_LINES_MAX) {
+            size_t n = std::min(g.lines.size() - start, (size_t)GPIO_V2_LINES_MAX);
+            if (relay->count_ + n > 0xFFFF) {
+                close(chip);
+                *err = "继电器数量过多";
+                return nullptr;
+            }
+
+            gpio_v2_line_request req;
+            memset(&req, 0, sizeof(req));
+            for (size_t i = 0; i < n; i++) req.offsets[i] = g.lines[start + i];
+            req.num_lines = (uint32_t)n;
+            strncpy(req.consumer, "wt-master", sizeof(req.consumer) - 1);
+            req.config.flags = GPIO_V2_LINE_FLAG_OUTPUT | (g.active_low ? GPIO_V2_LINE_FLAG_ACTIVE_LOW : 0);
+
+            if (ioctl(chip, GPIO_V2_GET_LINE_IOCTL, &req) < 0) {
+                *err = g.chip + ": 申请线路失败: " + strerror(errno);
+                close(chip);
+                return nullptr;
+            }
+            relay->requests_.push_back({req.fd, g.chip, relay->count_, (uint16_t)n, 0, false});
+            relay->count_ += (uint16_t)n;
+        }
+        close(chip);
+        LOG_I("%s: %zu 路继电器%s", g.chip.c_str(), g.lines.size(), g.active_low ? " (低电平触发)" : "");
+    }
+
+    if (relay->count_ == 0) {
+        *err = "没有指定 GPIO 线路";
+        return nullptr;
+    }
+    return relay;
+}
+
+bool GpioRelay::write(const uint8_t* bits, std::string* err) {
+    for (Request& r : requests_) {
+        uint64_t value = 0;
+        for (uint16_t i = 0; i < r.lines; i++) {
+            if (bit_get(bits, r.first + i)) value |= 1ULL << i;
+        }
+        if (r.written && value == r.last) continue;
+
+        gpio_v2_line_values v;
+        v.bits = value;
+        v.mask = r.lines == 64 ? ~0ULL : (1ULL << r.lines) - 1;
+        if (ioctl(r.fd, GPIO_V2_LINE_SET_VALUES_IOCTL, &v) < 0) {
+            *err = r.chip + ": 写入失败: " + strerror(errno);
+            r.written = false;
+            return false;
+        }
+        r.last = value;
+        r.written = true;
+    }
+    return true;
+}
+
+// ==================== 参数解析 ====================
+
+/**
+ * 解析 CHIP:L1,L2,...[:active-low]
+ */
+static bool parse_group(const std::string& text, GpioRelayGroup* out) {
+    std::string rest = text;
+    const std::string suffix = ":active-low";
+    if (rest.size() > suffix.size() && rest.compare(rest.size() - suffix.size(), suffix.size(), suffix) == 0) {
+        out->active_low = true;
+        rest.resize(rest.size() - suffix.size());
+    }
+
+    size_t colon = rest.rfind(':');
+    if (colon == std::string::npos || colon == 0) return false;
+    out->chip = rest.substr(0, colon);
+    if (out->chip.find('/') == std::string::npos) out->chip = "/dev/" + out->chip;
+
+    const char* p = rest.c_str() + colon + 1;
+    while (*p != '\0') {
+        char* end;
+        unsigned long line = strtoul(p, &end, 10);
+        if (end == p || (*end != ',' && *end != '\0')) return false;
+        out->lines.push_back((uint32_t)line);
+        p = *end == ',' ? end + 1 : end;
+    }
+    return !out->lines.empty();
+}
+
+std::unique_ptr<RelayBackend> relay_open(const std::string& spec, std::string* err) {
+    if (spec.compare(0, 4, "sim:") == 0) {
+        char* end;
+        unsigned long n = strtoul(spec.c_str() + 4, &end, 10);
+        if (*end != '\0' || n == 0 || n > 0xFFFF) {
+            *err = "无效的继电器数量: " + spec;
+            return nullptr;
+        }
+        return std::make_unique<SimRelay>((uint16_t)n);
+    }
+
+    if (spec.compare(0, 5, "gpio:") == 0) {
+        std::vector<GpioRelayGroup> groups;
+        size_t start = 5;
+        while (start <= spec.size()) {
+            size_t plus = spec.find('+', start);
+            if (plus == std::string::npos) plus = spec.size();
+            GpioRelayGroup g;
+            if (!parse_group(spec.substr(start, plus - start), &g)) {
+                *err = "无效的 GPIO 线路: " + spec.substr(start, plus - start);
+                return nullptr;
+            }
+            groups.push_back(std::move(g));
+            start = plus + 1;
+        }
+        return GpioRelay::open(groups, err);
+    }
+
+    *err = "未知的继电器后端: " + spec;
+    return nullptr;
+}
+
+}  // namespace wt
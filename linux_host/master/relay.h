@@ -0,0 +1,99 @@
+/*
+ * 继电器输出后端
+ *
+ * - SimRelay:  只记录状态 (开发和压力测试)
+ * - GpioRelay: Linux GPIO 字符设备 (gpio-cdev v2 接口)，每个 gpiochip 一次 ioctl 同时切换全部线路
+ *
+ * 继电器 i 对应水塔表中第 i 个水塔 (与 ESP8266 主机的 74HC595 映射一致)。
+ */
+
+#ifndef WT_RELAY_H
+#define WT_RELAY_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace wt {
+
+class RelayBackend {
+public:
+    virtual ~RelayBackend() = default;
+
+    virtual const char* name() const = 0;
+
+    /**
+     * 继电器路数
+     */
+    virtual uint16_t count() const = 0;
+
+    /**
+     * 输出全部继电器
+     * @param bits 位图 (bit i = 继电器 i)
+     * @return false=失败 (err 中为原因)
+     */
+    virtual bool write(const uint8_t* bits, std::string* err) = 0;
+};
+
+class SimRelay : public RelayBackend {
+public:
+    explicit SimRelay(uint16_t count);
+
+    const char* name() const override { return "sim"; }
+    uint16_t count() const override { return count_; }
+    bool write(const uint8_t* bits, std::string* err) override;
+
+private:
+    uint16_t count_;
+    std::vector<uint8_t> state_;
+};
+
+// 一个 gpiochip 上的一组输出线路
+struct GpioRelayGroup {
+    std::string chip;               // /dev/gpiochipN
+    std::vector<uint32_t> lines;    // 线路偏移，依次对应继电器编号
+    bool active_low = false;        // 低电平触发的继电器模块
+};
+
+class GpioRelay : public RelayBackend {
+public:
+    ~GpioRelay() override;
+
+    /**
+     * 申请全部线路为输出 (初始为关闭)
+     * @return nullptr=失败
+     */
+    static std::unique_ptr<GpioRelay> open(const std::vector<GpioRelayGroup>& groups, std::string* err);
+
+    const char* name() const override { return "gpio"; }
+    uint16_t count() const override { return count_; }
+    bool write(const uint8_t* bits, std::string* err) override;
+
+private:
+    // 一次线路申请最多 64 条 (GPIO_V2_LINES_MAX)，超出时同一芯片分多次申请
+    struct Request {
+        int fd;
+        std::string chip;
+        uint16_t first;         // 第一条线路对应的继电器编号
+        uint16_t lines;
+        uint64_t last;          // 上次输出的值 (未变化时不调用 ioctl)
+        bool written;
+    };
+
+    GpioRelay() = default;
+
+    std::vector<Request> requests_;
+    uint16_t count_ = 0;
+};
+
+/**
+ * 按命令行参数创建后端
+ *   sim:N                          模拟 N 路
+ *   gpio:CHIP:L1,L2,...[:active-low][+CHIP:...]
+ */
+std::unique_ptr<RelayBackend> relay_open(const std::string& spec, std::string* err);
+
+}  // namespace wt
+
+#endif  // WT_RELAY_H
@@ -0,0 +1,102 @@
+/*
+ * 微基准框架实现
+ */
+
+#include "bench.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<uint64_t> g_allocs{ 0 };
+std::atomic<uint64_t> g_alloc_bytes{ 0 };
+
+void* counted_alloc(size_t size) {
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    g_alloc_bytes.fetch_add(size, std::memory_order_relaxed);
+    void* p = malloc(size ? size : 1);
+    if (p == nullptr) throw std::bad_alloc();
+    return p;
+}
+
+}  // namespace
+
+// ==================== 全局 operator new (分配计数) ====================
+
+void* operator new(size_t size) {
+    return counted_alloc(size);
+}
+
+void* operator new[](size_t size) {
+    return counted_alloc(size);
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+    free(p);
+}
+
+namespace wt {
+
+uint64_t bench_alloc_count() {
+    return g_allocs.load(std::memory_order_relaxed);
+}
+
+uint64_t bench_alloc_bytes() {
+    return g_alloc_bytes.load(std::memory_order_relaxed);
+}
+
+void BenchState::start() {
+    start_allocs_ = bench_alloc_count();
+    start_bytes_ = bench_alloc_bytes();
+    start_ = std::chrono::steady_clock::now();
+}
+
+void BenchState::stop() {
+    elapsed_ns_ = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start_).count();
+    allocs_ = bench_alloc_count() - start_allocs_;
+    alloc_bytes_ = bench_alloc_bytes() - start_bytes_;
+}
+
+// 迭代次数上限 (极快的基准在最短时间内也停下)
+#define BENCH_MAX_ITERATIONS    ((uint64_t)1000000000)
+
+BenchResult bench_run(const Benchmark& bench, int64_t arg, double min_time_s) {
+    double min_ns = min_time_s * 1e9;
+    uint64_t iterations = 1;
+    for (;;) {
+        BenchState state(arg, iterations);
+        bench.func(state);
+
+        if (state.elapsed_ns() >= min_ns || iterations >= BENCH_MAX_ITERATIONS) {
+            BenchResult r;
+            r.name = bench.uses_arg ? std::string(bench.name) + "/" + std::to_string(arg) : bench.name;
+            r.iterations = iterations;
+            r.ns_per_op = state.elapsed_ns() / iterations;
+            r.allocs_per_op = (double)state.allocs() / iterations;
+            r.bytes_per_op = (double)state.alloc_bytes() / iterations;
+            return r;
+        }
+
+        // 按本次耗时估算达到最短时间所需的次数 (多估 40%)，每轮最多放大 100 倍
+        double estimate = state.elapsed_ns() > 0 ? iterations * min_ns * 1.4 / state.elapsed_ns() : iterations * 100.0;
+        double next = std::min(std::max(estimate, iterations + 1.0), iterations * 100.0);
+        iterations = std::min((uint64_t)next, BENCH_MAX_ITERATIONS);
+    }
+}
+
+}  // namespace wt
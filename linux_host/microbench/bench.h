@@ -0,0 +1,112 @@
+/*
+ * 微基准框架 (写法与 Google Benchmark 相同)
+ *
+ *   void bench_xxx(BenchState& state) {
+ *       ... 准备 (不计时) ...
+ *       for (auto _ : state) {
+ *           ... 被测代码，结果交给 bench_keep() 防止被优化掉 ...
+ *       }
+ *   }
+ *
+ * 运行器自动增加迭代次数直到单次运行超过最短时间，报告每次迭代的纳秒数和堆分配次数
+ * (本程序替换了全局 operator new，计时循环内的每次 new 都计数)。
+ */
+
+#ifndef WT_BENCH_H
+#define WT_BENCH_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace wt {
+
+/**
+ * 进程内累计的堆分配次数和字节数
+ */
+uint64_t bench_alloc_count();
+uint64_t bench_alloc_bytes();
+
+/**
+ * 阻止编译器把结果当作无用计算删除
+ */
+template <class T>
+inline void bench_keep(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+class BenchState {
+public:
+    BenchState(int64_t arg, uint64_t iterations) : arg_(arg), iterations_(iterations) {}
+
+    /**
+     * 参数 (水塔数等)，无参数的基准为 0
+     */
+    int64_t arg() const { return arg_; }
+    uint64_t iterations() const { return iterations_; }
+
+    double elapsed_ns() const { return elapsed_ns_; }
+    uint64_t allocs() const { return allocs_; }
+    uint64_t alloc_bytes() const { return alloc_bytes_; }
+
+    // 循环变量的类型 (for (auto _ : state) 中不使用，不产生未使用变量警告)
+    struct __attribute__((unused)) Value {};
+
+    struct Iterator {
+        BenchState* state;
+        uint64_t left;
+
+        bool operator!=(const Iterator&) {
+            if (left > 0) return true;
+            state->stop();
+            return false;
+        }
+        void operator++() { left--; }
+        Value operator*() const { return Value(); }
+    };
+
+    Iterator begin() {
+        start();
+        return Iterator{ this, iterations_ };
+    }
+    Iterator end() { return Iterator{ this, 0 }; }
+
+private:
+    void start();
+    void stop();
+
+    int64_t arg_;
+    uint64_t iterations_;
+    std::chrono::steady_clock::time_point start_;
+    uint64_t start_allocs_ = 0;
+    uint64_t start_bytes_ = 0;
+    double elapsed_ns_ = 0;
+    uint64_t allocs_ = 0;
+    uint64_t alloc_bytes_ = 0;
+};
+
+typedef void (*BenchFunc)(BenchState& state);
+
+struct Benchmark {
+    const char* name;
+    BenchFunc func;
+    bool uses_arg;          // 按 --towers 的每个取值各运行一次
+};
+
+struct BenchResult {
+    std::string name;       // 名称/参数
+    uint64_t iterations = 0;
+    double ns_per_op = 0;
+    double allocs_per_op = 0;
+    double bytes_per_op = 0;
+};
+
+/**
+ * 运行一个基准 (一个参数)，迭代次数自动增加到运行时间不少于 min_time_s
+ */
+BenchResult bench_run(const Benchmark& bench, int64_t arg, double min_time_s);
+
+}  // namespace wt
+
+#endif  // WT_BENCH_H
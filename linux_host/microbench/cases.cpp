@@ -0,0 +1,229 @@
+/*
+ * 主机固件纯逻辑部分的基准
+ *
+ * 被测代码都取自固件或与固件共用：
+ *   frame_handle    handle_network_comm() 中的帧解析和水塔表更新 (master_core_handle_frame)
+ *   towers_json_linux  wt-master 的 /api/towers JSON (towers_json_build，std::string，格式同固件；
+ *                   固件的 String/F() 版本依赖 Arduino，不在此测量，见 trace 的 api_build 区段)
+ *   auto_scan       process_auto_mode() 一轮，水位都在阈值之间 (只扫描，不切换)
+ *   auto_switch     同上，每轮全部水泵切换 (含继电器输出回调)
+ *   find_hit/miss   按从机地址查水塔 (master_core_find，原 find_tower)
+ *   error_message   error_get_message() 按错误码查描述 (含未定义的错误码)
+ *   history_encode  全部水塔的 48 条历史记录 (TowerData.history) 编码为列格式
+ * 带参数的基准参数为水塔数。
+ */
+
+#include "cases.h"
+
+#include "column.h"
+#include "controller.h"
+#include "error_codes.h"
+#include "master_core.h"
+
+#include <cstring>
+#include <vector>
+
+namespace wt {
+
+namespace {
+
+bool noop_relay_write(void*, const uint8_t*, uint16_t) {
+    return true;
+}
+
+void noop_tower_changed(void*, uint16_t, uint8_t) {
+}
+
+const MasterHooks_t NOOP_HOOKS = {
+    noop_relay_write,
+    noop_tower_changed,
+    nullptr,
+    nullptr,
+    nullptr,
+};
+
+/**
+ * 控制核心 + 已加入的 n 个水塔 (从机地址 1..n，按地址顺序加入)
+ */
+struct CoreFixture {
+    std::vector<TowerData> towers;
+    uint16_t tower_count = 0;
+    SystemStatus status;
+    MasterCore_t core;
+
+    CoreFixture(uint16_t n, SystemMode mode) : towers(MAX_TOWERS) {
+        memset(&status, 0, sizeof(status));
+        memset(&core, 0, sizeof(core));
+        status.mode = mode;
+        status.well_water_ok = true;
+        core.towers = towers.data();
+        core.tower_count = &tower_count;
+        core.status = &status;
+        core.relay_count = n;
+        core.hooks = &NOOP_HOOKS;
+        master_core_begin(&core, nullptr);
+
+        for (uint16_t i = 0; i < n; i++) {
+            uint8_t frame[5] = { (uint8_t)(i + 1), CMD_SENSOR_DATA, 2, (uint8_t)(i * 37 % 101), 1 };
+            master_core_handle_frame(&core, frame, sizeof(frame), 0);
+        }
+    }
+};
+
+uint16_t tower_arg(const BenchState& state) {
+    return (uint16_t)state.arg();
+}
+
+// ==================== 帧处理 ====================
+
+void bench_frame_handle(BenchState& state) {
+    uint16_t n = tower_arg(state);
+    CoreFixture f(n, MODE_MANUAL);
+
+    // 各水塔依次上报，水位每次都变化 (触发变化回调)
+    std::vector<uint8_t> frames;
+    for (uint32_t k = 0; k < (uint32_t)n * 4; k++) {
+        uint8_t frame[5] = { (uint8_t)(k % n + 1), CMD_SENSOR_DATA, 2, (uint8_t)(k * 53 % 101), 1 };
+        frames.insert(frames.end(), frame, frame + sizeof(frame));
+    }
+
+    size_t pos = 0;
+    uint32_t now = 0;
+    for (auto _ : state) {
+        bench_keep(master_core_handle_frame(&f.core, &frames[pos], 5, now));
+        pos += 5;
+        if (pos == frames.size()) pos = 0;
+        now += 20;
+    }
+}
+
+// ==================== /api/towers ====================
+
+void bench_towers_json_linux(BenchState& state) {
+    uint16_t n = tower_arg(state);
+    CoreFixture f(n, MODE_MANUAL);
+    for (uint16_t i = 0; i < n; i += 3) master_core_set_pump(&f.core, i, true);
+
+    for (auto _ : state) {
+        std::string body = towers_json_build(f.towers.data(), f.tower_count);
+        bench_keep(body.data());
+    }
+}
+
+// ==================== 自动控制 ====================
+
+void bench_auto_scan(BenchState& state) {
+    uint16_t n = tower_arg(state);
+    CoreFixture f(n, MODE_AUTO);
+    for (uint16_t i = 0; i < n; i++) f.towers[i].water_level = 50;
+
+    for (auto _ : state) {
+        bench_keep(master_core_auto(&f.core));
+    }
+}
+
+void bench_auto_switch(BenchState& state) {
+    uint16_t n = tower_arg(state);
+    CoreFixture f(n, MODE_AUTO);
+    bool low = true;
+
+    for (auto _ : state) {
+        uint8_t level = low ? 10 : 95;
+        for (uint16_t i = 0; i < n; i++) f.towers[i].water_level = level;
+        low = !low;
+        bench_keep(master_core_auto(&f.core));
+    }
+}
+
+// ==================== 水塔查找 ====================
+
+void bench_find_hit(BenchState& state) {
+    uint16_t n = tower_arg(state);
+    CoreFixture f(n, MODE_MANUAL);
+    uint8_t id = 1;
+
+    for (auto _ : state) {
+        bench_keep(master_core_find(&f.core, id));
+        id = id >= n ? 1 : id + 1;
+    }
+}
+
+void bench_find_miss(BenchState& state) {
+    uint16_t n = tower_arg(state);
+    CoreFixture f(n, MODE_MANUAL);
+    // 未加入的地址: n+1..255 和 0
+    uint8_t id = 0;
+
+    for (auto _ : state) {
+        bench_keep(master_core_find(&f.core, id));
+        id = id == 0 ? (uint8_t)(n + 1) : (uint8_t)(id + 1);
+    }
+}
+
+// ==================== 错误描述 ====================
+
+void bench_error_message(BenchState& state) {
+    // 覆盖全部类别 (含表中空位和超出范围的错误码)
+    const uint16_t codes = ERR_CATEGORY_COUNT * 100 + 100;
+    uint16_t code = 0;
+
+    for (auto _ : state) {
+        bench_keep(error_get_message(code));
+        if (++code == codes) code = 0;
+    }
+}
+
+// ==================== 历史记录编码 ====================
+
+void bench_history_encode(BenchState& state) {
+    uint16_t n = tower_arg(state);
+    CoreFixture f(n, MODE_MANUAL);
+
+    // 每小时一条，时间戳有几秒抖动，水位缓慢变化
+    for (uint16_t i = 0; i < n; i++) {
+        for (uint16_t k = 0; k < HISTORY_SIZE; k++) {
+            HistoryRecord& h = f.towers[i].history[k];
+            h.timestamp = 1700000000u + k * 3600u + (k * 7 + i) % 5;
+            h.water_level = (uint8_t)(40 + (k * 3 + i) % 50);
+            h.pump_status = (k / 6 + i) % 3 == 0;
+        }
+    }
+
+    std::vector<int64_t> ts(HISTORY_SIZE), dod(HISTORY_SIZE), level(HISTORY_SIZE), pump(HISTORY_SIZE);
+    for (auto _ : state) {
+        std::string out;
+        for (uint16_t i = 0; i < n; i++) {
+            const HistoryRecord* h = f.towers[i].history;
+            for (uint16_t k = 0; k < HISTORY_SIZE; k++) {
+                ts[k] = h[k].timestamp;
+                level[k] = h[k].water_level;
+                pump[k] = h[k].pump_status;
+            }
+            timestamp_to_dod(ts.data(), HISTORY_SIZE, dod.data());
+            column_encode(dod.data(), HISTORY_SIZE, out);
+            column_encode(level.data(), HISTORY_SIZE, out);
+            column_encode(pump.data(), HISTORY_SIZE, out);
+        }
+        bench_keep(out.data());
+    }
+}
+
+const Benchmark CASES[] = {
+    { "frame_handle", bench_frame_handle, true },
+    { "towers_json_linux", bench_towers_json_linux, true },
+    { "auto_scan", bench_auto_scan, true },
+    { "auto_switch", bench_auto_switch, true },
+    { "find_hit", bench_find_hit, true },
+    { "find_miss", bench_find_miss, true },
+    { "error_message", bench_error_message, false },
+    { "history_encode", bench_history_encode, true },
+};
+
+}  // namespace
+
+const Benchmark* microbench_cases(size_t* count) {
+    *count = sizeof(CASES) / sizeof(CASES[0]);
+    return CASES;
+}
+
+}  // namespace wt
@@ -0,0 +1,21 @@
+/*
+ * 主机固件纯逻辑部分的基准列表
+ */
+
+#ifndef WT_CASES_H
+#define WT_CASES_H
+
+#include "bench.h"
+
+#include <cstddef>
+
+namespace wt {
+
+/**
+ * 全部基准 (按报告顺序)
+ */
+const Benchmark* microbench_cases(size_t* count);
+
+}  // namespace wt
+
+#endif  // WT_CASES_H
@@ -0,0 +1,138 @@
+/*
+ * wt-microbench: 主机固件纯逻辑部分的微基准
+ *
+ * 在 Linux 上单独运行固件中与硬件无关的热点 (帧解析、/api/towers、自动控制、
+ * 水塔查找、错误描述、历史记录编码)，在烧录前量化优化效果。基准列表见 cases.cpp。
+ *
+ * 用法:
+ *   wt-microbench [--filter TEXT] [--towers LIST] [--min-time S] [--csv FILE] [--list]
+ *
+ *   --filter     只运行名称包含 TEXT 的基准
+ *   --towers     水塔数 (默认 1,8,64,255)
+ *   --min-time   每个基准的最短运行时间 (秒，默认 0.2)
+ *   --csv        结果写入 CSV ("-" 为标准输出)
+ *   --list       列出基准名称
+ *
+ * 每行输出: 名称/水塔数、迭代次数、ns/op、allocs/op、bytes/op。
+ * 与固件一样按 MAX_TOWERS=256 编译；单线程运行，结果受 CPU 频率调节影响，对比时固定频率。
+ */
+
+#include "bench.h"
+#include "cases.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace wt;
+
+namespace {
+
+void usage(const char* prog) {
+    fprintf(stderr, "用法: %s [--filter TEXT] [--towers LIST] [--min-time S] [--csv FILE] [--list]\n", prog);
+}
+
+/**
+ * 解析逗号分隔的整数列表
+ */
+bool parse_list(const char* s, uint32_t min, uint32_t max, std::vector<uint32_t>* out) {
+    out->clear();
+    while (*s) {
+        char* end;
+        unsigned long v = strtoul(s, &end, 10);
+        if (end == s || v < min || v > max) return false;
+        out->push_back((uint32_t)v);
+        if (*end == ',') end++;
+        else if (*end != '\0') return false;
+        s = end;
+    }
+    return !out->empty();
+}
+
+void write_csv(FILE* f, const std::vector<BenchResult>& results) {
+    fprintf(f, "name,iterations,ns_per_op,allocs_per_op,bytes_per_op\n");
+    for (const BenchResult& r : results) {
+        fprintf(f, "%s,%llu,%.2f,%.3f,%.1f\n", r.name.c_str(), (unsigned long long)r.iterations, r.ns_per_op,
+                r.allocs_per_op, r.bytes_per_op);
+    }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::string filter;
+    std::vector<uint32_t> towers = { 1, 8, 64, 255 };
+    double min_time_s = 0.2;
+    std::string csv_path;
+    bool list = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        bool ok = true;
+        if (arg == "--filter" && has_value) {
+            filter = argv[++i];
+        } else if (arg == "--towers" && has_value) {
+            // 从机地址 1..255
+            ok = parse_list(argv[++i], 1, 255, &towers);
+        } else if (arg == "--min-time" && has_value) {
+            min_time_s = strtod(argv[++i], nullptr);
+            ok = min_time_s > 0;
+        } else if (arg == "--csv" && has_value) {
+            csv_path = argv[++i];
+        } else if (arg == "--list") {
+            list = true;
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    size_t count;
+    const Benchmark* cases = microbench_cases(&count);
+    if (list) {
+        for (size_t i = 0; i < count; i++) printf("%s%s\n", cases[i].name, cases[i].uses_arg ? "/<水塔数>" : "");
+        return 0;
+    }
+
+    // CSV 写到标准输出时表格改到标准错误
+    FILE* out = csv_path == "-" ? stderr : stdout;
+    fprintf(out, "%-24s %12s %12s %10s %10s\n", "基准", "迭代", "ns/op", "allocs/op", "bytes/op");
+
+    std::vector<BenchResult> results;
+    for (size_t i = 0; i < count; i++) {
+        if (!filter.empty() && strstr(cases[i].name, filter.c_str()) == nullptr) continue;
+        std::vector<uint32_t> args = cases[i].uses_arg ? towers : std::vector<uint32_t>{ 0 };
+        for (uint32_t a : args) {
+            BenchResult r = bench_run(cases[i], a, min_time_s);
+            fprintf(out, "%-24s %12llu %12.2f %10.3f %10.1f\n", r.name.c_str(), (unsigned long long)r.iterations,
+                    r.ns_per_op, r.allocs_per_op, r.bytes_per_op);
+            fflush(out);
+            results.push_back(r);
+        }
+    }
+    if (results.empty()) {
+        fprintf(stderr, "没有名称包含 \"%s\" 的基准\n", filter.c_str());
+        return 2;
+    }
+
+    if (!csv_path.empty()) {
+        FILE* f = csv_path == "-" ? stdout : fopen(csv_path.c_str(), "w");
+        if (f == nullptr) {
+            fprintf(stderr, "%s: %s\n", csv_path.c_str(), strerror(errno));
+            return 2;
+        }
+        write_csv(f, results);
+        if (f != stdout && fclose(f) != 0) {
+            fprintf(stderr, "%s: %s\n", csv_path.c_str(), strerror(errno));
+            return 2;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,233 @@
+/*
+ * wt-plantsim: 供水系统仿真，比较水泵控制策略
+ *
+ * 把主机控制核心 (master_core.cpp) 和从机协议 (slave_proto.c、slave_window.c) 接到供水系统物理模型上
+ * (见 plant.h)，以 1 秒步长运行数天，统计各策略的启泵次数、运行时间、空转、溢流和井水位。
+ * 每个策略在种子 1..N 上各运行一次，同一种子下所有策略面对相同的水塔参数和用水序列。
+ *
+ * 用法:
+ *   wt-plantsim [--strategies LIST] [--towers N] [--days N] [--runs N] [--well-m3 M3]
+ *               [--recharge M3H] [--well-low PCT] [--well-ok PCT] [--demand M3] [--outages N]
+ *               [--threads N] [--csv FILE]
+ *
+ *   --strategies 逗号分隔的策略 (见 strategy.h)，
+ *                默认 firmware,band:on=30:off=80,band:max=3:minoff=600:offline
+ *   --towers     水塔数 (默认 8)
+ *   --days       每次运行的天数 (默认 7)
+ *   --runs       每个策略运行的次数 (默认 20)
+ *   --well-m3    井的可用容量 (默认 120)
+ *   --recharge   井的补水速度 m³/h (默认 20)
+ *   --well-low   浮球开关断开的井水位 % (默认 10)
+ *   --well-ok    浮球开关重新闭合的井水位 % (默认 20)
+ *   --demand     每座水塔平均日用水量 m³ (默认 30)
+ *   --outages    每座水塔每天通信中断的概率 (默认 0.05)
+ *   --csv        每次运行一行写入 CSV ("-" 为标准输出)
+ *   --threads    并行线程数 (默认 CPU 核数)
+ *
+ * 标准输出为按策略汇总的表格 (各次运行平均，按天折算)。
+ */
+
+#include "scenario.h"
+#include "strategy.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace wt;
+
+namespace {
+
+void usage(const char* prog) {
+    fprintf(stderr,
+            "用法: %s [--strategies LIST] [--towers N] [--days N] [--runs N] [--well-m3 M3]\n"
+            "          [--recharge M3H] [--well-low PCT] [--well-ok PCT] [--demand M3] [--outages N]\n"
+            "          [--threads N] [--csv FILE]\n",
+            prog);
+}
+
+std::vector<std::string> split(const std::string& s) {
+    std::vector<std::string> out;
+    size_t pos = 0;
+    while (pos <= s.size()) {
+        size_t comma = s.find(',', pos);
+        out.push_back(s.substr(pos, comma == std::string::npos ? std::string::npos : comma - pos));
+        if (comma == std::string::npos) break;
+        pos = comma + 1;
+    }
+    return out;
+}
+
+void write_csv(FILE* f, const std::vector<ScenarioResult>& results) {
+    fprintf(f,
+            "strategy,towers,days,seed,pump_starts,run_h,dry_run_events,dry_run_min,overflow_events,overflow_m3,"
+            "empty_h,unmet_m3,demand_m3,pumped_m3,well_min_pct,well_trips,well_low_h,frames,offline_events,"
+            "wall_ms\n");
+    for (const ScenarioResult& r : results) {
+        const PlantConfig& c = r.config;
+        const PlantStats& s = r.stats;
+        fprintf(f, "\"%s\",%u,%u,%u,%llu,%.2f,%llu,%.1f,%llu,%.2f,%.2f,%.2f,%.1f,%.1f,%.1f,%llu,%.2f,%llu,%llu,%.1f\n",
+                r.strategy.c_str(), c.towers, c.days, c.seed, (unsigned long long)s.pump_starts, s.run_s / 3600,
+                (unsigned long long)s.dry_run_events, s.dry_run_s / 60, (unsigned long long)s.overflow_events,
+                s.overflow_m3, s.empty_s / 3600, s.unmet_m3, s.demand_m3, s.pumped_m3, s.well_min_pct,
+                (unsigned long long)s.well_trips, s.well_low_s / 3600, (unsigned long long)r.frames,
+                (unsigned long long)r.offline_events, r.wall_ms);
+    }
+}
+
+/**
+ * 汇总：同一策略的各次运行相邻排列
+ */
+void print_summary(FILE* out, const std::vector<ScenarioResult>& results, uint32_t runs) {
+    size_t width = 8;
+    for (const ScenarioResult& r : results) width = std::max(width, r.strategy.size());
+
+    fprintf(out, "%-*s %10s %10s %8s %8s %8s %8s %8s %8s %9s %8s %8s %9s\n", (int)width, "策略",
+            "启泵/台/天", "运行h/台/天", "空转/天", "空转min", "溢流/天", "溢流m³", "断水h", "缺水m³", "井最低%",
+            "井断开", "供水m³/天", "×实时");
+    for (size_t i = 0; i < results.size(); i += runs) {
+        const PlantConfig& c = results[i].config;
+        PlantStats sum;
+        double well_min = 0, wall_ms = 0;
+        for (size_t j = i; j < i + runs; j++) {
+            const PlantStats& s = results[j].stats;
+            sum.pump_starts += s.pump_starts;
+            sum.run_s += s.run_s;
+            sum.dry_run_events += s.dry_run_events;
+            sum.dry_run_s += s.dry_run_s;
+            sum.overflow_events += s.overflow_events;
+            sum.overflow_m3 += s.overflow_m3;
+            sum.empty_s += s.empty_s;
+            sum.unmet_m3 += s.unmet_m3;
+            sum.pumped_m3 += s.pumped_m3;
+            sum.well_trips += s.well_trips;
+            well_min += s.well_min_pct / runs;
+            wall_ms += results[j].wall_ms;
+        }
+        double days = (double)c.days * runs;
+        double pump_days = days * c.towers;
+        fprintf(out, "%-*s %10.2f %10.2f %8.2f %8.1f %8.2f %8.2f %8.2f %8.2f %9.1f %8.2f %8.1f %9.0f\n", (int)width,
+                results[i].strategy.c_str(), sum.pump_starts / pump_days, sum.run_s / 3600 / pump_days,
+                sum.dry_run_events / days, sum.dry_run_s / 60 / days, sum.overflow_events / days,
+                sum.overflow_m3 / days, sum.empty_s / 3600 / days, sum.unmet_m3 / days, well_min,
+                sum.well_trips / days, sum.pumped_m3 / days, wall_ms > 0 ? days * 86400e3 / wall_ms : 0.0);
+    }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::vector<std::string> strategies = split("firmware,band:on=30:off=80,band:max=3:minoff=600:offline");
+    uint32_t runs = 20;
+    uint32_t threads = 0;
+    std::string csv_path;
+    PlantConfig base;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        bool ok = true;
+        if (arg == "--strategies" && has_value) {
+            strategies = split(argv[++i]);
+        } else if (arg == "--towers" && has_value) {
+            unsigned long n = strtoul(argv[++i], nullptr, 10);
+            ok = n > 0 && n <= MAX_TOWERS - 1;
+            base.towers = (uint16_t)n;
+        } else if (arg == "--days" && has_value) {
+            base.days = (uint32_t)strtoul(argv[++i], nullptr, 10);
+            ok = base.days > 0;
+        } else if (arg == "--runs" && has_value) {
+            runs = (uint32_t)strtoul(argv[++i], nullptr, 10);
+            ok = runs > 0;
+        } else if (arg == "--well-m3" && has_value) {
+            base.well_m3 = strtod(argv[++i], nullptr);
+            ok = base.well_m3 > 0;
+        } else if (arg == "--recharge" && has_value) {
+            base.recharge_m3h = strtod(argv[++i], nullptr);
+            ok = base.recharge_m3h >= 0;
+        } else if (arg == "--well-low" && has_value) {
+            base.well_low_pct = strtod(argv[++i], nullptr);
+        } else if (arg == "--well-ok" && has_value) {
+            base.well_ok_pct = strtod(argv[++i], nullptr);
+        } else if (arg == "--demand" && has_value) {
+            base.demand_m3_day = strtod(argv[++i], nullptr);
+            ok = base.demand_m3_day >= 0;
+        } else if (arg == "--outages" && has_value) {
+            base.outages_per_day = strtod(argv[++i], nullptr);
+            ok = base.outages_per_day >= 0;
+        } else if (arg == "--threads" && has_value) {
+            threads = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--csv" && has_value) {
+            csv_path = argv[++i];
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (base.well_low_pct >= base.well_ok_pct) {
+        fprintf(stderr, "--well-low 应低于 --well-ok\n");
+        return 2;
+    }
+
+    // 先检查全部策略描述，避免跑到一半才报错
+    for (const std::string& spec : strategies) {
+        std::string err;
+        if (!strategy_create(spec, &err)) {
+            fprintf(stderr, "%s\n", err.c_str());
+            return 2;
+        }
+    }
+
+    std::vector<PlantConfig> configs;
+    for (uint32_t seed = 1; seed <= runs; seed++) {
+        PlantConfig c = base;
+        c.seed = seed;
+        configs.push_back(c);
+    }
+
+    // 同一策略的各次运行相邻，便于汇总
+    std::vector<ScenarioResult> results(strategies.size() * runs);
+    auto start = std::chrono::steady_clock::now();
+    size_t workers;
+    {
+        ThreadPool pool(threads);
+        workers = pool.size();
+        for (size_t i = 0; i < results.size(); i++) {
+            pool.submit([&configs, &strategies, &results, runs, i] {
+                std::string err;
+                scenario_run(configs[i % runs], strategies[i / runs], &results[i], &err);
+            });
+        }
+    }
+    double wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (!csv_path.empty()) {
+        FILE* f = csv_path == "-" ? stdout : fopen(csv_path.c_str(), "w");
+        if (f == nullptr) {
+            fprintf(stderr, "%s: %s\n", csv_path.c_str(), strerror(errno));
+            return 2;
+        }
+        write_csv(f, results);
+        if (f != stdout && fclose(f) != 0) {
+            fprintf(stderr, "%s: %s\n", csv_path.c_str(), strerror(errno));
+            return 2;
+        }
+    }
+
+    // CSV 写到标准输出时汇总改到标准错误
+    FILE* out = csv_path == "-" ? stderr : stdout;
+    double sim_days = (double)base.days * results.size();
+    fprintf(out, "%zu 次运行 (%u 座水塔，每次 %u 天)，%zu 线程，耗时 %.2f 秒，共 %.0f 倍实时\n\n", results.size(),
+            base.towers, base.days, workers, wall_s, wall_s > 0 ? sim_days * 86400 / wall_s : 0.0);
+    print_summary(out, results, runs);
+    return 0;
+}
@@ -0,0 +1,160 @@
+/*
+ * 供水系统物理模型实现
+ */
+
+#include "plant.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace wt {
+
+namespace {
+
+// 每小时的用水系数 (早晚高峰)，使用时按平均值归一化
+const double DIURNAL[24] = {
+    0.35, 0.30, 0.30, 0.30, 0.40, 0.70, 1.30, 1.80, 1.70, 1.30, 1.10, 1.10,
+    1.20, 1.10, 1.00, 1.00, 1.10, 1.40, 1.70, 1.60, 1.30, 1.00, 0.70, 0.50,
+};
+
+// 每小时用水随机波动 (对数正态的 σ)
+#define DEMAND_SIGMA            0.35
+
+// 每座水塔每小时开始一次集中用水的概率，持续 0.5-1 小时，流量为平均的 2-5 倍
+#define BURST_PER_HOUR          0.03
+
+// 通信中断持续 1-8 小时
+#define OUTAGE_MIN_H            1.0
+#define OUTAGE_MAX_H            8.0
+
+double diurnal_mean() {
+    double sum = 0;
+    for (double v : DIURNAL) sum += v;
+    return sum / 24;
+}
+
+}  // namespace
+
+Plant::Plant(const PlantConfig& config) : cfg_(config), tanks_(config.towers), well_m3_(config.well_m3) {
+    std::mt19937_64 rng(config.seed);
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+    for (size_t i = 0; i < tanks_.size(); i++) {
+        Tank& t = tanks_[i];
+        t.volume_m3 = 20 + 40 * u(rng);
+        t.height_m = 3 + 3 * u(rng);
+        t.elevation_m = 10 + 20 * u(rng);
+        t.pump_q0 = (8 + 8 * u(rng)) / 3600.0;
+        t.pump_h0_m = t.elevation_m + t.height_m + 10 + 15 * u(rng);
+        t.demand = cfg_.demand_m3_day * (0.6 + 0.8 * u(rng)) / 86400.0;
+        t.water_m3 = t.volume_m3 * (0.4 + 0.4 * u(rng));
+        std::seed_seq seq{ (uint64_t)config.seed, (uint64_t)i };
+        t.rng.seed(seq);
+    }
+}
+
+/**
+ * 每小时抽取一次随机量 (每次抽取的个数固定，用水序列不受控制策略影响)
+ */
+void Plant::new_hour(Tank& t) {
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+    std::normal_distribution<double> n(-DEMAND_SIGMA * DEMAND_SIGMA / 2, DEMAND_SIGMA);
+    double factor = std::exp(n(t.rng));
+    double burst = u(t.rng);
+    double burst_len = u(t.rng);
+    double burst_mult = u(t.rng);
+    double outage = u(t.rng);
+    double outage_len = u(t.rng);
+
+    t.hour_factor = factor;
+    if (burst < BURST_PER_HOUR) {
+        t.burst_until = time_s_ + 1800 * (1 + burst_len);
+        t.burst_rate = t.demand * (2 + 3 * burst_mult);
+    }
+    if (outage < cfg_.outages_per_day / 24 && time_s_ >= t.outage_until) {
+        t.outage_until = time_s_ + 3600 * (OUTAGE_MIN_H + (OUTAGE_MAX_H - OUTAGE_MIN_H) * outage_len);
+    }
+}
+
+void Plant::step(double dt) {
+    static const double mean = diurnal_mean();
+
+    uint32_t hour = (uint32_t)(time_s_ / 3600);
+    if (hour != hour_) {
+        hour_ = hour;
+        for (Tank& t : tanks_) new_hour(t);
+    }
+    double profile = DIURNAL[hour % 24] / mean;
+
+    // 补水，再按扬程计算各水泵的流量；井中水量不够时按比例减少
+    well_m3_ = std::min(cfg_.well_m3, well_m3_ + cfg_.recharge_m3h / 3600.0 * dt);
+    double want = 0;
+    for (Tank& t : tanks_) {
+        if (!t.pump_on) continue;
+        double head = t.elevation_m + t.water_m3 / t.volume_m3 * t.height_m;
+        want += head >= t.pump_h0_m ? 0 : t.pump_q0 * std::sqrt(1 - head / t.pump_h0_m) * dt;
+    }
+    double scale = want > well_m3_ ? well_m3_ / want : 1.0;
+    bool dry = scale < 1.0;
+
+    for (Tank& t : tanks_) {
+        if (t.pump_on) {
+            double head = t.elevation_m + t.water_m3 / t.volume_m3 * t.height_m;
+            double in = head >= t.pump_h0_m ? 0 : t.pump_q0 * std::sqrt(1 - head / t.pump_h0_m) * dt * scale;
+            well_m3_ -= in;
+            t.water_m3 += in;
+            stats_.pumped_m3 += in;
+            stats_.run_s += dt;
+            if (dry && !t.dry) stats_.dry_run_events++;
+            if (dry) stats_.dry_run_s += dt;
+            t.dry = dry;
+        } else {
+            t.dry = false;
+        }
+
+        double use = (t.demand * profile * t.hour_factor + (time_s_ < t.burst_until ? t.burst_rate : 0)) * dt;
+        stats_.demand_m3 += use;
+        if (t.water_m3 >= use) {
+            t.water_m3 -= use;
+        } else {
+            stats_.unmet_m3 += use - t.water_m3;
+            stats_.empty_s += dt;
+            t.water_m3 = 0;
+        }
+
+        if (t.water_m3 > t.volume_m3) {
+            stats_.overflow_m3 += t.water_m3 - t.volume_m3;
+            t.water_m3 = t.volume_m3;
+            if (!t.overflowing) stats_.overflow_events++;
+            t.overflowing = true;
+        } else {
+            t.overflowing = false;
+        }
+    }
+    well_m3_ = std::max(0.0, well_m3_);
+
+    // 浮球开关 (带回差)
+    double pct = well_m3_ / cfg_.well_m3 * 100;
+    stats_.well_min_pct = std::min(stats_.well_min_pct, pct);
+    if (well_ok_ && pct < cfg_.well_low_pct) {
+        well_ok_ = false;
+        stats_.well_trips++;
+    } else if (!well_ok_ && pct >= cfg_.well_ok_pct) {
+        well_ok_ = true;
+    }
+    if (!well_ok_) stats_.well_low_s += dt;
+
+    time_s_ += dt;
+}
+
+void Plant::set_pump(uint16_t index, bool on) {
+    Tank& t = tanks_[index];
+    if (on && !t.pump_on) stats_.pump_starts++;
+    t.pump_on = on;
+}
+
+uint8_t Plant::level_pct(uint16_t index) const {
+    const Tank& t = tanks_[index];
+    return (uint8_t)std::lround(t.water_m3 / t.volume_m3 * 100);
+}
+
+}  // namespace wt
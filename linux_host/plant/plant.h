@@ -0,0 +1,125 @@
+/*
+ * 供水系统物理模型
+ *
+ * 一口井向 N 座水塔供水，每座水塔一台水泵 (由主机的一路继电器控制)：
+ * - 井: 容量、恒定补水速度；水位低于浮球开关时开关断开 (主机的井水传感器)，
+ *   回升到恢复点后闭合 (浮球的回差)
+ * - 水泵: 流量随扬程下降 Q = Q0·sqrt(1 - H/H0)，H = 水塔高程 + 水箱内水深；
+ *   多台同时运行超过井中可用水量时按比例减少，井抽空时水泵空转
+ * - 水箱: 容量、高度；进水超过容量即溢流，用水超过存量即断水
+ * - 用水: 日内曲线 (早晚高峰) × 每小时随机波动 (对数正态) + 随机的集中用水 (灌溉等)
+ * - 通信中断: 从机偶尔掉线数小时，期间主机收不到该水塔的水位
+ *
+ * 各水塔的参数和用水序列只取决于种子，同一种子下不同控制策略面对完全相同的用水。
+ */
+
+#ifndef WT_PLANT_H
+#define WT_PLANT_H
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace wt {
+
+struct PlantConfig {
+    uint16_t towers = 8;
+    uint32_t days = 7;
+    uint32_t seed = 1;
+
+    double well_m3 = 120;           // 井的可用容量
+    double recharge_m3h = 20;       // 补水速度
+    double well_low_pct = 10;       // 浮球开关断开
+    double well_ok_pct = 20;        // 浮球开关重新闭合
+
+    double demand_m3_day = 30;      // 每座水塔的平均日用水量 (各塔在 ±40% 内随机)
+    double outages_per_day = 0.05;  // 每座水塔每天发生通信中断的概率
+};
+
+struct PlantStats {
+    uint64_t pump_starts = 0;
+    double run_s = 0;               // 各水泵运行时间之和
+    uint64_t dry_run_events = 0;    // 水泵进入空转
+    double dry_run_s = 0;
+    uint64_t overflow_events = 0;   // 水箱开始溢流
+    double overflow_m3 = 0;
+    double empty_s = 0;             // 水箱断水时间 (各塔之和)
+    double unmet_m3 = 0;            // 断水期间未满足的用水量
+    double demand_m3 = 0;
+    double pumped_m3 = 0;
+    double well_min_pct = 100;
+    uint64_t well_trips = 0;        // 浮球开关断开次数
+    double well_low_s = 0;          // 浮球开关断开的时间
+};
+
+class Plant {
+public:
+    explicit Plant(const PlantConfig& config);
+
+    /**
+     * 推进 dt 秒 (用水、抽水、补水)
+     */
+    void step(double dt);
+
+    /**
+     * 水泵开关 (继电器输出)
+     * @param index 水塔编号 0..N-1
+     */
+    void set_pump(uint16_t index, bool on);
+
+    uint16_t towers() const { return (uint16_t)tanks_.size(); }
+    double time_s() const { return time_s_; }
+
+    /**
+     * 水位 (0-100%，从机上报的值)
+     */
+    uint8_t level_pct(uint16_t index) const;
+
+    /**
+     * 该水塔的从机此刻能否与主机通信
+     */
+    bool link_up(uint16_t index) const { return time_s_ >= tanks_[index].outage_until; }
+
+    /**
+     * 浮球开关状态
+     */
+    bool well_ok() const { return well_ok_; }
+
+    const PlantStats& stats() const { return stats_; }
+
+private:
+    struct Tank {
+        // 参数
+        double volume_m3;
+        double height_m;
+        double elevation_m;
+        double pump_q0;         // 零扬程流量 (m³/s)
+        double pump_h0_m;       // 关死扬程
+        double demand;          // 平均用水 (m³/s)
+
+        // 状态
+        double water_m3;
+        bool pump_on = false;
+        bool dry = false;
+        bool overflowing = false;
+        double hour_factor = 1;     // 本小时的随机波动
+        double burst_until = 0;     // 集中用水结束时刻
+        double burst_rate = 0;      // 集中用水流量 (m³/s)
+        double outage_until = 0;
+        std::mt19937_64 rng;        // 每塔独立，用水序列与控制无关
+    };
+
+    void new_hour(Tank& t);
+
+    PlantConfig cfg_;
+    std::vector<Tank> tanks_;
+    double well_m3_;
+    bool well_ok_ = true;
+    double time_s_ = 0;
+    uint32_t hour_ = UINT32_MAX;
+    PlantStats stats_;
+};
+
+}  // namespace wt
+
+#endif  // WT_PLANT_H
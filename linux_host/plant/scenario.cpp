@@ -0,0 +1,120 @@
+/*
+ * 仿真场景实现
+ */
+
+#include "scenario.h"
+
+#include "master_core.h"
+#include "slave_proto.h"
+#include "slave_window.h"
+#include "strategy.h"
+
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace wt {
+
+namespace {
+
+// 主循环与模型的步长
+#define SCENARIO_STEP_MS        1000
+
+// 离线判定时间 (与 wt-master 默认值相同)
+#define SCENARIO_OFFLINE_MS     60000
+
+struct Coupling {
+    Plant* plant;
+    const MasterCore_t* core;
+};
+
+/**
+ * 继电器输出：第 i 路对应控制核心中第 i 个水塔 (从机地址 = 模型中的编号 + 1)
+ */
+bool relay_write(void* ctx, const uint8_t* bits, uint16_t count) {
+    Coupling* c = static_cast<Coupling*>(ctx);
+    for (uint16_t i = 0; i < count && i < *c->core->tower_count; i++) {
+        uint16_t index = (uint16_t)(c->core->towers[i].id - 1);
+        if (index < c->plant->towers()) c->plant->set_pump(index, (bits[i / 8] >> (i % 8)) & 1);
+    }
+    return true;
+}
+
+}  // namespace
+
+bool scenario_run(const PlantConfig& config, const std::string& strategy_spec, ScenarioResult* result,
+                  std::string* err) {
+    std::unique_ptr<Strategy> strategy = strategy_create(strategy_spec, err);
+    if (!strategy) return false;
+
+    auto start = std::chrono::steady_clock::now();
+    result->config = config;
+    result->strategy = strategy_spec;
+
+    Plant plant(config);
+
+    std::vector<TowerData> towers(MAX_TOWERS);
+    uint16_t tower_count = 0;
+    SystemStatus status;
+    MasterHooks_t hooks;
+    MasterCore_t core;
+    memset(&status, 0, sizeof(status));
+    memset(&hooks, 0, sizeof(hooks));
+    memset(&core, 0, sizeof(core));
+    Coupling coupling = { &plant, &core };
+
+    status.mode = strategy->mode();
+    status.well_water_ok = true;
+    hooks.relay_write = relay_write;
+    core.towers = towers.data();
+    core.tower_count = &tower_count;
+    core.status = &status;
+    core.relay_count = config.towers;
+    core.hooks = &hooks;
+    core.ctx = &coupling;
+    master_core_begin(&core, nullptr);
+
+    // 从机上报相位随机 (与控制策略无关): 上次上报时刻设在一个周期之前的随机位置
+    std::mt19937_64 rng(config.seed);
+    std::uniform_int_distribution<uint32_t> phase(0, SLAVE_REPORT_MS - 1);
+    std::vector<SlaveNode_t> slaves(config.towers);
+    std::vector<SlaveWindow_t> windows(config.towers);
+    for (uint16_t i = 0; i < config.towers; i++) {
+        slave_init(&slaves[i], (unsigned char)(i + 1));
+        slave_window_init(&windows[i], 0);
+        slaves[i].last_send = (unsigned long)phase(rng) - SLAVE_REPORT_MS;
+    }
+
+    uint64_t steps = (uint64_t)config.days * 86400000ULL / SCENARIO_STEP_MS;
+    for (uint64_t k = 0; k < steps; k++) {
+        uint64_t now = k * SCENARIO_STEP_MS;
+        plant.step(SCENARIO_STEP_MS / 1000.0);
+
+        // 从机每秒采样 (步长即采样间隔)，到期上报；LoRa 接收
+        for (uint16_t i = 0; i < config.towers; i++) {
+            slave_window_add(&windows[i], &slaves[i], plant.level_pct(i), plant.well_ok() ? 1 : 0, 0,
+                             (unsigned long)now);
+            if (!slave_window_report_due(&windows[i], &slaves[i], (unsigned long)now)) continue;
+
+            unsigned char frame[SLAVE_WINDOW_REPORT_MAX];
+            unsigned char len = slave_window_build_report(&windows[i], &slaves[i], frame, sizeof(frame));
+            slave_window_report_sent(&windows[i], &slaves[i], (unsigned long)now);
+            if (!plant.link_up(i)) continue;
+
+            master_core_handle_frame(&core, frame, len, (uint32_t)now);
+            result->frames++;
+        }
+
+        // check_well_water() + 自动控制 (或替代策略)
+        master_core_set_well(&core, plant.well_ok());
+        result->offline_events += master_core_expire(&core, (uint32_t)now, SCENARIO_OFFLINE_MS);
+        strategy->step(&core, (uint32_t)now);
+    }
+
+    result->stats = plant.stats();
+    result->wall_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return true;
+}
+
+}  // namespace wt
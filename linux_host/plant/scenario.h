@@ -0,0 +1,39 @@
+/*
+ * 仿真场景：物理模型 + 主机控制核心 + 控制策略
+ *
+ * 与固件的连接方式和现场相同：
+ * - 水位: 每座水塔的从机每秒采样，每 SLAVE_REPORT_MS (井水状态变化时立即) 用 slave_window.c
+ *         组装带窗口摘要的上报帧，交给 master_core_handle_frame() (通信中断期间丢失)
+ * - 井水: 每轮主循环把浮球开关状态交给 master_core_set_well() (同 check_well_water)
+ * - 水泵: 控制核心的继电器输出回调驱动模型中的水泵 (第 i 路继电器对应第 i 个加入的水塔)
+ * 主循环和模型都以 1 秒为步长推进。
+ */
+
+#ifndef WT_SCENARIO_H
+#define WT_SCENARIO_H
+
+#include "plant.h"
+
+#include <string>
+
+namespace wt {
+
+struct ScenarioResult {
+    PlantConfig config;
+    std::string strategy;
+    PlantStats stats;
+    uint64_t frames = 0;            // 交给控制核心的上报帧
+    uint64_t offline_events = 0;    // 控制核心判定离线的次数
+    double wall_ms = 0;
+};
+
+/**
+ * 运行一个场景
+ * @return false=策略描述无效 (err 中为原因)
+ */
+bool scenario_run(const PlantConfig& config, const std::string& strategy, ScenarioResult* result,
+                  std::string* err);
+
+}  // namespace wt
+
+#endif  // WT_SCENARIO_H
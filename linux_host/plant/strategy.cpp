@@ -0,0 +1,146 @@
+/*
+ * 水泵控制策略实现
+ */
+
+#include "strategy.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace wt {
+
+namespace {
+
+bool relay_on(const MasterCore_t* core, uint16_t i) {
+    return (core->relays[i / 8] >> (i % 8)) & 1;
+}
+
+void bit_set(uint8_t* bits, uint16_t i) {
+    bits[i / 8] |= (uint8_t)(1 << (i % 8));
+}
+
+// ==================== firmware ====================
+
+class FirmwareStrategy : public Strategy {
+public:
+    SystemMode mode() const override { return MODE_AUTO; }
+    void step(MasterCore_t* core, uint32_t) override { master_core_auto(core); }
+};
+
+// ==================== band ====================
+
+struct BandOptions {
+    uint8_t on = MASTER_LEVEL_PUMP_ON;
+    uint8_t off = MASTER_LEVEL_PUMP_OFF;
+    uint16_t max_on = 0;            // 0=不限
+    uint32_t min_off_s = 0;
+    bool stop_offline = false;
+};
+
+class BandStrategy : public Strategy {
+public:
+    explicit BandStrategy(const BandOptions& opt)
+        : opt_(opt), stopped_at_(MAX_TOWERS, 0), stopped_(MAX_TOWERS, false) {}
+
+    void step(MasterCore_t* core, uint32_t now) override;
+
+private:
+    BandOptions opt_;
+    std::vector<uint32_t> stopped_at_;
+    std::vector<bool> stopped_;         // 停过泵 (minoff 从第一次停泵开始生效)
+    std::vector<uint16_t> candidates_;
+};
+
+void BandStrategy::step(MasterCore_t* core, uint32_t now) {
+    uint8_t set[MASTER_RELAY_BYTES];
+    uint8_t clear[MASTER_RELAY_BYTES];
+    memset(set, 0, sizeof(set));
+    memset(clear, 0, sizeof(clear));
+
+    uint16_t n = std::min(*core->tower_count, core->relay_count);
+    uint16_t running = 0;
+    candidates_.clear();
+    for (uint16_t i = 0; i < n; i++) {
+        const TowerData& t = core->towers[i];
+        bool on = relay_on(core, i);
+        bool stop = !core->status->well_water_ok || t.water_level > opt_.off ||
+                    (opt_.stop_offline && !t.online);
+        if (on && stop) {
+            bit_set(clear, i);
+            stopped_at_[i] = now;
+            stopped_[i] = true;
+        } else if (on) {
+            running++;
+        } else if (!stop && t.water_level < opt_.on &&
+                   (!stopped_[i] || now - stopped_at_[i] >= opt_.min_off_s * 1000)) {
+            candidates_.push_back(i);
+        }
+    }
+
+    // 水位最低的优先启动
+    std::sort(candidates_.begin(), candidates_.end(), [core](uint16_t a, uint16_t b) {
+        return core->towers[a].water_level < core->towers[b].water_level;
+    });
+    for (uint16_t i : candidates_) {
+        if (opt_.max_on > 0 && running >= opt_.max_on) break;
+        bit_set(set, i);
+        running++;
+    }
+    master_core_apply(core, set, clear, nullptr);
+}
+
+bool parse_band(const std::string& spec, BandOptions* opt, std::string* err) {
+    size_t pos = spec.find(':');
+    while (pos != std::string::npos) {
+        size_t next = spec.find(':', pos + 1);
+        std::string item = spec.substr(pos + 1, next == std::string::npos ? std::string::npos : next - pos - 1);
+        pos = next;
+
+        if (item == "offline") {
+            opt->stop_offline = true;
+            continue;
+        }
+        size_t eq = item.find('=');
+        if (eq == std::string::npos) {
+            *err = "无法识别的选项: " + item;
+            return false;
+        }
+        std::string key = item.substr(0, eq);
+        unsigned long value = strtoul(item.c_str() + eq + 1, nullptr, 10);
+        if (key == "on" && value <= 100) {
+            opt->on = (uint8_t)value;
+        } else if (key == "off" && value <= 100) {
+            opt->off = (uint8_t)value;
+        } else if (key == "max" && value <= MAX_TOWERS) {
+            opt->max_on = (uint16_t)value;
+        } else if (key == "minoff") {
+            opt->min_off_s = (uint32_t)value;
+        } else {
+            *err = "无法识别的选项: " + item;
+            return false;
+        }
+    }
+    if (opt->on >= opt->off) {
+        *err = "开泵水位应低于停泵水位";
+        return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+std::unique_ptr<Strategy> strategy_create(const std::string& spec, std::string* err) {
+    if (spec == "firmware") return std::unique_ptr<Strategy>(new FirmwareStrategy());
+
+    if (spec == "band" || spec.compare(0, 5, "band:") == 0) {
+        BandOptions opt;
+        if (!parse_band(spec, &opt, err)) return nullptr;
+        return std::unique_ptr<Strategy>(new BandStrategy(opt));
+    }
+
+    *err = "未知策略: " + spec;
+    return nullptr;
+}
+
+}  // namespace wt
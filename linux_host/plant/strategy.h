@@ -0,0 +1,50 @@
+/*
+ * 水泵控制策略
+ *
+ * 策略每轮主循环运行一次，只能看到主机知道的信息 (控制核心中的水塔表、继电器映像、
+ * 井水开关)，通过控制核心的接口输出继电器，与网页/串口手动控制走同一条路径。
+ *
+ *   firmware                      固件的自动模式 (master_core_auto: 20%/90% 开关 + 井水联锁)
+ *   band[:on=N][:off=N][:max=N][:minoff=S][:offline]
+ *                                 可调阈值的开关控制 (默认同固件)，井水开关断开时全部停泵；
+ *                                 max: 同时运行的水泵上限 (水位最低的优先)；
+ *                                 minoff: 停泵后至少间隔 S 秒才能再启动；
+ *                                 offline: 水塔离线 (收不到水位) 时停泵
+ */
+
+#ifndef WT_STRATEGY_H
+#define WT_STRATEGY_H
+
+#include "master_core.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace wt {
+
+class Strategy {
+public:
+    virtual ~Strategy() = default;
+
+    /**
+     * 运行时控制核心所处的模式
+     */
+    virtual SystemMode mode() const { return MODE_MANUAL; }
+
+    /**
+     * 一轮控制 (井水状态和本轮收到的帧已交给核心)
+     * @param now 毫秒
+     */
+    virtual void step(MasterCore_t* core, uint32_t now) = 0;
+};
+
+/**
+ * 按描述创建策略
+ * @return nullptr=描述无效 (err 中为原因)
+ */
+std::unique_ptr<Strategy> strategy_create(const std::string& spec, std::string* err);
+
+}  // namespace wt
+
+#endif  // WT_STRATEGY_H
@@ -0,0 +1,70 @@
+/*
+ * 帧捕获文件读取实现
+ */
+
+#include "capture_file.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+namespace wt {
+
+static_assert(sizeof(CapturePcapHeader_t) == 24, "pcap 文件头应为 24 字节");
+static_assert(sizeof(CapturePcapPacket_t) == 16, "pcap 包头应为 16 字节");
+static_assert(sizeof(CapturePacketHeader_t) == 12, "CapturePacketHeader_t 应为 12 字节");
+
+const char* capture_type_name(uint8_t type) {
+    switch (type) {
+        case CAPTURE_RX:        return "rx";
+        case CAPTURE_TX:        return "tx";
+        case CAPTURE_SNAPSHOT:  return "snapshot";
+        case CAPTURE_TOWER:     return "tower";
+        case CAPTURE_WELL:      return "well";
+        case CAPTURE_MODE:      return "mode";
+        case CAPTURE_PUMPS:     return "pumps";
+        case CAPTURE_RELAY:     return "relay";
+        case CAPTURE_STOP:      return "stop";
+        default:                return "?";
+    }
+}
+
+bool capture_read(const std::string& path, std::vector<CaptureRecord_t>* out, std::string* err) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (f == nullptr) {
+        *err = path + ": " + strerror(errno);
+        return false;
+    }
+
+    CapturePcapHeader_t file;
+    if (fread(&file, sizeof(file), 1, f) != 1 || file.magic != CAPTURE_PCAP_MAGIC) {
+        *err = path + ": 不是 pcap 文件 (或字节序不同)";
+        fclose(f);
+        return false;
+    }
+    if (file.network != CAPTURE_PCAP_LINKTYPE) {
+        *err = path + ": 链路类型 " + std::to_string(file.network) + " 不是帧捕获";
+        fclose(f);
+        return false;
+    }
+
+    bool ok = true;
+    CapturePcapPacket_t pkt;
+    while (fread(&pkt, sizeof(pkt), 1, f) == 1) {
+        CaptureRecord_t rec;
+        memset(&rec, 0, sizeof(rec));
+        if (pkt.incl_len < sizeof(rec.h) || pkt.incl_len > sizeof(rec.h) + CAPTURE_DATA_MAX ||
+            fread(&rec.h, sizeof(rec.h), 1, f) != 1 || rec.h.len != pkt.incl_len - sizeof(rec.h) ||
+            fread(rec.data, 1, rec.h.len, f) != rec.h.len) {
+            *err = path + ": 第 " + std::to_string(out->size() + 1) + " 条记录不完整";
+            ok = false;
+            break;
+        }
+        rec.ts_ms = pkt.ts_sec * 1000 + pkt.ts_usec / 1000;
+        out->push_back(rec);
+    }
+    fclose(f);
+    return ok;
+}
+
+}  // namespace wt
@@ -0,0 +1,29 @@
+/*
+ * 帧捕获文件读取 (pcap，格式见 esp8266_master/src/capture_format.h)
+ */
+
+#ifndef WT_CAPTURE_FILE_H
+#define WT_CAPTURE_FILE_H
+
+#include "capture_format.h"
+
+#include <string>
+#include <vector>
+
+namespace wt {
+
+/**
+ * 读取捕获文件
+ * @param out 按文件顺序的记录 (ts_ms 由 pcap 时间戳换算)
+ * @return false=无法打开或格式错误 (err 中为原因，已读出的记录保留在 out 中)
+ */
+bool capture_read(const std::string& path, std::vector<CaptureRecord_t>* out, std::string* err);
+
+/**
+ * 记录类型名称
+ */
+const char* capture_type_name(uint8_t type);
+
+}  // namespace wt
+
+#endif  // WT_CAPTURE_FILE_H
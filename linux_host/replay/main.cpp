@@ -0,0 +1,261 @@
+/*
+ * wt-replay: 帧捕获回放
+ *
+ * 读取主机 /api/capture 导出的 pcap 文件，把其中的输入送入与固件相同的控制核心，
+ * 核对回放得到的继电器输出与捕获中记录的输出是否一致，并按从机统计信号质量和最长断线时间。
+ *
+ * 用法:
+ *   wt-replay FILE [--speed X] [--repeat N] [--decisions CSV] [--dump]
+ *
+ *   --speed      相对捕获时间的回放倍速 (默认 1000；0=不限速，用于测吞吐)
+ *   --repeat     重复回放 N 次 (不限速时给出每条记录的处理时间)
+ *   --decisions  把回放得到的继电器输出写入 CSV: session,loop,ts_ms,relays
+ *   --dump       逐条输出记录
+ *
+ * 退出码: 0=决策一致，1=不一致，2=参数或文件错误
+ */
+
+#include "capture_file.h"
+#include "replayer.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <time.h>
+#include <vector>
+
+using namespace wt;
+
+namespace {
+
+// 最多列出的不一致条数
+#define MAX_MISMATCH_REPORT     10
+
+void usage(const char* prog) {
+    fprintf(stderr, "用法: %s FILE [--speed X] [--repeat N] [--decisions CSV] [--dump]\n", prog);
+}
+
+uint64_t now_ns() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+void sleep_until(uint64_t deadline_ns) {
+    timespec ts;
+    ts.tv_sec = (time_t)(deadline_ns / 1000000000ULL);
+    ts.tv_nsec = (long)(deadline_ns % 1000000000ULL);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {
+    }
+}
+
+std::string relay_hex(const uint8_t* bits) {
+    std::string out = "0x";
+    char buf[4];
+    for (int i = MASTER_RELAY_BYTES - 1; i >= 0; i--) {
+        snprintf(buf, sizeof(buf), "%02X", bits[i]);
+        out += buf;
+    }
+    return out;
+}
+
+void dump_record(const CaptureRecord_t& rec) {
+    printf("%10.3f %8u %-8s", rec.ts_ms / 1000.0, rec.h.loop, capture_type_name(rec.h.type));
+    if (rec.h.type == CAPTURE_RX) printf(" rssi %4d snr %6.2f", rec.h.rssi, rec.h.snr / 4.0);
+    printf(" |");
+    for (uint8_t i = 0; i < rec.h.len; i++) printf(" %02X", rec.data[i]);
+    printf("\n");
+}
+
+struct PassResult {
+    bool ok = true;
+    std::string err;
+    uint64_t busy_ns = 0;       // 处理记录的时间 (不含等待)
+    uint64_t wall_ns = 0;
+    uint64_t span_ms = 0;       // 捕获覆盖的时间 (各段之和)
+};
+
+/**
+ * 回放一遍
+ * @param speed 倍速 (0=不限速)
+ */
+PassResult run_pass(Replayer& replayer, const std::vector<CaptureRecord_t>& records, double speed) {
+    PassResult r;
+    uint64_t start = now_ns();
+    uint64_t session_wall = start;
+    uint32_t session_ts = 0;
+    uint32_t last_ts = 0;
+    bool have_session = false;
+
+    for (const CaptureRecord_t& rec : records) {
+        // 每段捕获的时间戳从开机算起，分段计时
+        if (rec.h.type == CAPTURE_SNAPSHOT) {
+            if (have_session) r.span_ms += last_ts - session_ts;
+            have_session = true;
+            session_ts = rec.ts_ms;
+            session_wall = now_ns();
+        }
+        last_ts = rec.ts_ms;
+        if (speed > 0 && have_session) {
+            sleep_until(session_wall + (uint64_t)((rec.ts_ms - session_ts) * 1e6 / speed));
+        }
+
+        uint64_t t0 = now_ns();
+        bool ok = replayer.feed(rec, &r.err);
+        r.busy_ns += now_ns() - t0;
+        if (!ok) {
+            r.ok = false;
+            return r;
+        }
+    }
+    uint64_t t0 = now_ns();
+    replayer.finish();
+    r.busy_ns += now_ns() - t0;
+    if (have_session) r.span_ms += last_ts - session_ts;
+    r.wall_ns = now_ns() - start;
+    return r;
+}
+
+/**
+ * 核对决策
+ * @return 不一致的条数
+ */
+size_t compare(const Replayer& replayer, bool verbose) {
+    const auto& expected = replayer.expected();
+    const auto& produced = replayer.produced();
+    size_t n = std::max(expected.size(), produced.size());
+    size_t mismatches = 0;
+    for (size_t i = 0; i < n; i++) {
+        bool have_e = i < expected.size();
+        bool have_p = i < produced.size();
+        if (have_e && have_p && expected[i] == produced[i]) continue;
+        if (verbose && mismatches < MAX_MISMATCH_REPORT) {
+            printf("  #%zu", i + 1);
+            if (have_e) {
+                printf(" 捕获: 段 %u 循环 %u %s", expected[i].session, expected[i].loop,
+                       relay_hex(expected[i].relays).c_str());
+            } else {
+                printf(" 捕获: -");
+            }
+            if (have_p) {
+                printf("  回放: 段 %u 循环 %u %s", produced[i].session, produced[i].loop,
+                       relay_hex(produced[i].relays).c_str());
+            } else {
+                printf("  回放: -");
+            }
+            printf("\n");
+        }
+        mismatches++;
+    }
+    return mismatches;
+}
+
+bool write_decisions(const std::string& path, const Replayer& replayer) {
+    FILE* f = fopen(path.c_str(), "w");
+    if (f == nullptr) {
+        fprintf(stderr, "%s: %s\n", path.c_str(), strerror(errno));
+        return false;
+    }
+    fprintf(f, "session,loop,ts_ms,relays\n");
+    for (const ReplayDecision& d : replayer.produced()) {
+        fprintf(f, "%u,%u,%u,%s\n", d.session, d.loop, d.ts_ms, relay_hex(d.relays).c_str());
+    }
+    return fclose(f) == 0;
+}
+
+void print_links(const Replayer& replayer) {
+    if (replayer.links().empty()) return;
+    printf("\n%4s %8s %18s %9s %12s %12s\n", "从机", "帧数", "RSSI min/avg/max", "SNR avg", "最长间隔(s)",
+           "结束于(s)");
+    for (const auto& kv : replayer.links()) {
+        const ReplayLink& l = kv.second;
+        printf("%4u %8llu %5d/%5.0f/%5d %9.2f %12.1f %12.1f\n", kv.first, (unsigned long long)l.frames,
+               l.rssi_min, (double)l.rssi_sum / l.frames, l.rssi_max, l.snr_sum / 4.0 / l.frames,
+               l.max_gap_ms / 1000.0, l.max_gap_at / 1000.0);
+    }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::string path;
+    double speed = 1000;
+    uint32_t repeat = 1;
+    std::string decisions_path;
+    bool dump = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--speed" && has_value) {
+            speed = strtod(argv[++i], nullptr);
+        } else if (arg == "--repeat" && has_value) {
+            repeat = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--decisions" && has_value) {
+            decisions_path = argv[++i];
+        } else if (arg == "--dump") {
+            dump = true;
+        } else if (path.empty() && arg[0] != '-') {
+            path = arg;
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (path.empty() || speed < 0 || repeat == 0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    std::vector<CaptureRecord_t> records;
+    std::string err;
+    if (!capture_read(path, &records, &err)) {
+        if (records.empty()) {
+            fprintf(stderr, "%s\n", err.c_str());
+            return 2;
+        }
+        fprintf(stderr, "警告: %s，只回放前 %zu 条\n", err.c_str(), records.size());
+    }
+    if (dump) {
+        for (const CaptureRecord_t& rec : records) dump_record(rec);
+    }
+
+    // 第一遍按倍速回放并核对，其余各遍不限速，测处理时间
+    Replayer replayer;
+    PassResult first = run_pass(replayer, records, speed);
+    if (!first.ok) {
+        fprintf(stderr, "%s\n", first.err.c_str());
+        return 2;
+    }
+
+    const ReplayStats& s = replayer.stats();
+    printf("%s: %llu 条记录，%llu 段，接收 %llu 帧，发送 %llu 帧，其他输入 %llu 条，自动控制 %llu 次\n",
+           path.c_str(), (unsigned long long)s.records, (unsigned long long)s.sessions, (unsigned long long)s.rx,
+           (unsigned long long)s.tx, (unsigned long long)s.inputs, (unsigned long long)s.auto_runs);
+    if (s.skipped > 0) printf("跳过 %llu 条 (快照之前或无法识别)\n", (unsigned long long)s.skipped);
+    printf("捕获时长 %.1f 秒，回放 %.3f 秒 (%.0f 倍速)，处理 %.1f ns/条\n", first.span_ms / 1000.0,
+           first.wall_ns / 1e9, first.wall_ns ? first.span_ms * 1e6 / first.wall_ns : 0.0,
+           s.records ? (double)first.busy_ns / s.records : 0.0);
+
+    size_t mismatches = compare(replayer, true);
+    printf("继电器决策: 捕获 %zu 条，回放 %zu 条，%s", replayer.expected().size(), replayer.produced().size(),
+           mismatches == 0 ? "一致\n" : "");
+    if (mismatches > 0) printf("%zu 条不一致\n", mismatches);
+
+    for (uint32_t pass = 1; pass < repeat; pass++) {
+        Replayer again;
+        PassResult r = run_pass(again, records, 0);
+        size_t m = compare(again, false);
+        printf("第 %u 遍: %.1f ns/条%s\n", pass + 1, s.records ? (double)r.busy_ns / s.records : 0.0,
+               m == mismatches ? "" : "，结果与第 1 遍不同");
+        if (m != mismatches) mismatches = std::max(mismatches, m);
+    }
+
+    print_links(replayer);
+
+    if (!decisions_path.empty() && !write_decisions(decisions_path, replayer)) return 2;
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,215 @@
+/*
+ * 捕获回放实现
+ */
+
+#include "replayer.h"
+
+#include <cstring>
+
+namespace wt {
+
+bool ReplayDecision::operator==(const ReplayDecision& o) const {
+    return session == o.session && loop == o.loop && memcmp(relays, o.relays, sizeof(relays)) == 0;
+}
+
+Replayer::Replayer() {
+    memset(towers_, 0, sizeof(towers_));
+    memset(&status_, 0, sizeof(status_));
+    memset(&hooks_, 0, sizeof(hooks_));
+    memset(&core_, 0, sizeof(core_));
+    memset(snapshot_relays_, 0, sizeof(snapshot_relays_));
+    memset(last_relays_, 0, sizeof(last_relays_));
+
+    hooks_.relay_write = on_relay_write;
+    core_.towers = towers_;
+    core_.tower_count = &tower_count_;
+    core_.status = &status_;
+    core_.hooks = &hooks_;
+    core_.ctx = this;
+}
+
+/**
+ * 与固件相同：只记录与上次不同的输出 (紧急停止每轮都会重新输出)
+ */
+bool Replayer::on_relay_write(void* ctx, const uint8_t* bits, uint16_t) {
+    Replayer* self = static_cast<Replayer*>(ctx);
+    if (memcmp(bits, self->last_relays_, sizeof(self->last_relays_)) == 0) return true;
+    memcpy(self->last_relays_, bits, sizeof(self->last_relays_));
+
+    ReplayDecision d;
+    d.session = (uint32_t)self->stats_.sessions;
+    d.loop = self->loop_;
+    d.ts_ms = self->now_ms_;
+    memcpy(d.relays, bits, sizeof(d.relays));
+    self->produced_.push_back(d);
+    return true;
+}
+
+bool Replayer::feed(const CaptureRecord_t& rec, std::string* err) {
+    stats_.records++;
+    now_ms_ = rec.ts_ms;
+
+    if (rec.h.type == CAPTURE_SNAPSHOT) return start_session(rec, err);
+    if (rec.h.type == CAPTURE_RX) track_link(rec);
+    if (!in_session_) {
+        stats_.skipped++;
+        return true;
+    }
+    if (rec.h.type == CAPTURE_TOWER && core_pending_) {
+        add_tower(rec);
+        return true;
+    }
+    if (core_pending_) begin_core();
+
+    switch (rec.h.type) {
+        case CAPTURE_RX:
+            next_loop(rec.h.loop);
+            stats_.rx++;
+            mesh_master_handle_frame(&mesh_, &core_, rec.data, rec.h.len, rec.ts_ms, nullptr);
+            break;
+        case CAPTURE_TX:
+            stats_.tx++;
+            break;
+        case CAPTURE_WELL:
+            next_loop(rec.h.loop);
+            stats_.inputs++;
+            if (rec.h.len >= 1) master_core_set_well(&core_, rec.data[0] != 0);
+            break;
+        case CAPTURE_MODE:
+            next_loop(rec.h.loop);
+            stats_.inputs++;
+            if (rec.h.len >= 1) master_core_set_mode(&core_, (SystemMode)rec.data[0]);
+            break;
+        case CAPTURE_PUMPS: {
+            next_loop(rec.h.loop);
+            stats_.inputs++;
+            uint8_t set[MASTER_RELAY_BYTES] = {};
+            uint8_t clear[MASTER_RELAY_BYTES] = {};
+            size_t half = rec.h.len / 2;
+            size_t n = half < sizeof(set) ? half : sizeof(set);
+            memcpy(set, rec.data, n);
+            memcpy(clear, rec.data + half, n);
+            master_core_apply(&core_, set, clear, nullptr);
+            break;
+        }
+        case CAPTURE_RELAY: {
+            next_loop(rec.h.loop);
+            ReplayDecision d;
+            d.session = (uint32_t)stats_.sessions;
+            d.loop = rec.h.loop;
+            d.ts_ms = rec.ts_ms;
+            memcpy(d.relays, rec.data, rec.h.len < sizeof(d.relays) ? rec.h.len : sizeof(d.relays));
+            expected_.push_back(d);
+            break;
+        }
+        case CAPTURE_STOP:
+            // 停止发生在网页请求处理中，这一轮的自动控制不在捕获范围内
+            next_loop(rec.h.loop);
+            in_session_ = false;
+            break;
+        default:
+            stats_.skipped++;
+            break;
+    }
+    return true;
+}
+
+void Replayer::finish() {
+    if (core_pending_) begin_core();
+    if (in_session_) end_iteration();
+    in_session_ = false;
+}
+
+bool Replayer::start_session(const CaptureRecord_t& rec, std::string* err) {
+    finish();
+
+    const uint8_t* p = rec.data;
+    if (rec.h.len < CAPTURE_SNAPSHOT_FIXED) {
+        *err = "快照记录过短";
+        return false;
+    }
+    uint16_t towers = (uint16_t)(p[2] | p[3] << 8);
+    uint16_t relays = (uint16_t)(p[4] | p[5] << 8);
+    uint16_t max_towers = (uint16_t)(p[6] | p[7] << 8);
+    if (max_towers != MAX_TOWERS || rec.h.len != CAPTURE_SNAPSHOT_FIXED + MASTER_RELAY_BYTES) {
+        *err = "捕获来自 MAX_TOWERS=" + std::to_string(max_towers) + " 的固件，本程序按 MAX_TOWERS=" +
+               std::to_string(MAX_TOWERS) + " 编译";
+        return false;
+    }
+    if (towers > MAX_TOWERS || relays > MAX_TOWERS) {
+        *err = "快照中的水塔数或继电器路数超出范围";
+        return false;
+    }
+
+    stats_.sessions++;
+    memset(towers_, 0, sizeof(towers_));
+    memset(&status_, 0, sizeof(status_));
+    tower_count_ = 0;
+    status_.mode = (SystemMode)p[0];
+    status_.well_water_ok = p[1] != 0;
+    core_.relay_count = relays;
+    memcpy(snapshot_relays_, p + CAPTURE_SNAPSHOT_FIXED, sizeof(snapshot_relays_));
+    memcpy(last_relays_, snapshot_relays_, sizeof(last_relays_));
+
+    loop_ = rec.h.loop;
+    in_session_ = true;
+    core_pending_ = true;
+    if (towers == 0) begin_core();
+    return true;
+}
+
+void Replayer::add_tower(const CaptureRecord_t& rec) {
+    if (tower_count_ >= MAX_TOWERS || rec.h.len < CAPTURE_TOWER_LEN) {
+        stats_.skipped++;
+        return;
+    }
+    const uint8_t* p = rec.data;
+    TowerData* t = &towers_[tower_count_++];
+    t->id = p[0];
+    t->water_level = p[1];
+    t->pump_on = p[2] != 0;
+    t->online = p[3] != 0;
+    t->last_update = (uint32_t)p[4] | (uint32_t)p[5] << 8 | (uint32_t)p[6] << 16 | (uint32_t)p[7] << 24;
+}
+
+void Replayer::begin_core() {
+    core_pending_ = false;
+    master_core_begin(&core_, snapshot_relays_);
+    mesh_master_begin(&mesh_);
+}
+
+void Replayer::next_loop(uint32_t loop) {
+    if (loop == loop_) return;
+    end_iteration();
+    loop_ = loop;
+}
+
+/**
+ * 一轮主循环的末尾：与固件 loop() 相同，仅自动模式执行自动控制
+ */
+void Replayer::end_iteration() {
+    if (status_.mode != MODE_AUTO) return;
+    stats_.auto_runs++;
+    master_core_auto(&core_);
+}
+
+void Replayer::track_link(const CaptureRecord_t& rec) {
+    if (rec.h.len < 1) return;
+    ReplayLink& link = links_[rec.data[0]];
+    uint32_t session = (uint32_t)stats_.sessions;
+    if (link.frames == 0) {
+        link.rssi_min = link.rssi_max = rec.h.rssi;
+    } else if (link.last_session == session && rec.ts_ms - link.last_ms > link.max_gap_ms) {
+        link.max_gap_ms = rec.ts_ms - link.last_ms;
+        link.max_gap_at = rec.ts_ms;
+    }
+    if (rec.h.rssi < link.rssi_min) link.rssi_min = rec.h.rssi;
+    if (rec.h.rssi > link.rssi_max) link.rssi_max = rec.h.rssi;
+    link.rssi_sum += rec.h.rssi;
+    link.snr_sum += rec.h.snr;
+    link.frames++;
+    link.last_ms = rec.ts_ms;
+    link.last_session = session;
+}
+
+}  // namespace wt
@@ -0,0 +1,122 @@
+/*
+ * 捕获回放
+ *
+ * 把捕获中的输入 (LoRa 帧、井水传感器、模式切换、手动控制) 按原顺序送入控制核心，
+ * 在与固件相同的位置执行自动控制，记录回放得到的继电器输出 (决策)，
+ * 与捕获中记录的输出逐条核对。
+ *
+ * 自动控制在固件中每轮主循环执行一次，对不变的状态重复执行没有效果，
+ * 因此只需在主循环序号变化时 (即下一轮的第一条记录之前) 执行一次。
+ * 每段捕获从快照开始，控制核心按快照重建。
+ * 收到的帧与固件一样先经中继网络主机端 (mesh_master.h)，路由和去重表在每段开始时清空。
+ */
+
+#ifndef WT_REPLAYER_H
+#define WT_REPLAYER_H
+
+#include "capture_format.h"
+#include "master_core.h"
+#include "mesh_master.h"
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace wt {
+
+// 一次继电器输出变化
+struct ReplayDecision {
+    uint32_t session = 0;       // 第几段捕获 (从 1 开始)
+    uint32_t loop = 0;          // 主循环序号
+    uint32_t ts_ms = 0;
+    uint8_t relays[MASTER_RELAY_BYTES] = {};
+
+    bool operator==(const ReplayDecision& o) const;
+};
+
+// 单个从机的接收统计
+struct ReplayLink {
+    uint64_t frames = 0;
+    int16_t rssi_min = 0;
+    int16_t rssi_max = 0;
+    int64_t rssi_sum = 0;
+    int64_t snr_sum = 0;        // 0.25 dB
+    uint32_t last_ms = 0;
+    uint32_t max_gap_ms = 0;    // 同一段内相邻两帧的最大间隔
+    uint32_t max_gap_at = 0;    // 最大间隔结束时刻
+    uint32_t last_session = 0;
+};
+
+struct ReplayStats {
+    uint64_t records = 0;
+    uint64_t sessions = 0;
+    uint64_t rx = 0;
+    uint64_t tx = 0;
+    uint64_t inputs = 0;        // 井水/模式/手动控制
+    uint64_t auto_runs = 0;
+    uint64_t skipped = 0;       // 快照之前或格式错误的记录
+};
+
+class Replayer {
+public:
+    Replayer();
+
+    Replayer(const Replayer&) = delete;
+    Replayer& operator=(const Replayer&) = delete;
+
+    /**
+     * 处理一条记录
+     * @return false=快照与本程序的编译配置不一致 (err 中为原因)
+     */
+    bool feed(const CaptureRecord_t& rec, std::string* err);
+
+    /**
+     * 捕获结束 (未以停止标记结尾时执行最后一轮的自动控制)
+     */
+    void finish();
+
+    const ReplayStats& stats() const { return stats_; }
+    const std::vector<ReplayDecision>& expected() const { return expected_; }
+    const std::vector<ReplayDecision>& produced() const { return produced_; }
+    const std::map<uint8_t, ReplayLink>& links() const { return links_; }
+
+    /**
+     * 回放后的状态 (调试用)
+     */
+    const TowerData* towers() const { return towers_; }
+    uint16_t tower_count() const { return tower_count_; }
+
+private:
+    static bool on_relay_write(void* ctx, const uint8_t* bits, uint16_t count);
+
+    bool start_session(const CaptureRecord_t& rec, std::string* err);
+    void add_tower(const CaptureRecord_t& rec);
+    void begin_core();
+    void next_loop(uint32_t loop);
+    void end_iteration();
+    void track_link(const CaptureRecord_t& rec);
+
+    TowerData towers_[MAX_TOWERS];
+    uint16_t tower_count_ = 0;
+    SystemStatus status_;
+    MasterHooks_t hooks_;
+    MasterCore_t core_;
+    MeshMaster_t mesh_;
+
+    bool in_session_ = false;
+    bool core_pending_ = false;     // 快照中的水塔尚未全部读入
+    uint8_t snapshot_relays_[MASTER_RELAY_BYTES];
+    uint8_t last_relays_[MASTER_RELAY_BYTES];
+    uint32_t loop_ = 0;
+    uint32_t now_ms_ = 0;
+
+    ReplayStats stats_;
+    std::vector<ReplayDecision> expected_;
+    std::vector<ReplayDecision> produced_;
+    std::map<uint8_t, ReplayLink> links_;
+};
+
+}  // namespace wt
+
+#endif  // WT_REPLAYER_H
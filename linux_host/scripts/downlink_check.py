@@ -0,0 +1,102 @@
+# wt-master 下行命令检查 (模拟后端，不需要硬件)
+#
+# 启动 wt-master --radio sim:N,REPORT_MS,0,HIDDEN：地址最大的 HIDDEN 个模拟从机只能经中继
+# (地址 1，运行同一份 slave_mesh.c) 到达主机。等全部水塔上线后对每个从机 POST /api/query，
+# 主机在收到该从机的下一帧后按其路由下发 (直连原样，经中继为 CMD_MESH_DOWN)，从机在上报后的
+# 接收窗口内收到并立即上报。检查:
+# - 隐藏从机的帧经中继到达 (/api/stats 的 relayed)
+# - 每个查询都已下发并在 3 秒内得到应答 (downlinks、downlink_replies)
+# 任何一项不满足时返回 1。
+#
+#   python3 scripts/downlink_check.py --master build/master/wt-master
+
+import argparse
+import json
+import subprocess
+import sys
+import time
+import urllib.parse
+import urllib.request
+
+
+def get(base, path):
+    with urllib.request.urlopen(base + path, timeout=5) as r:
+        return json.loads(r.read())
+
+
+def post(base, path, **params):
+    data = urllib.parse.urlencode(params).encode()
+    with urllib.request.urlopen(base + path, data=data, timeout=5) as r:
+        return r.read().decode()
+
+
+def wait_for(check, timeout_s):
+    deadline = time.time() + timeout_s
+    while time.time() < deadline:
+        try:
+            if check():
+                return True
+        except OSError:     # 还没有开始监听
+            pass
+        time.sleep(0.5)
+    return False
+
+
+def run(args, base):
+    ids = list(range(1, args.towers + 1))
+    window_s = args.report_ms / 1000.0
+
+    # 隐藏从机要先经中继的路由通告入网，再经中继上报
+    if not wait_for(lambda: len(get(base, "/api/towers")) == args.towers, 3 * window_s + 5):
+        online = sorted(t["id"] for t in get(base, "/api/towers"))
+        print("❌ %.0f 秒内只有 %s 上线" % (3 * window_s + 5, online))
+        return 1
+    before = get(base, "/api/stats")
+    print("✅ %d 个水塔上线，经中继的帧 %d" % (args.towers, before["relayed"]))
+
+    for i in ids:
+        post(base, "/api/query", id=i)
+    expect = before["downlink_replies"] + len(ids)
+    wait_for(lambda: get(base, "/api/stats")["downlink_replies"] >= expect, window_s + 5)
+
+    after = get(base, "/api/stats")
+    sent = after["downlinks"] - before["downlinks"]
+    replies = after["downlink_replies"] - before["downlink_replies"]
+    print("下发 %d 条查询，应答 %d 条，经中继的帧 %d" % (sent, replies, after["relayed"]))
+
+    errors = []
+    if args.hidden and after["relayed"] == 0:
+        errors.append("没有经中继到达的帧")
+    if sent != len(ids):
+        errors.append("查询了 %d 个从机，只下发了 %d 条" % (len(ids), sent))
+    if replies != len(ids):
+        errors.append("%d 条查询没有应答" % (len(ids) - replies))
+    for e in errors:
+        print("❌ " + e)
+    return 1 if errors else 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description="wt-master 下行命令检查")
+    parser.add_argument("--master", default="build/master/wt-master")
+    parser.add_argument("--towers", type=int, default=6)
+    parser.add_argument("--hidden", type=int, default=2, help="只能经中继到达的从机数")
+    parser.add_argument("--report-ms", type=int, default=10000)
+    parser.add_argument("--port", type=int, default=18093)
+    args = parser.parse_args()
+
+    radio = "sim:%d,%d,0,%d" % (args.towers, args.report_ms, args.hidden)
+    proc = subprocess.Popen([args.master, "--listen", "127.0.0.1:%d" % args.port, "--radio", radio, "-q"])
+    base = "http://127.0.0.1:%d" % args.port
+    try:
+        if not wait_for(lambda: proc.poll() is None and get(base, "/api/status") is not None, 5):
+            print("❌ wt-master 没有启动")
+            return 1
+        return run(args, base)
+    finally:
+        proc.terminate()
+        proc.wait()
+
+
+if __name__ == "__main__":
+    sys.exit(main())
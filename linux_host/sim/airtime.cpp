@@ -0,0 +1,45 @@
+/*
+ * LoRa 空中时间与灵敏度
+ */
+
+#include "airtime.h"
+
+#include <cmath>
+
+namespace wt {
+
+namespace {
+
+// 接收机噪声系数 (dB)
+#define LORA_NOISE_FIGURE_DB    6.0
+
+// 启用低速率优化的符号时间 (微秒)
+#define LORA_LDRO_SYMBOL_US     16000.0
+
+}  // namespace
+
+double lora_symbol_us(const LoraParams& p) {
+    return (double)(1u << p.sf) * 1e6 / p.bw_hz;
+}
+
+uint32_t lora_preamble_us(const LoraParams& p) {
+    return (uint32_t)((p.preamble + 4.25) * lora_symbol_us(p));
+}
+
+uint32_t lora_airtime_us(const LoraParams& p, uint8_t payload_len) {
+    double ts = lora_symbol_us(p);
+    int de = ts >= LORA_LDRO_SYMBOL_US ? 1 : 0;
+    int num = 8 * payload_len - 4 * p.sf + 28 + (p.crc ? 16 : 0) - (p.implicit_header ? 20 : 0);
+    int den = 4 * (p.sf - 2 * de);
+    int blocks = num > 0 ? (num + den - 1) / den : 0;
+    double symbols = p.preamble + 4.25 + 8 + blocks * (p.cr + 4);
+    return (uint32_t)std::ceil(symbols * ts);
+}
+
+double lora_sensitivity_dbm(const LoraParams& p) {
+    // SF6: -5 dB，之后每级 -2.5 dB (SF12: -20 dB)
+    double snr_min = -5.0 - 2.5 * (p.sf - 6);
+    return -174.0 + 10.0 * std::log10((double)p.bw_hz) + LORA_NOISE_FIGURE_DB + snr_min;
+}
+
+}  // namespace wt
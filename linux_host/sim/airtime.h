@@ -0,0 +1,51 @@
+/*
+ * LoRa 调制参数：空中时间与接收灵敏度
+ *
+ * 空中时间按 SX127x 数据手册的公式 (PAN3031 与之兼容)：
+ *   Tsym = 2^SF / BW
+ *   前导码 = (前导码符号数 + 4.25) × Tsym
+ *   负载符号数 = 8 + max(ceil((8PL - 4SF + 28 + 16CRC - 20IH) / (4(SF - 2DE))) × (CR + 4), 0)
+ * 符号时间 >= 16 ms 时启用低速率优化 (DE=1)。
+ *
+ * 灵敏度 = -174 + 10·log10(BW) + 噪声系数 + 解调所需的最低信噪比 (随 SF 每级降 2.5 dB)。
+ */
+
+#ifndef WT_AIRTIME_H
+#define WT_AIRTIME_H
+
+#include <cstdint>
+
+namespace wt {
+
+struct LoraParams {
+    uint8_t sf = 7;                 // 扩频因子 6-12 (两端驱动的默认值为 7)
+    uint32_t bw_hz = 125000;
+    uint8_t cr = 1;                 // 编码率 4/(4+cr)，1-4
+    uint16_t preamble = 8;          // 前导码符号数
+    bool crc = true;
+    bool implicit_header = false;
+};
+
+/**
+ * 符号时间 (微秒)
+ */
+double lora_symbol_us(const LoraParams& p);
+
+/**
+ * 前导码时间 (微秒)；接收机在前导码结束前锁定信号
+ */
+uint32_t lora_preamble_us(const LoraParams& p);
+
+/**
+ * 一帧的空中时间 (微秒)
+ */
+uint32_t lora_airtime_us(const LoraParams& p, uint8_t payload_len);
+
+/**
+ * 接收灵敏度 (dBm)
+ */
+double lora_sensitivity_dbm(const LoraParams& p);
+
+}  // namespace wt
+
+#endif  // WT_AIRTIME_H
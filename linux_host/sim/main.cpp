@@ -0,0 +1,271 @@
+/*
+ * wt-lorasim: LoRa 网络规模仿真
+ *
+ * 在购买硬件之前估计 8/64/256 座水塔时的冲突率、上报延迟和信道占用。
+ * 从机和主机运行固件原样的协议代码 (slave_proto.c、slave_window.c、master_core.cpp)，无线电为虚拟信道，
+ * 模型见 netsim.h。各参数取值的全部组合 × 种子数构成一次扫参，在多个线程上并行运行。
+ *
+ * 用法:
+ *   wt-lorasim [--towers LIST] [--sf LIST] [--bw LIST] [--scheme LIST] [--duration S] [--seeds N]
+ *              [--radius M] [--power DBM] [--exponent N] [--shadowing DB] [--capture DB]
+ *              [--ppm N] [--loop-ms N] [--sync-start] [--batch] [--offline-s N] [--threads N] [--csv FILE]
+ *
+ *   --towers     水塔数 (默认 8,64,256)
+ *   --sf         扩频因子 (默认 7)
+ *   --bw         带宽 kHz (默认 125)
+ *   --scheme     push (从机定期上报，现有固件) / poll (主机依次查询)，默认 push
+ *   --duration   仿真时长 (秒，默认 3600)
+ *   --batch      上报帧附带每次采样的 SC09B 通道图 (从机 make BATCH=1)
+ *   --seeds      每个配置运行的次数 (种子 1..N，节点位置不同)
+ *   --csv        每次运行一行写入 CSV ("-" 为标准输出)
+ *   --threads    并行线程数 (默认 CPU 核数)
+ *
+ * 标准输出为按配置汇总 (各种子平均，分位数按合并后的分布) 的表格。
+ */
+
+#include "netsim.h"
+#include "thread_pool.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace wt;
+
+namespace {
+
+void usage(const char* prog) {
+    fprintf(stderr,
+            "用法: %s [--towers LIST] [--sf LIST] [--bw LIST] [--scheme LIST] [--duration S] [--seeds N]\n"
+            "          [--radius M] [--power DBM] [--exponent N] [--shadowing DB] [--capture DB]\n"
+            "          [--ppm N] [--loop-ms N] [--sync-start] [--batch] [--offline-s N] [--threads N]\n"
+            "          [--csv FILE]\n",
+            prog);
+}
+
+/**
+ * 解析逗号分隔的整数列表
+ */
+bool parse_list(const char* s, uint32_t min, uint32_t max, std::vector<uint32_t>* out) {
+    out->clear();
+    while (*s) {
+        char* end;
+        unsigned long v = strtoul(s, &end, 10);
+        if (end == s || v < min || v > max) return false;
+        out->push_back((uint32_t)v);
+        if (*end == ',') end++;
+        else if (*end != '\0') return false;
+        s = end;
+    }
+    return !out->empty();
+}
+
+bool parse_schemes(const char* s, std::vector<SimScheme>* out) {
+    out->clear();
+    std::string list = s;
+    size_t pos = 0;
+    while (pos <= list.size()) {
+        size_t comma = list.find(',', pos);
+        std::string name = list.substr(pos, comma == std::string::npos ? std::string::npos : comma - pos);
+        if (name == "push") {
+            out->push_back(SimScheme::PUSH);
+        } else if (name == "poll") {
+            out->push_back(SimScheme::POLL);
+        } else {
+            return false;
+        }
+        if (comma == std::string::npos) break;
+        pos = comma + 1;
+    }
+    return !out->empty();
+}
+
+double ratio(uint64_t num, uint64_t den) {
+    return den ? (double)num / den : 0.0;
+}
+
+void write_csv(FILE* f, const std::vector<SimResult>& results) {
+    fprintf(f,
+            "scheme,towers,sf,bw_khz,seed,duration_s,airtime_ms,uplinks,delivered,pdr,lost_collision,"
+            "lost_sensitivity,lost_half_duplex,collision_rate,channel_util,max_node_duty,polls,poll_lost,"
+            "poll_timeouts,latency_p50_ms,latency_p99_ms,gap_p50_s,gap_p99_s,gap_max_s,offline_events,"
+            "towers_seen,events,wall_ms\n");
+    for (const SimResult& r : results) {
+        const SimConfig& c = r.config;
+        double duration_us = c.duration_s * 1e6;
+        fprintf(f,
+                "%s,%u,%u,%g,%u,%u,%.2f,%llu,%llu,%.4f,%llu,%llu,%llu,%.4f,%.4f,%.5f,%llu,%llu,%llu,%.1f,%.1f,"
+                "%.2f,%.2f,%.2f,%llu,%u,%llu,%.1f\n",
+                sim_scheme_name(c.scheme), c.towers, c.lora.sf, c.lora.bw_hz / 1000.0, c.seed, c.duration_s,
+                r.uplink_airtime_us / 1000.0, (unsigned long long)r.uplinks, (unsigned long long)r.delivered,
+                ratio(r.delivered, r.uplinks), (unsigned long long)r.lost_collision,
+                (unsigned long long)r.lost_sensitivity, (unsigned long long)r.lost_half_duplex,
+                ratio(r.lost_collision, r.uplinks), r.airtime_us / duration_us, r.max_node_airtime_us / duration_us,
+                (unsigned long long)r.polls, (unsigned long long)r.poll_lost, (unsigned long long)r.poll_timeouts,
+                r.latency_us.percentile(50) / 1000.0, r.latency_us.percentile(99) / 1000.0,
+                r.gap_us.percentile(50) / 1e6, r.gap_us.percentile(99) / 1e6, r.gap_us.max() / 1e6,
+                (unsigned long long)r.offline_events, r.towers_seen, (unsigned long long)r.events, r.wall_ms);
+    }
+}
+
+/**
+ * 汇总：同一配置的各种子相邻排列
+ */
+void print_summary(FILE* out, const std::vector<SimResult>& results, uint32_t seeds) {
+    fprintf(out, "%-5s %5s %3s %5s %8s %8s %7s %8s %9s %10s %10s %10s %8s %6s\n", "方案", "水塔", "SF", "BW",
+            "空中ms", "送达%", "冲突%", "信道%", "占空比%", "延迟p99ms", "间隔p99s", "最长间隔s", "离线/h", "收到");
+    for (size_t i = 0; i < results.size(); i += seeds) {
+        const SimConfig& c = results[i].config;
+        uint64_t uplinks = 0, delivered = 0, collisions = 0, airtime = 0, offline = 0, seen = 0;
+        double duty = 0;
+        LatencyHistogram latency, gap;
+        for (size_t j = i; j < i + seeds; j++) {
+            const SimResult& r = results[j];
+            uplinks += r.uplinks;
+            delivered += r.delivered;
+            collisions += r.lost_collision;
+            airtime += r.airtime_us;
+            offline += r.offline_events;
+            seen += r.towers_seen;
+            duty += (double)r.max_node_airtime_us / (c.duration_s * 1e6) / seeds;
+            latency.merge(r.latency_us);
+            gap.merge(r.gap_us);
+        }
+        double hours = c.duration_s / 3600.0 * seeds;
+        fprintf(out, "%-5s %5u %3u %5g %8.1f %8.2f %7.2f %8.1f %9.2f %10.1f %10.1f %10.1f %8.1f %6.1f\n",
+                sim_scheme_name(c.scheme), c.towers, c.lora.sf, c.lora.bw_hz / 1000.0,
+                results[i].uplink_airtime_us / 1000.0, 100.0 * ratio(delivered, uplinks),
+                100.0 * ratio(collisions, uplinks), 100.0 * airtime / (c.duration_s * 1e6 * seeds), 100.0 * duty,
+                latency.percentile(99) / 1000.0, gap.percentile(99) / 1e6, gap.max() / 1e6, offline / hours,
+                (double)seen / seeds);
+    }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::vector<uint32_t> towers = { 8, 64, 256 };
+    std::vector<uint32_t> sfs = { 7 };
+    std::vector<uint32_t> bws = { 125 };
+    std::vector<SimScheme> schemes = { SimScheme::PUSH };
+    uint32_t seeds = 1;
+    uint32_t threads = 0;
+    std::string csv_path;
+    SimConfig base;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        bool ok = true;
+        if (arg == "--towers" && has_value) {
+            ok = parse_list(argv[++i], 1, SIM_MAX_TOWERS, &towers);
+        } else if (arg == "--sf" && has_value) {
+            ok = parse_list(argv[++i], 6, 12, &sfs);
+        } else if (arg == "--bw" && has_value) {
+            ok = parse_list(argv[++i], 7, 500, &bws);
+        } else if (arg == "--scheme" && has_value) {
+            ok = parse_schemes(argv[++i], &schemes);
+        } else if (arg == "--duration" && has_value) {
+            base.duration_s = (uint32_t)strtoul(argv[++i], nullptr, 10);
+            ok = base.duration_s > 0;
+        } else if (arg == "--seeds" && has_value) {
+            seeds = (uint32_t)strtoul(argv[++i], nullptr, 10);
+            ok = seeds > 0;
+        } else if (arg == "--radius" && has_value) {
+            base.radius_m = strtod(argv[++i], nullptr);
+            ok = base.radius_m > 0;
+        } else if (arg == "--power" && has_value) {
+            base.tx_power_dbm = strtod(argv[++i], nullptr);
+        } else if (arg == "--exponent" && has_value) {
+            base.path_loss_exponent = strtod(argv[++i], nullptr);
+            ok = base.path_loss_exponent > 0;
+        } else if (arg == "--shadowing" && has_value) {
+            base.shadowing_db = strtod(argv[++i], nullptr);
+            ok = base.shadowing_db >= 0;
+        } else if (arg == "--capture" && has_value) {
+            base.capture_db = strtod(argv[++i], nullptr);
+        } else if (arg == "--ppm" && has_value) {
+            base.clock_ppm = strtod(argv[++i], nullptr);
+            ok = base.clock_ppm >= 0;
+        } else if (arg == "--loop-ms" && has_value) {
+            base.slave_loop_ms = (uint32_t)strtoul(argv[++i], nullptr, 10);
+            ok = base.slave_loop_ms > 0;
+        } else if (arg == "--sync-start") {
+            base.sync_start = true;
+        } else if (arg == "--batch") {
+            base.batch = true;
+        } else if (arg == "--offline-s" && has_value) {
+            base.offline_s = (uint32_t)strtoul(argv[++i], nullptr, 10);
+            ok = base.offline_s > 0;
+        } else if (arg == "--threads" && has_value) {
+            threads = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--csv" && has_value) {
+            csv_path = argv[++i];
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    // 同一配置的各种子相邻，便于汇总
+    std::vector<SimConfig> configs;
+    for (SimScheme scheme : schemes) {
+        for (uint32_t sf : sfs) {
+            for (uint32_t bw : bws) {
+                for (uint32_t n : towers) {
+                    for (uint32_t seed = 1; seed <= seeds; seed++) {
+                        SimConfig c = base;
+                        c.scheme = scheme;
+                        c.lora.sf = (uint8_t)sf;
+                        c.lora.bw_hz = bw * 1000;
+                        c.towers = (uint16_t)n;
+                        c.seed = seed;
+                        configs.push_back(c);
+                    }
+                }
+            }
+        }
+    }
+
+    std::vector<SimResult> results(configs.size());
+    auto start = std::chrono::steady_clock::now();
+    size_t workers;
+    {
+        ThreadPool pool(threads);
+        workers = pool.size();
+        for (size_t i = 0; i < configs.size(); i++) {
+            pool.submit([&configs, &results, i] { sim_run(configs[i], &results[i]); });
+        }
+    }
+    double wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (!csv_path.empty()) {
+        FILE* f = csv_path == "-" ? stdout : fopen(csv_path.c_str(), "w");
+        if (f == nullptr) {
+            fprintf(stderr, "%s: %s\n", csv_path.c_str(), strerror(errno));
+            return 2;
+        }
+        write_csv(f, results);
+        if (f != stdout && fclose(f) != 0) {
+            fprintf(stderr, "%s: %s\n", csv_path.c_str(), strerror(errno));
+            return 2;
+        }
+    }
+
+    uint64_t events = 0;
+    for (const SimResult& r : results) events += r.events;
+    // CSV 写到标准输出时汇总改到标准错误
+    FILE* out = csv_path == "-" ? stderr : stdout;
+    fprintf(out, "%zu 次运行 (每次 %u 秒)，%zu 线程，耗时 %.2f 秒，%.1f 百万事件/秒\n\n", results.size(),
+           base.duration_s, workers, wall_s, wall_s > 0 ? events / wall_s / 1e6 : 0.0);
+    print_summary(out, results, seeds);
+    return 0;
+}
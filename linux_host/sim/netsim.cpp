@@ -0,0 +1,522 @@
+/*
+ * LoRa 网络离散事件仿真实现
+ */
+
+#include "netsim.h"
+
+#include "master_core.h"
+#include "slave_proto.h"
+#include "slave_window.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <queue>
+#include <random>
+#include <vector>
+
+namespace wt {
+
+const char* sim_scheme_name(SimScheme scheme) {
+    return scheme == SimScheme::POLL ? "poll" : "push";
+}
+
+namespace {
+
+// 节点编号 0 为主机，1..N 为从机 (从机地址为编号的低 8 位)
+#define SIM_MASTER              0
+
+#define SIM_FRAME_MAX           32
+
+// 主机离线检查周期 (与 wt-master 相同)
+#define SIM_EXPIRE_MS           1000
+
+// 从机与主机的最小距离 (米)
+#define SIM_MIN_DISTANCE_M      10.0
+
+// 查询超时在 "查询 + 等待一个节拍 + 应答" 之外的余量
+#define SIM_POLL_MARGIN_US      20000
+
+// 主机查询帧: [源地址][目标地址][命令][长度]
+#define SIM_POLL_LEN            SLAVE_COMMAND_MIN
+
+enum EventType : uint8_t {
+    EV_TICK = 0,        // 从机主循环一轮 (arg=节拍代数)
+    EV_TX_END,          // 一帧发送结束 (arg=帧编号)
+    EV_POLL,            // 主机发出下一个查询
+    EV_POLL_TIMEOUT,    // 查询超时 (arg=查询序号)
+    EV_EXPIRE           // 主机离线检查
+};
+
+struct Event {
+    uint64_t t;
+    uint64_t seq;       // 同一时刻按加入顺序处理
+    EventType type;
+    uint16_t node;
+    uint32_t arg;
+
+    bool operator>(const Event& o) const { return t != o.t ? t > o.t : seq > o.seq; }
+};
+
+enum LossReason : uint8_t {
+    LOSS_NONE = 0,
+    LOSS_SENSITIVITY,
+    LOSS_COLLISION,
+    LOSS_HALF_DUPLEX
+};
+
+struct Transmission {
+    uint32_t id;
+    uint16_t sender;
+    uint16_t target;
+    uint64_t start;
+    uint64_t end;
+    uint64_t queued;    // 发送方决定发送的时刻 (计算延迟)
+    double rx_dbm;      // 目标处的接收功率
+    LossReason loss;
+    uint8_t frame[SIM_FRAME_MAX];
+    uint8_t len;
+};
+
+struct Node {
+    double x = 0;
+    double y = 0;
+    double shadow_db = 0;           // 与主机之间的阴影衰落
+    double clock = 1;               // 本地时钟速率 (1 + 误差)
+    uint64_t boot_us = 0;
+    bool transmitting = false;
+    uint64_t airtime_us = 0;
+
+    // 从机
+    SlaveNode_t proto;
+    SlaveWindow_t window;
+    bool booted = false;
+    uint32_t tick_gen = 0;          // 重新安排节拍时作废已排队的节拍事件
+    uint64_t grid_us = 0;           // 主循环延时开始的时刻，节拍为其后每个周期
+    uint64_t next_tick = UINT64_MAX;
+    uint16_t send_queue = 0;        // 本轮还要发送的上报帧
+    uint64_t queued_at = 0;
+    bool rx_pending = false;        // 收到的命令在下一个节拍处理
+    uint8_t rx[SIM_FRAME_MAX];
+    uint8_t rx_len = 0;
+    bool heard = false;             // 主机收到过本机的帧
+    uint64_t last_heard = 0;
+};
+
+uint64_t splitmix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+class Simulation {
+public:
+    Simulation(const SimConfig& config, SimResult* result);
+
+    void run();
+
+private:
+    void place_nodes();
+    double path_loss_db(uint16_t a, uint16_t b) const;
+    double pair_shadow_db(uint16_t a, uint16_t b) const;
+    double rx_dbm(uint16_t from, uint16_t to) const { return cfg_.tx_power_dbm - path_loss_db(from, to); }
+
+    void schedule(uint64_t t, EventType type, uint16_t node, uint32_t arg);
+    uint64_t loop_period_us(const Node& n) const { return (uint64_t)(cfg_.slave_loop_ms * 1000.0 / n.clock); }
+    unsigned long local_ms(const Node& n, uint64_t t) const {
+        return (unsigned long)((double)(t - n.boot_us) * n.clock / 1000.0);
+    }
+
+    // 从机
+    void slave_tick(uint16_t s, uint64_t t);
+    void slave_send(uint16_t s, uint64_t t);
+    void slave_idle(uint16_t s, uint64_t from);
+    void slave_wake(uint16_t s, uint64_t t);
+
+    // 无线电
+    void start_tx(uint16_t sender, uint16_t target, const uint8_t* frame, uint8_t len, uint64_t t,
+                  uint64_t queued);
+    void end_tx(uint32_t id, uint64_t t);
+    void uplink_done(const Transmission& tx, uint64_t t);
+
+    // 主机
+    void poll(uint64_t t);
+    static bool relay_write(void*, const uint8_t*, uint16_t) { return true; }
+
+    const SimConfig& cfg_;
+    SimResult* res_;
+    std::mt19937_64 rng_;
+    std::vector<Node> nodes_;
+    std::priority_queue<Event, std::vector<Event>, std::greater<Event>> events_;
+    uint64_t event_seq_ = 0;
+    std::vector<Transmission> active_;
+    uint32_t tx_seq_ = 0;
+
+    double sensitivity_dbm_;
+    double pl0_db_;                 // 1 米处的自由空间损耗
+    uint32_t poll_air_us_;
+
+    // 控制核心
+    std::vector<TowerData> towers_;
+    uint16_t tower_count_ = 0;
+    SystemStatus status_;
+    MasterHooks_t hooks_;
+    MasterCore_t core_;
+
+    // 查询
+    uint16_t poll_next_ = 1;
+    uint16_t poll_waiting_ = 0;     // 等待应答的从机 (0=无)
+    uint32_t poll_seq_ = 0;
+    uint64_t poll_start_ = 0;
+};
+
+Simulation::Simulation(const SimConfig& config, SimResult* result)
+    : cfg_(config), res_(result), rng_(config.seed), nodes_(config.towers + 1), towers_(MAX_TOWERS) {
+    sensitivity_dbm_ = lora_sensitivity_dbm(cfg_.lora);
+    pl0_db_ = 20.0 * std::log10(4.0 * M_PI * cfg_.freq_mhz * 1e6 / 299792458.0);
+    poll_air_us_ = lora_airtime_us(cfg_.lora, SIM_POLL_LEN);
+    // 一个上报周期的窗口 (附带通道图时每次采样 9 位)
+    uint32_t samples = std::min<uint32_t>(SLAVE_REPORT_MS / SLAVE_SAMPLE_MS, WINDOW_SAMPLES_MAX);
+    res_->uplink_airtime_us =
+        lora_airtime_us(cfg_.lora, SLAVE_SUMMARY_LEN + (cfg_.batch ? WINDOW_BATCH_BYTES(samples) : 0));
+
+    memset(&status_, 0, sizeof(status_));
+    memset(&hooks_, 0, sizeof(hooks_));
+    memset(&core_, 0, sizeof(core_));
+    status_.mode = MODE_MANUAL;
+    status_.well_water_ok = true;
+    hooks_.relay_write = relay_write;
+    core_.towers = towers_.data();
+    core_.tower_count = &tower_count_;
+    core_.status = &status_;
+    core_.hooks = &hooks_;
+    master_core_begin(&core_, nullptr);
+}
+
+/**
+ * 节点位置、阴影衰落、时钟误差和上电时刻只取决于种子和编号，
+ * 同一种子下不同水塔数/SF/方案的前 N 个节点相同，便于对比
+ */
+void Simulation::place_nodes() {
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::normal_distribution<double> shadow(0.0, cfg_.shadowing_db);
+    for (uint16_t s = 1; s < nodes_.size(); s++) {
+        Node& n = nodes_[s];
+        double r = std::max(SIM_MIN_DISTANCE_M, cfg_.radius_m * std::sqrt(unit(rng_)));
+        double theta = 2.0 * M_PI * unit(rng_);
+        n.x = r * std::cos(theta);
+        n.y = r * std::sin(theta);
+        n.shadow_db = shadow(rng_);
+        n.clock = 1.0 + cfg_.clock_ppm * 1e-6 * (2.0 * unit(rng_) - 1.0);
+        double boot = unit(rng_);
+        // 同时上电时只差晶振起振和复位的几毫秒
+        n.boot_us = cfg_.sync_start ? (uint64_t)(boot * 5000) : (uint64_t)(boot * SLAVE_REPORT_MS * 1000);
+        slave_init(&n.proto, (unsigned char)s);
+        slave_window_init(&n.window, cfg_.batch ? 1 : 0);
+    }
+}
+
+double Simulation::pair_shadow_db(uint16_t a, uint16_t b) const {
+    if (a > b) std::swap(a, b);
+    uint64_t h = splitmix64(((uint64_t)cfg_.seed << 32) ^ ((uint64_t)a << 16) ^ b);
+    double u1 = ((h >> 11) + 0.5) / 9007199254740992.0;
+    double u2 = ((splitmix64(h) >> 11) + 0.5) / 9007199254740992.0;
+    return cfg_.shadowing_db * std::sqrt(-2.0 * std::log(u1)) * std::cos(2.0 * M_PI * u2);
+}
+
+double Simulation::path_loss_db(uint16_t a, uint16_t b) const {
+    const Node& na = nodes_[a];
+    const Node& nb = nodes_[b];
+    double d = std::max(1.0, std::hypot(na.x - nb.x, na.y - nb.y));
+    double shadow = a == SIM_MASTER ? nb.shadow_db : b == SIM_MASTER ? na.shadow_db : pair_shadow_db(a, b);
+    return pl0_db_ + 10.0 * cfg_.path_loss_exponent * std::log10(d) + shadow;
+}
+
+void Simulation::schedule(uint64_t t, EventType type, uint16_t node, uint32_t arg) {
+    events_.push(Event{ t, event_seq_++, type, node, arg });
+}
+
+void Simulation::run() {
+    place_nodes();
+    for (uint16_t s = 1; s < nodes_.size(); s++) {
+        nodes_[s].next_tick = nodes_[s].boot_us;
+        schedule(nodes_[s].boot_us, EV_TICK, s, 0);
+    }
+    schedule(SIM_EXPIRE_MS * 1000ULL, EV_EXPIRE, SIM_MASTER, 0);
+    if (cfg_.scheme == SimScheme::POLL) schedule(0, EV_POLL, SIM_MASTER, 0);
+
+    uint64_t end = (uint64_t)cfg_.duration_s * 1000000ULL;
+    while (!events_.empty() && events_.top().t <= end) {
+        Event ev = events_.top();
+        events_.pop();
+        res_->events++;
+
+        switch (ev.type) {
+            case EV_TICK:
+                if (ev.arg == nodes_[ev.node].tick_gen) slave_tick(ev.node, ev.t);
+                break;
+            case EV_TX_END:
+                end_tx(ev.arg, ev.t);
+                break;
+            case EV_POLL:
+                poll(ev.t);
+                break;
+            case EV_POLL_TIMEOUT:
+                if (poll_waiting_ != 0 && ev.arg == poll_seq_) {
+                    res_->poll_timeouts++;
+                    poll_waiting_ = 0;
+                    poll(ev.t);
+                }
+                break;
+            case EV_EXPIRE:
+                res_->offline_events += master_core_expire(&core_, (uint32_t)(ev.t / 1000),
+                                                           cfg_.offline_s * 1000);
+                schedule(ev.t + SIM_EXPIRE_MS * 1000ULL, EV_EXPIRE, SIM_MASTER, 0);
+                break;
+        }
+    }
+
+    // 截至结束仍未收到的时间也算一次间隔，从未收到的从机从上电算起
+    for (uint16_t s = 1; s < nodes_.size(); s++) {
+        const Node& n = nodes_[s];
+        uint64_t since = n.heard ? n.last_heard : n.boot_us;
+        if (end > since) res_->gap_us.record(end - since);
+    }
+    res_->towers_seen = tower_count_;
+    for (const Node& n : nodes_) res_->max_node_airtime_us = std::max(res_->max_node_airtime_us, n.airtime_us);
+}
+
+// ==================== 从机 ====================
+
+/**
+ * 与 main.c 的主循环相同：读传感器 → 到期则上报 → 处理主机命令 → 延时一个节拍
+ * (上电时 main() 先采样一次再上报)
+ */
+void Simulation::slave_tick(uint16_t s, uint64_t t) {
+    Node& n = nodes_[s];
+    unsigned long now = local_ms(n, t);
+    n.next_tick = UINT64_MAX;
+
+    // 每秒采样 (跳过的节拍补齐)；水位每分钟变化一次，控制核心才会看到数值变化。
+    // 通道图的内容不影响仿真，只有长度影响空中时间
+    unsigned char level = (unsigned char)((now / 60000 + s * 37UL) % 101);
+    if (!n.booted) {
+        n.booted = true;
+        slave_window_add(&n.window, &n.proto, level, 1, 0, now);
+        n.send_queue++;
+    }
+    while (slave_window_sample_due(&n.window, now)) {
+        slave_window_add(&n.window, &n.proto, level, 1, 0, n.window.last_sample + SLAVE_SAMPLE_MS);
+    }
+    if (cfg_.scheme == SimScheme::PUSH && slave_window_report_due(&n.window, &n.proto, now)) n.send_queue++;
+    if (n.rx_pending) {
+        n.rx_pending = false;
+        if (slave_handle_command(&n.proto, n.rx, n.rx_len)) n.send_queue++;
+    }
+
+    if (n.send_queue > 0) {
+        n.queued_at = t;
+        slave_send(s, t);
+    } else {
+        slave_idle(s, t);
+    }
+}
+
+void Simulation::slave_send(uint16_t s, uint64_t t) {
+    Node& n = nodes_[s];
+    uint8_t frame[SIM_FRAME_MAX];
+    uint8_t len = slave_window_build_report(&n.window, &n.proto, frame, SIM_FRAME_MAX);
+    n.send_queue--;
+    start_tx(s, SIM_MASTER, frame, len, t, n.queued_at);
+}
+
+/**
+ * 本轮结束，延时后进入下一个节拍
+ * push 方案直接跳到上报到期的节拍 (中间的节拍什么也不做)；poll 方案等收到命令再唤醒
+ */
+void Simulation::slave_idle(uint16_t s, uint64_t from) {
+    Node& n = nodes_[s];
+    n.grid_us = from;
+    n.tick_gen++;
+    if (cfg_.scheme == SimScheme::POLL) {
+        n.next_tick = UINT64_MAX;
+        return;
+    }
+
+    uint64_t k = 1;
+    unsigned long elapsed = local_ms(n, from) - n.proto.last_send;
+    if (elapsed < SLAVE_REPORT_MS) {
+        // 取整误差只会提前一个节拍，届时由 slave_report_due 重新判断
+        k = std::max<uint64_t>(1, (SLAVE_REPORT_MS - elapsed) / cfg_.slave_loop_ms);
+    }
+    n.next_tick = from + k * loop_period_us(n);
+    schedule(n.next_tick, EV_TICK, s, n.tick_gen);
+}
+
+/**
+ * 收到命令：在延时结束后的第一个节拍处理
+ */
+void Simulation::slave_wake(uint16_t s, uint64_t t) {
+    Node& n = nodes_[s];
+    uint64_t period = loop_period_us(n);
+    uint64_t k = std::max<uint64_t>(1, (t - n.grid_us + period - 1) / period);
+    uint64_t tick = n.grid_us + k * period;
+    if (tick >= n.next_tick) return;
+    n.next_tick = tick;
+    n.tick_gen++;
+    schedule(tick, EV_TICK, s, n.tick_gen);
+}
+
+// ==================== 无线电 ====================
+
+/**
+ * 开始发送：按半双工、灵敏度和捕获效应判定本帧及重叠的帧
+ */
+void Simulation::start_tx(uint16_t sender, uint16_t target, const uint8_t* frame, uint8_t len, uint64_t t,
+                          uint64_t queued) {
+    Transmission tx;
+    tx.id = tx_seq_++;
+    tx.sender = sender;
+    tx.target = target;
+    tx.start = t;
+    tx.end = t + lora_airtime_us(cfg_.lora, len);
+    tx.queued = queued;
+    tx.rx_dbm = rx_dbm(sender, target);
+    tx.loss = LOSS_NONE;
+    tx.len = std::min<uint8_t>(len, SIM_FRAME_MAX);
+    memcpy(tx.frame, frame, tx.len);
+
+    if (nodes_[target].transmitting) {
+        tx.loss = LOSS_HALF_DUPLEX;
+    } else if (tx.rx_dbm < sensitivity_dbm_) {
+        tx.loss = LOSS_SENSITIVITY;
+    }
+
+    for (Transmission& other : active_) {
+        // 开始发送的节点放弃正在接收的帧
+        if (other.target == sender) {
+            if (other.loss == LOSS_NONE) other.loss = LOSS_HALF_DUPLEX;
+            continue;
+        }
+        // 新帧对已在接收的帧的干扰
+        if (other.loss == LOSS_NONE && other.rx_dbm - rx_dbm(sender, other.target) < cfg_.capture_db) {
+            other.loss = LOSS_COLLISION;
+        }
+        // 已在空中的帧对新帧的干扰
+        if (tx.loss == LOSS_NONE && other.sender != target &&
+            tx.rx_dbm - rx_dbm(other.sender, target) < cfg_.capture_db) {
+            tx.loss = LOSS_COLLISION;
+        }
+    }
+
+    Node& n = nodes_[sender];
+    n.transmitting = true;
+    n.airtime_us += tx.end - tx.start;
+    res_->airtime_us += tx.end - tx.start;
+    active_.push_back(tx);
+    schedule(tx.end, EV_TX_END, sender, tx.id);
+}
+
+void Simulation::end_tx(uint32_t id, uint64_t t) {
+    auto it = std::find_if(active_.begin(), active_.end(), [id](const Transmission& tx) { return tx.id == id; });
+    Transmission tx = *it;
+    *it = active_.back();
+    active_.pop_back();
+    nodes_[tx.sender].transmitting = false;
+
+    if (tx.target == SIM_MASTER) {
+        uplink_done(tx, t);
+    } else if (tx.loss != LOSS_NONE || !nodes_[tx.target].booted) {
+        res_->poll_lost++;      // 未上电的从机也收不到
+    } else {
+        Node& n = nodes_[tx.target];
+        memcpy(n.rx, tx.frame, tx.len);
+        n.rx_len = tx.len;
+        n.rx_pending = true;
+        slave_wake(tx.target, t);
+    }
+
+    // 从机的 pan3031_send() 阻塞到发送结束，之后继续本轮或进入延时
+    if (tx.sender != SIM_MASTER) {
+        Node& n = nodes_[tx.sender];
+        slave_window_report_sent(&n.window, &n.proto, local_ms(n, t));
+        if (n.send_queue > 0) {
+            slave_send(tx.sender, t);
+        } else {
+            slave_idle(tx.sender, t);
+        }
+    }
+}
+
+void Simulation::uplink_done(const Transmission& tx, uint64_t t) {
+    res_->uplinks++;
+    switch (tx.loss) {
+        case LOSS_SENSITIVITY:
+            res_->lost_sensitivity++;
+            return;
+        case LOSS_COLLISION:
+            res_->lost_collision++;
+            return;
+        case LOSS_HALF_DUPLEX:
+            res_->lost_half_duplex++;
+            return;
+        case LOSS_NONE:
+            break;
+    }
+
+    res_->delivered++;
+    master_core_handle_frame(&core_, tx.frame, tx.len, (uint32_t)(t / 1000));
+
+    Node& n = nodes_[tx.sender];
+    if (n.heard) res_->gap_us.record(t - n.last_heard);
+    n.heard = true;
+    n.last_heard = t;
+
+    if (poll_waiting_ != 0 && tx.frame[0] == (uint8_t)poll_waiting_) {
+        res_->latency_us.record(t - poll_start_);
+        poll_waiting_ = 0;
+        poll_seq_++;
+        poll(t);
+    } else {
+        res_->latency_us.record(t - tx.queued);
+    }
+}
+
+// ==================== 主机 ====================
+
+/**
+ * 依次向每个从机发心跳命令，收到应答或超时后查询下一个
+ */
+void Simulation::poll(uint64_t t) {
+    if (nodes_.size() <= 1) return;
+
+    uint16_t s = poll_next_;
+    poll_next_ = (uint16_t)(poll_next_ % (nodes_.size() - 1) + 1);
+
+    uint8_t frame[SIM_POLL_LEN] = { 0x00, (uint8_t)s, CMD_HEARTBEAT, 0 };
+    start_tx(SIM_MASTER, s, frame, sizeof(frame), t, t);
+    res_->polls++;
+
+    poll_waiting_ = s;
+    poll_start_ = t;
+    poll_seq_++;
+    uint64_t timeout = poll_air_us_ + cfg_.slave_loop_ms * 1000ULL + res_->uplink_airtime_us + SIM_POLL_MARGIN_US;
+    schedule(t + timeout, EV_POLL_TIMEOUT, SIM_MASTER, poll_seq_);
+}
+
+}  // namespace
+
+void sim_run(const SimConfig& config, SimResult* result) {
+    *result = SimResult();
+    result->config = config;
+
+    auto start = std::chrono::steady_clock::now();
+    Simulation sim(config, result);
+    sim.run();
+    result->wall_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+}  // namespace wt
@@ -0,0 +1,97 @@
+/*
+ * LoRa 网络离散事件仿真
+ *
+ * 从机运行 slave_node_stc8g/src/slave_proto.c、slave_window.c (采样窗口、上报帧、命令处理)，
+ * 主机运行 esp8266_master/src/master_core.cpp (帧处理、离线判断)，两者都是固件原样的代码，
+ * 只有无线电换成虚拟信道：
+ *
+ * - 空中时间按 SF/BW/负载长度计算 (airtime.h)
+ * - 路径损耗: 对数距离模型 + 每条链路固定的对数正态阴影衰落，低于灵敏度的帧丢失
+ * - 同频冲突: 两帧在接收端重叠时，强者高出 capture_db 以上才能解出 (捕获效应)，否则都丢失
+ * - 半双工: 正在发送的节点收不到帧，开始发送时正在接收的帧也丢失
+ *
+ * 从机按主循环节拍 (默认 100 ms，时钟有 ppm 级误差) 检查上报和接收，发送期间主循环阻塞。
+ * 两种方案：
+ * - push: 与现有固件相同，从机每 SEND_INTERVAL 秒主动上报 (带窗口摘要，--batch 时附带通道图)
+ * - poll: 从机不主动上报，主机依次发心跳命令，从机在下一个节拍应答
+ *
+ * 每次运行单线程且互不共享状态，扫参时在多个线程上并行运行。
+ */
+
+#ifndef WT_NETSIM_H
+#define WT_NETSIM_H
+
+#include "airtime.h"
+#include "histogram.h"
+
+#include <cstdint>
+
+namespace wt {
+
+// 8 位从机地址的全部取值
+#define SIM_MAX_TOWERS      256
+
+enum class SimScheme : uint8_t {
+    PUSH = 0,
+    POLL
+};
+
+const char* sim_scheme_name(SimScheme scheme);
+
+struct SimConfig {
+    uint16_t towers = 8;            // 从机数量 (1-256)
+    LoraParams lora;
+    SimScheme scheme = SimScheme::PUSH;
+    uint32_t duration_s = 3600;
+    uint32_t seed = 1;              // 同一种子下各配置的节点位置相同
+
+    // 信道
+    double radius_m = 2000;         // 从机均匀分布在以主机为圆心的圆内
+    double tx_power_dbm = 17;       // 两端驱动的最大功率
+    double freq_mhz = 434;
+    double path_loss_exponent = 2.7;
+    double shadowing_db = 6;        // 阴影衰落标准差
+    double capture_db = 6;          // 捕获门限
+
+    // 节点
+    uint32_t slave_loop_ms = 100;   // 从机主循环节拍
+    double clock_ppm = 50;          // 从机时钟误差范围 (±)
+    bool sync_start = false;        // 全部同时上电 (停电恢复)，否则在一个上报周期内随机上电
+    bool batch = false;             // 上报帧附带 SC09B 通道图 (从机 BATCH=1)
+    uint32_t offline_s = 60;        // 主机判定离线的时间 (与 wt-master 默认值相同)
+};
+
+struct SimResult {
+    SimConfig config;
+
+    uint32_t uplink_airtime_us = 0; // 上报帧的空中时间 (一个上报周期的窗口)
+    uint64_t uplinks = 0;           // 从机发出的帧
+    uint64_t delivered = 0;         // 主机解出并交给控制核心的帧
+    uint64_t lost_collision = 0;
+    uint64_t lost_sensitivity = 0;
+    uint64_t lost_half_duplex = 0;
+
+    uint64_t polls = 0;             // 主机发出的查询 (仅 poll)
+    uint64_t poll_lost = 0;         // 查询未送达从机
+    uint64_t poll_timeouts = 0;     // 超时未收到应答
+
+    uint64_t airtime_us = 0;        // 全部发送的空中时间之和
+    uint64_t max_node_airtime_us = 0;
+    uint64_t offline_events = 0;    // 控制核心判定离线的次数
+    uint16_t towers_seen = 0;       // 控制核心水塔表中的水塔数
+
+    LatencyHistogram latency_us;    // 从机排队发送 (poll 为主机发出查询) 到主机收到
+    LatencyHistogram gap_us;        // 同一水塔相邻两次成功上报的间隔 (含到结束时仍未收到的时间)
+
+    uint64_t events = 0;
+    double wall_ms = 0;
+};
+
+/**
+ * 运行一次仿真
+ */
+void sim_run(const SimConfig& config, SimResult* result);
+
+}  // namespace wt
+
+#endif  // WT_NETSIM_H
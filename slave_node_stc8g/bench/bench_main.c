@@ -0,0 +1,291 @@
+/*
+ * 从机热点函数基准 - 在 SDCC 的 s51 模拟器中运行 (make bench)
+ *
+ * 与固件链接同一批 .rel (main.c 的 main 改名为 slave_main)，逐个调用被测函数：
+ * - 周期: 定时器 0 (16 位，溢出由中断计数) 计机器周期，减去空函数的调用开销
+ * - 栈深: 调用前把 SP 以上的 idata 填成 0xA5，调用后找最高被改写的字节
+ *         (与计周期分开运行，不含定时器中断压栈)
+ * 结果经串口按行输出 "函数,周期,栈深"，最后进入掉电模式，模拟器随之停止。
+ *
+ * 外设: 模拟器中端口引脚空闲为高电平，即 SC09B 读回 0xFF、不应答 (读数据时每一位都走
+ * data |= 0x01 分支)，PAN3031 的 MISO 恒为 1。周期数是 s51 标准 8051 (12T) 的机器周期，
+ * 用于前后对比，不等于 STC8G (1T) 的实际时钟数。
+ */
+
+#include "slave_config.h"
+#include "pan3031.h"
+#include "sc09b.h"
+
+#define BENCH_STACK_FILL    0xA5
+
+typedef void (*BenchFunc_t)(void);
+
+typedef struct {
+    const char *name;       // 被测函数名 (bench_report.py 按此名查代码/数据大小)
+    BenchFunc_t run;
+} BenchCase_t;
+
+// main.c 中的节点状态和通信函数
+extern SlaveNode_t node;
+extern __xdata SlaveMesh_t mesh;
+extern __xdata SlaveWindow_t window;
+extern __xdata SlaveOta_t ota;
+void send_sensor_data(void);
+
+static volatile unsigned int bench_overflows;
+static volatile unsigned char bench_sink;
+static unsigned char bench_report[SLAVE_REPORT_LEN];
+static __code const unsigned char bench_command[SLAVE_COMMAND_MIN] = { 0x00, NODE_ID, CMD_HEARTBEAT, 0x00 };
+static unsigned char bench_mesh_frame[SLAVE_MESH_FRAME_MAX];
+static unsigned char bench_mesh_len;
+static __xdata unsigned char bench_window_report[SLAVE_WINDOW_REPORT_MAX];
+static unsigned int bench_window_map;
+static __xdata unsigned char bench_ota_frame[OTA_DATA_LEN_MAX];
+static __xdata unsigned char bench_ota_reply[OTA_STATUS_LEN];
+static __code const unsigned char bench_ota_query[OTA_QUERY_LEN] = { 0x00, CMD_OTA_QUERY, NODE_ID, 1, 0, 0 };
+
+// ==================== 被测函数 ====================
+
+static void case_empty(void) {
+}
+
+static void case_pan3031_write_reg(void) {
+    pan3031_write_reg(REG_PAYLOAD_LEN, SLAVE_REPORT_LEN);
+}
+
+static void case_pan3031_read_reg(void) {
+    bench_sink = pan3031_read_reg(REG_MODEM_CONFIG2);
+}
+
+static void case_pan3031_send(void) {
+    pan3031_send(bench_report, SLAVE_REPORT_LEN);
+}
+
+static void case_sc09b_read_status(void) {
+    bench_sink = sc09b_read_status();
+}
+
+static void case_sc09b_read_water_level(void) {
+    bench_sink = (unsigned char)sc09b_read_water_level();
+}
+
+static void case_sc09b_get_water_percent(void) {
+    bench_sink = sc09b_get_water_percent();
+}
+
+static void case_slave_report_due(void) {
+    bench_sink = slave_report_due(&node, 12345UL);
+}
+
+static void case_slave_build_report(void) {
+    bench_sink = slave_build_report(&node, bench_report);
+}
+
+static void case_slave_handle_command(void) {
+    bench_sink = slave_handle_command(&node, bench_command, SLAVE_COMMAND_MIN);
+}
+
+// 每秒一次的采样 (水位和通道图每次都变)
+static void case_slave_window_add(void) {
+    bench_window_map = (bench_window_map << 1 | 1) & WINDOW_MAP_MASK;
+    slave_window_add(&window, &node, (unsigned char)bench_window_map, 1, bench_window_map, 12345UL);
+}
+
+// 采样环已满: 摘要 + 16 个通道图
+static void case_slave_window_build_report(void) {
+    bench_sink = slave_window_build_report(&window, &node, bench_window_report, SLAVE_WINDOW_REPORT_MAX);
+}
+
+static void case_send_sensor_data(void) {
+    send_sensor_data();
+}
+
+// 中继收到子节点的上行帧 (每次换序号，不被去重)，下一轮转发
+static void case_slave_mesh_receive(void) {
+    bench_mesh_frame[0] = 0x02;
+    bench_mesh_frame[1] = CMD_MESH_UP;
+    bench_mesh_frame[MESH_UP_NEXT] = NODE_ID;
+    bench_mesh_frame[MESH_UP_ORIGIN] = 0x02;
+    bench_mesh_frame[MESH_UP_SEQ]++;
+    bench_mesh_frame[MESH_UP_TTL] = MESH_MAX_RELAYS;
+    bench_mesh_frame[MESH_UP_INNER_LEN] = SLAVE_REPORT_LEN;
+    bench_mesh_len = MESH_UP_HEADER + SLAVE_REPORT_LEN;
+    bench_sink = slave_mesh_receive(&mesh, bench_mesh_frame, &bench_mesh_len, -100, 12345UL);
+}
+
+static void case_slave_mesh_poll(void) {
+    bench_sink = slave_mesh_poll(&mesh, 12400UL, bench_mesh_frame);
+}
+
+static void case_slave_mesh_wrap_report(void) {
+    bench_sink = slave_mesh_wrap_report(&mesh, bench_mesh_frame, SLAVE_REPORT_LEN);
+}
+
+// 升级会话中收到一个新分片 (每次换序号)
+static void case_slave_ota_receive(void) {
+    bench_ota_frame[OTA_DATA_INDEX]++;
+    bench_sink = slave_ota_receive(&ota, bench_ota_frame, OTA_DATA_LEN_MAX, bench_ota_reply);
+}
+
+// 查询缺片: 组装 128 个分片的位图
+static void case_slave_ota_query(void) {
+    bench_sink = slave_ota_receive(&ota, bench_ota_query, OTA_QUERY_LEN, bench_ota_reply);
+}
+
+static __code const BenchCase_t bench_cases[] = {
+    { "pan3031_write_reg",          case_pan3031_write_reg },
+    { "pan3031_read_reg",           case_pan3031_read_reg },
+    { "pan3031_send",               case_pan3031_send },
+    { "sc09b_read_status",          case_sc09b_read_status },
+    { "sc09b_read_water_level",     case_sc09b_read_water_level },
+    { "sc09b_get_water_percent",    case_sc09b_get_water_percent },
+    { "slave_report_due",           case_slave_report_due },
+    { "slave_build_report",         case_slave_build_report },
+    { "slave_handle_command",       case_slave_handle_command },
+    { "slave_window_add",           case_slave_window_add },
+    { "slave_window_build_report",  case_slave_window_build_report },
+    { "send_sensor_data",           case_send_sensor_data },
+    { "slave_mesh_receive",         case_slave_mesh_receive },
+    { "slave_mesh_poll",            case_slave_mesh_poll },
+    { "slave_mesh_wrap_report",     case_slave_mesh_wrap_report },
+    { "slave_ota_receive",          case_slave_ota_receive },
+    { "slave_ota_query",            case_slave_ota_query },
+};
+
+#define BENCH_CASE_COUNT    (sizeof(bench_cases) / sizeof(bench_cases[0]))
+
+// ==================== 测量 ====================
+
+void bench_timer0_isr(void) __interrupt(1) {
+    bench_overflows++;
+}
+
+/**
+ * 运行一次，返回机器周期 (含调用开销)
+ */
+static unsigned long bench_cycles(BenchFunc_t run) {
+    TR0 = 0;
+    TH0 = 0;
+    TL0 = 0;
+    TF0 = 0;
+    bench_overflows = 0;
+    ET0 = 1;
+    EA = 1;
+
+    TR0 = 1;
+    run();
+    TR0 = 0;
+
+    EA = 0;
+    if (TF0) {
+        TF0 = 0;
+        bench_overflows++;
+    }
+    return ((unsigned long)bench_overflows << 16) | ((unsigned int)TH0 << 8) | TL0;
+}
+
+/**
+ * 运行一次，返回调用期间栈的最大深度 (字节，含返回地址)
+ */
+static unsigned char bench_stack(BenchFunc_t run) {
+    unsigned char base = SP;
+    unsigned char __idata *p = (unsigned char __idata *)base;
+
+    // 填到 idata 顶部 (0xFF)
+    do {
+        p++;
+        *p = BENCH_STACK_FILL;
+    } while ((unsigned char)p != 0xFF);
+
+    run();
+
+    p = (unsigned char __idata *)0xFF;
+    while ((unsigned char)p > base && *p == BENCH_STACK_FILL) p--;
+    return (unsigned char)p - base;
+}
+
+// ==================== 串口输出 ====================
+
+static void bench_putc(char c) {
+    SBUF = c;
+    while (!TI);
+    TI = 0;
+}
+
+static void bench_puts(const char *s) {
+    while (*s) bench_putc(*s++);
+}
+
+static void bench_put_ulong(unsigned long v) {
+    char buf[10];
+    unsigned char n = 0;
+
+    do {
+        buf[n++] = '0' + (char)(v % 10);
+        v /= 10;
+    } while (v);
+    while (n) bench_putc(buf[--n]);
+}
+
+// ==================== 主函数 ====================
+
+void main(void) {
+    unsigned long base_cycles;
+    unsigned char base_stack;
+    unsigned char i;
+
+    // 定时器 0: 16 位计数；定时器 1: 8 位自动重装，串口 9600bps @ 11.0592MHz
+    TMOD = 0x21;
+    TH1 = 0xFD;
+    TL1 = 0xFD;
+    TR1 = 1;
+    SCON = 0x50;
+
+    slave_init(&node, NODE_ID);
+    // 两跳中继: 父节点 0x03，以便测量转发和封装
+    slave_mesh_init(&mesh, NODE_ID, 1);
+    mesh.parent = 0x03;
+    mesh.hops = 2;
+    mesh.cost = 2;
+    mesh.parent_heard = 12000UL;
+    // 升级会话: 4 KB 镜像 (会话 1)，之后的分片帧只改序号
+    slave_ota_init(&ota, NODE_ID);
+    bench_ota_frame[0] = 0x00;
+    bench_ota_frame[1] = CMD_OTA_BEGIN;
+    bench_ota_frame[OTA_TARGET] = NODE_ID;
+    bench_ota_frame[OTA_SESSION] = 1;
+    bench_ota_frame[OTA_BEGIN_SIZE] = 0x00;
+    bench_ota_frame[OTA_BEGIN_SIZE + 1] = 0x10;
+    slave_ota_receive(&ota, bench_ota_frame, OTA_BEGIN_LEN, bench_ota_reply);
+    bench_ota_frame[1] = CMD_OTA_DATA;
+    bench_ota_frame[OTA_DATA_SESSION] = 1;
+    bench_ota_frame[OTA_DATA_INDEX] = 0;
+    bench_ota_frame[OTA_DATA_INDEX + 1] = 0;
+    node.water_level = 50;
+    node.well_water_ok = 1;
+    slave_build_report(&node, bench_report);
+    // 附带通道图，采样环先填满
+    slave_window_init(&window, 1);
+    for (i = 0; i < WINDOW_SAMPLES_MAX; i++) case_slave_window_add();
+    sc09b_init();
+
+    base_cycles = bench_cycles(case_empty);
+    base_stack = bench_stack(case_empty);
+
+    bench_puts("function,cycles,stack\n");
+    for (i = 0; i < BENCH_CASE_COUNT; i++) {
+        unsigned long cycles = bench_cycles(bench_cases[i].run) - base_cycles;
+        unsigned char stack = bench_stack(bench_cases[i].run) - base_stack;
+
+        bench_puts(bench_cases[i].name);
+        bench_putc(',');
+        bench_put_ulong(cycles);
+        bench_putc(',');
+        bench_put_ulong(stack);
+        bench_putc('\n');
+    }
+
+    // 掉电，模拟器停止
+    PCON |= 0x02;
+    while (1);
+}
@@ -0,0 +1,186 @@
+# 从机基准报告 (make bench / make bench-baseline 调用)
+#
+# 合并两部分数据，按函数输出并与 bench/baseline.csv 对比：
+# - 周期、栈深: bench_main.c 在 s51 中经串口输出的 "函数,周期,栈深"
+# - 代码、数据: SDCC --debug 生成的 .cdb
+#     L:G$函数$..:地址 / L:XG$函数$..:地址   函数起止地址 (静态函数为 F模块$函数)
+#     S:L函数$变量$..({大小}类型),空间,..      局部变量和参数；空间 E/F/G/H (内部/外部 RAM、
+#                                            位寻址区) 计入数据，R (寄存器) 和栈上的不计
+#
+# 回归判定: 周期超过基线 --tolerance (默认 2%)，栈深、代码、数据比基线大，或基线中有周期数的
+# 函数本次没有结果 (基准中途停止)。有回归时返回 1 (make 失败)；基线为空时只输出本次结果，
+# 标明"没有基线" (不判定回归，返回 0)。--update 用本次结果覆盖基线。
+# 结果同时写入 --csv。
+
+import argparse
+import csv
+import os
+import re
+import sys
+
+# 不统计的模块 (基准框架本身)
+SKIP_MODULES = ("bench_main",)
+
+DATA_SPACES = "EFGH"
+
+
+def read_uart(path):
+    rows = {}
+    with open(path, "rb") as f:
+        text = f.read().decode("ascii", "replace")
+    for line in text.splitlines():
+        parts = line.strip().split(",")
+        if len(parts) == 3 and parts[1].isdigit() and parts[2].isdigit():
+            rows[parts[0]] = {"cycles": int(parts[1]), "stack": int(parts[2])}
+    return rows
+
+
+def read_cdb(path):
+    """返回 {函数名: {"code": 字节, "data": 字节}}"""
+    module = None
+    func_module = {}
+    start = {}
+    end = {}
+    data = {}
+
+    link = re.compile(r"^L:(X?)(?:G|F[^$]*)\$([^$]+)\$0\$0:([0-9A-Fa-f]+)$")
+    func = re.compile(r"^F:(?:G|F[^$]*)\$([^$]+)\$")
+    local = re.compile(r"^S:L([^$]+)\$[^$]+\$[^(]*\(\{(\d+)\}[^)]*\),([A-Z])")
+
+    with open(path, "r", errors="replace") as f:
+        for line in f:
+            line = line.strip()
+            if line.startswith("M:"):
+                module = line[2:]
+                continue
+            m = func.match(line)
+            if m:
+                func_module[m.group(1)] = module
+                continue
+            m = link.match(line)
+            if m:
+                (end if m.group(1) else start)[m.group(2)] = int(m.group(3), 16)
+                continue
+            m = local.match(line)
+            if m and m.group(3) in DATA_SPACES:
+                name = m.group(1).split(".")[-1]
+                data[name] = data.get(name, 0) + int(m.group(2))
+
+    sizes = {}
+    for name, addr in start.items():
+        if func_module.get(name) in SKIP_MODULES or name not in end:
+            continue
+        # 结束地址为 ret 指令
+        sizes[name] = {"code": end[name] - addr + 1, "data": data.get(name, 0)}
+    return sizes
+
+
+def read_baseline(path):
+    base = {}
+    if not os.path.exists(path):
+        return base
+    with open(path) as f:
+        for row in csv.DictReader(f):
+            base[row["function"]] = row
+    return base
+
+
+def field(row, key):
+    value = row.get(key, "") if row else ""
+    return int(value) if value not in ("", None) else None
+
+
+def change(cur, old):
+    if cur is None or old is None:
+        return ""
+    if cur == old:
+        return "="
+    return "%+d" % (cur - old)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="从机 s51 基准报告")
+    parser.add_argument("--uart", required=True)
+    parser.add_argument("--cdb", required=True)
+    parser.add_argument("--baseline", required=True)
+    parser.add_argument("--csv", required=True)
+    parser.add_argument("--tolerance", type=float, default=2.0, help="周期允许增加的百分比")
+    parser.add_argument("--update", action="store_true", help="用本次结果覆盖基线")
+    args = parser.parse_args()
+
+    measured = read_uart(args.uart)
+    if not measured:
+        print("❌ %s 中没有基准结果 (s51 是否运行完成?)" % args.uart)
+        return 1
+    sizes = read_cdb(args.cdb)
+    baseline = read_baseline(args.baseline)
+
+    # 有周期数的函数在前 (按运行顺序)，其余按代码大小
+    names = list(measured)
+    names += sorted((n for n in sizes if n not in measured), key=lambda n: -sizes[n]["code"])
+
+    rows = []
+    for name in names:
+        row = {"function": name}
+        row.update(measured.get(name, {}))
+        row.update(sizes.get(name, {}))
+        rows.append(row)
+
+    regressions = []
+    print("")
+    print("========== 从机基准 (s51 机器周期，字节) ==========")
+    print("%-26s %10s %8s %6s %5s %6s %6s %5s %5s" %
+          ("函数", "周期", "变化", "栈", "变化", "代码", "变化", "数据", "变化"))
+    for row in rows:
+        name = row["function"]
+        old = baseline.get(name)
+        cur = {key: row.get(key) for key in ("cycles", "stack", "code", "data")}
+        prev = {key: field(old, key) for key in cur}
+
+        print("%-26s %10s %8s %6s %5s %6s %6s %5s %5s" % (
+            name,
+            "-" if cur["cycles"] is None else cur["cycles"], change(cur["cycles"], prev["cycles"]),
+            "-" if cur["stack"] is None else cur["stack"], change(cur["stack"], prev["stack"]),
+            "-" if cur["code"] is None else cur["code"], change(cur["code"], prev["code"]),
+            "-" if cur["data"] is None else cur["data"], change(cur["data"], prev["data"])))
+
+        if cur["cycles"] is not None and prev["cycles"] is not None and \
+                cur["cycles"] > prev["cycles"] * (1 + args.tolerance / 100.0):
+            regressions.append("%s 周期 %d -> %d" % (name, prev["cycles"], cur["cycles"]))
+        for key, label in (("stack", "栈深"), ("code", "代码"), ("data", "数据")):
+            if cur[key] is not None and prev[key] is not None and cur[key] > prev[key]:
+                regressions.append("%s %s %d -> %d" % (name, label, prev[key], cur[key]))
+
+    keys = ("function", "cycles", "stack", "code", "data")
+    with open(args.csv, "w", newline="") as f:
+        writer = csv.DictWriter(f, fieldnames=keys, extrasaction="ignore")
+        writer.writeheader()
+        writer.writerows(rows)
+
+    if args.update:
+        with open(args.baseline, "w", newline="") as f:
+            writer = csv.DictWriter(f, fieldnames=keys, extrasaction="ignore")
+            writer.writeheader()
+            writer.writerows(rows)
+        print("基线已更新: %s" % args.baseline)
+        return 0
+
+    for name, old in baseline.items():
+        if field(old, "cycles") is not None and name not in measured:
+            regressions.append("%s 没有周期结果" % name)
+
+    if not baseline:
+        print("⚠️ 没有基线: %s 为空，本次未做回归判定；确认结果后运行 make bench-baseline 记录并提交" %
+              args.baseline)
+        return 0
+    if regressions:
+        print("❌ 相对基线退化:")
+        for r in regressions:
+            print("   " + r)
+        return 1
+    print("✅ 未超过基线")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -52,6 +52,15 @@ __sfr __at(0x97) CLK_DIV;
 // 看门狗
 __sfr __at(0xC1) WDT_CONTR;
 
+// IAP/EEPROM (空中升级，见 ota_flash.h)
+__sfr __at(0xC2) IAP_DATA;
+__sfr __at(0xC3) IAP_ADDRH;
+__sfr __at(0xC4) IAP_ADDRL;
+__sfr __at(0xC5) IAP_CMD;
+__sfr __at(0xC6) IAP_TRIG;
+__sfr __at(0xC7) IAP_CONTR;
+__sfr __at(0xF5) IAP_TPS;
+
 // 端口寄存器定义 (必须在 #include 之前，以便 sbit 使用)
 __sfr __at(0x80) P0;
 __sfr __at(0x90) P1;
@@ -0,0 +1,112 @@
+/*
+ * STC8G1K08 空中升级的 Flash 操作 - 暂存区擦写、激活记录、节点身份和启动时的镜像复制
+ *
+ * 协议和分片记录在 slave_ota.c (与硬件无关)，这里只按 IAP 地址读写 Flash。
+ *
+ * Flash 分区 (IAP 地址。STC-ISP 下载时把 EEPROM 大小设为整个 Flash (12K)，
+ * IAP 地址即程序地址，程序区才能被 IAP 改写):
+ *   0x0000-0x13FF  程序区 (含中断向量，升级时整体替换，长度即 OTA_IMAGE_MAX)
+ *   0x1400-0x15FF  复制程序 (ota_boot.c，链接到 BOOT 段，不随升级更新)
+ *   0x1600-0x29FF  暂存区 (接收中的新镜像)
+ *   0x2A00-0x2BFF  激活记录
+ *   0x2C00-0x2DFF  节点身份 (地址和角色，升级不改写)
+ *   0x2E00-0x2FFF  保留
+ *
+ * 激活: 写激活记录后软件复位；main() 开头调用 ota_boot()，发现记录且暂存区 CRC 正确时
+ * 关中断把暂存区逐页复制到程序区，清除记录后再次复位进入新程序。
+ * 复制不到 1 秒，期间掉电需要用 STC-ISP 重新烧录。
+ *
+ * ota_boot.c 不随升级更新，已部署的节点上它与新镜像中的调用地址必须一致：不要修改该文件。
+ * 它的工作变量固定在 OTA_BOOT_RAM (寄存器组 2、3)，固件中不能使用 __using(2)/__using(3)。
+ *
+ * 节点身份: 同一个镜像广播给多个节点，地址和角色 (中继、通道图) 不能编译在镜像中。
+ * 启动时 ota_identity_load() 读身份记录；没有记录 (首次用 STC-ISP 烧录) 时写入编译时的
+ * NODE_ID、MESH_RELAY、WINDOW_BATCH，之后的升级镜像不论如何编译都沿用记录。
+ * 修改地址或角色需要用 STC-ISP 擦除整个 Flash 后重新烧录。
+ */
+
+#ifndef OTA_FLASH_H
+#define OTA_FLASH_H
+
+#include "slave_config.h"
+
+// ==================== Flash 分区 ====================
+#define OTA_FLASH_PAGE      512     // 擦除单位
+#define OTA_APP_BASE        0x0000
+#define OTA_BOOT_BASE       0x1400
+#define OTA_STAGE_BASE      0x1600
+#define OTA_RECORD_BASE     0x2A00
+
+// 激活记录: [0x5A][0xA5][长度 2][CRC 2]
+#define OTA_RECORD_MAGIC0   0x5A
+#define OTA_RECORD_MAGIC1   0xA5
+#define OTA_RECORD_LEN      6
+
+// 节点身份: [0x1D][0xE1][地址][角色][校验 (地址 ^ 角色 ^ 0xFF)]
+#define OTA_IDENTITY_BASE   0x2C00
+#define OTA_IDENTITY_MAGIC0 0x1D
+#define OTA_IDENTITY_MAGIC1 0xE1
+#define OTA_IDENTITY_LEN    5
+#define OTA_ROLE_RELAY      0x01    // 中继节点 (MESH_RELAY)
+#define OTA_ROLE_BATCH      0x02    // 上报帧附带通道图 (WINDOW_BATCH)
+
+// ==================== 复制程序的工作变量 ====================
+#define OTA_BOOT_RAM        0x10    // 内部 RAM 0x10-0x1F (寄存器组 2、3)
+
+// ==================== IAP ====================
+#define IAP_CMD_READ        0x01
+#define IAP_CMD_PROGRAM     0x02
+#define IAP_CMD_ERASE       0x03
+#define IAP_CONTR_IAPEN     0x80
+#define IAP_CONTR_SWRST     0x20    // 软件复位 (从用户程序区启动)
+#define OTA_IAP_TPS         11      // 系统时钟 (MHz，11.0592MHz 取整)
+
+// ==================== 函数声明 ====================
+
+// ota_boot.c (BOOT 段)
+
+/**
+ * 上电时调用: 有激活记录时复制镜像并复位 (不返回)，否则立即返回
+ */
+void ota_boot(void);
+
+uint8_t ota_iap_read(uint16_t addr);
+
+/**
+ * 把 IAP_DATA 写入 addr (已擦除的位置)，调用前先设置 IAP_DATA
+ * (复制程序不随升级更新，第二个参数的地址由链接器分配，因此不用参数传递)
+ */
+void ota_iap_program(uint16_t addr);
+
+void ota_iap_erase(uint16_t addr);
+
+// ota_flash.c
+
+/**
+ * 擦除暂存区中 size 字节所占的页
+ */
+void ota_flash_erase(uint16_t size);
+
+/**
+ * 写入暂存区 (已擦除的位置)
+ */
+void ota_flash_write(uint16_t offset, const uint8_t *data, uint8_t len);
+
+/**
+ * 暂存区前 size 字节的 CRC (slave_ota_crc16)
+ */
+uint16_t ota_flash_crc(uint16_t size);
+
+/**
+ * 写激活记录并软件复位 (不返回)
+ */
+void ota_flash_activate(uint16_t size, uint16_t crc);
+
+/**
+ * 读节点身份，没有记录时写入编译时的 NODE_ID、MESH_RELAY、WINDOW_BATCH
+ * @param role 输出 OTA_ROLE_* 组合
+ * @return 节点地址
+ */
+uint8_t ota_identity_load(uint8_t *role);
+
+#endif
@@ -59,6 +59,11 @@
 #define MODE_RXCONT         0x05
 #define MODE_RXSINGLE       0x06
 
+// 中断标志 (REG_IRQ_FLAGS)
+#define IRQ_RX_DONE         0x40
+#define IRQ_CRC_ERROR       0x20
+#define IRQ_TX_DONE         0x08
+
 // ==================== 函数声明 ====================
 void pan3031_init(void);
 void pan3031_write_reg(uint8_t addr, uint8_t value);
@@ -68,7 +73,9 @@ void pan3031_set_sf(uint8_t sf);
 void pan3031_set_bw(uint32_t bw);
 void pan3031_set_power(uint8_t power);
 void pan3031_send(uint8_t *data, uint8_t len);
-uint8_t pan3031_receive(uint8_t *data, uint8_t *len);
+void pan3031_listen(void);
+uint8_t pan3031_receive(uint8_t *data, uint8_t max);
+int pan3031_packet_rssi(void);
 void pan3031_sleep(void);
 void pan3031_wor_enable(void);
 
@@ -6,29 +6,43 @@
 #define SLAVE_CONFIG_H
 
 #include <STC8G1K08.h>
+#include "slave_proto.h"   // 命令字、上报间隔 (与仿真器共用)
+#include "slave_mesh.h"    // 中继网络
+#include "slave_ota.h"     // 空中升级
+#include "slave_window.h"  // 采样窗口
 
 // ==================== 节点配置 ====================
-#define NODE_ID         0x01    // 默认节点地址 (可通过拨码开关设置)
+// 地址和下面的角色只在首次烧录时写入 Flash 的身份记录，之后以记录为准 (升级镜像广播给
+// 多个节点，见 ota_flash.h)。首次烧录: make NODE=5 [RELAY=1] [BATCH=1]
+#ifndef NODE_ID
+#define NODE_ID         0x01    // 默认节点地址
+#endif
 
 // ==================== 通信配置 ====================
-#define SEND_INTERVAL   5       // 心跳发送间隔 (秒)
 #define PAN3031_FREQ    434000000  // 频率 434MHz
 #define PAN3031_SF      7       // 扩频因子
 #define PAN3031_BW      125000  // 带宽 125kHz
 #define PAN3031_PWR     20      // 发射功率 20dBm
+#define SLAVE_RX_MAX    SLAVE_MESH_FRAME_MAX    // 接收缓冲区 (中继上行帧，不短于升级分片帧)
 
-// ==================== 命令字定义 ====================
-#define CMD_HEARTBEAT   0x01    // 心跳包
-#define CMD_QUERY       0x02    // 查询状态
-#define CMD_SENSOR      0x03    // 传感器数据
-#define CMD_SENSOR_DATA 0x03    // 传感器数据 (别名)
-#define CMD_READ_SENSOR 0x03    // 读取传感器 (别名)
-#define CMD_PUMP_CTRL   0x10    // 水泵控制
-#define CMD_SET_AUTO    0x20    // 自动模式
-#define CMD_SET_MANUAL  0x21    // 手动模式
-#define CMD_ALARM       0xFF    // 报警
+// ==================== 中继配置 ====================
+// 市电供电的节点编译为中继 (make RELAY=1): 持续接收，转发其他节点的帧并发送路由通告。
+// 电池节点保持 0，只按路由通告选择上报路径，只在上报后和预计的通告前后短暂接收
+#ifndef MESH_RELAY
+#define MESH_RELAY      0
+#endif
+
+// ==================== 采样配置 ====================
+// 装有 SC09B 的节点 (make BATCH=1): 上报帧附带窗口内每次采样的 9 位通道图。
+// 0 时只带窗口摘要 (最低/最高水位、变化次数)
+#ifndef WINDOW_BATCH
+#define WINDOW_BATCH    0
+#endif
 
 // ==================== 功耗配置 ====================
+// 电池节点升级会话中最后一帧之后保持接收的时间 (主机中途停止时不一直开着接收)
+#define OTA_LISTEN_MS   60000UL
+
 // 睡眠模式：
 // - CPU 停止
 // - ADC 关闭
@@ -0,0 +1,159 @@
+/*
+ * 从机中继网络 - 让主机单个 PAN3031 覆盖不到的水塔经市电供电的从机转发
+ *
+ * 与 slave_proto.c 一样不访问 SFR、不依赖 SDCC 扩展。每个节点的网络状态放在 SlaveMesh_t 中。
+ *
+ * 路由树:
+ * - 主机每 MESH_BEACON_MS 发送路由通告 (跳数 0)；已入网的中继以自己的跳数和路径代价再通告
+ * - 节点 (中继和电池节点) 按收到的通告选父节点: 路径代价 = 对方的代价 + 本跳链路代价 (按 RSSI)，
+ *   新路径须比当前路径好 MESH_COST_HYSTERESIS 以上才切换；父节点 MESH_ROUTE_TIMEOUT_MS 没有通告则路由失效
+ * - 跳数超过 MESH_MAX_HOPS 的通告被忽略，以本机为父节点的通告不作为上行路径 (避免环路)
+ *
+ * 转发:
+ * - 父节点是主机 (或没有路由) 时上报帧按原格式直接发送，不增加空中时间
+ * - 否则封装为 CMD_MESH_UP 沿父节点逐跳上行；每个中继把剩余中继数减一，并追加
+ *   [中继地址][驻留时间]，主机据此统计每一跳的延迟和完整路径
+ * - 下行帧 (CMD_MESH_DOWN) 带主机从上行帧得到的路径，只有路径上的下一个中继转发 (不泛洪)
+ * - 中继和目标节点按 (源地址, 序号) 去重
+ *
+ * 接收: 中继持续接收；电池节点只在预计的父节点通告前后接收 (没有路由时定期寻找)，
+ * 另外在每次上报后的短暂窗口内接收主机命令 (slave_rx_window)，其余时间射频睡眠
+ *
+ * 帧格式 (第 1 字节均为本跳发送者，第 2 字节为命令):
+ *   通告: [发送者][CMD_MESH_BEACON][父节点][跳数][路径代价]
+ *   上行: [发送者][CMD_MESH_UP][下一跳][源][序号][剩余中继数][内层长度 n][内层帧 n 字节]
+ *         [中继地址][驻留时间 (10 ms)]...
+ *   下行: [发送者][CMD_MESH_DOWN][目标][序号][路径长度 k][下一跳位置][中继地址 × k][内层帧]
+ *         (路径从主机一侧起，目标节点收到后按原格式的主机命令处理内层帧)
+ *
+ * 命令字 0x30-0x32 与旧格式主机命令的目标地址处于同一字节，从机地址不要使用 0x30-0x32。
+ */
+
+#ifndef SLAVE_MESH_H
+#define SLAVE_MESH_H
+
+#include "slave_proto.h"
+
+// ==================== 参数 ====================
+#define MESH_MASTER_ID          0x00    // 主机地址
+#define MESH_NO_NODE            0xFF    // 无效地址
+
+#define MESH_MAX_HOPS           5       // 到主机的最大跳数 (即最多 4 个中继)
+#define MESH_MAX_RELAYS         (MESH_MAX_HOPS - 1)
+#define MESH_BEACON_MS          30000UL // 路由通告间隔 (毫秒)
+#define MESH_ROUTE_TIMEOUT_MS   (3 * MESH_BEACON_MS + 5000UL)
+#define MESH_COST_HYSTERESIS    1       // 切换父节点所需的最小代价改善
+#define MESH_LISTEN_GUARD_MS    1000UL  // 电池节点在预计的通告时刻前后各接收的时间
+#define MESH_SEARCH_MS          600000UL    // 没有路由的电池节点每 10 分钟接收一个通告周期
+
+// 链路代价: RSSI 不低于 GOOD 为 1，不低于 FAIR 为 2，否则为 4 (SF7 灵敏度约 -123 dBm)
+#define MESH_RSSI_GOOD          (-105)
+#define MESH_RSSI_FAIR          (-115)
+
+#define MESH_SEEN_SIZE          8       // 去重表条目数
+#define SLAVE_MESH_FRAME_MAX    32      // 收发缓冲区长度 (主机一次最多读出 32 字节)
+
+// ==================== 帧格式 ====================
+#define MESH_BEACON_LEN         5
+#define MESH_BEACON_PARENT      2
+#define MESH_BEACON_HOPS        3
+#define MESH_BEACON_COST        4
+
+#define MESH_UP_NEXT            2
+#define MESH_UP_ORIGIN          3
+#define MESH_UP_SEQ             4
+#define MESH_UP_TTL             5
+#define MESH_UP_INNER_LEN       6
+#define MESH_UP_HEADER          7
+
+#define MESH_DOWN_TARGET        2
+#define MESH_DOWN_SEQ           3
+#define MESH_DOWN_PATH_LEN      4
+#define MESH_DOWN_NEXT          5
+#define MESH_DOWN_HEADER        6       // 其后为路径
+
+// slave_mesh_receive() 返回值
+#define MESH_RX_PASS            0       // 不是中继网络帧，按原样交给 slave_handle_command()
+#define MESH_RX_DONE            1       // 已处理 (通告、转发、重复或不是给本机的)
+#define MESH_RX_LOCAL           2       // 给本机的下行命令，内层帧已移到缓冲区开头
+
+// ==================== 节点状态 ====================
+typedef struct {
+    unsigned char id;
+    unsigned char seq;
+} MeshSeen_t;
+
+typedef struct {
+    unsigned char id;               // 本机地址
+    unsigned char relay;            // 1=中继 (转发其他节点的帧并发送路由通告)
+
+    // 路由
+    unsigned char parent;           // 上行下一跳 (MESH_MASTER_ID=直连主机)
+    unsigned char hops;             // 到主机的跳数，0=没有路由 (按原格式直接发给主机)
+    unsigned char cost;             // 路径代价
+    unsigned long parent_heard;     // 最近一次收到父节点通告的时刻 (毫秒)
+    unsigned long last_beacon;      // 本机上次发送通告的时刻
+    unsigned char beacon_now;       // 路由变化，下一轮立即通告
+    unsigned char seq;              // 本机发起的上行帧序号
+
+    // 去重
+    MeshSeen_t seen[MESH_SEEN_SIZE];
+    unsigned char seen_next;
+
+    // 待转发的帧 (1 帧)
+    unsigned char queue[SLAVE_MESH_FRAME_MAX];
+    unsigned char queue_len;        // 0=空
+    unsigned long queued_at;        // 收到的时刻 (计算驻留时间)
+
+    // 统计
+    unsigned int forwarded;
+    unsigned int dropped;           // 队列忙、路径过长或没有路由而丢弃
+} SlaveMesh_t;
+
+// ==================== 函数声明 ====================
+
+/**
+ * 初始化网络状态 (没有路由)
+ * @param relay 1=中继节点
+ */
+void slave_mesh_init(SlaveMesh_t *m, unsigned char id, unsigned char relay);
+
+/**
+ * 处理收到的一帧
+ * @param rx 收到的帧 (MESH_RX_LOCAL 时改写为内层帧)
+ * @param len 帧长度 (MESH_RX_LOCAL 时改写为内层帧长度)
+ * @param rssi 接收信号强度 (dBm)
+ * @param now 当前时间 (毫秒)
+ * @return MESH_RX_*
+ */
+unsigned char slave_mesh_receive(SlaveMesh_t *m, unsigned char *rx, unsigned char *len, int rssi,
+                                 unsigned long now);
+
+/**
+ * 本机上报帧 (封装前) 的最大长度: 经过每个中继追加记录后仍不超过 SLAVE_MESH_FRAME_MAX
+ */
+unsigned char slave_mesh_report_room(const SlaveMesh_t *m);
+
+/**
+ * 按当前路由封装本机的上报帧
+ * 父节点是主机或没有路由时不变
+ * @param buf 上报帧，至少 SLAVE_MESH_FRAME_MAX 字节
+ * @return 封装后的长度
+ */
+unsigned char slave_mesh_wrap_report(SlaveMesh_t *m, unsigned char *buf, unsigned char len);
+
+/**
+ * 射频是否需要为路由接收
+ * 中继总是接收；电池节点有路由时只在预计的父节点通告时刻前后 MESH_LISTEN_GUARD_MS 内，
+ * 没有路由时每 MESH_SEARCH_MS 接收一个通告周期寻找父节点 (上电后立即开始)
+ */
+unsigned char slave_mesh_listen(const SlaveMesh_t *m, unsigned long now);
+
+/**
+ * 每轮主循环调用一次: 检查路由超时，取出需要发送的帧 (待转发的帧优先，其次是路由通告)
+ * @param buf 至少 SLAVE_MESH_FRAME_MAX 字节
+ * @return 帧长度，0=没有要发送的
+ */
+unsigned char slave_mesh_poll(SlaveMesh_t *m, unsigned long now, unsigned char *buf);
+
+#endif
@@ -0,0 +1,126 @@
+/*
+ * 从机空中升级 - 分片接收、缺片位图和镜像校验
+ *
+ * 与 slave_proto.c 一样不访问 SFR、不依赖 SDCC 扩展：Flash 的擦写由调用方按
+ * slave_ota_receive() 返回的动作完成 (STC8G 见 ota_flash.h，Linux 主机的模拟从机写内存)。
+ *
+ * 过程 (主机端见 esp8266_master/src/ota_master.h):
+ * 1. 主机逐个给目标节点发 BEGIN (会话号、镜像长度、CRC)，节点擦除暂存区后应答状态
+ * 2. 主机广播全部分片，节点写入暂存区并在位图中记下；收齐后校验整个镜像的 CRC
+ * 3. 主机逐个查询，节点应答缺片位图 (每帧覆盖 OTA_STATUS_WINDOW 个分片)；主机合并
+ *    所有节点的缺片，下一轮只重发缺少的分片，直到全部节点校验通过
+ * 4. 主机发 ACTIVATE，校验通过的节点应答后把暂存区复制到程序区并复位 (ota_boot.c)
+ *
+ * 分片是广播的，所有节点共用同一轮发送：总空中时间约为镜像大小加各节点缺片的并集，
+ * 而不是节点数 × 镜像大小。
+ *
+ * 帧格式 (多字节字段低字节在前):
+ *   BEGIN:    [0][CMD_OTA_BEGIN][目标][会话][长度 2][CRC 2]
+ *   DATA:     [0][CMD_OTA_DATA][会话][分片序号 2][数据，最后一片可不足 OTA_CHUNK_SIZE]
+ *   QUERY:    [0][CMD_OTA_QUERY][目标][会话][起始分片 2]
+ *   ACTIVATE: [0][CMD_OTA_ACTIVATE][目标][会话]
+ *   STATUS:   [节点][CMD_OTA_STATUS][会话][状态][缺片数 2][窗口起点 2][位图 OTA_STATUS_BITMAP 字节]
+ *             窗口起点为起始分片之后第一个缺少的分片，位图第 i 位 (字节 i/8 的位 i%8)
+ *             为 1 表示窗口起点 + i 号分片缺少
+ *
+ * 命令字 0x40-0x44 与旧格式主机命令的目标地址处于同一字节，从机地址不要使用 0x40-0x44。
+ * 镜像 CRC 为 CRC-16/CCITT-FALSE (多项式 0x1021，初值 0xFFFF)。
+ */
+
+#ifndef SLAVE_OTA_H
+#define SLAVE_OTA_H
+
+#include "slave_proto.h"
+
+// ==================== 参数 ====================
+#define OTA_CHUNK_SIZE          24      // 分片数据长度 (DATA 帧 29 字节)
+#define OTA_IMAGE_MAX           0x1400  // 镜像最大长度 (与 ota_flash.h 的程序区相同)
+#define OTA_CHUNKS_MAX          ((OTA_IMAGE_MAX + OTA_CHUNK_SIZE - 1) / OTA_CHUNK_SIZE)
+#define OTA_BITMAP_BYTES        ((OTA_CHUNKS_MAX + 7) / 8)
+#define OTA_CRC_INIT            0xFFFF
+
+// ==================== 帧格式 ====================
+#define OTA_TARGET              2       // BEGIN/QUERY/ACTIVATE 的目标地址
+#define OTA_SESSION             3       // BEGIN/QUERY/ACTIVATE 的会话号
+
+#define OTA_BEGIN_SIZE          4
+#define OTA_BEGIN_CRC           6
+#define OTA_BEGIN_LEN           8
+
+#define OTA_DATA_SESSION        2
+#define OTA_DATA_INDEX          3
+#define OTA_DATA_HEADER         5       // 其后为分片数据
+#define OTA_DATA_LEN_MAX        (OTA_DATA_HEADER + OTA_CHUNK_SIZE)
+
+#define OTA_QUERY_FROM          4
+#define OTA_QUERY_LEN           6
+
+#define OTA_ACTIVATE_LEN        4
+
+#define OTA_STATUS_SESSION      2
+#define OTA_STATUS_STATE        3
+#define OTA_STATUS_MISSING      4
+#define OTA_STATUS_BASE         6
+#define OTA_STATUS_HEADER       8       // 其后为位图
+#define OTA_STATUS_BITMAP       16
+#define OTA_STATUS_WINDOW       (OTA_STATUS_BITMAP * 8)
+#define OTA_STATUS_LEN          (OTA_STATUS_HEADER + OTA_STATUS_BITMAP)
+
+// 会话状态 (STATUS 帧的状态字节)
+#define OTA_STATE_IDLE          0       // 没有会话
+#define OTA_STATE_RECEIVING     1       // 接收分片
+#define OTA_STATE_VERIFIED      2       // 已收齐且 CRC 正确，等待激活
+#define OTA_STATE_CRC_ERROR     3       // 已收齐但 CRC 错误 (主机重新 BEGIN)
+#define OTA_STATE_REJECTED      4       // 镜像长度无效
+#define OTA_STATE_ACTIVATING    5       // 正在激活
+
+// slave_ota_receive() 返回的动作 (按位组合，调用方按下列顺序执行)，0=不是升级帧
+#define OTA_DO_HANDLED          0x01    // 升级帧 (已处理，不再交给其他模块)
+#define OTA_DO_ERASE            0x02    // 擦除暂存区 (size 字节)
+#define OTA_DO_WRITE            0x04    // 把 rx + OTA_DATA_HEADER 起 write_len 字节写到暂存区 write_offset 处
+#define OTA_DO_VERIFY           0x08    // 已收齐: 计算暂存区 size 字节的 CRC，交给 slave_ota_verified()
+#define OTA_DO_REPLY            0x10    // 发送 tx 中的 STATUS 帧 (OTA_STATUS_LEN 字节)
+#define OTA_DO_ACTIVATE         0x20    // 应答发出后激活暂存区的镜像
+
+// ==================== 会话状态 ====================
+typedef struct {
+    unsigned char id;                       // 本机地址
+    unsigned char state;                    // OTA_STATE_*
+    unsigned char session;                  // 主机分配的会话号
+    unsigned int size;                      // 镜像长度
+    unsigned int crc;                       // 镜像 CRC (BEGIN 中主机给出)
+    unsigned int chunks;                    // 分片数
+    unsigned int missing;                   // 尚未收到的分片数
+    unsigned char have[OTA_BITMAP_BYTES];   // 已收到的分片
+
+    // OTA_DO_WRITE 的位置
+    unsigned int write_offset;
+    unsigned char write_len;
+} SlaveOta_t;
+
+// ==================== 函数声明 ====================
+
+/**
+ * 初始化 (没有会话)
+ */
+void slave_ota_init(SlaveOta_t *o, unsigned char id);
+
+/**
+ * 处理收到的一帧
+ * @param tx 应答缓冲区，至少 OTA_STATUS_LEN 字节 (OTA_DO_REPLY 时有效)
+ * @return OTA_DO_* 的组合，0=不是升级帧
+ */
+unsigned char slave_ota_receive(SlaveOta_t *o, const unsigned char *rx, unsigned char len, unsigned char *tx);
+
+/**
+ * 暂存区校验完毕 (OTA_DO_VERIFY 之后调用)
+ * @param crc 按 slave_ota_crc16() 计算的暂存区 CRC
+ */
+void slave_ota_verified(SlaveOta_t *o, unsigned int crc);
+
+/**
+ * CRC-16/CCITT-FALSE 累加一个字节 (从 OTA_CRC_INIT 开始)
+ */
+unsigned int slave_ota_crc16(unsigned int crc, unsigned char b);
+
+#endif
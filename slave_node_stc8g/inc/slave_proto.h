@@ -0,0 +1,88 @@
+/*
+ * 从机协议 - 与硬件无关的上报帧组装、上报周期判断和主机命令处理
+ *
+ * 不访问 SFR，不依赖 SDCC 扩展：main.c (STC8G) 和 Linux 端 LoRa 网络仿真器
+ * (linux_host/sim) 共用同一份代码。节点状态放在 SlaveNode_t 中，仿真器可同时运行多个节点。
+ */
+
+#ifndef SLAVE_PROTO_H
+#define SLAVE_PROTO_H
+
+// ==================== 命令字定义 ====================
+#define CMD_HEARTBEAT   0x01    // 心跳包
+#define CMD_QUERY       0x02    // 查询状态
+#define CMD_SENSOR      0x03    // 传感器数据
+#define CMD_SENSOR_DATA 0x03    // 传感器数据 (别名)
+#define CMD_READ_SENSOR 0x03    // 读取传感器 (别名)
+#define CMD_PUMP_CTRL   0x10    // 水泵控制
+#define CMD_SET_AUTO    0x20    // 自动模式
+#define CMD_SET_MANUAL  0x21    // 手动模式
+#define CMD_MESH_BEACON 0x30    // 路由通告 (中继网络，见 slave_mesh.h)
+#define CMD_MESH_UP     0x31    // 经中继转发的上行帧
+#define CMD_MESH_DOWN   0x32    // 经中继转发的下行帧
+#define CMD_OTA_BEGIN   0x40    // 开始升级会话 (空中升级，见 slave_ota.h)
+#define CMD_OTA_DATA    0x41    // 镜像分片 (广播)
+#define CMD_OTA_QUERY   0x42    // 查询缺片
+#define CMD_OTA_STATUS  0x43    // 升级状态和缺片位图 (从机应答)
+#define CMD_OTA_ACTIVATE 0x44   // 激活新镜像
+#define CMD_ALARM       0xFF    // 报警
+
+// ==================== 上报 ====================
+#define SEND_INTERVAL   15      // 上报间隔 (秒)，期间每秒采样 (见 slave_window.h)
+#define SLAVE_REPORT_MS ((unsigned long)SEND_INTERVAL * 1000UL)
+
+// 电池节点每次上报后保持接收的时间 (毫秒)，主机在此期间下发命令 (见 slave_rx_window)
+#define SLAVE_RX_WINDOW_MS  1500UL
+
+// 上报帧: [NodeID][CMD_SENSOR_DATA][Len][WaterLevel][WellWaterOK]
+#define SLAVE_REPORT_LEN    5
+
+// 主机命令帧: [源地址][目标地址][命令]...，至少 4 字节
+#define SLAVE_COMMAND_MIN   4
+
+// ==================== 节点状态 ====================
+typedef struct {
+    unsigned char id;               // 从机地址
+    unsigned char water_level;      // 水位 0-100%
+    unsigned char well_water_ok;    // 井水正常
+    unsigned long last_send;        // 上次上报时刻 (毫秒)
+} SlaveNode_t;
+
+// ==================== 函数声明 ====================
+
+/**
+ * 初始化节点状态
+ */
+void slave_init(SlaveNode_t *node, unsigned char id);
+
+/**
+ * 是否到了定期上报的时间
+ * @param now 当前时间 (毫秒)
+ */
+unsigned char slave_report_due(const SlaveNode_t *node, unsigned long now);
+
+/**
+ * 组装上报帧
+ * @param buf 至少 SLAVE_REPORT_LEN 字节
+ * @return 帧长度
+ */
+unsigned char slave_build_report(const SlaveNode_t *node, unsigned char *buf);
+
+/**
+ * 上报帧发送完毕，记录时刻 (下一次定期上报从此刻算起)
+ */
+void slave_report_sent(SlaveNode_t *node, unsigned long now);
+
+/**
+ * 是否在上报后的接收窗口内
+ * 电池节点只在窗口内接收主机命令，其余时间射频睡眠 (中继持续接收，见 slave_mesh_listen)
+ */
+unsigned char slave_rx_window(const SlaveNode_t *node, unsigned long now);
+
+/**
+ * 处理一帧主机命令
+ * @return 1=需要立即上报传感器数据，0=忽略 (不是给本机的、太短或无需应答)
+ */
+unsigned char slave_handle_command(const SlaveNode_t *node, const unsigned char *rx, unsigned char len);
+
+#endif
@@ -0,0 +1,105 @@
+/*
+ * 从机采样窗口 - 每秒采样，上报帧带整个窗口的摘要和可选的 SC09B 通道图
+ *
+ * 与 slave_proto.c 一样不访问 SFR、不依赖 SDCC 扩展：传感器由调用方读取后交给
+ * slave_window_add()，Linux 端的仿真器用同一份代码组装上报帧。
+ *
+ * 采样和上报分开:
+ * - 每 SLAVE_SAMPLE_MS 采样一次，窗口记下上次上报以来的最低/最高水位和读数变化次数，
+ *   通道图放进采样环 (最近 WINDOW_SAMPLES_MAX 次)
+ * - 每 SEND_INTERVAL 秒上报一次，两次上报之间的短暂波动由摘要和通道图带给主机；
+ *   井水状态变化时立即上报，附带通道图时采样环满也立即上报 (不丢弃采样)
+ * - 上报后开始新的窗口 (读数变化按相邻两次采样比较，跨窗口也计算)
+ *
+ * 上报帧 (前 5 字节与旧格式相同，旧主机只读水位和井水状态):
+ *   [NodeID][CMD_SENSOR_DATA][Len][水位][井水正常][最低水位][最高水位][变化次数][采样数]
+ *   [通道图 ...]
+ * - 水位和井水状态为最后一次采样；采样数为 0 时没有读数 (主机只刷新在线状态)
+ * - 通道图: 最新的 n 次采样的 9 位通道图 (bit0=通道 1)，从旧到新依次排列，
+ *   第 i 个占第 9i 位起的 9 位 (字节 k 的位 j 为第 8k+j 位)，n = 通道图字节数 × 8 / 9；
+ *   经中继上报时按剩余长度减少 n，放不下时只带摘要
+ */
+
+#ifndef SLAVE_WINDOW_H
+#define SLAVE_WINDOW_H
+
+#include "slave_proto.h"
+
+// ==================== 参数 ====================
+#define SLAVE_SAMPLE_MS         1000UL  // 采样间隔 (毫秒)
+#define WINDOW_SAMPLES_MAX      16      // 采样环容量 (2 的幂)
+#define WINDOW_MAP_MASK         0x01FF  // SC09B 通道图 (9 位)
+#define WINDOW_NO_LEVEL         0xFF    // 还没有采样
+
+// ==================== 帧格式 ====================
+#define WINDOW_LEVEL_MIN        5
+#define WINDOW_LEVEL_MAX        6
+#define WINDOW_CHANGES          7
+#define WINDOW_SAMPLES          8
+#define WINDOW_MAPS             9       // 其后为通道图
+#define WINDOW_BATCH_BYTES(n)   (((n) * 9 + 7) / 8)
+#define SLAVE_SUMMARY_LEN       WINDOW_MAPS
+#define SLAVE_WINDOW_REPORT_MAX (SLAVE_SUMMARY_LEN + WINDOW_BATCH_BYTES(WINDOW_SAMPLES_MAX))
+
+// ==================== 窗口状态 ====================
+typedef struct {
+    unsigned char batch;            // 1=上报帧附带通道图
+    unsigned long last_sample;      // 上次采样时刻 (毫秒)
+
+    // 摘要 (上次上报以来的全部采样)
+    unsigned char samples;          // 采样数 (到 255 为止)
+    unsigned char level_min;
+    unsigned char level_max;
+    unsigned char changes;          // 水位或井水状态变化次数 (到 255 为止)
+    unsigned char urgent;           // 井水状态变化，立即上报
+
+    // 上一次采样
+    unsigned char prev_level;       // WINDOW_NO_LEVEL=还没有采样
+    unsigned char prev_well;
+
+    // 采样环 (本窗口最近的通道图)
+    unsigned int map[WINDOW_SAMPLES_MAX];
+    unsigned char head;             // 下一次写入的位置
+    unsigned char count;            // 环中本窗口的采样数
+} SlaveWindow_t;
+
+// ==================== 函数声明 ====================
+
+/**
+ * 初始化窗口 (没有采样)
+ * @param batch 1=上报帧附带通道图 (装有 SC09B 的节点)
+ */
+void slave_window_init(SlaveWindow_t *w, unsigned char batch);
+
+/**
+ * 是否到了采样时间
+ */
+unsigned char slave_window_sample_due(const SlaveWindow_t *w, unsigned long now);
+
+/**
+ * 记录一次采样，节点的最新读数更新为本次读数
+ * @param map SC09B 通道图 (不附带通道图时忽略)
+ */
+void slave_window_add(SlaveWindow_t *w, SlaveNode_t *node, unsigned char level, unsigned char well_ok,
+                      unsigned int map, unsigned long now);
+
+/**
+ * 是否需要上报: 定期上报到期、井水状态变化或采样环已满 (附带通道图时)
+ */
+unsigned char slave_window_report_due(const SlaveWindow_t *w, const SlaveNode_t *node, unsigned long now);
+
+/**
+ * 组装带窗口摘要的上报帧
+ * @param buf 至少 room 字节
+ * @param room 帧的最大长度 (不小于 SLAVE_SUMMARY_LEN，通道图按此减少)
+ * @return 帧长度
+ */
+unsigned char slave_window_build_report(const SlaveWindow_t *w, const SlaveNode_t *node, unsigned char *buf,
+                                        unsigned char room);
+
+/**
+ * 上报帧发送完毕: 记录时刻 (同 slave_report_sent) 并开始新的窗口
+ */
+void slave_window_report_sent(SlaveWindow_t *w, SlaveNode_t *node, unsigned long now);
+
+#endif
@@ -6,15 +6,21 @@
  * - STC8G1K08 从机只负责传感器数据采集
  * 
  * 功能：
- * 1. 读取液位传感器 (ADC)
+ * 1. 每秒读取液位传感器 (ADC) 和 SC09B 通道图 (BATCH=1)，按窗口汇总后上报 (slave_window.c)
  * 2. 检测缺水
  * 3. 通过 PAN3031 与主机通信
  * 4. 接收主机命令 (只读，不执行水泵控制)
+ * 5. 中继网络: 按路由通告选择上报路径，中继节点转发其他节点的帧；
+ *    电池节点只在上报后、预计的路由通告前后和升级会话中接收，其余时间射频睡眠
+ * 6. 空中升级: 接收主机广播的镜像分片，校验后复制到程序区 (slave_ota.c、ota_flash.h)；
+ *    地址和角色 (中继、通道图) 在首次烧录时写入 Flash，不随镜像更新
  */
 
 #include <8051.h>
 #include "pan3031.h"
+#include "sc09b.h"
 #include "slave_config.h"
+#include "ota_flash.h"
 
 // ==================== 引脚定义 ====================
 // PAN3031 LoRa 通信
@@ -28,43 +34,70 @@ __sbit __at(0xB4) WATER_LOW_DET; // P3.4 = 0xB0+4  // 缺水检测
 // 注意：水泵继电器由 ESP8266 主机控制，STC8G 不控制
 
 // ==================== 全局变量 ====================
-volatile unsigned char node_id = NODE_ID;
-volatile unsigned char water_level = 0;
-volatile unsigned char well_water_ok = 1;
-volatile unsigned long last_send = 0;
+SlaveNode_t node;   // 地址、最新读数、上次上报时刻 (协议逻辑见 slave_proto.c)
+__xdata SlaveMesh_t mesh;   // 路由、去重表、待转发的帧 (见 slave_mesh.c)
+__xdata SlaveWindow_t window;   // 上次上报以来的采样摘要和通道图 (见 slave_window.c)
+__xdata SlaveOta_t ota;     // 升级会话和已收到的分片 (见 slave_ota.c)
+unsigned long ota_heard;    // 最近一次收到升级帧的时刻
 
 // ==================== 函数声明 ====================
 void system_init(void);
 unsigned char read_water_level(void);
 unsigned char check_well_water(void);
+void sample_sensors(void);
 void send_sensor_data(void);
+unsigned char radio_listen(void);
 void handle_host_command(void);
+void handle_mesh_send(void);
+unsigned char handle_ota(unsigned char *rx, unsigned char len);
 void delay_ms(unsigned int ms);
 unsigned long millis(void);
 
 // ==================== 主函数 ====================
 void main(void) {
+    unsigned char id, role;
+    
+    // 有待激活的新镜像时复制到程序区并复位 (不返回)
+    ota_boot();
+    
+    // 地址和角色取自 Flash 的身份记录 (升级镜像对所有节点相同)
+    id = ota_identity_load(&role);
+    slave_init(&node, id);
+    slave_mesh_init(&mesh, id, (role & OTA_ROLE_RELAY) ? 1 : 0);
+    slave_window_init(&window, (role & OTA_ROLE_BATCH) ? 1 : 0);
+    slave_ota_init(&ota, id);
     system_init();
     
-    // 发送上电心跳
+    // 上电先采样一次，第一帧就带读数 (采样数为 0 的帧主机不采用其水位)
+    sample_sensors();
     send_sensor_data();
     
     while (1) {
-        // 读取水位传感器
-        water_level = read_water_level();
-        
-        // 检查井水是否缺水
-        well_water_ok = check_well_water();
+        // 每秒采样一次 (水位、井水、SC09B 通道图)
+        if (slave_window_sample_due(&window, millis())) {
+            sample_sensors();
+        }
         
-        // 定期发送传感器数据 (每 5 秒)
-        if (millis() - last_send > 5000) {
+        // 定期上报窗口摘要 (每 SEND_INTERVAL 秒)；井水状态变化时立即上报
+        if (slave_window_report_due(&window, &node, millis())) {
             send_sensor_data();
         }
         
-        // 处理主机命令 (非阻塞)
-        handle_host_command();
+        // 处理主机命令和中继网络帧 (非阻塞)；不需要接收时射频睡眠
+        if (radio_listen()) {
+            pan3031_listen();
+            handle_host_command();
+        } else {
+            pan3031_sleep();
+        }
         
-        delay_ms(100);
+        // 转发其他节点的帧、发送路由通告
+        handle_mesh_send();
+        
+        // 接收升级分片时不延时 (主机按空中时间连续广播，PAN3031 只保留最后一帧)
+        if (ota.state != OTA_STATE_RECEIVING) {
+            delay_ms(100);
+        }
     }
 }
 
@@ -83,6 +116,11 @@ void system_init(void) {
     pan3031_set_bw(125000UL);       // 125kHz
     pan3031_set_power(20);          // 20dBm
     
+    // SC09B 通道图 (上报帧附带)
+    if (window.batch) {
+        sc09b_init();
+    }
+    
     // 串口调试 (可选)
     // SCON = 0x50;  // 串口模式 1
     // TMOD |= 0x20; // 定时器 1 模式 2
@@ -126,68 +164,96 @@ unsigned char check_well_water(void) {
     return (WATER_LOW_DET == 1) ? 1 : 0;
 }
 
+/**
+ * 采样一次，记入窗口 (节点的最新读数随之更新)
+ */
+void sample_sensors(void) {
+    unsigned int map = 0;
+    
+    if (window.batch) {
+        map = sc09b_read_water_level();
+    }
+    slave_window_add(&window, &node, read_water_level(), check_well_water(), map, millis());
+}
+
 // ==================== 通信函数 ====================
 /**
  * 发送传感器数据到主机
  * 
  * 数据格式:
- * [NodeID][CMD_SENSOR][Len][WaterLevel][WellWaterOK]
+ * [NodeID][CMD_SENSOR][Len][WaterLevel][WellWaterOK][Min][Max][Changes][Samples][通道图...]
+ * 父节点是中继时封装为 CMD_MESH_UP (见 slave_mesh.h)，通道图按剩余长度减少
  */
 void send_sensor_data(void) {
-    unsigned char tx_data[5];
+    static __xdata unsigned char tx_data[SLAVE_MESH_FRAME_MAX];
+    unsigned char len = slave_window_build_report(&window, &node, tx_data, slave_mesh_report_room(&mesh));
     
-    tx_data[0] = node_id;           // 从机 ID
-    tx_data[1] = CMD_SENSOR_DATA;   // 传感器数据命令
-    tx_data[2] = 2;                 // 数据长度
-    tx_data[3] = water_level;       // 水位 0-100%
-    tx_data[4] = well_water_ok ? 1 : 0;  // 井水状态
+    len = slave_mesh_wrap_report(&mesh, tx_data, len);
     
-    pan3031_send(tx_data, 5);
-    last_send = millis();
+    pan3031_send(tx_data, len);
+    slave_window_report_sent(&window, &node, millis());
     
     // 调试输出
-    // printf("Send: ID=%d Level=%d Well=%d\n", node_id, water_level, well_water_ok);
+    // printf("Send: ID=%d Level=%d Well=%d\n", node.id, node.water_level, node.well_water_ok);
 }
 
 /**
- * 处理主机命令
- * 
- * 支持命令:
- * - CMD_READ_SENSOR: 读取传感器 (立即响应)
- * - CMD_PUMP_CTRL: 水泵控制 (忽略，由 ESP8266 直接控制)
- * - CMD_HEARTBEAT: 心跳请求
+ * 射频是否需要接收
+ * 中继持续接收；电池节点只在上报后的窗口 (主机下发命令)、预计的路由通告前后，
+ * 以及升级会话中 (最后一帧之后 OTA_LISTEN_MS 内) 接收
+ */
+unsigned char radio_listen(void) {
+    unsigned long now = millis();
+    
+    if (slave_mesh_listen(&mesh, now) || slave_rx_window(&node, now)) return 1;
+    return (ota.state != OTA_STATE_IDLE && now - ota_heard < OTA_LISTEN_MS) ? 1 : 0;
+}
+
+/**
+ * 处理主机命令 (非阻塞)
+ * 中继网络帧交给 slave_mesh_receive()，经中继下发的命令拆出后与直接收到的命令相同处理；
+ * 升级帧交给 handle_ota()；读取传感器和心跳请求立即上报，其余命令忽略 (见 slave_handle_command)
  */
 void handle_host_command(void) {
-    unsigned char rx_data[8];
-    unsigned char len = pan3031_receive(rx_data, 8);
+    static __xdata unsigned char rx_data[SLAVE_RX_MAX];
+    unsigned char len = pan3031_receive(rx_data, SLAVE_RX_MAX);
     
-    if (len < 4) return;  // 数据太短
+    if (len == 0) return;
+    if (slave_mesh_receive(&mesh, rx_data, &len, pan3031_packet_rssi(), millis()) == MESH_RX_DONE) return;
+    if (handle_ota(rx_data, len)) return;
     
-    // 验证目标地址
-    if (rx_data[1] != node_id) return;  // 不是给我的
+    if (slave_handle_command(&node, rx_data, len)) {
+        send_sensor_data();
+    }
+}
+
+/**
+ * 发送中继网络的待发帧 (每轮最多一帧)
+ */
+void handle_mesh_send(void) {
+    static __xdata unsigned char tx_data[SLAVE_MESH_FRAME_MAX];
+    unsigned char len = slave_mesh_poll(&mesh, millis(), tx_data);
     
-    unsigned char cmd = rx_data[2];
+    if (len) pan3031_send(tx_data, len);
+}
+
+/**
+ * 处理空中升级帧: 按 slave_ota_receive() 返回的动作擦写暂存区、应答状态、激活新镜像
+ * @return 1=升级帧 (已处理)
+ */
+unsigned char handle_ota(unsigned char *rx, unsigned char len) {
+    static __xdata unsigned char tx_data[OTA_STATUS_LEN];
+    unsigned char act = slave_ota_receive(&ota, rx, len, tx_data);
     
-    switch (cmd) {
-        case CMD_READ_SENSOR:
-            // 立即发送传感器数据
-            send_sensor_data();
-            break;
-            
-        case CMD_PUMP_CTRL:
-            // 忽略水泵控制命令 (ESP8266 直接控制继电器)
-            // 只记录状态，不执行
-            break;
-            
-        case CMD_HEARTBEAT:
-            // 心跳响应
-            send_sensor_data();
-            break;
-            
-        default:
-            // 未知命令
-            break;
-    }
+    // 发给其他节点的升级帧也算 (会话仍在进行，见 radio_listen)
+    if (len >= 2 && rx[1] >= CMD_OTA_BEGIN && rx[1] <= CMD_OTA_ACTIVATE) ota_heard = millis();
+    if (act == 0) return 0;
+    if (act & OTA_DO_ERASE) ota_flash_erase(ota.size);
+    if (act & OTA_DO_WRITE) ota_flash_write(ota.write_offset, rx + OTA_DATA_HEADER, ota.write_len);
+    if (act & OTA_DO_VERIFY) slave_ota_verified(&ota, ota_flash_crc(ota.size));
+    if (act & OTA_DO_REPLY) pan3031_send(tx_data, OTA_STATUS_LEN);
+    if (act & OTA_DO_ACTIVATE) ota_flash_activate(ota.size, ota.crc);    // 复位，不返回
+    return 1;
 }
 
 // ==================== 工具函数 ====================
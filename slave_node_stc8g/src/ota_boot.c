@@ -0,0 +1,120 @@
+/*
+ * 空中升级的镜像复制 - 链接到 BOOT 段 (OTA_BOOT_BASE)，不随升级更新
+ *
+ * 复制过程中程序区被改写，这里不能调用其他文件的函数 (包括 SDCC 的库函数)，
+ * CRC 也在本文件中单独计算。
+ *
+ * 内部 RAM: --model-small 下非重入函数的参数和局部变量由链接器分配在 DATA/覆盖区，
+ * 每次链接的地址不同；已部署节点上的复制程序是旧镜像链接的，会按旧地址改写新镜像的
+ * 变量甚至栈 (main() 开头调用 ota_boot() 的返回地址)。因此本文件:
+ * - 工作变量全部固定在 OTA_BOOT_RAM (寄存器组 2、3)，每个镜像都链接本文件，
+ *   链接器在这些地址之外分配其他变量和栈
+ * - 函数最多一个参数 (经 DPL/DPH 传递)，入口处即存入工作变量，不使用局部变量
+ * - 写入的数据经 IAP_DATA 传递 (ota_iap_program)
+ */
+
+#include "ota_flash.h"
+
+// ==================== 工作变量 (固定地址) ====================
+static __data __at(OTA_BOOT_RAM + 0) uint16_t boot_addr;    // IAP 地址
+static __data __at(OTA_BOOT_RAM + 2) uint16_t boot_size;    // 激活记录: 镜像长度
+static __data __at(OTA_BOOT_RAM + 4) uint16_t boot_expect;  // 激活记录: CRC
+static __data __at(OTA_BOOT_RAM + 6) uint16_t boot_crc;     // 暂存区的 CRC
+static __data __at(OTA_BOOT_RAM + 8) uint16_t boot_i;
+static __data __at(OTA_BOOT_RAM + 10) uint8_t boot_j;
+static __data __at(OTA_BOOT_RAM + 11) uint8_t boot_cmd;     // IAP 命令
+static __data __at(OTA_BOOT_RAM + 12) uint8_t boot_ea;      // 调用前的中断允许
+
+// ==================== IAP ====================
+
+/**
+ * 对 boot_addr 执行 boot_cmd (读出和写入的数据在 IAP_DATA)
+ */
+static void iap_run(void) {
+    boot_ea = EA;
+
+    EA = 0;     // 两次触发之间不能被中断
+    IAP_CONTR = IAP_CONTR_IAPEN;
+    IAP_TPS = OTA_IAP_TPS;
+    IAP_CMD = boot_cmd;
+    IAP_ADDRL = (uint8_t)boot_addr;
+    IAP_ADDRH = (uint8_t)(boot_addr >> 8);
+    IAP_TRIG = 0x5A;
+    IAP_TRIG = 0xA5;
+    __asm nop __endasm;
+
+    // 回到空闲状态，防止误触发
+    IAP_CONTR = 0;
+    IAP_CMD = 0;
+    IAP_TRIG = 0;
+    IAP_ADDRH = 0x80;
+    IAP_ADDRL = 0;
+    EA = boot_ea;
+}
+
+uint8_t ota_iap_read(uint16_t addr) {
+    boot_addr = addr;
+    boot_cmd = IAP_CMD_READ;
+    iap_run();
+    return IAP_DATA;
+}
+
+void ota_iap_program(uint16_t addr) {
+    boot_addr = addr;
+    boot_cmd = IAP_CMD_PROGRAM;
+    iap_run();
+}
+
+void ota_iap_erase(uint16_t addr) {
+    boot_addr = addr;
+    boot_cmd = IAP_CMD_ERASE;
+    iap_run();
+}
+
+// ==================== 复制 ====================
+
+/**
+ * 暂存区前 boot_size 字节的 CRC，结果在 boot_crc
+ */
+static void boot_check(void) {
+    boot_crc = 0xFFFF;
+    boot_cmd = IAP_CMD_READ;
+
+    for (boot_i = 0; boot_i < boot_size; boot_i++) {
+        boot_addr = OTA_STAGE_BASE + boot_i;
+        iap_run();
+        boot_crc ^= (uint16_t)IAP_DATA << 8;
+        for (boot_j = 0; boot_j < 8; boot_j++) {
+            if (boot_crc & 0x8000) boot_crc = (boot_crc << 1) ^ 0x1021;
+            else boot_crc <<= 1;
+        }
+    }
+}
+
+void ota_boot(void) {
+    if (ota_iap_read(OTA_RECORD_BASE) != OTA_RECORD_MAGIC0 ||
+        ota_iap_read(OTA_RECORD_BASE + 1) != OTA_RECORD_MAGIC1) {
+        return;
+    }
+    boot_size = ota_iap_read(OTA_RECORD_BASE + 2);
+    boot_size |= (uint16_t)ota_iap_read(OTA_RECORD_BASE + 3) << 8;
+    boot_expect = ota_iap_read(OTA_RECORD_BASE + 4);
+    boot_expect |= (uint16_t)ota_iap_read(OTA_RECORD_BASE + 5) << 8;
+
+    // 暂存区损坏时放弃，继续运行旧程序
+    if (boot_size != 0 && boot_size <= OTA_BOOT_BASE - OTA_APP_BASE) {
+        boot_check();
+        if (boot_crc == boot_expect) {
+            EA = 0;
+            for (boot_i = 0; boot_i < boot_size; boot_i++) {
+                if ((boot_i & (OTA_FLASH_PAGE - 1)) == 0) ota_iap_erase(OTA_APP_BASE + boot_i);
+                ota_iap_read(OTA_STAGE_BASE + boot_i);      // 读出的字节留在 IAP_DATA
+                ota_iap_program(OTA_APP_BASE + boot_i);
+            }
+        }
+    }
+
+    ota_iap_erase(OTA_RECORD_BASE);
+    IAP_CONTR = IAP_CONTR_SWRST;
+    while (1);
+}
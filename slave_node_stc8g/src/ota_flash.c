@@ -0,0 +1,76 @@
+/*
+ * 空中升级的暂存区操作和节点身份 (Flash 分区见 ota_flash.h)
+ */
+
+#include "ota_flash.h"
+
+static void flash_put(uint16_t addr, uint8_t value) {
+    IAP_DATA = value;
+    ota_iap_program(addr);
+}
+
+void ota_flash_erase(uint16_t size) {
+    uint16_t offset;
+
+    for (offset = 0; offset < size; offset += OTA_FLASH_PAGE) {
+        ota_iap_erase(OTA_STAGE_BASE + offset);
+    }
+}
+
+void ota_flash_write(uint16_t offset, const uint8_t *data, uint8_t len) {
+    uint8_t i;
+
+    for (i = 0; i < len; i++) {
+        flash_put(OTA_STAGE_BASE + offset + i, data[i]);
+    }
+}
+
+uint16_t ota_flash_crc(uint16_t size) {
+    uint16_t crc = OTA_CRC_INIT;
+    uint16_t i;
+
+    for (i = 0; i < size; i++) {
+        crc = slave_ota_crc16(crc, ota_iap_read(OTA_STAGE_BASE + i));
+    }
+    return crc;
+}
+
+void ota_flash_activate(uint16_t size, uint16_t crc) {
+    ota_iap_erase(OTA_RECORD_BASE);
+    flash_put(OTA_RECORD_BASE, OTA_RECORD_MAGIC0);
+    flash_put(OTA_RECORD_BASE + 1, OTA_RECORD_MAGIC1);
+    flash_put(OTA_RECORD_BASE + 2, (uint8_t)size);
+    flash_put(OTA_RECORD_BASE + 3, (uint8_t)(size >> 8));
+    flash_put(OTA_RECORD_BASE + 4, (uint8_t)crc);
+    flash_put(OTA_RECORD_BASE + 5, (uint8_t)(crc >> 8));
+
+    // 复位后由 ota_boot() 复制
+    IAP_CONTR = IAP_CONTR_SWRST;
+    while (1);
+}
+
+// ==================== 节点身份 ====================
+
+uint8_t ota_identity_load(uint8_t *role) {
+    uint8_t id = ota_iap_read(OTA_IDENTITY_BASE + 2);
+    uint8_t flags = ota_iap_read(OTA_IDENTITY_BASE + 3);
+
+    if (ota_iap_read(OTA_IDENTITY_BASE) == OTA_IDENTITY_MAGIC0 &&
+        ota_iap_read(OTA_IDENTITY_BASE + 1) == OTA_IDENTITY_MAGIC1 &&
+        ota_iap_read(OTA_IDENTITY_BASE + 4) == (uint8_t)(id ^ flags ^ 0xFF)) {
+        *role = flags;
+        return id;
+    }
+
+    // 首次烧录: 记录编译时的配置
+    id = NODE_ID;
+    flags = (MESH_RELAY ? OTA_ROLE_RELAY : 0) | (WINDOW_BATCH ? OTA_ROLE_BATCH : 0);
+    ota_iap_erase(OTA_IDENTITY_BASE);
+    flash_put(OTA_IDENTITY_BASE, OTA_IDENTITY_MAGIC0);
+    flash_put(OTA_IDENTITY_BASE + 1, OTA_IDENTITY_MAGIC1);
+    flash_put(OTA_IDENTITY_BASE + 2, id);
+    flash_put(OTA_IDENTITY_BASE + 3, flags);
+    flash_put(OTA_IDENTITY_BASE + 4, (uint8_t)(id ^ flags ^ 0xFF));
+    *role = flags;
+    return id;
+}
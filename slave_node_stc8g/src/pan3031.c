@@ -13,6 +13,8 @@ __sbit __at(0xA0) PAN3031_SCK;
 
 // 全局变量
 static unsigned long g_millis = 0;
+static int packet_rssi = 0;     // 最近一帧的 RSSI (dBm)
+static unsigned char op_mode = MODE_STDBY;  // 当前工作模式 (避免每轮重复写寄存器)
 
 // 微秒延时
 void delay_us(unsigned int us) {
@@ -154,16 +156,51 @@ void pan3031_send(unsigned char *data, unsigned char len) {
     pan3031_write_reg(0x01, 0x03);  // TX 模式
     delay_ms(10);
     pan3031_write_reg(0x01, 0x01);  // 待机
+    op_mode = MODE_STDBY;
 }
 
-// 接收数据 (简化版)
-unsigned char pan3031_receive(unsigned char *data, unsigned char *len) {
-    (void)data;
-    (void)len;
-    return 0;  // 不实现接收
+// 进入连续接收 (发送后回到待机，需重新进入)
+void pan3031_listen(void) {
+    if (op_mode == MODE_RXCONT) return;
+    pan3031_write_reg(REG_OP_MODE, MODE_RXCONT);
+    op_mode = MODE_RXCONT;
 }
 
-// 睡眠模式
+// 接收数据 (pan3031_listen() 之后，非阻塞)，返回帧长度，0=没有收到
+unsigned char pan3031_receive(unsigned char *data, unsigned char max) {
+    unsigned char irq, len, i;
+    signed char snr;
+
+    if (op_mode != MODE_RXCONT) return 0;
+    irq = pan3031_read_reg(REG_IRQ_FLAGS);
+    if ((irq & IRQ_RX_DONE) == 0) return 0;
+    if (irq & IRQ_CRC_ERROR) {
+        pan3031_write_reg(REG_IRQ_FLAGS, 0xFF);
+        return 0;
+    }
+
+    len = pan3031_read_reg(REG_RX_NB_BYTES);
+    if (len > max) len = max;
+    pan3031_write_reg(REG_FIFO_ADDR_PTR, pan3031_read_reg(REG_FIFO_RX_ADDR));
+    for (i = 0; i < len; i++) data[i] = pan3031_read_reg(REG_FIFO);
+
+    // 信号质量 (与主机驱动相同: RSSI = -164 + 寄存器值，SNR 为负时再加 SNR)
+    snr = (signed char)pan3031_read_reg(REG_PKT_SNR);
+    packet_rssi = -164 + pan3031_read_reg(REG_PKT_RSSI);
+    if (snr < 0) packet_rssi += snr / 4;
+
+    pan3031_write_reg(REG_IRQ_FLAGS, 0xFF);
+    return len;
+}
+
+// 最近一帧的 RSSI (dBm)
+int pan3031_packet_rssi(void) {
+    return packet_rssi;
+}
+
+// 睡眠模式 (下次 pan3031_send() 或 pan3031_listen() 时唤醒)
 void pan3031_sleep(void) {
-    pan3031_write_reg(0x01, 0x00);
+    if (op_mode == MODE_SLEEP) return;
+    pan3031_write_reg(REG_OP_MODE, MODE_SLEEP);
+    op_mode = MODE_SLEEP;
 }
@@ -26,9 +26,9 @@ __sbit __at(0xB2) SC09B_INT;  // 可选中断引脚
 
 // 短延时 (约 1μs @ 12MHz)
 static void i2c_delay(void) {
-    _nop_();
-    _nop_();
-    _nop_();
+    __asm nop __endasm;
+    __asm nop __endasm;
+    __asm nop __endasm;
 }
 
 // I2C 初始化
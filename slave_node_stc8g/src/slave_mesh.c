@@ -0,0 +1,234 @@
+/*
+ * 从机中继网络实现
+ */
+
+#include "slave_mesh.h"
+
+// ==================== 内部函数 ====================
+
+/**
+ * 按 RSSI 估计链路代价 (弱链路代价高，宁可多走一跳好链路)
+ */
+static unsigned char mesh_link_cost(int rssi) {
+    if (rssi >= MESH_RSSI_GOOD) return 1;
+    if (rssi >= MESH_RSSI_FAIR) return 2;
+    return 4;
+}
+
+/**
+ * 查去重表，未见过的帧记入表中
+ * @return 1=重复
+ */
+static unsigned char mesh_seen(SlaveMesh_t *m, unsigned char id, unsigned char seq) {
+    unsigned char i;
+
+    for (i = 0; i < MESH_SEEN_SIZE; i++) {
+        if (m->seen[i].id == id && m->seen[i].seq == seq) return 1;
+    }
+    m->seen[m->seen_next].id = id;
+    m->seen[m->seen_next].seq = seq;
+    m->seen_next = (m->seen_next + 1) % MESH_SEEN_SIZE;
+    return 0;
+}
+
+static void mesh_enqueue(SlaveMesh_t *m, const unsigned char *rx, unsigned char len, unsigned long now) {
+    unsigned char i;
+
+    for (i = 0; i < len; i++) m->queue[i] = rx[i];
+    m->queue_len = len;
+    m->queued_at = now;
+}
+
+static void mesh_on_beacon(SlaveMesh_t *m, const unsigned char *rx, int rssi, unsigned long now) {
+    unsigned char sender = rx[0];
+    unsigned int cost;
+
+    // 子节点的通告不能作为上行路径
+    if (sender != MESH_MASTER_ID && rx[MESH_BEACON_PARENT] == m->id) return;
+
+    if (rx[MESH_BEACON_HOPS] >= MESH_MAX_HOPS) {
+        // 父节点离主机太远 (路径变长或出现环路)，放弃这条路由
+        if (m->hops && sender == m->parent) m->hops = 0;
+        return;
+    }
+
+    cost = (unsigned int)rx[MESH_BEACON_COST] + mesh_link_cost(rssi);
+    if (cost > 0xFF) cost = 0xFF;
+
+    // 父节点的定期通告只刷新路径；其他节点的路径须明显更好才切换
+    if (m->hops && sender != m->parent && cost + MESH_COST_HYSTERESIS >= m->cost) return;
+    if (!m->hops || sender != m->parent) m->beacon_now = m->relay;
+
+    m->parent = sender;
+    m->hops = rx[MESH_BEACON_HOPS] + 1;
+    m->cost = (unsigned char)cost;
+    m->parent_heard = now;
+}
+
+static void mesh_on_up(SlaveMesh_t *m, const unsigned char *rx, unsigned char len, unsigned long now) {
+    if (len < MESH_UP_HEADER + rx[MESH_UP_INNER_LEN]) return;
+    if (mesh_seen(m, rx[MESH_UP_ORIGIN], rx[MESH_UP_SEQ])) return;
+
+    // 追加逐跳记录后要放得下
+    if (rx[MESH_UP_TTL] == 0 || m->hops == 0 || m->queue_len || len + 2 > SLAVE_MESH_FRAME_MAX) {
+        m->dropped++;
+        return;
+    }
+    mesh_enqueue(m, rx, len, now);
+    m->queue[MESH_UP_TTL]--;
+}
+
+static unsigned char mesh_on_down(SlaveMesh_t *m, unsigned char *rx, unsigned char *len, unsigned long now) {
+    unsigned char n = *len;
+    unsigned char k, next, start, i;
+
+    if (n < MESH_DOWN_HEADER) return MESH_RX_DONE;
+    k = rx[MESH_DOWN_PATH_LEN];
+    next = rx[MESH_DOWN_NEXT];
+    start = MESH_DOWN_HEADER + k;
+    if (k > MESH_MAX_RELAYS || start > n) return MESH_RX_DONE;
+
+    if (rx[MESH_DOWN_TARGET] == m->id) {
+        if (mesh_seen(m, MESH_MASTER_ID, rx[MESH_DOWN_SEQ])) return MESH_RX_DONE;
+
+        // 内层帧移到开头，按原格式的主机命令处理
+        n -= start;
+        for (i = 0; i < n; i++) rx[i] = rx[start + i];
+        *len = n;
+        return MESH_RX_LOCAL;
+    }
+
+    // 只有路径上的下一个中继转发
+    if (!m->relay || next >= k || rx[MESH_DOWN_HEADER + next] != m->id) return MESH_RX_DONE;
+    if (mesh_seen(m, MESH_MASTER_ID, rx[MESH_DOWN_SEQ])) return MESH_RX_DONE;
+    if (m->queue_len) {
+        m->dropped++;
+        return MESH_RX_DONE;
+    }
+    mesh_enqueue(m, rx, n, now);
+    m->queue[MESH_DOWN_NEXT]++;
+    return MESH_RX_DONE;
+}
+
+// ==================== 接口 ====================
+
+void slave_mesh_init(SlaveMesh_t *m, unsigned char id, unsigned char relay) {
+    unsigned char i;
+
+    m->id = id;
+    m->relay = relay;
+    m->parent = MESH_NO_NODE;
+    m->hops = 0;
+    m->cost = 0xFF;
+    m->parent_heard = 0;
+    m->last_beacon = 0;
+    m->beacon_now = 0;
+    m->seq = 0;
+    for (i = 0; i < MESH_SEEN_SIZE; i++) {
+        m->seen[i].id = MESH_NO_NODE;
+        m->seen[i].seq = 0;
+    }
+    m->seen_next = 0;
+    m->queue_len = 0;
+    m->queued_at = 0;
+    m->forwarded = 0;
+    m->dropped = 0;
+}
+
+unsigned char slave_mesh_receive(SlaveMesh_t *m, unsigned char *rx, unsigned char *len, int rssi,
+                                 unsigned long now) {
+    if (*len < 2) return MESH_RX_PASS;
+
+    switch (rx[1]) {
+        case CMD_MESH_BEACON:
+            if (*len >= MESH_BEACON_LEN) mesh_on_beacon(m, rx, rssi, now);
+            return MESH_RX_DONE;
+
+        case CMD_MESH_UP:
+            // 只处理发给本机的
+            if (m->relay && *len >= MESH_UP_HEADER && rx[MESH_UP_NEXT] == m->id) mesh_on_up(m, rx, *len, now);
+            return MESH_RX_DONE;
+
+        case CMD_MESH_DOWN:
+            return mesh_on_down(m, rx, len, now);
+
+        default:
+            return MESH_RX_PASS;
+    }
+}
+
+unsigned char slave_mesh_listen(const SlaveMesh_t *m, unsigned long now) {
+    unsigned long phase;
+
+    if (m->relay) return 1;
+    if (m->hops == 0) return (now % MESH_SEARCH_MS < MESH_BEACON_MS + MESH_LISTEN_GUARD_MS) ? 1 : 0;
+
+    // 父节点按 MESH_BEACON_MS 周期通告，漏听一次后仍按同一相位等待
+    phase = (now - m->parent_heard) % MESH_BEACON_MS;
+    return (phase < MESH_LISTEN_GUARD_MS || phase >= MESH_BEACON_MS - MESH_LISTEN_GUARD_MS) ? 1 : 0;
+}
+
+unsigned char slave_mesh_report_room(const SlaveMesh_t *m) {
+    if (m->hops <= 1) return SLAVE_MESH_FRAME_MAX;
+    // 途经 hops - 1 个中继，每个追加 [地址][驻留时间]
+    return (unsigned char)(SLAVE_MESH_FRAME_MAX - MESH_UP_HEADER - 2 * (m->hops - 1));
+}
+
+unsigned char slave_mesh_wrap_report(SlaveMesh_t *m, unsigned char *buf, unsigned char len) {
+    unsigned char i;
+
+    if (m->hops <= 1 || len + MESH_UP_HEADER > SLAVE_MESH_FRAME_MAX) return len;
+
+    for (i = len; i > 0; i--) buf[MESH_UP_HEADER + i - 1] = buf[i - 1];
+    buf[0] = m->id;
+    buf[1] = CMD_MESH_UP;
+    buf[MESH_UP_NEXT] = m->parent;
+    buf[MESH_UP_ORIGIN] = m->id;
+    buf[MESH_UP_SEQ] = m->seq++;
+    buf[MESH_UP_TTL] = MESH_MAX_RELAYS;
+    buf[MESH_UP_INNER_LEN] = len;
+    return MESH_UP_HEADER + len;
+}
+
+unsigned char slave_mesh_poll(SlaveMesh_t *m, unsigned long now, unsigned char *buf) {
+    unsigned char n, i;
+    unsigned long residency;
+
+    // 父节点长时间没有通告，路由失效 (电池节点改为直接发给主机)
+    if (m->hops && now - m->parent_heard > MESH_ROUTE_TIMEOUT_MS) m->hops = 0;
+
+    if (m->queue_len) {
+        n = m->queue_len;
+        m->queue_len = 0;
+        if (m->queue[1] == CMD_MESH_UP && m->hops == 0) {
+            m->dropped++;
+            return 0;
+        }
+
+        for (i = 0; i < n; i++) buf[i] = m->queue[i];
+        buf[0] = m->id;
+        if (buf[1] == CMD_MESH_UP) {
+            // 驻留时间 (10 ms，最大 2.55 秒)
+            residency = (now - m->queued_at) / 10;
+            buf[MESH_UP_NEXT] = m->parent;
+            buf[n++] = m->id;
+            buf[n++] = residency > 0xFF ? 0xFF : (unsigned char)residency;
+        }
+        m->forwarded++;
+        return n;
+    }
+
+    // 中继: 入网后立即通告，之后定期通告 (已在最大跳数的中继不能再带子节点)
+    if (m->relay && m->hops && m->hops < MESH_MAX_HOPS &&
+        (m->beacon_now || now - m->last_beacon > MESH_BEACON_MS)) {
+        buf[0] = m->id;
+        buf[1] = CMD_MESH_BEACON;
+        buf[MESH_BEACON_PARENT] = m->parent;
+        buf[MESH_BEACON_HOPS] = m->hops;
+        buf[MESH_BEACON_COST] = m->cost;
+        m->beacon_now = 0;
+        m->last_beacon = now;
+        return MESH_BEACON_LEN;
+    }
+    return 0;
+}
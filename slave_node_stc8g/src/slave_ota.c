@@ -0,0 +1,164 @@
+/*
+ * 从机空中升级实现
+ */
+
+#include "slave_ota.h"
+
+#define OTA_HAVE(o, i)      ((o)->have[(i) >> 3] & (1 << ((i) & 7)))
+
+// ==================== 内部函数 ====================
+
+static unsigned int ota_get16(const unsigned char *p) {
+    return p[0] | ((unsigned int)p[1] << 8);
+}
+
+static void ota_put16(unsigned char *p, unsigned int v) {
+    p[0] = (unsigned char)v;
+    p[1] = (unsigned char)(v >> 8);
+}
+
+/**
+ * 组装 STATUS 帧: 位图窗口从 from 之后第一个缺少的分片开始
+ */
+static void ota_build_status(const SlaveOta_t *o, unsigned char *tx, unsigned int from) {
+    unsigned int base = o->chunks;
+    unsigned int i;
+
+    if (o->state == OTA_STATE_RECEIVING) {
+        for (base = from; base < o->chunks && OTA_HAVE(o, base); base++);
+    }
+
+    tx[0] = o->id;
+    tx[1] = CMD_OTA_STATUS;
+    tx[OTA_STATUS_SESSION] = o->session;
+    tx[OTA_STATUS_STATE] = o->state;
+    ota_put16(tx + OTA_STATUS_MISSING, o->state == OTA_STATE_RECEIVING ? o->missing : 0);
+    ota_put16(tx + OTA_STATUS_BASE, base);
+    for (i = 0; i < OTA_STATUS_BITMAP; i++) tx[OTA_STATUS_HEADER + i] = 0;
+    for (i = 0; i < OTA_STATUS_WINDOW && base + i < o->chunks; i++) {
+        if (!OTA_HAVE(o, base + i)) tx[OTA_STATUS_HEADER + (i >> 3)] |= 1 << (i & 7);
+    }
+}
+
+static unsigned char ota_on_begin(SlaveOta_t *o, const unsigned char *rx, unsigned char *tx) {
+    unsigned int size = ota_get16(rx + OTA_BEGIN_SIZE);
+    unsigned int crc = ota_get16(rx + OTA_BEGIN_CRC);
+    unsigned int i;
+
+    // 重发的 BEGIN (主机没收到应答) 不重新擦除
+    if (rx[OTA_SESSION] == o->session && size == o->size && crc == o->crc &&
+        (o->state == OTA_STATE_RECEIVING || o->state == OTA_STATE_VERIFIED || o->state == OTA_STATE_ACTIVATING)) {
+        ota_build_status(o, tx, 0);
+        return OTA_DO_HANDLED | OTA_DO_REPLY;
+    }
+
+    o->session = rx[OTA_SESSION];
+    o->size = size;
+    o->crc = crc;
+    if (size == 0 || size > OTA_IMAGE_MAX) {
+        o->state = OTA_STATE_REJECTED;
+        o->chunks = 0;
+        o->missing = 0;
+        ota_build_status(o, tx, 0);
+        return OTA_DO_HANDLED | OTA_DO_REPLY;
+    }
+
+    o->state = OTA_STATE_RECEIVING;
+    o->chunks = (size + OTA_CHUNK_SIZE - 1) / OTA_CHUNK_SIZE;
+    o->missing = o->chunks;
+    for (i = 0; i < OTA_BITMAP_BYTES; i++) o->have[i] = 0;
+    ota_build_status(o, tx, 0);
+    return OTA_DO_HANDLED | OTA_DO_ERASE | OTA_DO_REPLY;
+}
+
+static unsigned char ota_on_data(SlaveOta_t *o, const unsigned char *rx, unsigned char len) {
+    unsigned int index = ota_get16(rx + OTA_DATA_INDEX);
+    unsigned int offset, expect;
+
+    if (o->state != OTA_STATE_RECEIVING || rx[OTA_DATA_SESSION] != o->session || index >= o->chunks) {
+        return OTA_DO_HANDLED;
+    }
+
+    // 最后一片可以不足 OTA_CHUNK_SIZE，其余必须是整片
+    offset = index * OTA_CHUNK_SIZE;
+    expect = o->size - offset;
+    if (expect > OTA_CHUNK_SIZE) expect = OTA_CHUNK_SIZE;
+    if ((unsigned int)(len - OTA_DATA_HEADER) != expect || OTA_HAVE(o, index)) return OTA_DO_HANDLED;
+
+    o->have[index >> 3] |= 1 << (index & 7);
+    o->missing--;
+    o->write_offset = offset;
+    o->write_len = (unsigned char)expect;
+    return o->missing ? OTA_DO_HANDLED | OTA_DO_WRITE : OTA_DO_HANDLED | OTA_DO_WRITE | OTA_DO_VERIFY;
+}
+
+// ==================== 接口 ====================
+
+void slave_ota_init(SlaveOta_t *o, unsigned char id) {
+    unsigned int i;
+
+    o->id = id;
+    o->state = OTA_STATE_IDLE;
+    o->session = 0;
+    o->size = 0;
+    o->crc = 0;
+    o->chunks = 0;
+    o->missing = 0;
+    for (i = 0; i < OTA_BITMAP_BYTES; i++) o->have[i] = 0;
+    o->write_offset = 0;
+    o->write_len = 0;
+}
+
+unsigned char slave_ota_receive(SlaveOta_t *o, const unsigned char *rx, unsigned char len, unsigned char *tx) {
+    if (len < 2) return 0;
+
+    switch (rx[1]) {
+        case CMD_OTA_DATA:
+            // 广播，不应答
+            if (len <= OTA_DATA_HEADER) return OTA_DO_HANDLED;
+            return ota_on_data(o, rx, len);
+
+        case CMD_OTA_BEGIN:
+            if (len < OTA_BEGIN_LEN || rx[OTA_TARGET] != o->id) return OTA_DO_HANDLED;
+            return ota_on_begin(o, rx, tx);
+
+        case CMD_OTA_QUERY:
+            if (len < OTA_QUERY_LEN || rx[OTA_TARGET] != o->id) return OTA_DO_HANDLED;
+            ota_build_status(o, tx, ota_get16(rx + OTA_QUERY_FROM));
+            return OTA_DO_HANDLED | OTA_DO_REPLY;
+
+        case CMD_OTA_ACTIVATE:
+            if (len < OTA_ACTIVATE_LEN || rx[OTA_TARGET] != o->id) return OTA_DO_HANDLED;
+            // 未校验通过或会话不符时只应答当前状态
+            if (o->state != OTA_STATE_VERIFIED || rx[OTA_SESSION] != o->session) {
+                ota_build_status(o, tx, 0);
+                return OTA_DO_HANDLED | OTA_DO_REPLY;
+            }
+            o->state = OTA_STATE_ACTIVATING;
+            ota_build_status(o, tx, 0);
+            return OTA_DO_HANDLED | OTA_DO_REPLY | OTA_DO_ACTIVATE;
+
+        case CMD_OTA_STATUS:
+            // 其他节点的应答
+            return OTA_DO_HANDLED;
+
+        default:
+            return 0;
+    }
+}
+
+void slave_ota_verified(SlaveOta_t *o, unsigned int crc) {
+    if (o->state != OTA_STATE_RECEIVING || o->missing) return;
+    o->state = crc == o->crc ? OTA_STATE_VERIFIED : OTA_STATE_CRC_ERROR;
+}
+
+unsigned int slave_ota_crc16(unsigned int crc, unsigned char b) {
+    unsigned char i;
+
+    crc ^= (unsigned int)b << 8;
+    for (i = 0; i < 8; i++) {
+        crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+    // int 宽于 16 位时 (主机端) 去掉移出的高位
+    return crc & 0xFFFF;
+}
@@ -0,0 +1,60 @@
+/*
+ * 从机协议实现
+ */
+
+#include "slave_proto.h"
+
+void slave_init(SlaveNode_t *node, unsigned char id) {
+    node->id = id;
+    node->water_level = 0;
+    node->well_water_ok = 1;
+    node->last_send = 0;
+}
+
+unsigned char slave_report_due(const SlaveNode_t *node, unsigned long now) {
+    return (now - node->last_send > SLAVE_REPORT_MS) ? 1 : 0;
+}
+
+unsigned char slave_build_report(const SlaveNode_t *node, unsigned char *buf) {
+    buf[0] = node->id;                      // 从机 ID
+    buf[1] = CMD_SENSOR_DATA;               // 传感器数据命令
+    buf[2] = 2;                             // 数据长度
+    buf[3] = node->water_level;             // 水位 0-100%
+    buf[4] = node->well_water_ok ? 1 : 0;   // 井水状态
+    return SLAVE_REPORT_LEN;
+}
+
+void slave_report_sent(SlaveNode_t *node, unsigned long now) {
+    node->last_send = now;
+}
+
+unsigned char slave_rx_window(const SlaveNode_t *node, unsigned long now) {
+    return (now - node->last_send < SLAVE_RX_WINDOW_MS) ? 1 : 0;
+}
+
+/**
+ * 支持命令:
+ * - CMD_READ_SENSOR: 读取传感器 (立即响应)
+ * - CMD_PUMP_CTRL: 水泵控制 (忽略，由 ESP8266 直接控制)
+ * - CMD_HEARTBEAT: 心跳请求
+ */
+unsigned char slave_handle_command(const SlaveNode_t *node, const unsigned char *rx, unsigned char len) {
+    if (len < SLAVE_COMMAND_MIN) return 0;  // 数据太短
+
+    // 验证目标地址
+    if (rx[1] != node->id) return 0;        // 不是给我的
+
+    switch (rx[2]) {
+        case CMD_READ_SENSOR:
+        case CMD_HEARTBEAT:
+            return 1;
+
+        case CMD_PUMP_CTRL:
+            // 忽略水泵控制命令 (ESP8266 直接控制继电器)
+            return 0;
+
+        default:
+            // 未知命令
+            return 0;
+    }
+}
@@ -0,0 +1,121 @@
+/*
+ * 从机采样窗口实现
+ */
+
+#include "slave_window.h"
+
+// ==================== 内部函数 ====================
+
+static void window_clear(SlaveWindow_t *w) {
+    w->samples = 0;
+    w->level_min = 0;
+    w->level_max = 0;
+    w->changes = 0;
+    w->urgent = 0;
+    w->count = 0;
+}
+
+/**
+ * 把采样环中最新的 n 个通道图按 9 位依次打包
+ * @return 写入的字节数
+ */
+static unsigned char window_pack(const SlaveWindow_t *w, unsigned char n, unsigned char *out) {
+    unsigned char idx = (unsigned char)((w->head - n) & (WINDOW_SAMPLES_MAX - 1));
+    unsigned char bits = 0;
+    unsigned char len = 0;
+    unsigned int acc = 0;
+
+    while (n--) {
+        // acc 中最多剩 7 位，加上 9 位不超过 16 位
+        acc |= (w->map[idx] & WINDOW_MAP_MASK) << bits;
+        bits += 9;
+        while (bits >= 8) {
+            out[len++] = (unsigned char)acc;
+            acc >>= 8;
+            bits -= 8;
+        }
+        idx = (unsigned char)((idx + 1) & (WINDOW_SAMPLES_MAX - 1));
+    }
+    if (bits) out[len++] = (unsigned char)acc;
+    return len;
+}
+
+// ==================== 采样 ====================
+
+void slave_window_init(SlaveWindow_t *w, unsigned char batch) {
+    w->batch = batch;
+    w->last_sample = 0;
+    w->prev_level = WINDOW_NO_LEVEL;
+    w->prev_well = 1;
+    w->head = 0;
+    window_clear(w);
+}
+
+unsigned char slave_window_sample_due(const SlaveWindow_t *w, unsigned long now) {
+    return (now - w->last_sample >= SLAVE_SAMPLE_MS) ? 1 : 0;
+}
+
+void slave_window_add(SlaveWindow_t *w, SlaveNode_t *node, unsigned char level, unsigned char well_ok,
+                      unsigned int map, unsigned long now) {
+    well_ok = well_ok ? 1 : 0;
+    w->last_sample = now;
+
+    if (w->samples == 0) {
+        w->level_min = level;
+        w->level_max = level;
+    } else {
+        if (level < w->level_min) w->level_min = level;
+        if (level > w->level_max) w->level_max = level;
+    }
+    if (w->samples != 0xFF) w->samples++;
+
+    // 与上一次采样比较 (上电后的第一次不算变化)
+    if (w->prev_level != WINDOW_NO_LEVEL) {
+        if ((level != w->prev_level || well_ok != w->prev_well) && w->changes != 0xFF) w->changes++;
+        if (well_ok != w->prev_well) w->urgent = 1;
+    }
+    w->prev_level = level;
+    w->prev_well = well_ok;
+
+    w->map[w->head] = map & WINDOW_MAP_MASK;
+    w->head = (unsigned char)((w->head + 1) & (WINDOW_SAMPLES_MAX - 1));
+    if (w->count < WINDOW_SAMPLES_MAX) w->count++;
+
+    node->water_level = level;
+    node->well_water_ok = well_ok;
+}
+
+// ==================== 上报 ====================
+
+unsigned char slave_window_report_due(const SlaveWindow_t *w, const SlaveNode_t *node, unsigned long now) {
+    if (w->urgent) return 1;
+    if (w->batch && w->count >= WINDOW_SAMPLES_MAX) return 1;
+    return slave_report_due(node, now);
+}
+
+unsigned char slave_window_build_report(const SlaveWindow_t *w, const SlaveNode_t *node, unsigned char *buf,
+                                        unsigned char room) {
+    unsigned char len = slave_build_report(node, buf);
+    unsigned char n;
+
+    buf[WINDOW_LEVEL_MIN] = w->samples ? w->level_min : node->water_level;
+    buf[WINDOW_LEVEL_MAX] = w->samples ? w->level_max : node->water_level;
+    buf[WINDOW_CHANGES] = w->changes;
+    buf[WINDOW_SAMPLES] = w->samples;
+    len = SLAVE_SUMMARY_LEN;
+
+    // 通道图: 放得下的最新 n 次采样
+    if (w->batch && room > len) {
+        n = (unsigned char)((unsigned int)(room - len) * 8 / 9);
+        if (n > w->count) n = w->count;
+        len += window_pack(w, n, buf + len);
+    }
+
+    buf[2] = (unsigned char)(len - 3);      // 数据长度
+    return len;
+}
+
+void slave_window_report_sent(SlaveWindow_t *w, SlaveNode_t *node, unsigned long now) {
+    slave_report_sent(node, now);
+    window_clear(w);
+}
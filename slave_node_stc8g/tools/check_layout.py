@@ -0,0 +1,100 @@
+# 从机固件布局检查 (make 链接后、make ota、make size 调用)
+#
+# 按 SDCC 链接生成的 .map (各段的地址和长度) 和 .mem (栈起始地址) 检查空中升级的分区
+# (inc/ota_flash.h)：
+# - 程序区: BOOT 以外的代码段 (CSEG、CONST、HOME、GSINIT 等) 必须在 --boot 之下，
+#   否则会与复制程序重叠，升级镜像也放不下
+# - BOOT 段: 复制程序不能超过 --stage (暂存区起始)
+# - 内部 RAM: 链接器分配的数据段和栈不能与复制程序的工作变量 (--boot-ram 起 16 字节) 重叠
+# 任何一项不满足时返回 1 (make 失败)。
+#
+# --image 输入 输出: 从完整的 .bin 中取出程序区 (到最后一个代码段的结尾) 作为升级镜像。
+
+import argparse
+import re
+import sys
+
+AREA = re.compile(r"^(\S+)\s+([0-9A-Fa-f]+)\s+([0-9A-Fa-f]+)\s+=\s+(\d+)\.\s+bytes\s+\(([^)]*)\)")
+STACK = re.compile(r"Stack starts at:\s*0x([0-9A-Fa-f]+)")
+BOOT_RAM_SIZE = 16
+
+
+def read_areas(path):
+    """返回 [(名称, 起始, 长度, 属性集合)]"""
+    areas = []
+    with open(path, errors="replace") as f:
+        for line in f:
+            m = AREA.match(line.strip())
+            if m:
+                attrs = set(a.strip() for a in m.group(5).split(","))
+                areas.append((m.group(1), int(m.group(2), 16), int(m.group(3), 16), attrs))
+    return areas
+
+
+def read_stack(path):
+    with open(path, errors="replace") as f:
+        m = STACK.search(f.read())
+    return int(m.group(1), 16) if m else None
+
+
+def main():
+    parser = argparse.ArgumentParser(description="从机固件布局检查")
+    parser.add_argument("--map", required=True)
+    parser.add_argument("--mem", required=True)
+    parser.add_argument("--boot", type=lambda s: int(s, 0), required=True, help="BOOT 段起始 (程序区上限)")
+    parser.add_argument("--stage", type=lambda s: int(s, 0), required=True, help="暂存区起始 (BOOT 段上限)")
+    parser.add_argument("--boot-ram", type=lambda s: int(s, 0), required=True, help="复制程序工作变量的地址")
+    parser.add_argument("--image", nargs=2, metavar=("BIN", "OUT"), help="取出升级镜像")
+    args = parser.parse_args()
+
+    areas = read_areas(args.map)
+    code = [a for a in areas if "CODE" in a[3] and a[2] > 0]
+    if not any(a[0] == "CSEG" for a in code):
+        print("❌ %s 中没有找到 CSEG (不是 SDCC 的 .map?)" % args.map)
+        return 1
+
+    errors = []
+    app_end = max(a[1] + a[2] for a in code if a[0] != "BOOT")
+    boot = [a for a in code if a[0] == "BOOT"]
+    boot_size = sum(a[2] for a in boot)
+    if app_end > args.boot:
+        over = [a[0] for a in code if a[0] != "BOOT" and a[1] + a[2] > args.boot]
+        errors.append("程序区结束于 0x%04X，超过 BOOT 段 0x%04X %d 字节 (%s)" %
+                      (app_end, args.boot, app_end - args.boot, ",".join(over)))
+    for name, start, size, _ in boot:
+        if start < args.boot or start + size > args.stage:
+            errors.append("BOOT 段 0x%04X-0x%04X 超出 0x%04X-0x%04X" %
+                          (start, start + size, args.boot, args.stage))
+
+    # 内部 RAM: 可重定位的数据段 (绝对地址的段即复制程序的工作变量本身)
+    ram_lo, ram_hi = args.boot_ram, args.boot_ram + BOOT_RAM_SIZE
+    for name, start, size, attrs in areas:
+        if size == 0 or "ABS" in attrs or not (attrs & {"DATA", "IDATA"}):
+            continue
+        if start < ram_hi and start + size > ram_lo:
+            errors.append("内部 RAM 段 %s 0x%02X-0x%02X 与复制程序的工作变量 0x%02X-0x%02X 重叠" %
+                          (name, start, start + size, ram_lo, ram_hi))
+    stack = read_stack(args.mem)
+    if stack is None:
+        errors.append("%s 中没有找到栈起始地址" % args.mem)
+    elif stack < ram_hi:
+        errors.append("栈从 0x%02X 开始，与复制程序的工作变量 0x%02X-0x%02X 重叠" % (stack, ram_lo, ram_hi))
+
+    print("程序区 %d / %d 字节，BOOT 段 %d / %d 字节，栈从 0x%02X 开始" %
+          (app_end, args.boot, boot_size, args.stage - args.boot, stack or 0))
+    if errors:
+        for e in errors:
+            print("❌ " + e)
+        return 1
+
+    if args.image:
+        with open(args.image[0], "rb") as f:
+            data = f.read()[:app_end]
+        with open(args.image[1], "wb") as f:
+            f.write(data)
+        print("升级镜像 %d 字节: %s" % (len(data), args.image[1]))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())